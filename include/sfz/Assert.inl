@@ -4,7 +4,7 @@
 
 #define sfz_assert_debug_m_impl(condition, message) \
 { \
-	if (!condition) { \
+	if (!(condition)) { \
 		std::cerr << message << std::endl; \
 		assert(condition); \
 	} \
@@ -21,7 +21,7 @@
 
 #define sfz_assert_release_impl(condition) \
 { \
-	if (!condition) { \
+	if (!(condition)) { \
 		assert(condition); \
 		std::terminate(); \
 	} \
@@ -29,7 +29,7 @@
 
 #define sfz_assert_release_m_impl(condition, message) \
 { \
-	if (!condition) { \
+	if (!(condition)) { \
 		std::cerr << message << std::endl; \
 		assert(condition); \
 		std::terminate(); \
@@ -4,9 +4,14 @@
 
 #include "sfz/geometry/AABB.hpp"
 #include "sfz/geometry/AABB2D.hpp"
+#include "sfz/geometry/BatchIntersection.hpp"
 #include "sfz/geometry/Circle.hpp"
 #include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/KdTree.hpp"
+#include "sfz/geometry/LodSelection.hpp"
+#include "sfz/geometry/MultiFrustumCuller.hpp"
 #include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/OcclusionCuller.hpp"
 #include "sfz/geometry/Plane.hpp"
 #include "sfz/geometry/Sphere.hpp"
 #include "sfz/geometry/ViewFrustum.hpp"
@@ -0,0 +1,7 @@
+#pragma once
+#ifndef SFZ_PHYSICS_HPP
+#define SFZ_PHYSICS_HPP
+
+#include "sfz/physics/PhysicsWorld2D.hpp"
+
+#endif
\ No newline at end of file
@@ -2,9 +2,25 @@
 #ifndef SFZ_UTIL_HPP
 #define SFZ_UTIL_HPP
 
+#include "sfz/util/Allocators.hpp"
+#include "sfz/util/AsyncIO.hpp"
+#include "sfz/util/Compression.hpp"
+#include "sfz/util/FileWatcher.hpp"
 #include "sfz/util/FrametimeStats.hpp"
+#include "sfz/util/HashMap.hpp"
+#include "sfz/util/HitchDetector.hpp"
 #include "sfz/util/IniParser.hpp"
 #include "sfz/util/IO.hpp"
+#include "sfz/util/JobSystem.hpp"
+#include "sfz/util/LockFree.hpp"
+#include "sfz/util/MappedFile.hpp"
+#include "sfz/util/MemoryTracking.hpp"
+#include "sfz/util/PackArchive.hpp"
+#include "sfz/util/Profiler.hpp"
+#include "sfz/util/SmallVector.hpp"
+#include "sfz/util/StaticVector.hpp"
 #include "sfz/util/StopWatch.hpp"
+#include "sfz/util/StringID.hpp"
+#include "sfz/util/Timer.hpp"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+#ifndef SFZ_GEOMETRY_BATCH_INTERSECTION_HPP
+#define SFZ_GEOMETRY_BATCH_INTERSECTION_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <vector>
+
+#include "sfz/math/Vector.hpp"
+
+// Forward declares geometry primitives
+namespace sfz {
+	struct AABB2D;
+	struct Circle;
+}
+
+namespace sfz {
+
+using std::size_t;
+using std::uint32_t;
+using std::vector;
+
+// Structure of arrays views
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Non-owning structure of arrays view of 2D points
+ * The batch functions below are equivalent to calling the corresponding single primitive
+ * functions in Intersection.hpp for every element, but process several elements at a time using
+ * SIMD (SSE2) where available.
+ */
+struct PointArray final {
+	const float* x;
+	const float* y;
+	size_t count;
+};
+
+/** @brief Non-owning structure of arrays view of Circles. */
+struct CircleArray final {
+	const float* x;
+	const float* y;
+	const float* radius;
+	size_t count;
+};
+
+/** @brief Non-owning structure of arrays view of AABB2Ds. */
+struct AABB2DArray final {
+	const float* minX;
+	const float* minY;
+	const float* maxX;
+	const float* maxY;
+	size_t count;
+};
+
+/** @brief A pair of indices into two arrays, result of many vs many tests. */
+struct IndexPair final {
+	uint32_t first, second;
+};
+
+/** @brief Returns the number of 32-bit words needed for a bitmask with count bits. */
+inline size_t bitmaskNumWords(size_t count) noexcept { return (count + 31) / 32; }
+
+/** @brief Returns whether bit i is set in bitmask. */
+inline bool bitmaskIsSet(const uint32_t* bitmask, size_t i) noexcept
+{
+	return ((bitmask[i / 32] >> (i % 32)) & 1u) != 0;
+}
+
+// One vs many, bitmask output
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Bit i in bitmaskOut is set if element i passes the test, bitmaskOut must have room for
+// bitmaskNumWords(count) words. All bits are written, no need to clear beforehand.
+
+void pointInside(const Circle& circle, const PointArray& points, uint32_t* bitmaskOut) noexcept;
+void pointInside(const AABB2D& rect, const PointArray& points, uint32_t* bitmaskOut) noexcept;
+
+void overlaps(const Circle& circle, const CircleArray& circles, uint32_t* bitmaskOut) noexcept;
+void overlaps(const Circle& circle, const AABB2DArray& rects, uint32_t* bitmaskOut) noexcept;
+void overlaps(const AABB2D& rect, const CircleArray& circles, uint32_t* bitmaskOut) noexcept;
+void overlaps(const AABB2D& rect, const AABB2DArray& rects, uint32_t* bitmaskOut) noexcept;
+
+// One vs many, index list output
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// The indices of the elements passing the test are written in increasing order to indicesOut,
+// which must have room for count indices. Returns the number of indices written.
+
+size_t pointInsideIndices(const Circle& circle, const PointArray& points, uint32_t* indicesOut) noexcept;
+size_t pointInsideIndices(const AABB2D& rect, const PointArray& points, uint32_t* indicesOut) noexcept;
+
+size_t overlapsIndices(const Circle& circle, const CircleArray& circles, uint32_t* indicesOut) noexcept;
+size_t overlapsIndices(const Circle& circle, const AABB2DArray& rects, uint32_t* indicesOut) noexcept;
+size_t overlapsIndices(const AABB2D& rect, const CircleArray& circles, uint32_t* indicesOut) noexcept;
+size_t overlapsIndices(const AABB2D& rect, const AABB2DArray& rects, uint32_t* indicesOut) noexcept;
+
+// Many vs many
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Appends all overlapping (lhs index, rhs index) pairs to pairsOut, returns number of pairs added.
+
+size_t overlappingPairs(const CircleArray& lhs, const CircleArray& rhs,
+                        vector<IndexPair>& pairsOut) noexcept;
+size_t overlappingPairs(const CircleArray& lhs, const AABB2DArray& rhs,
+                        vector<IndexPair>& pairsOut) noexcept;
+size_t overlappingPairs(const AABB2DArray& lhs, const AABB2DArray& rhs,
+                        vector<IndexPair>& pairsOut) noexcept;
+
+} // namespace sfz
+#endif
\ No newline at end of file
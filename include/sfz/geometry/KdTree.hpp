@@ -0,0 +1,141 @@
+#pragma once
+#ifndef SFZ_GEOMETRY_KD_TREE_HPP
+#define SFZ_GEOMETRY_KD_TREE_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <vector>
+
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+using std::vector;
+
+// Forward declares geometry primitives
+class AABB;
+struct AABB2D;
+struct Circle;
+class Sphere;
+
+/** @brief A point found by a KdTree query, index refers to the array the tree was built from. */
+struct KdNeighbour final {
+	uint32_t index;
+	float distSquared;
+};
+
+/**
+ * @brief An implicit kd-tree for nearest neighbour and range queries over 2D or 3D points
+ *
+ * The tree has no explicit nodes. Instead the points are stored in a single array ordered such
+ * that for each range [begin, end) the splitting point is located at (begin + end) / 2, with the
+ * left and right subtrees on either side of it. Ranges are split along the axis with the largest
+ * extent, and ranges of at most LEAF_SIZE points are left unsorted and scanned linearly. The tree
+ * is static, it has to be rebuilt if the points change.
+ *
+ * Queries write their results to caller provided vectors. These are cleared but keep their
+ * capacity, so repeated queries do not allocate once the vectors have grown large enough.
+ */
+template<size_t N>
+class KdTree final {
+public:
+	// Constants & typedefs
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	using VecN = Vector<float,N>;
+	static const uint32_t LEAF_SIZE = 8;
+	static const uint32_t NO_INDEX = ~0u;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	KdTree() noexcept = default;
+	KdTree(const KdTree&) = delete;
+	KdTree& operator= (const KdTree&) = delete;
+	KdTree(KdTree&&) noexcept = default;
+	KdTree& operator= (KdTree&&) noexcept = default;
+
+	/** @brief See build(). */
+	KdTree(const VecN* points, size_t numPoints, uint32_t numThreads = 0) noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/**
+	 * @brief Builds the tree from an array of points, replacing any previous content
+	 * The indices returned by queries refer to this array.
+	 * @param numThreads number of threads used for building, 0 means hardware concurrency
+	 */
+	void build(const VecN* points, size_t numPoints, uint32_t numThreads = 0) noexcept;
+
+	/** @brief Returns the closest point, index is NO_INDEX if the tree is empty. */
+	KdNeighbour findNearest(const VecN& point) const noexcept;
+
+	/** @brief Finds the (at most) k closest points, sorted by increasing distance. */
+	void findKNearest(const VecN& point, size_t k, vector<KdNeighbour>& out) const noexcept;
+
+	/**
+	 * @brief Batched version of findKNearest(), queries are distributed over several threads
+	 * @param out array of numQueries * k neighbours, query i is stored sorted in [i*k, i*k + k),
+	 *        unused slots (if the tree contains less than k points) get index NO_INDEX
+	 * @param numThreads number of threads used, 0 means hardware concurrency
+	 */
+	void findKNearest(const VecN* queries, size_t numQueries, size_t k, KdNeighbour* out,
+	                  uint32_t numThreads = 0) const noexcept;
+
+	/** @brief Finds all points within radius (inclusive) of point, in no particular order. */
+	void findInRadius(const VecN& point, float radius, vector<KdNeighbour>& out) const noexcept;
+	void findInRadius(const VecN& point, float radius, vector<uint32_t>& out) const noexcept;
+
+	/** @brief Finds the indices of all points inside the box [min, max], in no particular order. */
+	void findInBox(const VecN& min, const VecN& max, vector<uint32_t>& out) const noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t size() const noexcept { return mPoints.size(); }
+
+	/** @brief The points in tree order, point i has index indices()[i] in the original array. */
+	inline const VecN* points() const noexcept { return mPoints.data(); }
+	inline const uint32_t* indices() const noexcept { return mIndices.data(); }
+
+private:
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void buildRange(const VecN* points, uint32_t begin, uint32_t end, uint32_t numThreads) noexcept;
+	void searchKNearest(uint32_t begin, uint32_t end, const VecN& point, size_t k,
+	                    KdNeighbour* heap, size_t& heapSize) const noexcept;
+	template<typename Func>
+	void searchRadius(uint32_t begin, uint32_t end, const VecN& point, float radiusSquared,
+	                  Func& func) const noexcept;
+	void searchBox(uint32_t begin, uint32_t end, const VecN& min, const VecN& max,
+	               vector<uint32_t>& out) const noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	vector<VecN> mPoints;
+	vector<uint32_t> mIndices;
+	vector<uint8_t> mSplitAxes; // Split axis of the range with its splitting point at index i
+};
+
+using KdTree2 = KdTree<2>;
+using KdTree3 = KdTree<3>;
+
+// Range queries using geometry primitives
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Finds the indices of all points inside the primitive (points on the boundary are included), in
+// no particular order. The output vector is cleared first.
+
+void pointsInside(const KdTree2& tree, const Circle& circle, vector<uint32_t>& indicesOut) noexcept;
+void pointsInside(const KdTree2& tree, const AABB2D& rect, vector<uint32_t>& indicesOut) noexcept;
+void pointsInside(const KdTree3& tree, const Sphere& sphere, vector<uint32_t>& indicesOut) noexcept;
+void pointsInside(const KdTree3& tree, const AABB& box, vector<uint32_t>& indicesOut) noexcept;
+
+} // namespace sfz
+#endif
\ No newline at end of file
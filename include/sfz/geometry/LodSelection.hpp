@@ -0,0 +1,77 @@
+#pragma once
+#ifndef SFZ_GEOMETRY_LOD_SELECTION_HPP
+#define SFZ_GEOMETRY_LOD_SELECTION_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+
+namespace sfz {
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+
+// Forward declares geometry primitives
+class ViewFrustum;
+
+// Structure of arrays views
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/** @brief Non-owning structure of arrays view of Spheres. */
+struct SphereArray final {
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* radius;
+	size_t count;
+};
+
+/** @brief Non-owning structure of arrays view of AABBs. */
+struct AABBArray final {
+	const float* minX;
+	const float* minY;
+	const float* minZ;
+	const float* maxX;
+	const float* maxY;
+	const float* maxZ;
+	size_t count;
+};
+
+// Screen size
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// The screen size of an object is the projected diameter of its bounding sphere divided by the
+// height of the screen, i.e. 1.0 means the object covers the whole screen vertically. The
+// distance used is the distance to the camera position (not the view depth), meaning the screen
+// size does not change when the camera rotates. Distances are clamped to the near plane, objects
+// intersecting the camera get a large screen size. AABBs use their bounding sphere.
+//
+// sizesOut must have room for count elements. Processes 4 elements at a time using SIMD (SSE2)
+// where available.
+
+void screenSizes(const ViewFrustum& camera, const SphereArray& spheres, float* sizesOut) noexcept;
+void screenSizes(const ViewFrustum& camera, const AABBArray& aabbs, float* sizesOut) noexcept;
+
+// LOD selection
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Selects a LOD for each object based on its screen size
+ *
+ * LOD 0 is the most detailed, an object gets LOD i if its screen size is smaller than thresholds
+ * [0, i) but not smaller than thresholds[i], meaning there are numThresholds + 1 LODs.
+ *
+ * To avoid popping when an object is close to a threshold, hysteresis is applied relative to the
+ * current LOD (the previous value in lodsInOut): an object switches to a more detailed LOD only
+ * when its size is at least threshold * (1 + hysteresis), and to a less detailed LOD only when it
+ * is smaller than threshold * (1 - hysteresis). Initialize lodsInOut to 0 for new objects.
+ *
+ * @param sizes the screen sizes of the objects, see screenSizes()
+ * @param thresholds the screen sizes between each LOD, must be in decreasing order
+ * @param hysteresis relative size of the band around each threshold, 0 means no hysteresis
+ */
+void selectLods(const float* sizes, size_t count, const float* thresholds,
+                uint32_t numThresholds, float hysteresis, uint8_t* lodsInOut) noexcept;
+
+} // namespace sfz
+#endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+#ifndef SFZ_GEOMETRY_MULTI_FRUSTUM_CULLER_HPP
+#define SFZ_GEOMETRY_MULTI_FRUSTUM_CULLER_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <vector>
+
+#include "sfz/geometry/ViewFrustum.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::size_t;
+using std::uint32_t;
+using std::vector;
+
+// Forward declares geometry primitives
+class AABB;
+class Sphere;
+
+/**
+ * @brief Culls a set of objects against a camera frustum and several light frusta at once
+ *
+ * Intended for shadow caster culling, i.e. each gl::Spotlight's ViewFrustum is added as a light
+ * and only the objects inside a light's frustum are rendered into its shadow map. Objects are
+ * not required to be visible to the camera to be casters, since objects outside the view can
+ * still cast shadows into it. Lights whose frustum is not visible to the camera are skipped
+ * entirely and get no casters.
+ *
+ * The results are the same as calling ViewFrustum::isVisible() for every object and frustum, but
+ * each object is only loaded once and the frustum planes are stored in a flat array.
+ *
+ * Usage per frame:
+ * culler.beginFrame(cameraFrustum);
+ * culler.addLight(spotlight.viewFrustum()); // Once per light
+ * culler.cull(...); // With the bounding volumes of all objects
+ * culler.casters(lightIndex), culler.cameraVisible();
+ *
+ * Memory is reused between frames, so steady state culling does not allocate.
+ */
+class MultiFrustumCuller final {
+public:
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	MultiFrustumCuller() noexcept = default;
+	MultiFrustumCuller(const MultiFrustumCuller&) = delete;
+	MultiFrustumCuller& operator= (const MultiFrustumCuller&) = delete;
+	MultiFrustumCuller(MultiFrustumCuller&&) noexcept = default;
+	MultiFrustumCuller& operator= (MultiFrustumCuller&&) noexcept = default;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Removes all lights and results, sets the camera frustum. */
+	void beginFrame(const ViewFrustum& camera) noexcept;
+
+	/**
+	 * @brief Adds a light frustum
+	 * @return the index of the light, used to retrieve its casters
+	 */
+	uint32_t addLight(const ViewFrustum& lightFrustum) noexcept;
+
+	/**
+	 * @brief Culls the objects against the camera and all active lights
+	 * The index of each object in the array is what ends up in the caster and visible lists.
+	 */
+	void cull(const AABB* aabbs, size_t count) noexcept;
+	void cull(const Sphere* spheres, size_t count) noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline uint32_t numLights() const noexcept { return mNumLights; }
+
+	/** @brief Returns whether the light's frustum is visible to the camera. */
+	inline bool isLightActive(uint32_t light) const noexcept { return mLightActive[light]; }
+
+	/** @brief The indices of the objects inside the light's frustum, in increasing order. */
+	inline const vector<uint32_t>& casters(uint32_t light) const noexcept { return mCasters[light]; }
+
+	/** @brief The indices of the objects visible to the camera, in increasing order. */
+	inline const vector<uint32_t>& cameraVisible() const noexcept { return mCameraVisible; }
+
+private:
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void addFrustum(const ViewFrustum& frustum) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	ViewFrustum mCamera;
+
+	// Frustum 0 is the camera followed by the active lights, inactive lights have no frustum
+	uint32_t mNumLights = 0;
+	vector<vec4> mPlanes; // 6 per frustum, normal in xyz and d in w
+	vector<vec4> mBoundingSpheres; // Position in xyz, radius in w
+	vector<vec3> mBoundingMins, mBoundingMaxs;
+	vector<uint32_t> mFrustumLights; // Light index per frustum, ~0u for camera
+
+	vector<bool> mLightActive;
+	vector<vector<uint32_t>> mCasters; // Never shrunk to keep allocated memory between frames
+	vector<uint32_t> mCameraVisible;
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
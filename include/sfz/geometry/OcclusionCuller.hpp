@@ -0,0 +1,138 @@
+#pragma once
+#ifndef SFZ_GEOMETRY_OCCLUSION_CULLER_HPP
+#define SFZ_GEOMETRY_OCCLUSION_CULLER_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "sfz/math/Matrix.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::size_t;
+using std::uint32_t;
+using std::unique_ptr;
+using std::vector;
+
+// Forward declares geometry primitives
+class AABB;
+class OBB;
+class ViewFrustum;
+
+/**
+ * @brief A CPU software occlusion culler
+ *
+ * Rasterizes occluder triangles into a low resolution depth buffer and tests occludees (AABBs
+ * and OBBs) against it. No GPU is involved. The depth buffer stores inverse view depth (1/w),
+ * meaning larger values are closer to the camera and 0 is "nothing rendered". The screen is
+ * divided into tiles of TILE_WIDTH x TILE_HEIGHT pixels, each tile stores the farthest depth of
+ * its pixels so that most occludee tests can be resolved without touching individual pixels.
+ *
+ * Occluders are rasterized conservatively at pixel centers, i.e. they never cover more than they
+ * should. Occludees are tested using their projected bounding rectangle and nearest depth, which
+ * means the test may report hidden objects as visible, but never the other way around.
+ *
+ * Usage per frame:
+ * culler.beginFrame(viewFrustum);
+ * culler.addOccluder(...); // Any number of times
+ * culler.rasterize();
+ * culler.isVisible(...); // Any number of times
+ *
+ * Rasterization is split into horizontal bands of tiles which are processed in parallel by
+ * numThreads threads.
+ */
+class OcclusionCuller final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const uint32_t TILE_WIDTH = 8;
+	static const uint32_t TILE_HEIGHT = 8;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	OcclusionCuller() noexcept = default;
+	OcclusionCuller(const OcclusionCuller&) = delete;
+	OcclusionCuller& operator= (const OcclusionCuller&) = delete;
+	OcclusionCuller(OcclusionCuller&&) noexcept = default;
+	OcclusionCuller& operator= (OcclusionCuller&&) noexcept = default;
+
+	/**
+	 * @param width the width of the depth buffer, rounded up to a multiple of TILE_WIDTH
+	 * @param height the height of the depth buffer, rounded up to a multiple of TILE_HEIGHT
+	 * @param numThreads number of threads used for rasterization, 0 means hardware concurrency
+	 */
+	OcclusionCuller(uint32_t width, uint32_t height, uint32_t numThreads = 0) noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Clears the depth buffer and all occluders, sets the view projection matrix used. */
+	void beginFrame(const mat4& viewProjMatrix, float near) noexcept;
+	void beginFrame(const ViewFrustum& viewFrustum) noexcept;
+
+	/**
+	 * @brief Adds occluder triangles, transformed by the specified model matrix
+	 * Triangles are transformed and clipped against the near plane immediately, but are not
+	 * rasterized until rasterize() is called.
+	 * @param vertices the vertices of the occluder
+	 * @param indices the indices of the triangles (3 per triangle), nullptr if not indexed
+	 * @param numTriangles the number of triangles
+	 */
+	void addOccluder(const vec3* vertices, const uint32_t* indices, size_t numTriangles,
+	                 const mat4& modelMatrix) noexcept;
+
+	/** @brief Adds the 12 triangles of an AABB as occluder. */
+	void addOccluder(const AABB& aabb) noexcept;
+
+	/** @brief Rasterizes all added occluders into the depth buffer. */
+	void rasterize() noexcept;
+
+	/** @brief Returns whether the occludee might be visible, i.e. is not fully occluded. */
+	bool isVisible(const AABB& aabb) const noexcept;
+	bool isVisible(const OBB& obb) const noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline uint32_t width() const noexcept { return mWidth; }
+	inline uint32_t height() const noexcept { return mHeight; }
+	inline uint32_t numThreads() const noexcept { return mNumThreads; }
+	inline size_t numTriangles() const noexcept { return mTriangles.size(); }
+
+	/** @brief The inverse depth (1/w) buffer, row-major with width() pixels per row. */
+	inline const float* depthBuffer() const noexcept { return mDepth.get(); }
+
+	/** @brief The farthest inverse depth of each tile, (width() / TILE_WIDTH) tiles per row. */
+	inline const float* tileDepthBuffer() const noexcept { return mTileDepth.get(); }
+
+	/** @brief Internal screen space triangle, x & y in pixels and z as inverse depth. */
+	struct Triangle final {
+		vec3 v[3];
+	};
+
+private:
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void addClipTriangle(const vec4& a, const vec4& b, const vec4& c) noexcept;
+	void addScreenTriangle(const vec4& a, const vec4& b, const vec4& c) noexcept;
+	void rasterizeBand(uint32_t tileRowBegin, uint32_t tileRowEnd) noexcept;
+	bool isVisible(const vec3* corners) const noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	uint32_t mWidth = 0, mHeight = 0, mNumThreads = 1;
+	mat4 mViewProjMatrix;
+	float mNear = 0.0f;
+	unique_ptr<float[]> mDepth, mTileDepth;
+	vector<Triangle> mTriangles;
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
@@ -2,8 +2,12 @@
 #ifndef SFZ_GEOMETRY_VIEW_FRUSTUM_HPP
 #define SFZ_GEOMETRY_VIEW_FRUSTUM_HPP
 
+#include <cstdint>
+
+#include <sfz/geometry/AABB.hpp>
 #include <sfz/geometry/Plane.hpp>
-#include <sfz/geometry/ViewFrustum.hpp>
+#include <sfz/geometry/Sphere.hpp>
+#include <sfz/math/Matrix.hpp>
 #include <sfz/math/Vector.hpp>
 
 // Stupid hack for stupid near/far macros (windows.h)
@@ -12,11 +16,19 @@
 
 namespace sfz {
 	
+using std::uint32_t;
+
 // Forward declares geometry primitives
-class AABB;
 class OBB;
-class Sphere;
 
+/**
+ * @brief A perspective view frustum
+ *
+ * All derived data (matrices, planes, corners and bounding volumes) is computed by the setters,
+ * but only the parts depending on parameters that actually changed, e.g. moving the camera does
+ * not recalculate the projection matrix or the plane normals. The const methods never modify the
+ * frustum, so a const ViewFrustum can safely be used from several threads at once.
+ */
 class ViewFrustum final {
 public:
 	// Constructors & destructors
@@ -47,8 +59,28 @@ public:
 	inline float aspectRatio() const noexcept { return mAspectRatio; }
 	inline float near() const noexcept { return mNear; }
 	inline float far() const noexcept { return mFar; }
+
 	inline const mat4& viewMatrix() const noexcept { return mViewMatrix; }
 	inline const mat4& projMatrix() const noexcept { return mProjMatrix; }
+	/** @brief projMatrix() * viewMatrix() */
+	inline const mat4& viewProjMatrix() const noexcept { return mViewProjMatrix; }
+
+	/**
+	 * @brief Returns the 8 corners of the frustum in world space
+	 * Order: left-bottom-near, right-bottom-near, left-top-near, right-top-near, then the same
+	 * order for the far plane.
+	 */
+	inline const vec3* corners() const noexcept { return mCorners; }
+	/** @brief The smallest sphere containing the frustum, useful for cheap pre-rejection. */
+	inline const Sphere& boundingSphere() const noexcept { return mBoundingSphere; }
+	/** @brief The world space AABB containing the frustum, useful for cheap pre-rejection. */
+	inline const AABB& boundingAABB() const noexcept { return mBoundingAABB; }
+
+	/**
+	 * @brief Writes the 6 planes of the frustum to planesOut, normals are facing outwards
+	 * Order: near, far, up, down, left, right.
+	 */
+	void planes(Plane planesOut[6]) const noexcept;
 
 	// Setters
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -59,6 +91,11 @@ public:
 
 	void setDir(vec3 direction, vec3 up) noexcept;
 	void setClipDist(float near, float far) noexcept;
+
+	/**
+	 * @brief Sets all parameters, the other setters are implemented in terms of this one
+	 * Only the derived data depending on parameters that actually changed is recomputed.
+	 */
 	void set(vec3 position, vec3 direction, vec3 up, float verticalFovDeg, float aspect, float near,
 	         float far) noexcept;
 
@@ -66,17 +103,27 @@ private:
 	// Private methods
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
+	/** @brief Computes all dirty derived data. */
 	void update() noexcept;
-	void updateMatrices() noexcept;
+	void updateShape() noexcept;
 	void updatePlanes() noexcept;
+	void updateCorners() noexcept;
 
 	// Private members
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
-	vec3 mPos, mDir, mUp;
-	float mVerticalFovDeg, mAspectRatio, mNear, mFar;
-	mat4 mViewMatrix, mProjMatrix;
+	vec3 mPos{0.0f}, mDir{0.0f}, mUp{0.0f};
+	float mVerticalFovDeg = 0.0f, mAspectRatio = 0.0f, mNear = 0.0f, mFar = 0.0f;
+
+	// Derived data, see DIRTY_* flags in ViewFrustum.cpp
+	uint32_t mDirtyFlags = ~0u;
+	float mTanHalfFovX, mTanHalfFovY, mSphereDist, mSphereRadius;
+	mat4 mViewMatrix, mProjMatrix, mViewProjMatrix;
+	vec3 mRight, mUpNormal, mDownNormal, mLeftNormal, mRightNormal;
 	Plane mNearPlane, mFarPlane, mUpPlane, mDownPlane, mLeftPlane, mRightPlane;
+	vec3 mCorners[8];
+	Sphere mBoundingSphere;
+	AABB mBoundingAABB;
 };
 
 } // namespace sfz
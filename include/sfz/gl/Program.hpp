@@ -3,10 +3,14 @@
 #define SFZ_GL_SHADER_PROGRAM_HPP
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "sfz/math/Matrix.hpp"
 #include "sfz/math/Vector.hpp"
+#include "sfz/util/FileWatcher.hpp"
+#include "sfz/util/HashMap.hpp"
+#include "sfz/util/StringID.hpp"
 
 namespace gl {
 
@@ -16,9 +20,12 @@ using sfz::vec4;
 using sfz::mat2;
 using sfz::mat3;
 using sfz::mat4;
+using sfz::StringID;
+using sfz::operator"" _sid;
 
 using std::string;
 using std::uint32_t;
+using std::uint64_t;
 
 // Program class
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -76,6 +83,13 @@ public:
 	inline bool wasReloaded() const noexcept { return mWasReloaded; }
 	inline void clearWasReloadedFlag() noexcept { mWasReloaded = false; }
 
+	/**
+	 * @brief Returns the location of an active uniform, or -1 if there is no such uniform
+	 * The locations of all active uniforms are cached when the program is linked (or reloaded), so
+	 * this is only a hash map lookup. Arrays can be looked up both as "name" and "name[0]".
+	 */
+	int uniformLocation(StringID name) const noexcept;
+
 	/**
 	 * @brief Attempts to load source from file and recompile the program
 	 * This operation loads shader source from files and attempts to compile and link them into
@@ -86,6 +100,17 @@ public:
 	 */
 	bool reload() noexcept;
 
+	/**
+	 * @brief Reloads the program whenever its source files change
+	 * The program is reloaded from within FileWatcher::dispatch(), which must therefore be called
+	 * on the thread owning the OpenGL context. Check wasReloaded() to see if the program was
+	 * reloaded. Has no effect on programs not created from file. The watcher must outlive the
+	 * program, or stopWatching() must be called before it is destroyed.
+	 */
+	void watchFiles(sfz::FileWatcher& watcher) noexcept;
+	void stopWatching() noexcept;
+	inline bool isWatching() const noexcept { return mWatcher != nullptr; }
+
 	// Constructors & destructors
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -117,6 +142,20 @@ private:
 
 	// Optional function used to call glBindAttribLocation() & glBindFragDataLocation()
 	void(*mBindAttribFragFunc)(uint32_t shaderProgram) = nullptr;
+
+	// Optional watcher reloading the program, the watch callback reloads *mWatchTarget
+	sfz::FileWatcher* mWatcher = nullptr;
+	uint64_t mWatchId = sfz::FileWatcher::INVALID_ID;
+	std::shared_ptr<Program*> mWatchTarget;
+
+	// Locations of the active uniforms
+	sfz::HashMap<StringID, int> mUniformLocations;
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void swapWatch(Program& other) noexcept;
+	void cacheUniformLocations() noexcept;
 };
 
 // Program compilation & linking helper functions
@@ -141,45 +180,64 @@ const char* postProcessVertexShaderSource() noexcept;
 // Uniform setters
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
+// The StringID overloads use the locations cached by the program (see uniformLocation()), the
+// const char* overloads call glGetUniformLocation() every time.
+
 void setUniform(int location, int i) noexcept;
 void setUniform(const Program& program, const char* name, int i) noexcept;
+void setUniform(const Program& program, StringID name, int i) noexcept;
 void setUniform(int location, const int* intArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const int* intArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const int* intArray, size_t count) noexcept;
 
 void setUniform(int location, uint32_t u) noexcept;
 void setUniform(const Program& program, const char* name, uint32_t u) noexcept;
+void setUniform(const Program& program, StringID name, uint32_t u) noexcept;
 void setUniform(int location, const uint32_t* uintArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const uint32_t* uintArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const uint32_t* uintArray, size_t count) noexcept;
 
 void setUniform(int location, float f) noexcept;
 void setUniform(const Program& program, const char* name, float f) noexcept;
+void setUniform(const Program& program, StringID name, float f) noexcept;
 void setUniform(int location, const float* floatArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const float* floatArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const float* floatArray, size_t count) noexcept;
 
 void setUniform(int location, vec2 vector) noexcept;
 void setUniform(const Program& program, const char* name, vec2 vector) noexcept;
+void setUniform(const Program& program, StringID name, vec2 vector) noexcept;
 void setUniform(int location, const vec2* vectorArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const vec2* vectorArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const vec2* vectorArray, size_t count) noexcept;
 
 void setUniform(int location, const vec3& vector) noexcept;
 void setUniform(const Program& program, const char* name, const vec3& vector) noexcept;
+void setUniform(const Program& program, StringID name, const vec3& vector) noexcept;
 void setUniform(int location, const vec3* vectorArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const vec3* vectorArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const vec3* vectorArray, size_t count) noexcept;
 
 void setUniform(int location, const vec4& vector) noexcept;
 void setUniform(const Program& program, const char* name, const vec4& vector) noexcept;
+void setUniform(const Program& program, StringID name, const vec4& vector) noexcept;
 void setUniform(int location, const vec4* vectorArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const vec4* vectorArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const vec4* vectorArray, size_t count) noexcept;
 
 void setUniform(int location, const mat3& matrix) noexcept;
 void setUniform(const Program& program, const char* name, const mat3& matrix) noexcept;
+void setUniform(const Program& program, StringID name, const mat3& matrix) noexcept;
 void setUniform(int location, const mat3* matrixArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const mat3* matrixArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const mat3* matrixArray, size_t count) noexcept;
 
 void setUniform(int location, const mat4& matrix) noexcept;
 void setUniform(const Program& program, const char* name, const mat4& matrix) noexcept;
+void setUniform(const Program& program, StringID name, const mat4& matrix) noexcept;
 void setUniform(int location, const mat4* matrixArray, size_t count) noexcept;
 void setUniform(const Program& program, const char* name, const mat4* matrixArray, size_t count) noexcept;
+void setUniform(const Program& program, StringID name, const mat4* matrixArray, size_t count) noexcept;
 
 } // namespace gl
 #endif
\ No newline at end of file
@@ -4,13 +4,13 @@
 
 #include <cstddef> // size_t
 #include <cstdint>
-#include <memory>
 
 #include "sfz/geometry/AABB2D.hpp"
 #include "sfz/gl/Program.hpp"
 #include "sfz/gl/TextureRegion.hpp"
 #include "sfz/math/Matrix.hpp"
 #include "sfz/math/Vector.hpp"
+#include "sfz/util/MemoryTracking.hpp"
 
 namespace gl {
 
@@ -18,11 +18,11 @@ using sfz::AABB2D;
 using sfz::vec2;
 using sfz::vec4;
 using sfz::mat3;
+using sfz::TaggedArray;
 
 using std::int32_t;
 using std::size_t;
 using std::uint32_t;
-using std::unique_ptr;
 
 // SpriteBatch
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -82,8 +82,8 @@ private:
 	int32_t mTextureUniformLoc = 0;
 	uint32_t mVAO;
 	uint32_t mVertexBuffer, mIndexBuffer, mTransformBuffer, mUVBuffer;
-	unique_ptr<mat3[]> mTransformArray;
-	unique_ptr<vec4[]> mUVArray;
+	TaggedArray<mat3> mTransformArray;
+	TaggedArray<vec4> mUVArray;
 };
 
 } // namespace sfz
@@ -5,11 +5,12 @@
 #include <sfz/gl/Texture.hpp>
 #include <sfz/gl/TextureEnums.hpp>
 #include <sfz/gl/TextureRegion.hpp>
+#include <sfz/util/HashMap.hpp>
+#include <sfz/util/StringID.hpp>
 
 #include <cstddef> // size_t
 #include <vector>
 #include <string>
-#include <unordered_map>
 
 namespace gl {
 
@@ -17,7 +18,8 @@ using std::size_t;
 using std::vector;
 using std::string;
 using std::uint32_t;
-using std::unordered_map;
+using sfz::HashMap;
+using sfz::StringID;
 
 // TexturePacker
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -47,6 +49,9 @@ public:
 	inline const vector<string>& filenames() const noexcept { return mFilenames; }
 	const TextureRegion* textureRegion(const string& filename) const noexcept;
 
+	/** @brief Returns the region of the texture with the specified filename, or nullptr. */
+	const TextureRegion* textureRegion(StringID filename) const noexcept;
+
 private:
 	// Private members
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -54,7 +59,7 @@ private:
 	uint32_t mTexture;
 	size_t mWidth, mHeight;
 	vector<string> mFilenames;
-	unordered_map<string, TextureRegion> mTextureRegionMap;
+	HashMap<StringID, TextureRegion> mTextureRegionMap;
 };
 
 } // namespace sfz
@@ -0,0 +1,245 @@
+#pragma once
+#ifndef SFZ_PHYSICS_PHYSICS_WORLD_2D_HPP
+#define SFZ_PHYSICS_PHYSICS_WORLD_2D_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sfz/geometry/AABB2D.hpp"
+#include "sfz/geometry/Circle.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+/** @brief The shape of a body in a PhysicsWorld2D. */
+enum class BodyShape2D : uint8_t {
+	CIRCLE = 0,
+	BOX = 1
+};
+
+/** @brief A contact between two bodies, normal points from bodyA to bodyB (bodyA < bodyB). */
+struct Contact2D final {
+	uint32_t bodyA, bodyB;
+	vec2 normal;
+	float penetration;
+	float normalImpulse, tangentImpulse; // Accumulated impulses, kept between steps
+	float normalMass, friction, bias;
+};
+
+/**
+ * @brief A compact 2D rigid body physics world using Circles and AABB2Ds as shapes
+ *
+ * Bodies are stored as a structure of arrays and referenced by index. Since both shapes are axis
+ * aligned primitives bodies never rotate, only linear motion is simulated. Each step consists of:
+ * - Broadphase: sweep and prune along the x-axis, the sorted body list is kept between steps and
+ *   updated with insertion sort since it rarely changes much.
+ * - Narrowphase: one contact per overlapping pair (circle/circle, circle/box and box/box).
+ * - Solver: sequential impulses with friction, warm started with the accumulated impulses of the
+ *   same pair from the previous step.
+ * - Islands: bodies connected by contacts are grouped into islands which are solved independently,
+ *   in parallel when there are many of them. An island where all bodies have been (almost) still
+ *   for a while is put to sleep, and is woken as a whole when touched by an awake body.
+ *
+ * All memory is allocated at construction, meaning the number of bodies and contacts is fixed.
+ * Stepping the world never allocates. Worker threads (if any) are also started at construction,
+ * which is why the world can not be moved.
+ */
+class PhysicsWorld2D final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const uint32_t NO_BODY = ~0u;
+
+	/** @brief The maximum number of steps performed in one call to update(). */
+	static const uint32_t MAX_STEPS_PER_UPDATE = 8;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	PhysicsWorld2D() = delete;
+	PhysicsWorld2D(const PhysicsWorld2D&) = delete;
+	PhysicsWorld2D& operator= (const PhysicsWorld2D&) = delete;
+	PhysicsWorld2D(PhysicsWorld2D&&) = delete;
+	PhysicsWorld2D& operator= (PhysicsWorld2D&&) = delete;
+
+	/**
+	 * @param maxBodies the maximum number of bodies in the world
+	 * @param maxContacts the maximum number of contacts per step, 0 means 4 * maxBodies
+	 * @param numThreads number of threads used for solving islands, 0 means hardware concurrency
+	 */
+	PhysicsWorld2D(uint32_t maxBodies, uint32_t maxContacts = 0, uint32_t numThreads = 0) noexcept;
+	~PhysicsWorld2D() noexcept;
+
+	// Bodies
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/**
+	 * @brief Adds a body to the world
+	 * @param mass the mass of the body, 0 means static (immovable)
+	 * @return index of the body, or NO_BODY if the world is full
+	 */
+	uint32_t addBody(const Circle& circle, float mass, float friction = 0.5f,
+	                 float restitution = 0.0f) noexcept;
+	uint32_t addBody(const AABB2D& box, float mass, float friction = 0.5f,
+	                 float restitution = 0.0f) noexcept;
+
+	/** @brief Removes a body, its index may be reused by later added bodies. */
+	void removeBody(uint32_t body) noexcept;
+
+	/** @brief Wakes the body and all other bodies in its island. */
+	void wakeBody(uint32_t body) noexcept;
+
+	/** @brief Sets the position of the center of the body and wakes it. */
+	void setPosition(uint32_t body, vec2 position) noexcept;
+	void setVelocity(uint32_t body, vec2 velocity) noexcept;
+	void applyImpulse(uint32_t body, vec2 impulse) noexcept;
+	/** @brief Applies a force during the next step, forces are cleared after each step. */
+	void applyForce(uint32_t body, vec2 force) noexcept;
+
+	// Simulation
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/**
+	 * @brief Advances the simulation by deltaSeconds using fixed size steps
+	 * Left over time is accumulated until the next call, at most MAX_STEPS_PER_UPDATE steps are
+	 * performed per call to avoid a spiral of death when the simulation can't keep up.
+	 * @return the number of steps performed
+	 */
+	uint32_t update(float deltaSeconds) noexcept;
+
+	/** @brief Performs a single step of timestep() seconds. */
+	void step() noexcept;
+
+	/** @brief Accumulated left over time / timestep(), for interpolating rendered positions. */
+	inline float interpolationAlpha() const noexcept { return mAccumulator / mTimestep; }
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline uint32_t maxBodies() const noexcept { return mMaxBodies; }
+	inline uint32_t maxContacts() const noexcept { return mMaxContacts; }
+	inline uint32_t numBodies() const noexcept { return mNumBodies; }
+	inline uint32_t numThreads() const noexcept { return uint32_t(mWorkers.size()) + 1; }
+	uint32_t numAwakeBodies() const noexcept;
+	inline uint32_t numIslands() const noexcept { return mNumIslands; }
+
+	inline bool isValid(uint32_t body) const noexcept { return (mFlags[body] & FLAG_VALID) != 0; }
+	inline bool isStatic(uint32_t body) const noexcept { return (mFlags[body] & FLAG_STATIC) != 0; }
+	inline bool isAwake(uint32_t body) const noexcept { return (mFlags[body] & FLAG_AWAKE) != 0; }
+	inline BodyShape2D shape(uint32_t body) const noexcept { return mShapes[body]; }
+	inline vec2 position(uint32_t body) const noexcept { return mPositions[body]; }
+	inline vec2 velocity(uint32_t body) const noexcept { return mVelocities[body]; }
+	inline float mass(uint32_t body) const noexcept
+	{
+		return mInvMasses[body] != 0.0f ? (1.0f / mInvMasses[body]) : 0.0f;
+	}
+	Circle circle(uint32_t body) const noexcept;
+	AABB2D box(uint32_t body) const noexcept;
+
+	/** @brief Arrays with maxBodies() elements, only valid for indices where isValid() is true. */
+	inline const vec2* positions() const noexcept { return mPositions.data(); }
+	inline const vec2* velocities() const noexcept { return mVelocities.data(); }
+
+	/** @brief The contacts of the last step, sorted by (bodyA, bodyB). */
+	inline const Contact2D* contacts() const noexcept { return mContacts.data(); }
+	inline uint32_t numContacts() const noexcept { return mNumContacts; }
+
+	inline vec2 gravity() const noexcept { return mGravity; }
+	inline float timestep() const noexcept { return mTimestep; }
+	inline uint32_t velocityIterations() const noexcept { return mVelocityIterations; }
+
+	// Setters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline void gravity(vec2 gravity) noexcept { mGravity = gravity; }
+	void timestep(float timestep) noexcept;
+	inline void velocityIterations(uint32_t iterations) noexcept { mVelocityIterations = iterations; }
+
+private:
+	// Private constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const uint8_t FLAG_VALID = 1 << 0;
+	static const uint8_t FLAG_STATIC = 1 << 1;
+	static const uint8_t FLAG_AWAKE = 1 << 2;
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	uint32_t addBody(BodyShape2D shape, vec2 pos, vec2 halfExtents, float mass, float friction,
+	                 float restitution) noexcept;
+	/** @brief Wakes the sleeping bodies whose bounds overlap those of the (static) body. */
+	void wakeOverlapping(uint32_t body) noexcept;
+	void collide() noexcept;
+	/** @brief Narrow phase, normal points from a to b. */
+	bool testContact(uint32_t a, uint32_t b, vec2& normalOut, float& penetrationOut) const noexcept;
+	void addContact(uint32_t a, uint32_t b) noexcept;
+	void buildIslands() noexcept;
+	void solveIslands() noexcept;
+	void solveIsland(uint32_t island) noexcept;
+	void solveClaimedIslands() noexcept;
+	void updateSleeping() noexcept;
+	void workerMain() noexcept;
+
+	uint32_t findIslandRoot(uint32_t body) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	uint32_t mMaxBodies, mMaxContacts;
+	vec2 mGravity{0.0f, -9.82f};
+	float mTimestep = 1.0f / 60.0f, mAccumulator = 0.0f;
+	uint32_t mVelocityIterations = 8;
+
+	// Bodies (structure of arrays, maxBodies elements each)
+	uint32_t mNumBodies = 0;
+	vector<uint8_t> mFlags;
+	vector<BodyShape2D> mShapes;
+	vector<vec2> mPositions, mVelocities, mForces;
+	vector<vec2> mHalfExtents; // Radius stored in x for circles
+	vector<vec2> mBoundsMin, mBoundsMax;
+	vector<float> mInvMasses, mFrictions, mRestitutions, mSleepTimers;
+	vector<uint32_t> mFreeList;
+
+	// Broadphase, all valid bodies sorted by mBoundsMin.x
+	vector<uint32_t> mSortedBodies;
+
+	// Contacts, the previous step's contacts are kept for warm starting
+	uint32_t mNumContacts = 0, mNumOldContacts = 0;
+	vector<Contact2D> mContacts, mOldContacts;
+
+	// Islands (union find over bodies connected by contacts)
+	uint32_t mNumIslands = 0;
+	vector<uint32_t> mIslandParents; // Union find parent, per body
+	vector<uint32_t> mIslandIndices; // Index of island per root body
+	vector<uint32_t> mIslandNext; // Circular list of bodies in a sleeping island, per body
+	vector<uint32_t> mIslandContactOffsets; // numIslands + 1 elements
+	vector<uint32_t> mIslandContacts; // Contact indices grouped by island
+	vector<uint32_t> mIslandBodyOffsets; // numIslands + 1 elements
+	vector<uint32_t> mIslandBodies; // Body indices grouped by island
+	vector<uint32_t> mIslandCursors; // Temp storage used when grouping by island
+
+	// Worker threads for solving islands in parallel
+	vector<std::thread> mWorkers;
+	std::mutex mWorkMutex;
+	std::condition_variable mWorkCondition, mDoneCondition;
+	uint64_t mWorkGeneration = 0;
+	uint32_t mNumBusyWorkers = 0;
+	bool mShutdown = false;
+	std::atomic<uint32_t> mNextIsland{0};
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
@@ -4,19 +4,18 @@
 
 #include <cstdint>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include "sfz/sdl/GameController.hpp"
 #include "sfz/sdl/Mouse.hpp"
 #include "sfz/sdl/Window.hpp"
 #include "sfz/math/Vector.hpp"
+#include "sfz/util/HashMap.hpp"
 
 namespace sfz {
 
 using std::int32_t;
 using std::shared_ptr;
-using std::unordered_map;
 using std::vector;
 
 class BaseScreen; // Forward declaration for ScreenUpdateOp
@@ -62,8 +61,8 @@ struct UpdateState final {
 	vector<SDL_Event> events;
 	vector<SDL_Event> controllerEvents;
 	vector<SDL_Event> mouseEvents;
-	unordered_map<int32_t, sdl::GameController> controllers;
-	unordered_map<int32_t, sdl::GameControllerState> controllersLastFrameState;
+	HashMap<int32_t, sdl::GameController> controllers;
+	HashMap<int32_t, sdl::GameControllerState> controllersLastFrameState;
 	sdl::Mouse rawMouse;
 	float delta;
 };
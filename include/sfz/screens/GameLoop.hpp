@@ -6,12 +6,23 @@
 
 #include "sfz/screens/BaseScreen.hpp"
 #include "sfz/sdl/Window.hpp"
+#include "sfz/util/FileWatcher.hpp"
+#include "sfz/util/HitchDetector.hpp"
 
 namespace sfz {
 
 using std::shared_ptr;
 
-void runGameLoop(sdl::Window& window, shared_ptr<BaseScreen> initialScreen);
+/**
+ * @brief Runs the game loop until the current screen quits
+ * Heap allocations of each frame are counted by frameAllocationCounter(), frames where the screen
+ * was switched are not counted.
+ * @param fileWatcher optional watcher dispatched once per frame before updating the screen, so
+ *        that watched resources (e.g. gl::Program::watchFiles()) are reloaded on the main thread
+ * @param hitchDetector optional detector receiving the timings of the phases of each frame
+ */
+void runGameLoop(sdl::Window& window, shared_ptr<BaseScreen> initialScreen,
+                 FileWatcher* fileWatcher = nullptr, HitchDetector* hitchDetector = nullptr);
 
 } // namesapce sfz
 
@@ -3,19 +3,19 @@
 #define SFZ_SDL_GAME_CONTROLLER_HPP
 
 #include <cstdint> // uint8_t, int32_t
-#include <unordered_map>
 #include <vector>
 
 #include <SDL.h>
 #include <sfz/math/Vector.hpp>
+#include <sfz/util/HashMap.hpp>
 
 #include "sfz/sdl/ButtonState.hpp"
 
 namespace sdl {
 
 using std::int32_t;
+using sfz::HashMap;
 using sfz::vec2;
-using std::unordered_map;
 using std::vector;
 
 /** Struct used for representing the state of a GameController at a given point in time. */
@@ -86,7 +86,7 @@ private:
 // Update functions to update GameController struct
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
-void update(unordered_map<int32_t,GameController>& controllers, const vector<SDL_Event>& events) noexcept;
+void update(HashMap<int32_t,GameController>& controllers, const vector<SDL_Event>& events) noexcept;
 
 } // namespace sdl
 #endif
\ No newline at end of file
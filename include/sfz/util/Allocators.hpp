@@ -0,0 +1,292 @@
+#pragma once
+#ifndef SFZ_UTIL_ALLOCATORS_HPP
+#define SFZ_UTIL_ALLOCATORS_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Freed memory is overwritten with ALLOCATOR_POISON_BYTE by the allocators, making use of
+ *        freed memory easier to spot. Disabled by defining SFZ_NO_DEBUG or
+ *        SFZ_NO_ALLOCATOR_POISONING.
+ */
+#if !defined(SFZ_NO_DEBUG) && !defined(SFZ_NO_ALLOCATOR_POISONING)
+#define SFZ_ALLOCATOR_POISONING
+#endif
+
+namespace sfz {
+
+using std::size_t;
+using std::uint8_t;
+using std::vector;
+
+// Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const size_t ALLOCATOR_DEFAULT_ALIGNMENT = 16;
+const uint8_t ALLOCATOR_POISON_BYTE = 0xDD;
+
+const size_t FRAME_ALLOCATOR_CAPACITY = 4 * 1024 * 1024;
+const size_t SCRATCH_ALLOCATOR_CAPACITY = 1024 * 1024;
+
+// LinearAllocator
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Allocates linearly from a fixed block of memory, freed all at once with reset()
+ *
+ * Allocating only bumps an offset. Memory is not freed individually (except for the last
+ * allocation, so that growing a vector at the top does not waste memory), but by rewinding to a
+ * previously taken marker or by resetting the allocator.
+ *
+ * If the block is full allocations fall back to the heap, these are freed when rewinding past
+ * them. numOverflowAllocations() and highWaterMark() tell whether the capacity is large enough.
+ * Not thread-safe.
+ */
+class LinearAllocator final {
+public:
+	// Public types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	struct Marker final {
+		size_t offset;
+		size_t numOverflowAllocations;
+	};
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	LinearAllocator(const LinearAllocator&) = delete;
+	LinearAllocator& operator= (const LinearAllocator&) = delete;
+	LinearAllocator(LinearAllocator&&) = delete;
+	LinearAllocator& operator= (LinearAllocator&&) = delete;
+
+	explicit LinearAllocator(size_t capacity) noexcept;
+	~LinearAllocator() noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Allocates memory, alignment must be a power of two. Never returns nullptr. */
+	void* allocate(size_t size, size_t alignment = ALLOCATOR_DEFAULT_ALIGNMENT) noexcept;
+
+	/** @brief Allocates uninitialized memory for count elements of a trivial type. */
+	template<typename T>
+	inline T* allocateArray(size_t count) noexcept
+	{
+		return static_cast<T*>(this->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	/** @brief Frees the memory if it was the last allocation, otherwise does nothing. */
+	void deallocate(void* ptr, size_t size) noexcept;
+
+	inline Marker marker() const noexcept { return Marker{mOffset, mOverflow.size()}; }
+
+	/** @brief Frees all allocations made after the marker was taken. */
+	void rewind(Marker marker) noexcept;
+
+	/** @brief Frees all allocations, starting a new period for peak() and numAllocations(). */
+	void reset() noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t capacity() const noexcept { return mCapacity; }
+
+	/** @brief Number of bytes used in the block, overflow allocations not included. */
+	inline size_t used() const noexcept { return mOffset; }
+
+	/** @brief Max number of bytes used (including overflow) since last reset. */
+	inline size_t peak() const noexcept { return mPeak; }
+
+	/** @brief Value of peak() right before the last reset, i.e. the peak of the last frame. */
+	inline size_t lastPeak() const noexcept { return mLastPeak; }
+
+	/** @brief Max number of bytes used (including overflow) since construction. */
+	inline size_t highWaterMark() const noexcept { return mHighWaterMark; }
+
+	/** @brief Number of allocations since last reset. */
+	inline size_t numAllocations() const noexcept { return mNumAllocations; }
+
+	/** @brief Number of allocations since last reset which did not fit in the block. */
+	inline size_t numOverflowAllocations() const noexcept { return mNumOverflowAllocations; }
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	struct Overflow final {
+		void* ptr;
+		size_t size;
+	};
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void updatePeak(size_t used) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	uint8_t* const mBlock;
+	const size_t mCapacity;
+	size_t mOffset = 0;
+	vector<Overflow> mOverflow;
+	size_t mOverflowBytes = 0;
+
+	size_t mPeak = 0, mLastPeak = 0, mHighWaterMark = 0;
+	size_t mNumAllocations = 0, mNumOverflowAllocations = 0;
+};
+
+// PoolAllocator
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Allocates fixed-size elements from a preallocated block using a free list
+ * Allocating and freeing are O(1). Returns nullptr when all elements are in use. Not thread-safe.
+ */
+class PoolAllocator final {
+public:
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator= (const PoolAllocator&) = delete;
+	PoolAllocator(PoolAllocator&&) = delete;
+	PoolAllocator& operator= (PoolAllocator&&) = delete;
+
+	PoolAllocator(size_t elementSize, size_t numElements,
+	              size_t alignment = ALLOCATOR_DEFAULT_ALIGNMENT) noexcept;
+	~PoolAllocator() noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Allocates an element, returns nullptr if all elements are in use. */
+	void* allocate() noexcept;
+
+	/** @brief Returns nullptr if the size or alignment is larger than that of the elements. */
+	void* allocate(size_t size, size_t alignment = ALLOCATOR_DEFAULT_ALIGNMENT) noexcept;
+
+	void deallocate(void* ptr, size_t size = 0) noexcept;
+
+	/** @brief Allocates an element and constructs a T in it, returns nullptr if full. */
+	template<typename T, typename... Args>
+	T* create(Args&&... args) noexcept;
+
+	/** @brief Destroys and deallocates an element created with create(). */
+	template<typename T>
+	void destroy(T* ptr) noexcept;
+
+	/** @brief Returns whether the pointer points to an element of this pool. */
+	bool owns(const void* ptr) const noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t elementSize() const noexcept { return mElementSize; }
+	inline size_t capacity() const noexcept { return mNumElements; }
+	inline size_t numAllocated() const noexcept { return mNumAllocated; }
+
+	/** @brief Max number of elements allocated at the same time since construction. */
+	inline size_t peak() const noexcept { return mPeak; }
+
+private:
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const size_t mElementSize, mNumElements, mAlignment;
+	uint8_t* const mBlock;
+	void* mFreeList = nullptr; // Each free element stores a pointer to the next one
+	size_t mNumAllocated = 0, mPeak = 0;
+};
+
+// StlAllocator
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Adapter making it possible to use the allocators in this file with STL containers
+ * Allocator must have allocate(size, alignment) and deallocate(ptr, size) methods. Allocation
+ * failure is a fatal error.
+ */
+template<typename T, typename Allocator>
+class StlAllocator {
+public:
+	using value_type = T;
+
+	template<typename U>
+	struct rebind final {
+		using other = StlAllocator<U, Allocator>;
+	};
+
+	inline StlAllocator(Allocator& allocator) noexcept : mAllocator(&allocator) { }
+
+	template<typename U>
+	inline StlAllocator(const StlAllocator<U, Allocator>& other) noexcept
+	:
+		mAllocator(other.allocator())
+	{ }
+
+	T* allocate(size_t count) noexcept;
+	void deallocate(T* ptr, size_t count) noexcept;
+
+	inline Allocator* allocator() const noexcept { return mAllocator; }
+
+private:
+	Allocator* mAllocator;
+};
+
+template<typename T, typename U, typename Allocator>
+bool operator== (const StlAllocator<T, Allocator>& lhs,
+                 const StlAllocator<U, Allocator>& rhs) noexcept;
+
+template<typename T, typename U, typename Allocator>
+bool operator!= (const StlAllocator<T, Allocator>& lhs,
+                 const StlAllocator<U, Allocator>& rhs) noexcept;
+
+/** @brief A vector allocating from a LinearAllocator, e.g. LinearVector<int> v(frameAllocator()) */
+template<typename T>
+using LinearVector = vector<T, StlAllocator<T, LinearAllocator>>;
+
+// Frame and scratch memory
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Allocator for memory only needed during the current frame
+ * Reset at the start of each frame by runGameLoop(), lastPeak() is the usage of the last frame.
+ * Must only be used from the game loop thread.
+ */
+LinearAllocator& frameAllocator() noexcept;
+
+/** @brief Thread-local stack allocator for temporary memory, use through ScratchScope. */
+LinearAllocator& scratchAllocator() noexcept;
+
+/** @brief Frees everything allocated from the thread's scratch allocator during its lifetime. */
+class ScratchScope final {
+public:
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator= (const ScratchScope&) = delete;
+
+	inline ScratchScope() noexcept
+	:
+		mAllocator(scratchAllocator()),
+		mMarker(mAllocator.marker())
+	{ }
+
+	inline ~ScratchScope() noexcept { mAllocator.rewind(mMarker); }
+
+	template<typename T>
+	inline T* allocateArray(size_t count) noexcept { return mAllocator.allocateArray<T>(count); }
+
+	inline LinearAllocator& allocator() noexcept { return mAllocator; }
+
+private:
+	LinearAllocator& mAllocator;
+	const LinearAllocator::Marker mMarker;
+};
+
+} // namespace sfz
+
+#include "sfz/util/Allocators.inl"
+#endif
\ No newline at end of file
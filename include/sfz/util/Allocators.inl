@@ -0,0 +1,58 @@
+#include <new> // placement new
+#include <utility> // std::forward
+
+#include "sfz/Assert.hpp"
+
+namespace sfz {
+
+// PoolAllocator: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, typename... Args>
+T* PoolAllocator::create(Args&&... args) noexcept
+{
+	void* memory = this->allocate(sizeof(T), alignof(T));
+	if (memory == nullptr) return nullptr;
+	return new (memory) T(std::forward<Args>(args)...);
+}
+
+template<typename T>
+void PoolAllocator::destroy(T* ptr) noexcept
+{
+	if (ptr == nullptr) return;
+	ptr->~T();
+	this->deallocate(ptr, sizeof(T));
+}
+
+// StlAllocator
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, typename Allocator>
+T* StlAllocator<T, Allocator>::allocate(size_t count) noexcept
+{
+	void* memory = mAllocator->allocate(count * sizeof(T), alignof(T));
+	if (memory == nullptr) sfz_error("StlAllocator: allocation failed");
+	return static_cast<T*>(memory);
+}
+
+template<typename T, typename Allocator>
+void StlAllocator<T, Allocator>::deallocate(T* ptr, size_t count) noexcept
+{
+	mAllocator->deallocate(ptr, count * sizeof(T));
+}
+
+template<typename T, typename U, typename Allocator>
+bool operator== (const StlAllocator<T, Allocator>& lhs,
+                 const StlAllocator<U, Allocator>& rhs) noexcept
+{
+	return lhs.allocator() == rhs.allocator();
+}
+
+template<typename T, typename U, typename Allocator>
+bool operator!= (const StlAllocator<T, Allocator>& lhs,
+                 const StlAllocator<U, Allocator>& rhs) noexcept
+{
+	return lhs.allocator() != rhs.allocator();
+}
+
+} // namespace sfz
\ No newline at end of file
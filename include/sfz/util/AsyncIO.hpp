@@ -0,0 +1,198 @@
+#pragma once
+#ifndef SFZ_UTIL_ASYNC_IO_HPP
+#define SFZ_UTIL_ASYNC_IO_HPP
+
+#include <condition_variable>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sfz {
+
+using std::size_t;
+using std::string;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+/** @brief Priority of an AsyncIO request, higher priority requests are always started first. */
+enum class IOPriority : uint8_t {
+	LOW = 0,
+	NORMAL = 1,
+	HIGH = 2
+};
+
+enum class IOStatus : uint8_t {
+	DONE,
+	FAILED, // File could not be opened or read
+	BUFFER_TOO_SMALL, // Caller provided buffer was smaller than the file, nothing was read
+	CANCELLED
+};
+
+/** @brief The result of a completed AsyncIO request. */
+struct IOResult final {
+	uint64_t id = 0;
+	IOStatus status = IOStatus::FAILED;
+	size_t numBytes = 0; // Number of bytes read
+	uint8_t* userBuffer = nullptr; // The caller provided buffer, nullptr if none was provided
+	vector<uint8_t> data; // The contents of the file if no buffer was provided
+
+	/** @brief Pointer to the read bytes, regardless of where they were read to. */
+	inline const uint8_t* bytes() const noexcept
+	{
+		return userBuffer != nullptr ? userBuffer : data.data();
+	}
+};
+
+using IOCallback = std::function<void(IOResult& result)>;
+
+/**
+ * @brief Service for reading files asynchronously on worker threads
+ *
+ * Requests are queued and serviced by the worker threads in priority order (FIFO within the same
+ * priority). Files are read directly into either a caller provided buffer or a buffer taken from
+ * an internal pool, which can be refilled with releaseBuffer() once a result is no longer needed.
+ *
+ * Completion is reported in one of two ways:
+ * - Callbacks are never called on a worker thread, but from pollCompleted(), meaning they run on
+ *   the thread calling it (typically once per frame in the game loop).
+ * - Futures are fulfilled directly by the worker thread and do not require polling.
+ *
+ * Requests can be cancelled until they have completed, large files are read in chunks so that
+ * cancelling a request in progress takes effect quickly.
+ */
+class AsyncIO final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const uint64_t INVALID_ID = 0;
+
+	/** @brief Max number of bytes read by a single read call, cancellation is checked between. */
+	static const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	AsyncIO(const AsyncIO&) = delete;
+	AsyncIO& operator= (const AsyncIO&) = delete;
+	AsyncIO(AsyncIO&&) = delete;
+	AsyncIO& operator= (AsyncIO&&) = delete;
+
+	/** @param numThreads number of worker threads, 0 means hardware concurrency */
+	AsyncIO(uint32_t numThreads = 0) noexcept;
+
+	/** @brief Cancels all queued requests and waits for the ones in progress to finish. */
+	~AsyncIO() noexcept;
+
+	// Requests
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/**
+	 * @brief Reads an entire file into a buffer from the pool
+	 * @param callback called from pollCompleted() once the request has completed, may be empty
+	 * @return the id of the request
+	 */
+	uint64_t readFile(const char* path, IOCallback callback,
+	                  IOPriority priority = IOPriority::NORMAL) noexcept;
+
+	/** @brief Reads an entire file into the caller provided buffer, which must stay alive. */
+	uint64_t readFile(const char* path, uint8_t* buffer, size_t bufferSize, IOCallback callback,
+	                  IOPriority priority = IOPriority::NORMAL) noexcept;
+
+	/** @brief Reads an entire file, result is delivered through the returned future. */
+	std::future<IOResult> readFileFuture(const char* path,
+	                                     IOPriority priority = IOPriority::NORMAL) noexcept;
+	std::future<IOResult> readFileFuture(const char* path, uint8_t* buffer, size_t bufferSize,
+	                                     IOPriority priority = IOPriority::NORMAL) noexcept;
+
+	/**
+	 * @brief Cancels a request
+	 * The request completes with IOStatus::CANCELLED (callback or future) unless it had already
+	 * completed, in which case false is returned.
+	 */
+	bool cancel(uint64_t id) noexcept;
+
+	/** @brief Returns a result buffer to the pool so it can be reused by later requests. */
+	void releaseBuffer(vector<uint8_t>&& buffer) noexcept;
+
+	// Completion
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Calls the callbacks of all completed requests, returns number of completed requests. */
+	size_t pollCompleted() noexcept;
+
+	/** @brief Blocks until all requests have completed, then calls pollCompleted(). */
+	void waitAll() noexcept;
+
+	/** @brief Stops workers from starting new requests, requests in progress still complete. */
+	void suspend() noexcept;
+	void resume() noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline uint32_t numThreads() const noexcept { return uint32_t(mWorkers.size()); }
+
+	/** @brief Number of requests not yet completed (queued or in progress). */
+	size_t numPending() const noexcept;
+
+	/** @brief Total number of bytes read since construction. */
+	uint64_t numBytesRead() const noexcept;
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	struct Request final {
+		uint64_t id;
+		string path;
+		uint8_t* buffer;
+		size_t bufferSize;
+		IOCallback callback;
+		std::shared_ptr<std::promise<IOResult>> promise; // nullptr if callback is used
+	};
+
+	struct Completed final {
+		IOCallback callback;
+		IOResult result;
+	};
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	uint64_t enqueue(Request&& request, IOPriority priority) noexcept;
+	void complete(Request& request, IOResult&& result) noexcept;
+	void read(const Request& request, IOResult& result) noexcept;
+	bool isCancelled(uint64_t id) noexcept;
+	void workerMain(uint32_t workerIndex) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	mutable std::mutex mMutex;
+	std::condition_variable mWorkCondition, mDoneCondition;
+	bool mShutdown = false, mSuspended = false;
+	uint64_t mNextId = 1;
+	uint64_t mNumBytesRead = 0;
+	size_t mNumPending = 0;
+
+	std::deque<Request> mQueues[3]; // One per priority
+	vector<uint64_t> mActiveIds; // Request in progress per worker, INVALID_ID if idle
+	vector<uint64_t> mCancelledActive; // Cancelled requests that were in progress
+	vector<Completed> mCompleted, mCompletedTemp;
+	vector<vector<uint8_t>> mBufferPool;
+
+	vector<std::thread> mWorkers;
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
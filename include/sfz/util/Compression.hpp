@@ -0,0 +1,135 @@
+#pragma once
+#ifndef SFZ_UTIL_COMPRESSION_HPP
+#define SFZ_UTIL_COMPRESSION_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <vector>
+
+namespace sfz {
+
+using std::int64_t;
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+// Blocks
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * Fast LZ77 block compression using the same sequence encoding as the LZ4 block format. Blocks
+ * contain no size information or checksums, use the chunked streams below unless that is handled
+ * elsewhere.
+ */
+
+/** @brief Max size of a compressed block given size of the uncompressed data. */
+size_t compressBound(size_t srcSize) noexcept;
+
+/** @brief Compresses a block, returns compressed size or 0 if dst is too small. */
+size_t compressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst,
+                     size_t dstCapacity) noexcept;
+
+/** @brief Decompresses a block, returns decompressed size or negative value if block is corrupt. */
+int64_t decompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst,
+                        size_t dstCapacity) noexcept;
+
+/** @brief 32-bit xxHash of the data, used as checksum by chunked streams. */
+uint32_t checksum32(const uint8_t* data, size_t size, uint32_t seed = 0) noexcept;
+
+// Chunked streams
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * A chunked stream starts with a header containing the uncompressed size, followed by a table
+ * with the stored size and checksum (of the stored bytes) of each chunk, followed by the chunks.
+ * Chunks are compressed independently, which allows them to be decompressed in parallel or one
+ * by one as soon as they have been read. Chunks that do not compress are stored as is.
+ */
+
+const uint32_t DEFAULT_COMPRESSION_CHUNK_SIZE = 256 * 1024;
+
+/** @brief Compresses data into a chunked stream. */
+vector<uint8_t> compress(const uint8_t* src, size_t srcSize,
+                         uint32_t chunkSize = DEFAULT_COMPRESSION_CHUNK_SIZE) noexcept;
+
+/** @brief Returns whether the data starts with a chunked stream header. */
+bool isCompressed(const uint8_t* src, size_t srcSize) noexcept;
+
+/** @brief Returns the decompressed size of a chunked stream, negative value if not a stream. */
+int64_t decompressedSize(const uint8_t* src, size_t srcSize) noexcept;
+
+/**
+ * @brief Decompresses an entire chunked stream and verifies the checksums
+ * @param dstCapacity must be at least decompressedSize()
+ * @param numThreads number of threads decompressing chunks in parallel, 0 means hardware
+ *        concurrency. Additional threads are only used if there are enough chunks.
+ * @return whether successful or not, the vector version leaves dst empty on failure. Corrupt
+ *         headers are detected before allocating the output.
+ */
+bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity,
+                uint32_t numThreads = 1) noexcept;
+bool decompress(const uint8_t* src, size_t srcSize, vector<uint8_t>& dst,
+                uint32_t numThreads = 1) noexcept;
+
+/**
+ * @brief Decompresses a chunked stream incrementally as its bytes become available
+ * Each chunk is decompressed (and its checksum verified) as soon as all of its bytes have been
+ * fed, so decompression can overlap with reading the rest of the stream.
+ */
+class StreamDecompressor final {
+public:
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Feeds the next bytes of the stream, returns false if the stream is corrupt. */
+	bool feed(const uint8_t* data, size_t size) noexcept;
+
+	/** @brief Takes the decompressed output, leaves the decompressor ready for a new stream. */
+	vector<uint8_t> takeOutput() noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Whether the entire stream has been decompressed. */
+	inline bool isDone() const noexcept { return mHeaderParsed && mNextChunk == mChunkSizes.size(); }
+	inline bool hasError() const noexcept { return mError; }
+
+	/** @brief The output decompressed so far, numBytesDecompressed() bytes. */
+	inline const vector<uint8_t>& output() const noexcept { return mOutput; }
+	inline size_t numBytesDecompressed() const noexcept { return mNumDecompressed; }
+
+private:
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	bool parseHeader() noexcept;
+	bool decompressChunks() noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	vector<uint8_t> mInput, mOutput;
+	size_t mInputOffset = 0, mNumDecompressed = 0;
+	vector<uint32_t> mChunkSizes, mChunkChecksums;
+	uint32_t mChunkSize = 0;
+	uint64_t mUncompressedSize = 0;
+	size_t mNextChunk = 0;
+	bool mHeaderParsed = false, mError = false;
+};
+
+// Files
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/** @brief Compresses memory and writes it as a chunked stream, returns whether successful. */
+bool writeCompressedFile(const char* path, const uint8_t* data, size_t numBytes) noexcept;
+
+/**
+ * @brief Reads and decompresses a file written with writeCompressedFile()
+ * Uncompressed files are returned as is. Returns empty vector if error.
+ */
+vector<uint8_t> readCompressedFile(const char* path, uint32_t numThreads = 1) noexcept;
+
+} // namespace sfz
+#endif
\ No newline at end of file
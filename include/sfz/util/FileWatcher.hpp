@@ -0,0 +1,164 @@
+#pragma once
+#ifndef SFZ_UTIL_FILE_WATCHER_HPP
+#define SFZ_UTIL_FILE_WATCHER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sfz {
+
+using std::int64_t;
+using std::size_t;
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+/** @brief Called with the watched paths that changed (modified, created or deleted). */
+using FileWatchCallback = std::function<void(const vector<string>& changedPaths)>;
+
+/**
+ * @brief Service notifying when watched files change, intended for hot reloading of assets
+ *
+ * On Linux the directories containing the watched files are watched with inotify, so nothing is
+ * done until a file actually changes. Elsewhere, or if inotify is unavailable, a background
+ * thread instead stats the watched files at a fixed interval. Files in directories that do not
+ * exist (e.g. deleted and recreated while watched) are also polled, until the directory exists
+ * again and can be watched with inotify.
+ *
+ * Events are coalesced, a file is only reported once no more events have arrived for it during
+ * the coalesce delay. This way a file being written in several steps (or saved by an editor
+ * writing a temporary file and renaming it) results in a single notification. Before reporting
+ * a file its modification time and size are compared with what they were at the last
+ * notification, so events not changing the file (e.g. opening it for writing without writing)
+ * are ignored.
+ *
+ * Callbacks are never called on the background thread, but from dispatch(), meaning they run on
+ * the thread calling it (typically the main thread once per frame, so that OpenGL resources can
+ * be reloaded directly in the callbacks). Callbacks are called in the order the watches were
+ * created and may watch and unwatch files.
+ */
+class FileWatcher final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const uint64_t INVALID_ID = 0;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator= (const FileWatcher&) = delete;
+	FileWatcher(FileWatcher&&) = delete;
+	FileWatcher& operator= (FileWatcher&&) = delete;
+
+	/**
+	 * @param coalesceMs time without new events before a changed file is reported
+	 * @param pollIntervalMs time between stats of polled files
+	 * @param forcePolling polls all files even if inotify is available
+	 */
+	FileWatcher(uint32_t coalesceMs = 100, uint32_t pollIntervalMs = 250,
+	            bool forcePolling = false) noexcept;
+	~FileWatcher() noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/**
+	 * @brief Watches a group of files, the callback is called once per dispatch() if any changed
+	 * @return id of the watch, used to unwatch
+	 */
+	uint64_t watch(const vector<string>& paths, FileWatchCallback callback) noexcept;
+	uint64_t watch(const char* path, FileWatchCallback callback) noexcept;
+
+	/** @brief Stops watching, returns false if there is no watch with the specified id. */
+	bool unwatch(uint64_t id) noexcept;
+
+	/** @brief Calls the callbacks of all changed files, returns number of callbacks called. */
+	size_t dispatch() noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Whether inotify is used, false if all files are polled. */
+	inline bool usesInotify() const noexcept { return mInotifyFd >= 0; }
+
+	/** @brief Number of distinct files watched. */
+	size_t numWatchedFiles() const noexcept;
+
+	/** @brief Number of watched files currently polled, e.g. because their directory is missing. */
+	size_t numPolledFiles() const noexcept;
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Signature final {
+		int64_t size = -1; // -1 if the file does not exist
+		int64_t mtimeNs = 0;
+
+		inline bool operator== (const Signature& o) const noexcept
+		{
+			return size == o.size && mtimeNs == o.mtimeNs;
+		}
+		inline bool operator!= (const Signature& o) const noexcept { return !(*this == o); }
+	};
+
+	struct WatchedFile final {
+		int wd = -1; // inotify watch of the directory, -1 if polled
+		string name; // Filename without directory
+		uint32_t refCount = 0;
+		Signature polledSignature, dispatchedSignature;
+		bool pending = false;
+		Clock::time_point lastEvent;
+	};
+
+	struct Watch final {
+		vector<string> paths;
+		FileWatchCallback callback;
+	};
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static Signature fileSignature(const string& path) noexcept;
+	void addFile(const string& path) noexcept;
+	void removeFile(const string& path) noexcept;
+	void wakeThread() noexcept;
+	void readInotifyEvents() noexcept;
+	void pollFiles() noexcept;
+	void threadMain() noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const Clock::duration mCoalesceDelay, mPollInterval;
+	int mInotifyFd = -1;
+	int mWakePipe[2] = {-1, -1};
+
+	mutable std::mutex mMutex;
+	std::condition_variable mWakeCondition;
+	bool mShutdown = false;
+	uint64_t mNextId = 1;
+	std::unordered_map<uint64_t, Watch> mWatches;
+	std::unordered_map<string, WatchedFile> mFiles;
+	std::unordered_map<int, uint32_t> mDirRefCounts; // Number of files per inotify watch
+	size_t mNumPending = 0;
+	Clock::time_point mLastPoll;
+
+	std::thread mThread;
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
@@ -3,20 +3,33 @@
 #define SFZ_UTIL_FRAMETIMES_STATS_HPP
 
 #include <cstdint>
-#include <memory>
+
+#include "sfz/util/MemoryTracking.hpp"
 
 namespace sfz {
 
 using std::size_t;
-using std::unique_ptr;
+using std::uint32_t;
 
 /**
  * @brief Class used to calculate useful frametime statistics
  * All frametimes entered and received are in seconds, except for the string representation which
  * will be in milliseconds.
+ *
+ * Statistics are calculated over the last maxNumSamples samples, kept in a ring buffer. Adding a
+ * sample is O(1): the mean and standard deviation are updated incrementally (Welford's
+ * algorithm), min and max are kept in monotonic queues and percentiles are approximated with a
+ * fixed size histogram. The string representation is only created when requested.
  */
 class FrametimeStats final {
 public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Resolution of percentiles, samples above the histogram range go in the last bucket */
+	static const size_t NUM_HISTOGRAM_BUCKETS = 1000;
+	static const uint32_t HISTOGRAM_BUCKET_SIZE_US = 100;
+
 	// Constructors & destructors
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -27,29 +40,58 @@ public:
 
 	FrametimeStats() noexcept;
 	FrametimeStats(size_t maxNumSamples) noexcept;
-	
+
 	// Public methods
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 	void addSample(float sampleInSeconds) noexcept;
 	void reset() noexcept;
-	
+
+	/**
+	 * @brief Returns the approximate p-th percentile (0 < p <= 1) of the current samples
+	 * Accurate to HISTOGRAM_BUCKET_SIZE_US, samples above the histogram range are reported as max.
+	 */
+	float percentile(float p) const noexcept;
+
 	inline size_t maxNumSamples() const noexcept { return mMaxNumSamples; }
 	inline size_t currentNumSamples() const noexcept { return mCurrentNumSamples; }
 	inline float min() const noexcept { return mMin; }
 	inline float max() const noexcept { return mMax; }
 	inline float avg() const noexcept { return mAvg; }
 	inline float sd() const noexcept { return mSD; }
-	inline const char* to_string() const noexcept { return &mString[0]; }
+	inline float p50() const noexcept { return cachedPercentiles()[0]; }
+	inline float p90() const noexcept { return cachedPercentiles()[1]; }
+	inline float p99() const noexcept { return cachedPercentiles()[2]; }
+	inline float p999() const noexcept { return cachedPercentiles()[3]; }
+	const char* to_string() const noexcept;
 
 private:
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const float* cachedPercentiles() const noexcept;
+
 	// Private members
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
-	unique_ptr<float[]> mSamples;
-	size_t mMaxNumSamples, mCurrentNumSamples;
+	TaggedArray<float> mSamples; // Ring buffer, oldest sample at mFirstSample
+	size_t mMaxNumSamples, mCurrentNumSamples, mFirstSample;
+
+	// Monotonic queues (ring buffers) of indices of the samples which may become the min or max
+	// when older samples are removed
+	TaggedArray<size_t> mMinQueue, mMaxQueue;
+	size_t mMinQueueFirst, mMinQueueSize, mMaxQueueFirst, mMaxQueueSize;
+
+	double mMean, mM2; // Running mean and sum of squared differences from mean
 	float mMin, mMax, mAvg, mSD;
-	unique_ptr<char[]> mString;
+
+	// Histogram, and number of samples in each group of consecutive buckets
+	TaggedArray<uint32_t> mHistogram, mHistogramGroups;
+	mutable float mPercentiles[4];
+	mutable bool mPercentilesDirty;
+
+	TaggedArray<char> mString;
+	mutable bool mStringDirty;
 };
 
 } // namespace sfz
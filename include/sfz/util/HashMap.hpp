@@ -0,0 +1,173 @@
+#pragma once
+#ifndef SFZ_UTIL_HASH_MAP_HPP
+#define SFZ_UTIL_HASH_MAP_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <functional> // std::hash, std::equal_to
+#include <utility> // std::pair
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SFZ_HASH_MAP_SSE
+#include <emmintrin.h>
+#endif
+
+namespace sfz {
+
+using std::int8_t;
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+
+// HashMap
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Open addressing hash map storing its elements in a flat array
+ *
+ * Each slot has a control byte which is either empty, deleted or (if the slot is in use) 7 bits
+ * of the key's hash. Slots are probed in groups of 16, the control bytes of a group are compared
+ * against the hash bits with a single SSE2 instruction (or a scalar loop if SSE2 is not
+ * available), so keys are usually only compared for the slot actually holding the key. A lookup
+ * stops at the first group containing an empty slot.
+ *
+ * Erasing and clearing never frees memory, so a map which is cleared and refilled every frame
+ * does not allocate after the first frame. Pointers and iterators are invalidated when the map
+ * grows. Max load factor is 7/8.
+ */
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class HashMap final {
+public:
+	// Public types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	using value_type = std::pair<K, V>;
+
+	template<typename MapT, typename ValueT>
+	class IteratorBase final {
+	public:
+		inline IteratorBase(MapT* map, size_t index) noexcept : mMap(map), mIndex(index) { }
+
+		inline ValueT& operator* () const noexcept { return mMap->mSlots[mIndex]; }
+		inline ValueT* operator-> () const noexcept { return mMap->mSlots + mIndex; }
+		inline IteratorBase& operator++ () noexcept
+		{
+			mIndex = mMap->nextUsedSlot(mIndex + 1);
+			return *this;
+		}
+		inline IteratorBase operator++ (int) noexcept
+		{
+			IteratorBase copy = *this;
+			++(*this);
+			return copy;
+		}
+		inline bool operator== (const IteratorBase& o) const noexcept { return mIndex == o.mIndex; }
+		inline bool operator!= (const IteratorBase& o) const noexcept { return mIndex != o.mIndex; }
+
+	private:
+		MapT* mMap;
+		size_t mIndex;
+	};
+
+	using iterator = IteratorBase<HashMap, value_type>;
+	using const_iterator = IteratorBase<const HashMap, const value_type>;
+
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const size_t GROUP_SIZE = 16;
+	static const size_t MIN_CAPACITY = GROUP_SIZE;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline HashMap() noexcept { }
+	HashMap(const HashMap& other) noexcept;
+	HashMap& operator= (const HashMap& other) noexcept;
+	HashMap(HashMap&& other) noexcept;
+	HashMap& operator= (HashMap&& other) noexcept;
+	~HashMap() noexcept;
+
+	/** @brief Creates a map which can hold at least the specified number of elements. */
+	explicit HashMap(size_t numElements) noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Returns the value of the key, inserting a default constructed value if not found. */
+	V& operator[] (const K& key) noexcept;
+
+	/** @brief Inserts or replaces the value of the key, returns a reference to it. */
+	V& put(const K& key, const V& value) noexcept;
+	V& put(const K& key, V&& value) noexcept;
+
+	/** @brief Returns pointer to the value of the key, or nullptr if not found. */
+	V* get(const K& key) noexcept;
+	const V* get(const K& key) const noexcept;
+
+	iterator find(const K& key) noexcept;
+	const_iterator find(const K& key) const noexcept;
+
+	inline bool contains(const K& key) const noexcept { return this->findSlot(key) != NOT_FOUND; }
+
+	/** @brief Removes the key if it exists, returns the number of removed elements (0 or 1). */
+	size_t erase(const K& key) noexcept;
+
+	/** @brief Removes all elements without freeing any memory. */
+	void clear() noexcept;
+
+	/** @brief Makes sure the specified number of elements can be held without growing. */
+	void reserve(size_t numElements) noexcept;
+
+	inline iterator begin() noexcept { return iterator(this, this->nextUsedSlot(0)); }
+	inline iterator end() noexcept { return iterator(this, mCapacity); }
+	inline const_iterator begin() const noexcept
+	{
+		return const_iterator(this, this->nextUsedSlot(0));
+	}
+	inline const_iterator end() const noexcept { return const_iterator(this, mCapacity); }
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t size() const noexcept { return mSize; }
+	inline bool empty() const noexcept { return mSize == 0; }
+
+	/** @brief Number of slots, 0 until the first element is inserted. */
+	inline size_t capacity() const noexcept { return mCapacity; }
+
+private:
+	// Private constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const int8_t EMPTY = -128;
+	static const int8_t DELETED = -2;
+	static const size_t NOT_FOUND = ~size_t(0);
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	uint64_t hashKey(const K& key) const noexcept;
+	size_t findSlot(const K& key) const noexcept;
+	size_t findFreeSlot(uint64_t hash) const noexcept;
+	template<typename Arg>
+	V& insert(const K& key, Arg&& value, bool replace) noexcept;
+	void rehash(size_t newCapacity) noexcept;
+	size_t nextUsedSlot(size_t index) const noexcept;
+	void destroyAndFree() noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	value_type* mSlots = nullptr; // Only slots with a non-negative control byte are constructed
+	int8_t* mControl = nullptr; // Allocated together with mSlots
+	size_t mCapacity = 0, mSize = 0;
+	size_t mGrowthLeft = 0; // Number of empty slots that may be used before rehashing
+	Hash mHasher;
+	KeyEqual mKeyEqual;
+};
+
+} // namespace sfz
+
+#include "sfz/util/HashMap.inl"
+#endif
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include <cstring> // std::memset, std::memcpy
+#include <new> // placement new
+#include <utility> // std::move, std::forward
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Returns a 16-bit mask where bit i is set if control byte i of the group equals the value
+inline uint32_t hashMapMatch(const int8_t* group, int8_t value) noexcept
+{
+#ifdef SFZ_HASH_MAP_SSE
+	__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < 16; i++) {
+		if (group[i] == value) mask |= (1u << i);
+	}
+	return mask;
+#endif
+}
+
+// Returns a 16-bit mask where bit i is set if slot i of the group is empty or deleted
+inline uint32_t hashMapMatchFree(const int8_t* group) noexcept
+{
+#ifdef SFZ_HASH_MAP_SSE
+	return uint32_t(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < 16; i++) {
+		if (group[i] < 0) mask |= (1u << i);
+	}
+	return mask;
+#endif
+}
+
+inline uint32_t hashMapLowestBit(uint32_t mask) noexcept
+{
+#if defined(__GNUC__)
+	return uint32_t(__builtin_ctz(mask));
+#else
+	uint32_t index = 0;
+	while ((mask & 1u) == 0) {
+		mask >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+// Smallest power of two capacity able to hold the specified number of elements at max load
+inline size_t hashMapCapacity(size_t numElements, size_t minCapacity) noexcept
+{
+	size_t capacity = minCapacity;
+	while ((capacity - capacity / 8) < numElements) capacity *= 2;
+	return capacity;
+}
+
+// HashMap: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const size_t HashMap<K, V, Hash, KeyEqual>::GROUP_SIZE;
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const size_t HashMap<K, V, Hash, KeyEqual>::MIN_CAPACITY;
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const int8_t HashMap<K, V, Hash, KeyEqual>::EMPTY;
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const int8_t HashMap<K, V, Hash, KeyEqual>::DELETED;
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const size_t HashMap<K, V, Hash, KeyEqual>::NOT_FOUND;
+
+// HashMap: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>::HashMap(const HashMap& other) noexcept
+:
+	mHasher(other.mHasher),
+	mKeyEqual(other.mKeyEqual)
+{
+	if (other.mCapacity == 0) return;
+	this->rehash(other.mCapacity);
+	std::memcpy(mControl, other.mControl, mCapacity);
+	for (size_t i = 0; i < mCapacity; i++) {
+		if (mControl[i] >= 0) new (mSlots + i) value_type(other.mSlots[i]);
+	}
+	mSize = other.mSize;
+	mGrowthLeft = other.mGrowthLeft;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>& HashMap<K, V, Hash, KeyEqual>::operator= (
+	const HashMap& other) noexcept
+{
+	if (this == &other) return *this;
+	HashMap copy(other);
+	*this = std::move(copy);
+	return *this;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>::HashMap(HashMap&& other) noexcept
+:
+	mHasher(std::move(other.mHasher)),
+	mKeyEqual(std::move(other.mKeyEqual))
+{
+	*this = std::move(other);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>& HashMap<K, V, Hash, KeyEqual>::operator= (
+	HashMap&& other) noexcept
+{
+	if (this == &other) return *this;
+	this->destroyAndFree();
+	mSlots = other.mSlots;
+	mControl = other.mControl;
+	mCapacity = other.mCapacity;
+	mSize = other.mSize;
+	mGrowthLeft = other.mGrowthLeft;
+	mHasher = other.mHasher;
+	mKeyEqual = other.mKeyEqual;
+	other.mSlots = nullptr;
+	other.mControl = nullptr;
+	other.mCapacity = 0;
+	other.mSize = 0;
+	other.mGrowthLeft = 0;
+	return *this;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>::~HashMap() noexcept
+{
+	this->destroyAndFree();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>::HashMap(size_t numElements) noexcept
+{
+	this->reserve(numElements);
+}
+
+// HashMap: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V& HashMap<K, V, Hash, KeyEqual>::operator[] (const K& key) noexcept
+{
+	return this->insert(key, V(), false);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V& HashMap<K, V, Hash, KeyEqual>::put(const K& key, const V& value) noexcept
+{
+	return this->insert(key, value, true);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V& HashMap<K, V, Hash, KeyEqual>::put(const K& key, V&& value) noexcept
+{
+	return this->insert(key, std::move(value), true);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V* HashMap<K, V, Hash, KeyEqual>::get(const K& key) noexcept
+{
+	size_t index = this->findSlot(key);
+	if (index == NOT_FOUND) return nullptr;
+	return &mSlots[index].second;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const V* HashMap<K, V, Hash, KeyEqual>::get(const K& key) const noexcept
+{
+	size_t index = this->findSlot(key);
+	if (index == NOT_FOUND) return nullptr;
+	return &mSlots[index].second;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+typename HashMap<K, V, Hash, KeyEqual>::iterator HashMap<K, V, Hash, KeyEqual>::find(
+	const K& key) noexcept
+{
+	size_t index = this->findSlot(key);
+	return iterator(this, index == NOT_FOUND ? mCapacity : index);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+typename HashMap<K, V, Hash, KeyEqual>::const_iterator HashMap<K, V, Hash, KeyEqual>::find(
+	const K& key) const noexcept
+{
+	size_t index = this->findSlot(key);
+	return const_iterator(this, index == NOT_FOUND ? mCapacity : index);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t HashMap<K, V, Hash, KeyEqual>::erase(const K& key) noexcept
+{
+	size_t index = this->findSlot(key);
+	if (index == NOT_FOUND) return 0;
+	mSlots[index].~value_type();
+	mSize--;
+
+	// Lookups stop at the first group with an empty slot, so if this group already has one the
+	// slot can be made empty directly instead of leaving a tombstone
+	const int8_t* group = mControl + (index & ~(GROUP_SIZE - 1));
+	if (hashMapMatch(group, EMPTY) != 0) {
+		mControl[index] = EMPTY;
+		mGrowthLeft++;
+	} else {
+		mControl[index] = DELETED;
+	}
+	return 1;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::clear() noexcept
+{
+	if (mCapacity == 0) return;
+	for (size_t i = 0; i < mCapacity; i++) {
+		if (mControl[i] >= 0) mSlots[i].~value_type();
+	}
+	std::memset(mControl, EMPTY, mCapacity);
+	mSize = 0;
+	mGrowthLeft = mCapacity - mCapacity / 8;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::reserve(size_t numElements) noexcept
+{
+	size_t capacity = hashMapCapacity(numElements, MIN_CAPACITY);
+	if (capacity > mCapacity) this->rehash(capacity);
+}
+
+// HashMap: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+uint64_t HashMap<K, V, Hash, KeyEqual>::hashKey(const K& key) const noexcept
+{
+	// std::hash is the identity function for integers in most implementations, so the bits are
+	// mixed (MurmurHash3 finalizer) to make both the group index and the 7 control bits useful
+	uint64_t hash = uint64_t(mHasher(key));
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t HashMap<K, V, Hash, KeyEqual>::findSlot(const K& key) const noexcept
+{
+	if (mSize == 0) return NOT_FOUND;
+
+	const uint64_t hash = this->hashKey(key);
+	const int8_t hashBits = int8_t(hash & 0x7F);
+	const size_t groupMask = mCapacity / GROUP_SIZE - 1;
+	size_t group = size_t(hash >> 7) & groupMask;
+
+	// Triangular probing, visits every group since the number of groups is a power of two
+	for (size_t step = 1; true; step++) {
+		const int8_t* ctrl = mControl + group * GROUP_SIZE;
+		uint32_t matches = hashMapMatch(ctrl, hashBits);
+		while (matches != 0) {
+			size_t index = group * GROUP_SIZE + hashMapLowestBit(matches);
+			if (mKeyEqual(mSlots[index].first, key)) return index;
+			matches &= matches - 1;
+		}
+		if (hashMapMatch(ctrl, EMPTY) != 0) return NOT_FOUND;
+		group = (group + step) & groupMask;
+	}
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t HashMap<K, V, Hash, KeyEqual>::findFreeSlot(uint64_t hash) const noexcept
+{
+	const size_t groupMask = mCapacity / GROUP_SIZE - 1;
+	size_t group = size_t(hash >> 7) & groupMask;
+	for (size_t step = 1; true; step++) {
+		uint32_t free = hashMapMatchFree(mControl + group * GROUP_SIZE);
+		if (free != 0) return group * GROUP_SIZE + hashMapLowestBit(free);
+		group = (group + step) & groupMask;
+	}
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+template<typename Arg>
+V& HashMap<K, V, Hash, KeyEqual>::insert(const K& key, Arg&& value, bool replace) noexcept
+{
+	size_t index = this->findSlot(key);
+	if (index != NOT_FOUND) {
+		if (replace) mSlots[index].second = std::forward<Arg>(value);
+		return mSlots[index].second;
+	}
+
+	const uint64_t hash = this->hashKey(key);
+	if (mCapacity == 0) this->rehash(MIN_CAPACITY);
+	index = this->findFreeSlot(hash);
+
+	// Out of empty slots, grow unless most used slots are tombstones which can be reclaimed
+	if (mControl[index] == EMPTY && mGrowthLeft == 0) {
+		const size_t maxLoad = mCapacity - mCapacity / 8;
+		this->rehash(mSize < maxLoad / 2 ? mCapacity : mCapacity * 2);
+		index = this->findFreeSlot(hash);
+	}
+
+	if (mControl[index] == EMPTY) mGrowthLeft--;
+	mControl[index] = int8_t(hash & 0x7F);
+	new (mSlots + index) value_type(key, std::forward<Arg>(value));
+	mSize++;
+	return mSlots[index].second;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::rehash(size_t newCapacity) noexcept
+{
+	value_type* oldSlots = mSlots;
+	int8_t* oldControl = mControl;
+	const size_t oldCapacity = mCapacity;
+
+	// Slots and control bytes in one allocation, control bytes last to keep slots aligned
+	mSlots = static_cast<value_type*>(
+	    ::operator new(newCapacity * sizeof(value_type) + newCapacity));
+	mControl = reinterpret_cast<int8_t*>(mSlots + newCapacity);
+	mCapacity = newCapacity;
+	std::memset(mControl, EMPTY, newCapacity);
+
+	for (size_t i = 0; i < oldCapacity; i++) {
+		if (oldControl[i] < 0) continue;
+		const uint64_t hash = this->hashKey(oldSlots[i].first);
+		const size_t index = this->findFreeSlot(hash);
+		mControl[index] = int8_t(hash & 0x7F);
+		new (mSlots + index) value_type(std::move(oldSlots[i]));
+		oldSlots[i].~value_type();
+	}
+	mGrowthLeft = (newCapacity - newCapacity / 8) - mSize;
+	::operator delete(oldSlots);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t HashMap<K, V, Hash, KeyEqual>::nextUsedSlot(size_t index) const noexcept
+{
+	while (index < mCapacity && mControl[index] < 0) index++;
+	return index;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::destroyAndFree() noexcept
+{
+	for (size_t i = 0; i < mCapacity; i++) {
+		if (mControl[i] >= 0) mSlots[i].~value_type();
+	}
+	::operator delete(mSlots);
+	mSlots = nullptr;
+	mControl = nullptr;
+	mCapacity = 0;
+	mSize = 0;
+	mGrowthLeft = 0;
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+#ifndef SFZ_UTIL_HITCH_DETECTOR_HPP
+#define SFZ_UTIL_HITCH_DETECTOR_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sfz/util/FrametimeStats.hpp"
+
+namespace sfz {
+
+using std::size_t;
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+// Frame timings
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/** @brief The phases of a frame timed by runGameLoop(). */
+enum class FramePhase : uint32_t {
+	EVENTS = 0, // Processing events and reloading changed files
+	UPDATE = 1, // Updating input and the current screen
+	RENDER = 2,
+	SWAP = 3
+};
+
+const size_t NUM_FRAME_PHASES = 4;
+
+/** @brief Timings of a single frame, all times are in seconds. */
+struct FrameTimings final {
+	uint64_t frameIndex = 0;
+	double timestamp = 0.0; // Time since the HitchDetector was created
+	float frameTime = 0.0f;
+	float phaseTimes[NUM_FRAME_PHASES] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+	inline float& phaseTime(FramePhase phase) noexcept { return phaseTimes[uint32_t(phase)]; }
+	inline float phaseTime(FramePhase phase) const noexcept { return phaseTimes[uint32_t(phase)]; }
+};
+
+/** @brief A frame which took longer than the threshold, with the frames surrounding it. */
+struct Hitch final {
+	FrameTimings frame;
+	float threshold = 0.0f; // Threshold frame time exceeded, in seconds
+	vector<FrameTimings> framesBefore, framesAfter;
+};
+
+/** @brief Format of telemetry files, JSON files contain one JSON object per line. */
+enum class TelemetryFormat {
+	CSV,
+	JSON
+};
+
+// HitchDetector
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Detects frames taking too long (hitches) and optionally writes frame time telemetry
+ *
+ * A frame is a hitch if its frame time exceeds the budget, or (once the statistics window is
+ * full) the specified percentile of the recent frame times. Either criteria can be disabled by
+ * setting it to 0. For each hitch the timings of the frames surrounding it are captured, making
+ * it possible to see which phase of the frame stalled.
+ *
+ * If telemetry is started, hitches and a summary of the frame times (once per flush interval)
+ * are appended to a CSV or JSON file. The file is written by a background thread, the frame
+ * thread only queues the records.
+ */
+class HitchDetector final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const size_t MAX_NUM_STORED_HITCHES = 64;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	HitchDetector(const HitchDetector&) = delete;
+	HitchDetector& operator= (const HitchDetector&) = delete;
+	HitchDetector(HitchDetector&&) = delete;
+	HitchDetector& operator= (HitchDetector&&) = delete;
+
+	/**
+	 * @param budget frame time (in seconds) above which a frame is a hitch, 0 to disable
+	 * @param percentile frames above this percentile (e.g. 0.999) of the recent frame times are
+	 *        hitches, 0 to disable
+	 * @param numStatsSamples number of recent frames used for the statistics
+	 * @param numContextFrames number of frames captured before and after each hitch
+	 */
+	HitchDetector(float budget = 1.0f / 30.0f, float percentile = 0.0f,
+	              size_t numStatsSamples = 600, size_t numContextFrames = 4) noexcept;
+	~HitchDetector() noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/**
+	 * @brief Adds the timings of a finished frame, returns whether it was a hitch
+	 * The frame index and timestamp of the timings are set by the detector.
+	 */
+	bool addFrame(const FrameTimings& timings) noexcept;
+
+	/**
+	 * @brief Starts appending telemetry to the specified file from a background thread
+	 * Stops any previous telemetry. A CSV header is written if the file is empty. The flush
+	 * interval is clamped to at least 1 ms.
+	 */
+	bool startTelemetry(const char* path, TelemetryFormat format,
+	                    uint32_t flushIntervalMs = 5000) noexcept;
+
+	/** @brief Writes all queued telemetry (including incomplete hitches) and stops the thread. */
+	void stopTelemetry() noexcept;
+
+	/**
+	 * @brief Returns the path of the telemetry file for a game, in gameBaseFolderPath()
+	 * Creates the game folder if it does not exist.
+	 */
+	static string telemetryPath(const char* gameFolderName, TelemetryFormat format) noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Current frame time threshold in seconds, frames above it are hitches. */
+	float threshold() const noexcept;
+
+	/** @brief The last (at most MAX_NUM_STORED_HITCHES) hitches with all their context frames. */
+	inline const vector<Hitch>& hitches() const noexcept { return mHitches; }
+
+	inline const FrametimeStats& stats() const noexcept { return mStats; }
+	inline uint64_t numFrames() const noexcept { return mNumFrames; }
+	inline uint64_t numHitches() const noexcept { return mNumHitches; }
+	inline bool isTelemetryActive() const noexcept { return mTelemetryThread.joinable(); }
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Summary final {
+		double timestamp = 0.0;
+		uint64_t numFrames = 0, numHitches = 0;
+		float avg = 0.0f, p50 = 0.0f, p99 = 0.0f, max = 0.0f;
+		float phaseAvgs[NUM_FRAME_PHASES] = {0.0f, 0.0f, 0.0f, 0.0f};
+	};
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void completeHitch(Hitch& hitch) noexcept;
+	void queueSummary(double timestamp) noexcept;
+	void telemetryThreadMain() noexcept;
+	void writeTelemetry(std::FILE* file, const vector<Hitch>& hitches,
+	                    const vector<Summary>& summaries) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const float mBudget, mPercentile;
+	const size_t mNumContextFrames;
+	const Clock::time_point mStartTime;
+
+	FrametimeStats mStats;
+	uint64_t mNumFrames = 0, mNumHitches = 0;
+	vector<FrameTimings> mRecentFrames; // Ring buffer with the last mNumContextFrames frames
+	vector<Hitch> mIncompleteHitches; // Hitches still waiting for frames after them
+	vector<Hitch> mHitches;
+
+	// Accumulated since last summary
+	double mLastSummaryTime = 0.0;
+	uint64_t mSummaryNumFrames = 0, mSummaryNumHitches = 0;
+	double mSummaryPhaseSums[NUM_FRAME_PHASES] = {0.0, 0.0, 0.0, 0.0};
+
+	// Telemetry, queues are protected by the mutex
+	TelemetryFormat mTelemetryFormat = TelemetryFormat::CSV;
+	double mFlushInterval = 0.0;
+	string mTelemetryPath;
+	std::mutex mTelemetryMutex;
+	std::condition_variable mTelemetryCondition;
+	bool mStopTelemetry = false;
+	vector<Hitch> mQueuedHitches;
+	vector<Summary> mQueuedSummaries;
+	std::thread mTelemetryThread;
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
@@ -12,6 +12,8 @@ using std::int32_t;
 using std::int64_t;
 using std::string;
 using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
 using std::vector;
 
 /** @brief Returns path to the directory the application was run from, likely executable location. */
@@ -23,7 +25,7 @@ const string& myDocumentsPath() noexcept;
 /** @brief Returns path to where game folders with saves should be placed. */
 const string& gameBaseFolderPath() noexcept;
 
-/** @brief Returns whether a given file exists or not. */
+/** @brief Returns whether a given file (not directory) exists or not. */
 bool fileExists(const char* path) noexcept;
 
 /** @brief Returns whether a given directory exists or not. */
@@ -41,8 +43,35 @@ bool deleteFile(const char* path) noexcept;
 /** @brief Attempts to delete a given directory, will ONLY work if directory is empty. */
 bool deleteDirectory(const char* path) noexcept;
 
-/** @brief Attempts to copy file from source to destination. */ 
+/** @brief Information about a copy or delete operation, possibly of many files. */
+struct FileOpResult final {
+	uint64_t numBytes = 0; // Number of bytes copied
+	uint32_t numFiles = 0; // Number of files copied or deleted
+	int errorCode = 0; // errno (GetLastError() on Windows) of the first error, 0 if none
+	string errorPath; // Path that caused the first error
+};
+
+/**
+ * @brief Attempts to copy file from source to destination.
+ * The copy is performed by the OS without passing through user space where possible, and
+ * shares data blocks with the source on filesystems supporting it (reflink/block cloning).
+ * Destination is overwritten, and removed again if the copy fails.
+ */
 bool copyFile(const char* srcPath, const char* dstPath) noexcept;
+bool copyFile(const char* srcPath, const char* dstPath, FileOpResult& result) noexcept;
+
+/**
+ * @brief Recursively copies the contents of a directory, destination is created if needed.
+ * Symbolic links are recreated as links to the same target instead of being followed (on
+ * Windows links to directories are skipped). Stops at the first error, files already copied are
+ * kept.
+ */
+bool copyDirectory(const char* srcPath, const char* dstPath) noexcept;
+bool copyDirectory(const char* srcPath, const char* dstPath, FileOpResult& result) noexcept;
+
+/** @brief Deletes a directory and all its contents, symbolic links are not followed. */
+bool deleteDirectoryRecursive(const char* path) noexcept;
+bool deleteDirectoryRecursive(const char* path, FileOpResult& result) noexcept;
 
 /** @brief Returns size of file in bytes, negative value if error. */
 int64_t sizeofFile(const char* path) noexcept;
@@ -2,21 +2,41 @@
 #ifndef SFZ_UTIL_INI_PARSER_HPP
 #define SFZ_UTIL_INI_PARSER_HPP
 
+#include <cstddef> // std::size_t
 #include <cstdint>
 #include <limits>
-#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace sfz {
 
 using std::int32_t;
 using std::numeric_limits;
+using std::size_t;
 using std::string;
-using std::map;
+using std::uint8_t;
+using std::uint32_t;
+using std::vector;
 
 // IniParser class
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
+/**
+ * @brief Parser for simple ini files with sections and key/value items
+ *
+ * The file is memory mapped and parsed in place, all strings are then stored (null-terminated)
+ * in a single arena and referred to by offset. Items are indexed by an open addressing hash
+ * table on (section, key), and bool, int and float values are parsed once when the item is
+ * loaded or set. Lookups are thus O(1) and, except for getString() which returns a copy, do not
+ * allocate memory.
+ *
+ * Items and sections changed since the last load or save are tracked, save() does nothing if
+ * nothing changed. When saving, comments and the order of lines in the file are preserved and
+ * only changed items are rewritten. New items are added after the last item of their section,
+ * new sections at the end of the file. The file is written to a temporary file which then
+ * replaces the old one, so a crash while saving never leaves a partially written file.
+ */
 class IniParser final {
 public:
 
@@ -34,8 +54,25 @@ public:
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 	bool load() noexcept;
+
+	/** @brief Saves if anything changed since the last load or save, returns whether successful. */
 	bool save() noexcept;
 
+	/**
+	 * @brief Saves on a background thread once no further saves have been requested for delayMs
+	 * Only writing to disk is deferred, changes made after this call are not included until the
+	 * next save. Intended to be called whenever something changes (e.g. every frame a slider in a
+	 * settings menu is dragged) without causing a hitch. A pending save is written when the last
+	 * copy of this parser is destroyed or load() or save() is called.
+	 */
+	void saveAsync(uint32_t delayMs = 500) noexcept;
+
+	/** @brief Blocks until any pending background save is written, returns whether successful. */
+	bool flushAsyncSave() noexcept;
+
+	/** @brief Whether anything changed since the last load or save. */
+	inline bool isDirty() const noexcept { return mDirty; }
+
 	// Info about a specific item
 	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -87,8 +124,89 @@ public:
 	                    float maxValue = numeric_limits<float>::max()) noexcept;
 
 private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	// A string stored in the arena
+	struct StrRef final {
+		uint32_t offset = 0;
+		uint32_t length = 0;
+	};
+
+	struct Section final {
+		StrRef name;
+		uint32_t hash = 0;
+		bool dirty = false; // Has new or changed items
+	};
+
+	struct Item final {
+		uint32_t section = 0; // Index into mSections
+		uint32_t hash = 0;
+		StrRef key, value;
+		bool dirty = false; // Value changed since last load or save
+		bool inFile = false; // Has a line in mFileText
+
+		// Typed values, parsed when the value is set
+		uint8_t typeFlags = 0;
+		bool boolValue = false;
+		int32_t intValue = 0;
+		float floatValue = 0.0f;
+	};
+
+	enum class LineType : uint8_t {
+		OTHER, // Comments and empty lines
+		SECTION,
+		ITEM
+	};
+
+	// A line in mFileText, used to preserve comments and ordering when saving
+	struct Line final {
+		uint32_t offset = 0;
+		uint32_t length = 0; // Not including newline
+		uint32_t index = 0; // Index of section or item
+		LineType type = LineType::OTHER;
+	};
+
+	// Writes pending saves on a background thread, shared between copies of a parser
+	struct AsyncSaver;
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void clear() noexcept;
+	StrRef addString(const char* str, size_t length) noexcept;
+	bool equals(StrRef ref, const char* str, size_t length) const noexcept;
+	inline const char* str(StrRef ref) const noexcept { return mArena.data() + ref.offset; }
+
+	const Item* findItem(const string& section, const string& key) const noexcept;
+	uint32_t findSection(const char* name, size_t length, uint32_t hash) const noexcept;
+	uint32_t findItemIndex(uint32_t section, const char* key, size_t keyLength,
+	                       uint32_t hash) const noexcept;
+	uint32_t findOrAddSection(const char* name, size_t length) noexcept;
+	uint32_t set(uint32_t section, const char* key, size_t keyLength, const char* value,
+	             size_t valueLength) noexcept;
+	void parseValue(Item& item) noexcept;
+	void compactArena() noexcept;
+	void updateFileText() noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
 	string mPath;
-	map<string,map<string,string>> mIniTree;
+	vector<char> mArena;
+	size_t mArenaGarbage = 0; // Bytes in arena no longer referenced (overwritten values)
+	vector<Section> mSections;
+	vector<Item> mItems;
+
+	// Open addressing (linear probing) hash tables, entries are index + 1, 0 means empty
+	vector<uint32_t> mSectionTable, mItemTable;
+
+	// Contents of the file as of the last load or save
+	string mFileText;
+	vector<Line> mLines;
+	bool mDirty = false;
+	bool mWriteFailed = false; // Last write failed, next save must write even if not dirty
+	std::shared_ptr<AsyncSaver> mAsyncSaver;
 };
 
 } // namespace sfz
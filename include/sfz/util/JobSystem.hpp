@@ -0,0 +1,222 @@
+#pragma once
+#ifndef SFZ_UTIL_JOB_SYSTEM_HPP
+#define SFZ_UTIL_JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sfz {
+
+using std::int32_t;
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+using JobFunction = std::function<void()>;
+
+class JobCounter;
+
+// JobSystem
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Work-stealing job system running small jobs on a pool of worker threads
+ *
+ * Each thread of the system (the workers and the thread that created it) has its own Chase-Lev
+ * deque. Jobs are pushed to and popped from the bottom of the deque of the thread submitting
+ * them, idle threads steal from the top of the other deques. Jobs submitted from threads outside
+ * the system are placed in a shared queue instead.
+ *
+ * Completion is tracked with JobCounters, which can also be used as dependencies for other jobs.
+ * Waiting for a counter does not block, the waiting thread runs other jobs until it is done. This
+ * means jobs may themselves submit jobs and wait for them.
+ *
+ * Jobs must not throw exceptions, and all jobs must have finished before the system is destroyed.
+ */
+class JobSystem final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Capacity of the deque of each thread, jobs are placed in the shared queue when full. */
+	static const uint32_t DEQUE_CAPACITY = 4096;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator= (const JobSystem&) = delete;
+	JobSystem(JobSystem&&) = delete;
+	JobSystem& operator= (JobSystem&&) = delete;
+
+	/**
+	 * @param numWorkers number of worker threads, 0 means hardware concurrency - 1 (at least 1)
+	 * @param pinThreads whether to pin worker i to core i (modulo number of cores), the creating
+	 *        thread is not pinned but can be pinned to core 0 with pinCurrentThread()
+	 */
+	JobSystem(uint32_t numWorkers = 0, bool pinThreads = false) noexcept;
+	~JobSystem() noexcept;
+
+	// Jobs
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Submits a job, the counter (if any) is incremented until the job has finished. */
+	void run(JobFunction function, JobCounter* counter = nullptr) noexcept;
+
+	/** @brief Submits a job which is not started until the dependency counter is done. */
+	void runAfter(JobCounter& dependency, JobFunction function,
+	              JobCounter* counter = nullptr) noexcept;
+
+	/** @brief Runs other jobs on the calling thread until the counter is done. */
+	void wait(JobCounter& counter) noexcept;
+
+	/** @brief Runs a single queued job on the calling thread, returns false if none was found. */
+	bool runQueuedJob() noexcept;
+
+	/**
+	 * @brief Calls func(rangeBegin, rangeEnd) in parallel for subranges of [begin, end)
+	 * Returns once all subranges are done, the calling thread runs the first subrange and then
+	 * helps with the others.
+	 * @param grainSize number of elements per subrange, 0 means autoGrainSize()
+	 */
+	template<typename Func>
+	void parallelFor(size_t begin, size_t end, size_t grainSize, const Func& func) noexcept;
+
+	/**
+	 * @brief Calculates map(rangeBegin, rangeEnd) in parallel for subranges of [begin, end) and
+	 *        combines the results with reduce(T, T)
+	 * The results are combined in subrange order starting from identity, so the result is
+	 * deterministic (for a given grain size) even if reduce is not associative (e.g. float sums).
+	 * @param grainSize number of elements per subrange, 0 means autoGrainSize()
+	 */
+	template<typename T, typename MapFunc, typename ReduceFunc>
+	T parallelReduce(size_t begin, size_t end, size_t grainSize, const T& identity,
+	                 const MapFunc& map, const ReduceFunc& reduce) noexcept;
+
+	/** @brief Pins the calling thread to a core, returns false if failed or not supported. */
+	static bool pinCurrentThread(uint32_t core) noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline uint32_t numWorkers() const noexcept { return uint32_t(mWorkers.size()); }
+
+	/** @brief Number of threads running jobs, the workers plus the thread that created the system. */
+	inline uint32_t numThreads() const noexcept { return numWorkers() + 1; }
+
+	/** @brief Grain size giving about 4 subranges per thread. */
+	inline size_t autoGrainSize(size_t numElements) const noexcept
+	{
+		size_t grainSize = numElements / (size_t(numThreads()) * 4);
+		return grainSize != 0 ? grainSize : 1;
+	}
+
+	/** @brief Total number of jobs stolen from the deque of another thread. */
+	inline uint64_t numStolenJobs() const noexcept
+	{
+		return mNumStolenJobs.load(std::memory_order_relaxed);
+	}
+
+private:
+	friend class JobCounter;
+
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	using RangeFunction = void (*)(const void* context, size_t begin, size_t end);
+
+	struct Job final {
+		JobFunction function;
+		RangeFunction rangeFunction = nullptr; // Used instead of function if set
+		const void* context = nullptr;
+		size_t begin = 0, end = 0;
+		JobCounter* counter = nullptr;
+	};
+
+	struct ThreadData; // The deque of a thread, defined in JobSystem.cpp
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void runRange(RangeFunction function, const void* context, size_t begin, size_t end,
+	              JobCounter& counter) noexcept;
+	void submit(Job* job) noexcept;
+	Job* findJob(uint32_t threadIndex) noexcept;
+	void execute(Job* job) noexcept;
+	void finish(JobCounter& counter) noexcept;
+	bool hasQueuedJobs() const noexcept;
+	uint32_t currentThreadIndex() const noexcept;
+	void workerMain(uint32_t threadIndex, bool pinThread) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	vector<std::unique_ptr<ThreadData>> mThreads; // Index 0 is the thread creating the system
+	vector<std::thread> mWorkers;
+
+	// Jobs submitted from threads outside the system, or when a deque is full
+	mutable std::mutex mSharedMutex;
+	std::deque<Job*> mSharedQueue;
+	std::atomic<uint32_t> mNumShared{0};
+
+	std::mutex mSleepMutex;
+	std::condition_variable mSleepCondition;
+	std::atomic<uint32_t> mNumSleeping{0};
+	std::atomic<bool> mStop{false};
+
+	std::atomic<uint64_t> mNumStolenJobs{0};
+};
+
+// JobCounter
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Counts the unfinished jobs associated with it
+ * A counter may be destroyed once it is done (i.e. once JobSystem::wait() has returned or
+ * isDone() has returned true), as long as no more jobs are associated with it.
+ */
+class JobCounter final {
+public:
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator= (const JobCounter&) = delete;
+	JobCounter(JobCounter&&) = delete;
+	JobCounter& operator= (JobCounter&&) = delete;
+
+	JobCounter() noexcept = default;
+	~JobCounter() noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Returns whether all associated jobs have finished. */
+	bool isDone() const noexcept;
+
+	inline int32_t numUnfinished() const noexcept { return mCount.load(std::memory_order_acquire); }
+
+private:
+	friend class JobSystem;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	std::atomic<int32_t> mCount{0};
+	mutable std::mutex mMutex; // Protects mWaitingJobs and the transition of mCount to zero
+	vector<JobSystem::Job*> mWaitingJobs; // Jobs depending on this counter
+};
+
+} // namespace sfz
+
+#include "sfz/util/JobSystem.inl"
+#endif
\ No newline at end of file
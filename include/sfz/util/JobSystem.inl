@@ -0,0 +1,57 @@
+#include <algorithm> // std::min
+
+namespace sfz {
+
+// JobSystem: Jobs
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename Func>
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grainSize, const Func& func) noexcept
+{
+	if (end <= begin) return;
+	if (grainSize == 0) grainSize = this->autoGrainSize(end - begin);
+	if (end - begin <= grainSize) {
+		func(begin, end);
+		return;
+	}
+
+	RangeFunction rangeFunction = [](const void* context, size_t rangeBegin, size_t rangeEnd) {
+		(*static_cast<const Func*>(context))(rangeBegin, rangeEnd);
+	};
+
+	JobCounter counter;
+	size_t rangeBegin = begin + grainSize;
+	while (rangeBegin < end) {
+		size_t rangeEnd = rangeBegin + std::min(grainSize, end - rangeBegin);
+		this->runRange(rangeFunction, &func, rangeBegin, rangeEnd, counter);
+		rangeBegin = rangeEnd;
+	}
+	func(begin, begin + grainSize);
+	this->wait(counter);
+}
+
+template<typename T, typename MapFunc, typename ReduceFunc>
+T JobSystem::parallelReduce(size_t begin, size_t end, size_t grainSize, const T& identity,
+                            const MapFunc& map, const ReduceFunc& reduce) noexcept
+{
+	if (end <= begin) return identity;
+	if (grainSize == 0) grainSize = this->autoGrainSize(end - begin);
+
+	const size_t numRanges = (end - begin) / grainSize + ((end - begin) % grainSize != 0 ? 1 : 0);
+	// Wrapped so each range has its own element, vector<bool> would pack the results into shared
+	// words written concurrently by different threads
+	struct RangeResult final { T value; };
+	vector<RangeResult> results(numRanges, RangeResult{identity});
+	this->parallelFor(0, numRanges, 1, [&](size_t firstRange, size_t lastRange) {
+		for (size_t i = firstRange; i < lastRange; i++) {
+			size_t rangeBegin = begin + i * grainSize;
+			results[i].value = map(rangeBegin, rangeBegin + std::min(grainSize, end - rangeBegin));
+		}
+	});
+
+	T result = identity;
+	for (const RangeResult& rangeResult : results) result = reduce(result, rangeResult.value);
+	return result;
+}
+
+} // namespace sfz
\ No newline at end of file
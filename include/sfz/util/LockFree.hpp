@@ -0,0 +1,230 @@
+#pragma once
+#ifndef SFZ_UTIL_LOCK_FREE_HPP
+#define SFZ_UTIL_LOCK_FREE_HPP
+
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <type_traits>
+
+namespace sfz {
+
+using std::size_t;
+using std::uint8_t;
+
+/** @brief Assumed size of a cache line, used to pad data written by different threads. */
+const size_t CACHE_LINE_SIZE = 64;
+
+// SPSCQueue
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Bounded lock-free queue for a single producer thread and a single consumer thread
+ * The producer and consumer indices are kept on separate cache lines. Each side caches the last
+ * seen index of the other side, so the shared indices are only read when the queue appears full
+ * (producer) or empty (consumer).
+ */
+template<typename T>
+class SPSCQueue final {
+public:
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	SPSCQueue(const SPSCQueue&) = delete;
+	SPSCQueue& operator= (const SPSCQueue&) = delete;
+	SPSCQueue(SPSCQueue&&) = delete;
+	SPSCQueue& operator= (SPSCQueue&&) = delete;
+
+	/** @param capacity max number of elements in the queue, rounded up to a power of 2 */
+	explicit SPSCQueue(size_t capacity) noexcept;
+	~SPSCQueue() noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Producer only, returns false (without consuming value) if the queue is full. */
+	bool tryPush(const T& value) noexcept;
+	bool tryPush(T&& value) noexcept;
+
+	/** @brief Consumer only, returns false if the queue is empty. */
+	bool tryPop(T& out) noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t capacity() const noexcept { return mMask + 1; }
+
+	/** @brief Number of elements in the queue, only approximate if called while in use. */
+	size_t sizeApprox() const noexcept;
+
+private:
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	template<typename Arg>
+	bool push(Arg&& value) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const size_t mMask;
+	T* const mSlots; // Uninitialized memory, only slots between head and tail are constructed
+	char mPadding0[CACHE_LINE_SIZE];
+
+	// Consumer
+	std::atomic<size_t> mHead{0};
+	size_t mCachedTail = 0;
+	char mPadding1[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+	// Producer
+	std::atomic<size_t> mTail{0};
+	size_t mCachedHead = 0;
+	char mPadding2[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+};
+
+// MPMCQueue
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Bounded lock-free queue for any number of producer and consumer threads
+ * Based on the bounded MPMC queue by Dmitry Vyukov, each slot has a sequence number telling
+ * whether it is ready to be written or read for a given position. Pushing and popping costs a
+ * single CAS on the shared index when uncontended.
+ */
+template<typename T>
+class MPMCQueue final {
+public:
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	MPMCQueue(const MPMCQueue&) = delete;
+	MPMCQueue& operator= (const MPMCQueue&) = delete;
+	MPMCQueue(MPMCQueue&&) = delete;
+	MPMCQueue& operator= (MPMCQueue&&) = delete;
+
+	/** @param capacity max number of elements in the queue, rounded up to a power of 2 (min 2) */
+	explicit MPMCQueue(size_t capacity) noexcept;
+	~MPMCQueue() noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Returns false (without consuming value) if the queue is full. */
+	bool tryPush(const T& value) noexcept;
+	bool tryPush(T&& value) noexcept;
+
+	/** @brief Returns false if the queue is empty. */
+	bool tryPop(T& out) noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t capacity() const noexcept { return mMask + 1; }
+
+	/** @brief Number of elements in the queue, only approximate if called while in use. */
+	size_t sizeApprox() const noexcept;
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	struct Slot final {
+		std::atomic<size_t> sequence;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+		inline T* value() noexcept { return reinterpret_cast<T*>(&storage); }
+	};
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	template<typename Arg>
+	bool push(Arg&& value) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const size_t mMask;
+	Slot* const mSlots;
+	char mPadding0[CACHE_LINE_SIZE];
+	std::atomic<size_t> mEnqueuePos{0};
+	char mPadding1[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> mDequeuePos{0};
+	char mPadding2[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+};
+
+// TripleBuffer
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Lock-free publishing of the latest value from one writer thread to one reader thread
+ *
+ * Neither side ever waits: the writer fills its own buffer and publishes it by swapping it with
+ * the middle buffer, the reader picks up the middle buffer if a new value was published since its
+ * last update. Intermediate values may be skipped, which makes it suitable for state where only
+ * the latest value matters (e.g. input state sampled on one thread and used on another).
+ */
+template<typename T>
+class TripleBuffer final {
+public:
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator= (const TripleBuffer&) = delete;
+	TripleBuffer(TripleBuffer&&) = delete;
+	TripleBuffer& operator= (TripleBuffer&&) = delete;
+
+	explicit TripleBuffer(const T& initial = T()) noexcept;
+
+	// Writer
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief The buffer owned by the writer, contains an arbitrary older value after publish(). */
+	inline T& writeBuffer() noexcept { return mBuffers[mWriteIndex].value; }
+
+	/** @brief Publishes the write buffer, making it available to the reader. */
+	void publish() noexcept;
+
+	/** @brief Copies value into the write buffer and publishes it. */
+	void write(const T& value) noexcept;
+
+	// Reader
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Makes the latest published value the read buffer, returns false if none was new. */
+	bool update() noexcept;
+
+	/** @brief The buffer owned by the reader, only changed by update(). */
+	inline const T& readBuffer() const noexcept { return mBuffers[mReadIndex].value; }
+
+	/** @brief Calls update() and returns the read buffer. */
+	const T& read() noexcept;
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	struct Buffer final {
+		T value;
+		char padding[CACHE_LINE_SIZE]; // Separates the buffers so they never share a cache line
+	};
+
+	static const uint8_t INDEX_MASK = 0x03;
+	static const uint8_t NEW_VALUE_BIT = 0x04;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	Buffer mBuffers[3];
+	std::atomic<uint8_t> mMiddle{1}; // Index of the middle buffer and NEW_VALUE_BIT
+	char mPadding0[CACHE_LINE_SIZE];
+	uint8_t mWriteIndex = 0;
+	char mPadding1[CACHE_LINE_SIZE];
+	uint8_t mReadIndex = 2;
+};
+
+} // namespace sfz
+
+#include "sfz/util/LockFree.inl"
+#endif
\ No newline at end of file
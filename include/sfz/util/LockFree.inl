@@ -0,0 +1,257 @@
+#include <new> // placement new
+#include <utility> // std::forward, std::move
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+inline size_t lockFreeCapacity(size_t capacity, size_t minCapacity) noexcept
+{
+	size_t result = minCapacity;
+	while (result < capacity) result *= 2;
+	return result;
+}
+
+// SPSCQueue: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+SPSCQueue<T>::SPSCQueue(size_t capacity) noexcept
+:
+	mMask(lockFreeCapacity(capacity, 1) - 1),
+	mSlots(static_cast<T*>(::operator new(sizeof(T) * (mMask + 1))))
+{ }
+
+template<typename T>
+SPSCQueue<T>::~SPSCQueue() noexcept
+{
+	const size_t tail = mTail.load(std::memory_order_acquire);
+	for (size_t i = mHead.load(std::memory_order_relaxed); i != tail; i++) {
+		mSlots[i & mMask].~T();
+	}
+	::operator delete(mSlots);
+}
+
+// SPSCQueue: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+bool SPSCQueue<T>::tryPush(const T& value) noexcept
+{
+	return this->push(value);
+}
+
+template<typename T>
+bool SPSCQueue<T>::tryPush(T&& value) noexcept
+{
+	return this->push(std::move(value));
+}
+
+template<typename T>
+bool SPSCQueue<T>::tryPop(T& out) noexcept
+{
+	const size_t head = mHead.load(std::memory_order_relaxed);
+	if (head == mCachedTail) {
+		mCachedTail = mTail.load(std::memory_order_acquire);
+		if (head == mCachedTail) return false;
+	}
+
+	T& slot = mSlots[head & mMask];
+	out = std::move(slot);
+	slot.~T();
+	mHead.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+// SPSCQueue: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+size_t SPSCQueue<T>::sizeApprox() const noexcept
+{
+	const size_t head = mHead.load(std::memory_order_acquire);
+	const size_t tail = mTail.load(std::memory_order_acquire);
+	return tail - head <= mMask + 1 ? tail - head : 0;
+}
+
+// SPSCQueue: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+template<typename Arg>
+bool SPSCQueue<T>::push(Arg&& value) noexcept
+{
+	const size_t tail = mTail.load(std::memory_order_relaxed);
+	if (tail - mCachedHead > mMask) {
+		mCachedHead = mHead.load(std::memory_order_acquire);
+		if (tail - mCachedHead > mMask) return false;
+	}
+
+	new (&mSlots[tail & mMask]) T(std::forward<Arg>(value));
+	mTail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+// MPMCQueue: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+MPMCQueue<T>::MPMCQueue(size_t capacity) noexcept
+:
+	mMask(lockFreeCapacity(capacity, 2) - 1),
+	mSlots(new Slot[mMask + 1])
+{
+	for (size_t i = 0; i <= mMask; i++) {
+		mSlots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template<typename T>
+MPMCQueue<T>::~MPMCQueue() noexcept
+{
+	const size_t end = mEnqueuePos.load(std::memory_order_acquire);
+	for (size_t i = mDequeuePos.load(std::memory_order_relaxed); i != end; i++) {
+		mSlots[i & mMask].value()->~T();
+	}
+	delete[] mSlots;
+}
+
+// MPMCQueue: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+bool MPMCQueue<T>::tryPush(const T& value) noexcept
+{
+	return this->push(value);
+}
+
+template<typename T>
+bool MPMCQueue<T>::tryPush(T&& value) noexcept
+{
+	return this->push(std::move(value));
+}
+
+template<typename T>
+bool MPMCQueue<T>::tryPop(T& out) noexcept
+{
+	size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &mSlots[pos & mMask];
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos + 1);
+		if (diff == 0) {
+			// Slot written for this position, try to claim it
+			if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}
+		else if (diff < 0) {
+			return false; // Empty
+		}
+		else {
+			pos = mDequeuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	T* value = slot->value();
+	out = std::move(*value);
+	value->~T();
+	slot->sequence.store(pos + mMask + 1, std::memory_order_release);
+	return true;
+}
+
+// MPMCQueue: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+size_t MPMCQueue<T>::sizeApprox() const noexcept
+{
+	const size_t dequeuePos = mDequeuePos.load(std::memory_order_acquire);
+	const size_t enqueuePos = mEnqueuePos.load(std::memory_order_acquire);
+	const size_t size = enqueuePos - dequeuePos;
+	return size <= mMask + 1 ? size : 0;
+}
+
+// MPMCQueue: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+template<typename Arg>
+bool MPMCQueue<T>::push(Arg&& value) noexcept
+{
+	size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &mSlots[pos & mMask];
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+		if (diff == 0) {
+			// Slot free for this position, try to claim it
+			if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}
+		else if (diff < 0) {
+			return false; // Full
+		}
+		else {
+			pos = mEnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	new (slot->value()) T(std::forward<Arg>(value));
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+// TripleBuffer: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T> const uint8_t TripleBuffer<T>::INDEX_MASK;
+template<typename T> const uint8_t TripleBuffer<T>::NEW_VALUE_BIT;
+
+// TripleBuffer: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+TripleBuffer<T>::TripleBuffer(const T& initial) noexcept
+{
+	for (Buffer& buffer : mBuffers) buffer.value = initial;
+}
+
+// TripleBuffer: Writer
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+void TripleBuffer<T>::publish() noexcept
+{
+	const uint8_t previous = mMiddle.exchange(uint8_t(mWriteIndex | NEW_VALUE_BIT),
+	                                          std::memory_order_acq_rel);
+	mWriteIndex = uint8_t(previous & INDEX_MASK);
+}
+
+template<typename T>
+void TripleBuffer<T>::write(const T& value) noexcept
+{
+	this->writeBuffer() = value;
+	this->publish();
+}
+
+// TripleBuffer: Reader
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+bool TripleBuffer<T>::update() noexcept
+{
+	if ((mMiddle.load(std::memory_order_relaxed) & NEW_VALUE_BIT) == 0) return false;
+	const uint8_t previous = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel);
+	mReadIndex = uint8_t(previous & INDEX_MASK);
+	return true;
+}
+
+template<typename T>
+const T& TripleBuffer<T>::read() noexcept
+{
+	this->update();
+	return this->readBuffer();
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#ifndef SFZ_UTIL_MAPPED_FILE_HPP
+#define SFZ_UTIL_MAPPED_FILE_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+
+namespace sfz {
+
+using std::size_t;
+using std::uint8_t;
+
+/** @brief Hint about how the contents of a MappedFile will be accessed. */
+enum class FileAccessHint {
+	NORMAL,
+	SEQUENTIAL, // Read front to back once, aggressive read ahead
+	RANDOM, // Scattered reads, no read ahead
+	WILL_NEED // Entire file will be needed soon, start reading it in immediately
+};
+
+/**
+ * @brief A read-only view of an entire file
+ *
+ * On POSIX the file is memory mapped using mmap(), on Windows using CreateFileMapping(). The
+ * contents are then read directly from the OS page cache with no copies, pages are loaded on
+ * first access. If mapping is not possible (e.g. special files) the file is instead read into a
+ * heap allocated buffer. Empty files are valid, but data() returns nullptr.
+ *
+ * The view (and the pointer returned by data()) is valid until the MappedFile is destroyed. The
+ * file should not be modified by anyone while mapped.
+ */
+class MappedFile final {
+public:
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	MappedFile() noexcept = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator= (MappedFile&& other) noexcept;
+	~MappedFile() noexcept;
+
+	/** @brief Opens and maps the file, check isValid() to see if successful. */
+	MappedFile(const char* path, FileAccessHint hint = FileAccessHint::NORMAL) noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Changes the access hint (madvise() on POSIX), no-op if the file is not mapped. */
+	void advise(FileAccessHint hint) noexcept;
+
+	/** @brief Unmaps the file (or frees the fallback buffer), leaves an invalid MappedFile. */
+	void close() noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline bool isValid() const noexcept { return mValid; }
+	/** @brief Whether the file is memory mapped or was read into a buffer as fallback. */
+	inline bool isMapped() const noexcept { return mMapped; }
+	inline const uint8_t* data() const noexcept { return mData; }
+	inline size_t size() const noexcept { return mSize; }
+	inline const uint8_t* begin() const noexcept { return mData; }
+	inline const uint8_t* end() const noexcept { return mData + mSize; }
+
+private:
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const uint8_t* mData = nullptr;
+	size_t mSize = 0;
+	bool mValid = false, mMapped = false;
+#ifdef _WIN32
+	void* mFileHandle = nullptr;
+	void* mMappingHandle = nullptr;
+#endif
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
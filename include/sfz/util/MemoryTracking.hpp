@@ -0,0 +1,179 @@
+#pragma once
+#ifndef SFZ_UTIL_MEMORY_TRACKING_HPP
+#define SFZ_UTIL_MEMORY_TRACKING_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Global operator new and delete are replaced with versions counting the heap allocations
+ *        made by each thread, used by threadAllocationCount() and FrameAllocationCounter.
+ *        Disabled by defining SFZ_NO_DEBUG or SFZ_NO_ALLOCATION_COUNTING (e.g. if the application
+ *        replaces operator new itself), in which case only tagged allocations are counted.
+ */
+#if !defined(SFZ_NO_DEBUG) && !defined(SFZ_NO_ALLOCATION_COUNTING)
+#define SFZ_ALLOCATION_COUNTING
+#endif
+
+namespace sfz {
+
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::unique_ptr;
+
+// Memory tags
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/** @brief The subsystem an allocation belongs to. */
+enum class MemoryTag : uint32_t {
+	GENERAL = 0,
+	GRAPHICS = 1, // CPU side rendering data, e.g. sprite batches
+	TEXTURES = 2, // Image data
+	AUDIO = 3,
+	PROFILING = 4, // Frame statistics and telemetry
+	IO = 5
+};
+
+const size_t NUM_MEMORY_TAGS = 6;
+
+const char* memoryTagName(MemoryTag tag) noexcept;
+
+/** @brief Memory statistics of a tag, sizes are in bytes. */
+struct MemoryTagStats final {
+	size_t bytes = 0;
+	size_t peakBytes = 0; // Max bytes since resetMemoryPeaks()
+	size_t highWaterMark = 0; // Max bytes since program start
+	size_t numLiveAllocations = 0;
+	uint64_t numTotalAllocations = 0;
+};
+
+MemoryTagStats memoryTagStats(MemoryTag tag) noexcept;
+
+/** @brief Starts a new period for peakBytes of all tags, e.g. when loading a new level. */
+void resetMemoryPeaks() noexcept;
+
+/** @brief Prints the statistics of all tags to stdout. */
+void printMemoryStats() noexcept;
+
+/**
+ * @brief Records memory allocated by other means than taggedAllocate()
+ * Used to account for memory owned by external libraries, e.g. images decoded by stb_image or
+ * SDL surfaces. Each call to trackAllocation() must be matched by a trackDeallocation() with the
+ * same tag and size.
+ */
+void trackAllocation(MemoryTag tag, size_t size) noexcept;
+void trackDeallocation(MemoryTag tag, size_t size) noexcept;
+
+// Tagged allocations
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const size_t TAGGED_DEFAULT_ALIGNMENT = 16;
+
+/**
+ * @brief Allocates heap memory accounted to the tag, alignment must be a power of two
+ * Returns nullptr on failure. Must be freed with taggedDeallocate(), which looks up the tag and
+ * size in a small header stored before the returned memory. Thread-safe.
+ */
+void* taggedAllocate(MemoryTag tag, size_t size,
+                     size_t alignment = TAGGED_DEFAULT_ALIGNMENT) noexcept;
+
+void taggedDeallocate(void* ptr) noexcept;
+
+/** @brief Deleter for TaggedArray, elements are trivially destructible so none are destroyed. */
+template<typename T>
+struct TaggedArrayDeleter final {
+	inline void operator() (T* ptr) const noexcept { taggedDeallocate(ptr); }
+};
+
+/** @brief Owning pointer to an array allocated with makeTaggedArray(). */
+template<typename T>
+using TaggedArray = unique_ptr<T[], TaggedArrayDeleter<T>>;
+
+/** @brief Allocates a default-initialized array (null on failure) of a trivially destructible T */
+template<typename T>
+TaggedArray<T> makeTaggedArray(MemoryTag tag, size_t count) noexcept;
+
+/**
+ * @brief Records the callstack of each tagged allocation while enabled
+ * Costs a stack walk and a locked map insertion per allocation, so it is off by default. Only
+ * allocations made while enabled have callstacks, these can be printed with
+ * printLiveAllocations(). Not available on all platforms.
+ */
+void setMemoryCallstackCapture(bool enabled) noexcept;
+bool memoryCallstackCapture() noexcept;
+
+/**
+ * @brief Prints size and callstack of live tagged allocations with captured callstacks to stderr
+ * Useful for finding which code is responsible for the memory of a tag, or for leaks.
+ * @return the number of allocations printed
+ */
+size_t printLiveAllocations(MemoryTag tag) noexcept;
+
+// Allocation counting
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/** @brief Number of heap allocations and bytes requested by a thread. */
+struct AllocationCount final {
+	uint64_t numAllocations = 0;
+	uint64_t numBytes = 0;
+};
+
+/**
+ * @brief Total allocations made by the calling thread since it started
+ * Includes all uses of operator new if SFZ_ALLOCATION_COUNTING is defined, otherwise only tagged
+ * allocations. Memory allocated directly with malloc() (e.g. by C libraries) is never counted.
+ */
+AllocationCount threadAllocationCount() noexcept;
+
+/**
+ * @brief Counts the heap allocations made by a thread during each frame
+ * runGameLoop() uses the instance returned by frameAllocationCounter(). Once a game has reached
+ * a steady state (e.g. after the first frames of a level) it should not allocate at all, which
+ * can be enforced with setExpectZeroAllocations(true). Frames which allocate anyway are then
+ * reported and trigger a debug assert.
+ */
+class FrameAllocationCounter final {
+public:
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	void beginFrame() noexcept;
+
+	/** @brief Must be called on the same thread as the matching beginFrame(). */
+	void endFrame() noexcept;
+
+	inline void setExpectZeroAllocations(bool expect) noexcept { mExpectZero = expect; }
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline bool expectZeroAllocations() const noexcept { return mExpectZero; }
+
+	/** @brief Allocations made between the last beginFrame() and endFrame(). */
+	inline AllocationCount lastFrame() const noexcept { return mLastFrame; }
+
+	inline uint64_t numFrames() const noexcept { return mNumFrames; }
+
+	/** @brief Number of frames which allocated while zero allocations were expected. */
+	inline uint64_t numUnexpectedAllocationFrames() const noexcept { return mNumUnexpected; }
+
+private:
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	AllocationCount mFrameStart, mLastFrame;
+	uint64_t mNumFrames = 0, mNumUnexpected = 0;
+	bool mExpectZero = false;
+};
+
+/** @brief The counter used by runGameLoop(), must only be used from the game loop thread. */
+FrameAllocationCounter& frameAllocationCounter() noexcept;
+
+} // namespace sfz
+
+#include "sfz/util/MemoryTracking.inl"
+#endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+namespace sfz {
+
+// Tagged allocations
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T>
+TaggedArray<T> makeTaggedArray(MemoryTag tag, size_t count) noexcept
+{
+	static_assert(std::is_trivially_destructible<T>::value, "T must be trivially destructible");
+	const size_t alignment = alignof(T) > TAGGED_DEFAULT_ALIGNMENT ? alignof(T)
+	                                                               : TAGGED_DEFAULT_ALIGNMENT;
+	T* ptr = static_cast<T*>(taggedAllocate(tag, count * sizeof(T), alignment));
+	if (ptr != nullptr) {
+		for (size_t i = 0; i < count; i++) new (ptr + i) T;
+	}
+	return TaggedArray<T>(ptr);
+}
+
+} // namespace sfz
\ No newline at end of file
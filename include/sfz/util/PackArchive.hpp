@@ -0,0 +1,161 @@
+#pragma once
+#ifndef SFZ_UTIL_PACK_ARCHIVE_HPP
+#define SFZ_UTIL_PACK_ARCHIVE_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sfz/util/MappedFile.hpp"
+
+namespace sfz {
+
+using std::int64_t;
+using std::size_t;
+using std::string;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+/** @brief A read-only view of a file inside a PackArchive (or of a loose file). */
+struct AssetView final {
+	const uint8_t* data = nullptr; // nullptr for empty files
+	size_t size = 0; // Number of bytes stored, i.e. the compressed size if compressed
+	size_t uncompressedSize = 0;
+	bool found = false;
+	bool compressed = false; // Chunked stream (see sfz/util/Compression.hpp) if true
+
+	inline const uint8_t* begin() const noexcept { return data; }
+	inline const uint8_t* end() const noexcept { return data + size; }
+};
+
+/**
+ * @brief Writes a pack archive containing the specified files
+ * The files are read from baseDir + path, and are stored in the archive under their (normalized)
+ * relative path. Fails if a file can't be read or if a path is specified twice.
+ * @param alignment the alignment of each file's data inside the archive, must be a power of two
+ * @param compress whether files should be compressed, files that do not compress are stored as is
+ */
+bool writePackArchive(const char* packPath, const char* baseDir, const vector<string>& paths,
+                      uint32_t alignment = 16, bool compress = false) noexcept;
+
+/**
+ * @brief A read-only archive of many files packed into a single memory mapped file
+ *
+ * The archive starts with a header, followed by a table of contents sorted by the 64-bit FNV-1a
+ * hash of each file's path and a table of all paths. After that comes the data of each file,
+ * aligned to the alignment specified when writing. Looking up a file is a binary search in the
+ * table of contents, the returned view points directly into the mapped archive. Opening an
+ * archive thus costs a single open, the contents are then loaded by the OS on first access.
+ * Files may be stored compressed, in which case read() must be used to get the actual contents.
+ *
+ * Paths are relative and case sensitive, backslashes are treated as forward slashes and leading
+ * "./" and "/" are ignored. Archives are written in native byte order and are not portable
+ * between big and little endian machines.
+ *
+ * If a loose directory is specified files not found in the archive (or all files, if the
+ * archive does not exist) are instead looked up as loose files in that directory. This is
+ * intended for development, so that assets can be added without repacking. Loose files are
+ * memory mapped on first lookup and stay mapped until the PackArchive is destroyed.
+ *
+ * Views returned are valid until the PackArchive is destroyed. Lookups are thread safe.
+ */
+class PackArchive final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const uint32_t VERSION = 2;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	PackArchive() noexcept = default;
+	PackArchive(const PackArchive&) = delete;
+	PackArchive& operator= (const PackArchive&) = delete;
+	PackArchive(PackArchive&&) = delete;
+	PackArchive& operator= (PackArchive&&) = delete;
+
+	/**
+	 * @brief Opens and maps an archive, check isValid() to see if successful
+	 * @param looseDir directory used for loose file fallback, nullptr to disable
+	 */
+	PackArchive(const char* packPath, const char* looseDir = nullptr) noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Returns a view of the specified file, check found to see if it exists. */
+	AssetView find(const char* path) const noexcept;
+
+	/** @brief Returns whether a given file exists, in the archive or as a loose file. */
+	bool exists(const char* path) const noexcept;
+
+	/** @brief Returns (uncompressed) size of file in bytes, negative value if it does not exist. */
+	int64_t sizeofFile(const char* path) const noexcept;
+
+	/**
+	 * @brief Reads the contents of a file, decompressing it if necessary
+	 * Prefer find() for uncompressed files, which avoids the copy.
+	 * @param numThreads number of threads used to decompress, see sfz::decompress()
+	 * @return whether successful or not
+	 */
+	bool read(const char* path, vector<uint8_t>& dataOut, uint32_t numThreads = 1) const noexcept;
+
+	/** @brief Hash used for the table of contents, path is normalized before hashing. */
+	static uint64_t hashPath(const char* path) noexcept;
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Whether the archive was opened successfully or loose file fallback is enabled. */
+	inline bool isValid() const noexcept { return mHasPack || mLooseEnabled; }
+	inline bool hasPack() const noexcept { return mHasPack; }
+	inline bool looseFallbackEnabled() const noexcept { return mLooseEnabled; }
+
+	/** @brief Number of files in the archive, loose files not included. */
+	inline uint32_t numEntries() const noexcept { return mNumEntries; }
+
+	/** @brief Returns the path of the specified entry in the archive. */
+	string entryPath(uint32_t index) const noexcept;
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	struct Entry final {
+		uint64_t pathHash;
+		uint64_t offset;
+		uint64_t size;
+		uint64_t uncompressedSize; // Larger than size if compressed
+		uint32_t pathOffset;
+		uint32_t pathLength;
+	};
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	bool validate() noexcept;
+	const Entry* findEntry(const string& normalizedPath) const noexcept;
+	AssetView findLoose(const string& normalizedPath) const noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	MappedFile mFile;
+	const Entry* mEntries = nullptr;
+	const char* mStrings = nullptr;
+	uint32_t mNumEntries = 0;
+	bool mHasPack = false, mLooseEnabled = false;
+
+	string mLooseDir;
+	mutable std::mutex mLooseMutex;
+	mutable std::unordered_map<string, MappedFile> mLooseFiles;
+};
+
+} // namespace sfz
+#endif
\ No newline at end of file
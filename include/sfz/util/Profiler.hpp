@@ -0,0 +1,238 @@
+#pragma once
+#ifndef SFZ_UTIL_PROFILER_HPP
+#define SFZ_UTIL_PROFILER_HPP
+
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Profiles the rest of the enclosing scope as a zone with the specified name.
+ * The name must be a string with static lifetime (normally a string literal). Zones may be
+ * nested and are recorded per thread. Disabled by defining SFZ_NO_PROFILING, in which case the
+ * macro expands to nothing.
+ */
+#define sfz_profile_zone(name) sfz_profile_zone_impl(name)
+
+/**
+ * @brief Profiles the rest of the enclosing function as a zone named after the function.
+ * Disabled by defining SFZ_NO_PROFILING.
+ */
+#define sfz_profile_function() sfz_profile_zone_impl(__func__)
+
+/**
+ * @brief Marks the start of a new frame, should be called once per frame from the main thread.
+ * Disabled by defining SFZ_NO_PROFILING.
+ */
+#define sfz_profile_frame() sfz_profile_frame_impl()
+
+namespace sfz {
+
+using std::size_t;
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+/** @brief Aggregated timings of all zones with the same name, times are in nanoseconds. */
+struct ProfileZoneStats final {
+	const char* name = nullptr;
+	uint32_t count = 0;
+	uint64_t totalNs = 0;
+	uint64_t selfNs = 0; // Total time minus time spent in nested zones on the same thread
+	uint64_t minNs = 0;
+	uint64_t maxNs = 0;
+};
+
+/**
+ * @brief Low overhead hierarchical CPU profiler
+ *
+ * Each thread records its zones into its own fixed size ring buffer, so recording never locks
+ * or allocates (except the first time a thread records a zone, when its buffer is registered).
+ * A zone is written as a single event once it ends, containing its start and end time taken
+ * from the timer clock (see timerTicks()) and its nesting depth. When a ring buffer is full the
+ * oldest events are overwritten, so the buffers always contain the most recent history.
+ *
+ * The recorded events can be aggregated per zone name (for the last frames, as delimited by
+ * markFrame()) or exported as a Chrome trace (viewable in chrome://tracing or Perfetto).
+ * Aggregation and exporting may be done while other threads are recording, events overwritten
+ * while they are being read are skipped.
+ *
+ * Normally not used directly, but through the sfz_profile_zone(), sfz_profile_function() and
+ * sfz_profile_frame() macros.
+ */
+class Profiler final {
+public:
+	// Constants
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	static const size_t DEFAULT_EVENTS_PER_THREAD = 16384;
+	static const size_t MAX_NUM_FRAMES = 256;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	Profiler(const Profiler&) = delete;
+	Profiler& operator= (const Profiler&) = delete;
+	Profiler(Profiler&&) = delete;
+	Profiler& operator= (Profiler&&) = delete;
+
+	/** @brief Returns the global profiler used by the profiling macros. */
+	static Profiler& instance() noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	/** @brief Returns the current time of the profiler clock in nanoseconds. */
+	static uint64_t now() noexcept;
+
+	/** @brief Records a finished zone on the calling thread. */
+	void recordZone(const char* name, uint64_t startNs, uint64_t endNs, uint32_t depth) noexcept;
+
+	/** @brief Marks the start of a new frame. */
+	void markFrame() noexcept;
+
+	/** @brief Names the calling thread in exported traces. */
+	void setThreadName(const char* name) noexcept;
+
+	/** @brief Removes all recorded events and frames, already registered threads are kept. */
+	void clear() noexcept;
+
+	/**
+	 * @brief Aggregates the zones started during the last complete frames
+	 * Sorted by total time in descending order. If less than numFrames + 1 frames have been
+	 * marked (or if numFrames is 0) all recorded zones are aggregated.
+	 */
+	vector<ProfileZoneStats> zoneStats(uint32_t numFrames = 1) const noexcept;
+
+	/** @brief Writes all recorded zones and frames as a Chrome trace JSON file. */
+	bool writeChromeTrace(const char* path) const noexcept;
+
+	// Getters & setters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline bool isEnabled() const noexcept { return mEnabled.load(std::memory_order_relaxed); }
+	inline void setEnabled(bool enabled) noexcept
+	{
+		mEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	/** @brief Capacity of buffers of threads registered afterwards, rounded up to power of 2. */
+	void setEventsPerThread(size_t numEvents) noexcept;
+
+	/** @brief Number of frames marked since the profiler was last cleared. */
+	uint64_t numFrames() const noexcept;
+
+private:
+	// Private types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	// Fields are atomics so that they can be read while being overwritten by the recording thread
+	struct Event final {
+		std::atomic<const char*> name;
+		std::atomic<uint64_t> startNs, endNs;
+		std::atomic<uint32_t> depth;
+	};
+
+	struct ThreadBuffer final {
+		std::unique_ptr<Event[]> events;
+		size_t mask = 0;
+		std::atomic<uint64_t> startedIndex; // Number of events started being written
+		std::atomic<uint64_t> writeIndex; // Number of events completely written
+		std::atomic<uint64_t> clearIndex; // Events before this index have been cleared
+		std::atomic<bool> alive;
+		uint32_t threadId = 0;
+		string name;
+	};
+
+	struct RecordedZone final {
+		const char* name;
+		uint64_t startNs, endNs;
+		uint32_t depth;
+	};
+
+	friend struct ProfilerThreadHandle;
+
+	// Private constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	Profiler() noexcept;
+
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	ThreadBuffer* registerThread() noexcept;
+	void readZones(const ThreadBuffer& buffer, vector<RecordedZone>& zonesOut) const noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	const uint64_t mStartNs;
+	std::atomic<bool> mEnabled;
+
+	mutable std::mutex mMutex;
+	vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+	size_t mEventsPerThread = DEFAULT_EVENTS_PER_THREAD;
+	uint32_t mNextThreadId = 0;
+	uint64_t mFrames[MAX_NUM_FRAMES]; // Ring buffer with start times of last frames
+	uint64_t mNumFrames = 0;
+};
+
+/** @brief RAII class recording a zone from construction to destruction, see sfz_profile_zone(). */
+class ProfileZone final {
+public:
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator= (const ProfileZone&) = delete;
+
+	inline ProfileZone(const char* name) noexcept
+	:
+		mName(Profiler::instance().isEnabled() ? name : nullptr)
+	{
+		if (mName == nullptr) return;
+		mDepth = currentDepth()++;
+		mStartNs = Profiler::now();
+	}
+
+	inline ~ProfileZone() noexcept
+	{
+		if (mName == nullptr) return;
+		const uint64_t endNs = Profiler::now();
+		currentDepth()--;
+		Profiler::instance().recordZone(mName, mStartNs, endNs, mDepth);
+	}
+
+private:
+	static uint32_t& currentDepth() noexcept;
+
+	const char* mName;
+	uint64_t mStartNs = 0;
+	uint32_t mDepth = 0;
+};
+
+} // namespace sfz
+
+// Profiling macros implementation
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+#define SFZ_PROFILE_CONCAT_INNER(a, b) a ## b
+#define SFZ_PROFILE_CONCAT(a, b) SFZ_PROFILE_CONCAT_INNER(a, b)
+
+#ifndef SFZ_NO_PROFILING
+
+#define sfz_profile_zone_impl(name) \
+	sfz::ProfileZone SFZ_PROFILE_CONCAT(sfzProfileZone, __LINE__){name}
+
+#define sfz_profile_frame_impl() sfz::Profiler::instance().markFrame()
+
+#else
+
+#define sfz_profile_zone_impl(name) ((void)0)
+#define sfz_profile_frame_impl() ((void)0)
+
+#endif
+
+#endif
\ No newline at end of file
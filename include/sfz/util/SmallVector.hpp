@@ -0,0 +1,117 @@
+#pragma once
+#ifndef SFZ_UTIL_SMALL_VECTOR_HPP
+#define SFZ_UTIL_SMALL_VECTOR_HPP
+
+#include <cstddef> // std::size_t
+#include <initializer_list>
+#include <type_traits> // std::aligned_storage
+#include <utility> // std::move
+
+namespace sfz {
+
+using std::size_t;
+
+// SmallVector
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Vector storing up to N elements inline, only allocating from the heap if it grows larger
+ * Intended for containers which are usually small, e.g. local temporaries or small members, where
+ * the allocation of a std::vector would be more expensive than the work done with it. Once moved
+ * to the heap it stays there until destroyed or moved from. Pointers are invalidated on growth and
+ * when moving an inline SmallVector.
+ */
+template<typename T, size_t N>
+class SmallVector final {
+public:
+	static_assert(N > 0, "SmallVector must have an inline capacity of at least 1");
+
+	// Public types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	using value_type = T;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline SmallVector() noexcept : mData(inlineData()) { }
+	SmallVector(const SmallVector& other) noexcept;
+	SmallVector& operator= (const SmallVector& other) noexcept;
+	SmallVector(SmallVector&& other) noexcept;
+	SmallVector& operator= (SmallVector&& other) noexcept;
+	~SmallVector() noexcept;
+
+	SmallVector(std::initializer_list<T> list) noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline void push_back(const T& value) noexcept { this->emplace_back(value); }
+	inline void push_back(T&& value) noexcept { this->emplace_back(std::move(value)); }
+
+	template<typename... Args>
+	T& emplace_back(Args&&... args) noexcept;
+
+	void pop_back() noexcept;
+
+	/** @brief Destroys all elements, keeps the current capacity. */
+	void clear() noexcept;
+
+	/** @brief Default constructs new elements or destroys elements at the end. */
+	void resize(size_t size) noexcept;
+	void reserve(size_t capacity) noexcept;
+
+	inline T& operator[] (size_t index) noexcept { return mData[index]; }
+	inline const T& operator[] (size_t index) const noexcept { return mData[index]; }
+	inline T& front() noexcept { return mData[0]; }
+	inline const T& front() const noexcept { return mData[0]; }
+	inline T& back() noexcept { return mData[mSize - 1]; }
+	inline const T& back() const noexcept { return mData[mSize - 1]; }
+
+	inline T* data() noexcept { return mData; }
+	inline const T* data() const noexcept { return mData; }
+	inline iterator begin() noexcept { return mData; }
+	inline iterator end() noexcept { return mData + mSize; }
+	inline const_iterator begin() const noexcept { return mData; }
+	inline const_iterator end() const noexcept { return mData + mSize; }
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t size() const noexcept { return mSize; }
+	inline size_t capacity() const noexcept { return mCapacity; }
+	inline bool empty() const noexcept { return mSize == 0; }
+
+	/** @brief Returns whether the elements are stored inline (i.e. no heap memory is used). */
+	inline bool isInline() const noexcept { return mData == inlineData(); }
+
+private:
+	// Private methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline T* inlineData() noexcept { return reinterpret_cast<T*>(mInline); }
+	inline const T* inlineData() const noexcept { return reinterpret_cast<const T*>(mInline); }
+
+	/** @brief Moves the elements to a new heap buffer and frees the old one (if not inline). */
+	void moveTo(T* newData, size_t newCapacity) noexcept;
+
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	T* mData;
+	size_t mSize = 0, mCapacity = N;
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type mInline[N];
+};
+
+template<typename T, size_t N>
+bool operator== (const SmallVector<T, N>& lhs, const SmallVector<T, N>& rhs) noexcept;
+
+template<typename T, size_t N>
+bool operator!= (const SmallVector<T, N>& lhs, const SmallVector<T, N>& rhs) noexcept;
+
+} // namespace sfz
+
+#include "sfz/util/SmallVector.inl"
+#endif
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include <new> // placement new
+#include <utility> // std::move, std::forward
+
+namespace sfz {
+
+// SmallVector: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(const SmallVector& other) noexcept
+:
+	mData(inlineData())
+{
+	this->reserve(other.mSize);
+	for (size_t i = 0; i < other.mSize; i++) new (mData + i) T(other.mData[i]);
+	mSize = other.mSize;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator= (const SmallVector& other) noexcept
+{
+	if (this == &other) return *this;
+	this->clear();
+	this->reserve(other.mSize);
+	for (size_t i = 0; i < other.mSize; i++) new (mData + i) T(other.mData[i]);
+	mSize = other.mSize;
+	return *this;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(SmallVector&& other) noexcept
+:
+	mData(inlineData())
+{
+	*this = std::move(other);
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>& SmallVector<T, N>::operator= (SmallVector&& other) noexcept
+{
+	if (this == &other) return *this;
+	this->clear();
+
+	// Heap buffers are stolen, inline elements have to be moved one by one
+	if (!other.isInline()) {
+		if (!this->isInline()) ::operator delete(mData);
+		mData = other.mData;
+		mCapacity = other.mCapacity;
+		mSize = other.mSize;
+		other.mData = other.inlineData();
+		other.mCapacity = N;
+		other.mSize = 0;
+		return *this;
+	}
+	for (size_t i = 0; i < other.mSize; i++) {
+		new (mData + i) T(std::move(other.mData[i]));
+	}
+	mSize = other.mSize;
+	other.clear();
+	return *this;
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::~SmallVector() noexcept
+{
+	this->clear();
+	if (!this->isInline()) ::operator delete(mData);
+}
+
+template<typename T, size_t N>
+SmallVector<T, N>::SmallVector(std::initializer_list<T> list) noexcept
+:
+	mData(inlineData())
+{
+	this->reserve(list.size());
+	for (const T& value : list) new (mData + mSize++) T(value);
+}
+
+// SmallVector: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, size_t N>
+template<typename... Args>
+T& SmallVector<T, N>::emplace_back(Args&&... args) noexcept
+{
+	if (mSize == mCapacity) {
+		// New element constructed before the old ones are moved, args may refer to one of them
+		const size_t newCapacity = mCapacity * 2;
+		T* newData = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+		new (newData + mSize) T(std::forward<Args>(args)...);
+		this->moveTo(newData, newCapacity);
+	} else {
+		new (mData + mSize) T(std::forward<Args>(args)...);
+	}
+	return mData[mSize++];
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::pop_back() noexcept
+{
+	mSize--;
+	mData[mSize].~T();
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::clear() noexcept
+{
+	for (size_t i = 0; i < mSize; i++) mData[i].~T();
+	mSize = 0;
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::resize(size_t size) noexcept
+{
+	this->reserve(size);
+	while (mSize < size) new (mData + mSize++) T();
+	while (mSize > size) this->pop_back();
+}
+
+template<typename T, size_t N>
+void SmallVector<T, N>::reserve(size_t capacity) noexcept
+{
+	if (capacity <= mCapacity) return;
+	size_t newCapacity = mCapacity * 2;
+	if (newCapacity < capacity) newCapacity = capacity;
+	this->moveTo(static_cast<T*>(::operator new(newCapacity * sizeof(T))), newCapacity);
+}
+
+// SmallVector: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, size_t N>
+void SmallVector<T, N>::moveTo(T* newData, size_t newCapacity) noexcept
+{
+	for (size_t i = 0; i < mSize; i++) {
+		new (newData + i) T(std::move(mData[i]));
+		mData[i].~T();
+	}
+	if (!this->isInline()) ::operator delete(mData);
+	mData = newData;
+	mCapacity = newCapacity;
+}
+
+// SmallVector: Non-member operators
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, size_t N>
+bool operator== (const SmallVector<T, N>& lhs, const SmallVector<T, N>& rhs) noexcept
+{
+	if (lhs.size() != rhs.size()) return false;
+	for (size_t i = 0; i < lhs.size(); i++) {
+		if (!(lhs[i] == rhs[i])) return false;
+	}
+	return true;
+}
+
+template<typename T, size_t N>
+bool operator!= (const SmallVector<T, N>& lhs, const SmallVector<T, N>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+} // namespace sfz
\ No newline at end of file
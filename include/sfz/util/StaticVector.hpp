@@ -0,0 +1,102 @@
+#pragma once
+#ifndef SFZ_UTIL_STATIC_VECTOR_HPP
+#define SFZ_UTIL_STATIC_VECTOR_HPP
+
+#include <cstddef> // std::size_t
+#include <initializer_list>
+#include <type_traits> // std::aligned_storage
+#include <utility> // std::move
+
+#include "sfz/Assert.hpp"
+
+namespace sfz {
+
+using std::size_t;
+
+// StaticVector
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Vector with a fixed capacity of N elements stored inline, never allocates
+ * Elements are only constructed when added, unlike in a std::array. Adding elements to a full
+ * StaticVector is an error (checked even in release builds unless SFZ_NO_ASSERTIONS is defined).
+ */
+template<typename T, size_t N>
+class StaticVector final {
+public:
+	static_assert(N > 0, "StaticVector must have a capacity of at least 1");
+
+	// Public types
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	using value_type = T;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	// Constructors & destructors
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline StaticVector() noexcept { }
+	StaticVector(const StaticVector& other) noexcept;
+	StaticVector& operator= (const StaticVector& other) noexcept;
+	StaticVector(StaticVector&& other) noexcept;
+	StaticVector& operator= (StaticVector&& other) noexcept;
+	inline ~StaticVector() noexcept { this->clear(); }
+
+	StaticVector(std::initializer_list<T> list) noexcept;
+
+	// Public methods
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline void push_back(const T& value) noexcept { this->emplace_back(value); }
+	inline void push_back(T&& value) noexcept { this->emplace_back(std::move(value)); }
+
+	template<typename... Args>
+	T& emplace_back(Args&&... args) noexcept;
+
+	void pop_back() noexcept;
+	void clear() noexcept;
+
+	/** @brief Default constructs new elements or destroys elements at the end. */
+	void resize(size_t size) noexcept;
+
+	inline T& operator[] (size_t index) noexcept { return data()[index]; }
+	inline const T& operator[] (size_t index) const noexcept { return data()[index]; }
+	inline T& front() noexcept { return data()[0]; }
+	inline const T& front() const noexcept { return data()[0]; }
+	inline T& back() noexcept { return data()[mSize - 1]; }
+	inline const T& back() const noexcept { return data()[mSize - 1]; }
+
+	inline T* data() noexcept { return reinterpret_cast<T*>(mStorage); }
+	inline const T* data() const noexcept { return reinterpret_cast<const T*>(mStorage); }
+	inline iterator begin() noexcept { return data(); }
+	inline iterator end() noexcept { return data() + mSize; }
+	inline const_iterator begin() const noexcept { return data(); }
+	inline const_iterator end() const noexcept { return data() + mSize; }
+
+	// Getters
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	inline size_t size() const noexcept { return mSize; }
+	inline size_t capacity() const noexcept { return N; }
+	inline bool empty() const noexcept { return mSize == 0; }
+	inline bool full() const noexcept { return mSize == N; }
+
+private:
+	// Private members
+	// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+	size_t mSize = 0;
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type mStorage[N];
+};
+
+template<typename T, size_t N>
+bool operator== (const StaticVector<T, N>& lhs, const StaticVector<T, N>& rhs) noexcept;
+
+template<typename T, size_t N>
+bool operator!= (const StaticVector<T, N>& lhs, const StaticVector<T, N>& rhs) noexcept;
+
+} // namespace sfz
+
+#include "sfz/util/StaticVector.inl"
+#endif
\ No newline at end of file
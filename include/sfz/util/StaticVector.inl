@@ -0,0 +1,101 @@
+#include <new> // placement new
+
+namespace sfz {
+
+// StaticVector: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, size_t N>
+StaticVector<T, N>::StaticVector(const StaticVector& other) noexcept
+{
+	for (const T& value : other) new (data() + mSize++) T(value);
+}
+
+template<typename T, size_t N>
+StaticVector<T, N>& StaticVector<T, N>::operator= (const StaticVector& other) noexcept
+{
+	if (this == &other) return *this;
+	this->clear();
+	for (const T& value : other) new (data() + mSize++) T(value);
+	return *this;
+}
+
+template<typename T, size_t N>
+StaticVector<T, N>::StaticVector(StaticVector&& other) noexcept
+{
+	for (T& value : other) new (data() + mSize++) T(std::move(value));
+	other.clear();
+}
+
+template<typename T, size_t N>
+StaticVector<T, N>& StaticVector<T, N>::operator= (StaticVector&& other) noexcept
+{
+	if (this == &other) return *this;
+	this->clear();
+	for (T& value : other) new (data() + mSize++) T(std::move(value));
+	other.clear();
+	return *this;
+}
+
+template<typename T, size_t N>
+StaticVector<T, N>::StaticVector(std::initializer_list<T> list) noexcept
+{
+	sfz_assert_release(list.size() <= N);
+	for (const T& value : list) new (data() + mSize++) T(value);
+}
+
+// StaticVector: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, size_t N>
+template<typename... Args>
+T& StaticVector<T, N>::emplace_back(Args&&... args) noexcept
+{
+	sfz_assert_release(mSize < N);
+	new (data() + mSize) T(std::forward<Args>(args)...);
+	return data()[mSize++];
+}
+
+template<typename T, size_t N>
+void StaticVector<T, N>::pop_back() noexcept
+{
+	sfz_assert_debug(mSize > 0);
+	mSize--;
+	data()[mSize].~T();
+}
+
+template<typename T, size_t N>
+void StaticVector<T, N>::clear() noexcept
+{
+	for (size_t i = 0; i < mSize; i++) data()[i].~T();
+	mSize = 0;
+}
+
+template<typename T, size_t N>
+void StaticVector<T, N>::resize(size_t size) noexcept
+{
+	sfz_assert_release(size <= N);
+	while (mSize < size) new (data() + mSize++) T();
+	while (mSize > size) this->pop_back();
+}
+
+// StaticVector: Non-member operators
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename T, size_t N>
+bool operator== (const StaticVector<T, N>& lhs, const StaticVector<T, N>& rhs) noexcept
+{
+	if (lhs.size() != rhs.size()) return false;
+	for (size_t i = 0; i < lhs.size(); i++) {
+		if (!(lhs[i] == rhs[i])) return false;
+	}
+	return true;
+}
+
+template<typename T, size_t N>
+bool operator!= (const StaticVector<T, N>& lhs, const StaticVector<T, N>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -2,15 +2,18 @@
 #ifndef SFZ_UTIL_STOP_WATCH_HPP
 #define SFZ_UTIL_STOP_WATCH_HPP
 
-#include <chrono>
+#include <cstdint>
+
+#include "sfz/util/Timer.hpp"
 
 namespace sfz {
 
 /**
  * @brief Utility class for measuring time intervals.
  * 
- * A simple class implemented using the standard library that helps measuring time intervals with
- * the highest precision available.
+ * A simple class that helps measuring time intervals with the highest precision available. Times
+ * are stored as integer ticks of the timer clock (see timerTicks()), so precision is not lost
+ * regardless of how long the StopWatch has been running.
  *
  * @author Peter Hillerström <peter@hstroem.se>
  */
@@ -68,9 +71,24 @@ public:
 	 */
 	float getTimeNanoSeconds() noexcept;
 
+	/**
+	 * @brief Returns the time in timer ticks, see timerTicks().
+	 * Same semantics as the other time getters.
+	 */
+	uint64_t getTimeTicks() noexcept;
+
+	/**
+	 * @brief Returns the time since the last lap (or start) in ticks and starts a new lap.
+	 * Does not stop the StopWatch, can be called repeatedly to time consecutive intervals.
+	 */
+	uint64_t lapTicks() noexcept;
+
+	/** @brief Returns the time since the last lap (or start) in seconds and starts a new lap. */
+	float lapSeconds() noexcept;
+
 private:
 	bool mHasTime;
-	std::chrono::high_resolution_clock::time_point mStartTime, mStopTime;
+	std::uint64_t mStartTicks, mStopTicks, mLapTicks;
 };
 
 } // namespace sfz
@@ -0,0 +1,90 @@
+#pragma once
+#ifndef SFZ_UTIL_STRING_ID_HPP
+#define SFZ_UTIL_STRING_ID_HPP
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <functional> // std::hash
+
+namespace sfz {
+
+using std::size_t;
+using std::uint8_t;
+using std::uint64_t;
+
+// FNV-1a hashing
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t FNV1A_PRIME = 1099511628211ull;
+
+/** @brief 64-bit FNV-1a hash of a null-terminated string, can be evaluated at compile time. */
+constexpr uint64_t fnv1aHash(const char* str) noexcept;
+
+/** @brief 64-bit FNV-1a hash of the first length chars of a string. */
+constexpr uint64_t fnv1aHash(const char* str, size_t length) noexcept;
+
+// StringID
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief A string represented by its 64-bit FNV-1a hash
+ *
+ * Comparing and hashing a StringID is as cheap as for an integer, so hot code should look things
+ * up by StringID instead of by string. When constructed from a string literal in a constexpr
+ * context (or with the _sid literal) the hash is computed at compile time:
+ *     constexpr StringID PROJ_MATRIX("uProjMatrix");
+ *     setUniform(program, "uViewMatrix"_sid, viewMatrix);
+ *
+ * The original string can not be recovered from the hash. Strings registered with internString()
+ * can be looked up with internedString() for debugging, which also detects hash collisions
+ * between interned strings.
+ */
+struct StringID final {
+	uint64_t id = 0;
+
+	constexpr StringID() noexcept = default;
+	constexpr explicit StringID(uint64_t id) noexcept : id(id) { }
+	constexpr explicit StringID(const char* str) noexcept : id(fnv1aHash(str)) { }
+	constexpr StringID(const char* str, size_t length) noexcept : id(fnv1aHash(str, length)) { }
+};
+
+constexpr bool operator== (StringID lhs, StringID rhs) noexcept { return lhs.id == rhs.id; }
+constexpr bool operator!= (StringID lhs, StringID rhs) noexcept { return lhs.id != rhs.id; }
+constexpr bool operator< (StringID lhs, StringID rhs) noexcept { return lhs.id < rhs.id; }
+
+/** @brief "name"_sid is a StringID computed at compile time. */
+constexpr StringID operator"" _sid(const char* str, size_t length) noexcept;
+
+// Intern table
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Returns the StringID of the string and registers the string in the global intern table
+ * Prints an error if a different string with the same hash has already been interned. Intended
+ * to be called when loading (e.g. for asset names), not in hot code. Thread-safe.
+ */
+StringID internString(const char* str) noexcept;
+StringID internString(const char* str, size_t length) noexcept;
+
+/** @brief Returns the interned string of the ID, or nullptr if no such string was interned. */
+const char* internedString(StringID id) noexcept;
+
+size_t numInternedStrings() noexcept;
+
+} // namespace sfz
+
+// Specializations of standard library for sfz::StringID
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace std {
+
+template<>
+struct hash<sfz::StringID> {
+	size_t operator() (sfz::StringID str) const noexcept;
+};
+
+} // namespace std
+
+#include "sfz/util/StringID.inl"
+#endif
\ No newline at end of file
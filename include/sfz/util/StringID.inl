@@ -0,0 +1,49 @@
+namespace sfz {
+
+// FNV-1a hashing
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// C++11 constexpr functions can only consist of a single return statement, hence the recursion
+constexpr uint64_t fnv1aHashStep(const char* str, uint64_t hash) noexcept
+{
+	return (*str == '\0') ? hash :
+	       fnv1aHashStep(str + 1, (hash ^ uint64_t(uint8_t(*str))) * FNV1A_PRIME);
+}
+
+constexpr uint64_t fnv1aHashStep(const char* str, size_t length, uint64_t hash) noexcept
+{
+	return (length == 0) ? hash :
+	       fnv1aHashStep(str + 1, length - 1, (hash ^ uint64_t(uint8_t(*str))) * FNV1A_PRIME);
+}
+
+constexpr uint64_t fnv1aHash(const char* str) noexcept
+{
+	return fnv1aHashStep(str, FNV1A_OFFSET_BASIS);
+}
+
+constexpr uint64_t fnv1aHash(const char* str, size_t length) noexcept
+{
+	return fnv1aHashStep(str, length, FNV1A_OFFSET_BASIS);
+}
+
+// StringID
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+constexpr StringID operator"" _sid(const char* str, size_t length) noexcept
+{
+	return StringID(str, length);
+}
+
+} // namespace sfz
+
+// Specializations of standard library for sfz::StringID
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace std {
+
+inline size_t hash<sfz::StringID>::operator() (sfz::StringID str) const noexcept
+{
+	return size_t(str.id);
+}
+
+} // namespace std
\ No newline at end of file
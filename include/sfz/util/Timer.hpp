@@ -0,0 +1,94 @@
+#pragma once
+#ifndef SFZ_UTIL_TIMER_HPP
+#define SFZ_UTIL_TIMER_HPP
+
+#include <cstdint>
+
+namespace sfz {
+
+using std::uint64_t;
+
+// Timer ticks
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/** @brief Information about the clock used by the timer functions, determined on first use. */
+struct TimerInfo final {
+	bool usesTsc; // Whether the CPU timestamp counter (TSC) is used
+	uint64_t ticksPerSecond;
+	double secondsPerTick, nanosecondsPerTick;
+};
+
+/**
+ * @brief Returns information about the timer clock, calibrating it on first call
+ * The invariant TSC is used on x86 CPUs supporting it, calibrated against
+ * std::chrono::steady_clock during the first call (which takes about 10 ms). Otherwise
+ * std::chrono::steady_clock (with nanosecond ticks) is used. Using the TSC can be disabled by
+ * defining SFZ_NO_TSC.
+ */
+inline const TimerInfo& timerInfo() noexcept;
+
+/** @brief Returns the current time of the monotonic timer clock in ticks. */
+inline uint64_t timerTicks() noexcept;
+
+inline double ticksToSeconds(uint64_t ticks) noexcept;
+inline double ticksToMilliseconds(uint64_t ticks) noexcept;
+inline double ticksToNanoseconds(uint64_t ticks) noexcept;
+inline uint64_t secondsToTicks(double seconds) noexcept;
+
+/** @brief Performs the calibration, use timerInfo() instead. */
+TimerInfo calibrateTimer() noexcept;
+
+// TimeAccumulator
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/**
+ * @brief Accumulates the total time of many (possibly very short) intervals
+ * Intended for timing parts of tight inner loops, each interval costs two reads of the timer
+ * clock. Either use begin() and end(), or a ScopedTimer.
+ */
+class TimeAccumulator final {
+public:
+	inline void begin() noexcept { mBegin = timerTicks(); }
+	inline void end() noexcept { add(timerTicks() - mBegin); }
+	inline void add(uint64_t ticks) noexcept { mTotalTicks += ticks; mCount++; }
+	inline void reset() noexcept { mTotalTicks = 0; mCount = 0; }
+
+	inline uint64_t totalTicks() const noexcept { return mTotalTicks; }
+	inline uint64_t count() const noexcept { return mCount; }
+	inline double totalSeconds() const noexcept { return ticksToSeconds(mTotalTicks); }
+	inline double totalMilliseconds() const noexcept { return ticksToMilliseconds(mTotalTicks); }
+	inline double averageNanoseconds() const noexcept
+	{
+		return mCount == 0 ? 0.0 : ticksToNanoseconds(mTotalTicks) / double(mCount);
+	}
+
+private:
+	uint64_t mBegin = 0, mTotalTicks = 0, mCount = 0;
+};
+
+// ScopedTimer
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+/** @brief Adds the time from construction to destruction to a TimeAccumulator. */
+class ScopedTimer final {
+public:
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator= (const ScopedTimer&) = delete;
+
+	inline ScopedTimer(TimeAccumulator& accumulator) noexcept
+	:
+		mAccumulator(accumulator),
+		mBegin(timerTicks())
+	{ }
+
+	inline ~ScopedTimer() noexcept { mAccumulator.add(timerTicks() - mBegin); }
+
+private:
+	TimeAccumulator& mAccumulator;
+	uint64_t mBegin;
+};
+
+} // namespace sfz
+
+#include "sfz/util/Timer.inl"
+#endif
\ No newline at end of file
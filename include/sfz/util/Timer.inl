@@ -0,0 +1,53 @@
+#include <chrono>
+
+#if !defined(SFZ_NO_TSC) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+                             defined(_M_IX86))
+#define SFZ_TIMER_TSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace sfz {
+
+// Timer ticks
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+inline const TimerInfo& timerInfo() noexcept
+{
+	static const TimerInfo info = calibrateTimer();
+	return info;
+}
+
+inline uint64_t timerTicks() noexcept
+{
+#ifdef SFZ_TIMER_TSC
+	if (timerInfo().usesTsc) return __rdtsc();
+#endif
+	using namespace std::chrono;
+	return uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+inline double ticksToSeconds(uint64_t ticks) noexcept
+{
+	return double(ticks) * timerInfo().secondsPerTick;
+}
+
+inline double ticksToMilliseconds(uint64_t ticks) noexcept
+{
+	return double(ticks) * (timerInfo().secondsPerTick * 1000.0);
+}
+
+inline double ticksToNanoseconds(uint64_t ticks) noexcept
+{
+	return double(ticks) * timerInfo().nanosecondsPerTick;
+}
+
+inline uint64_t secondsToTicks(double seconds) noexcept
+{
+	return uint64_t(seconds * double(timerInfo().ticksPerSecond) + 0.5);
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include "sfz/geometry/BatchIntersection.hpp"
+
+#include <algorithm>
+#include <cstring> // std::memset
+
+#include "sfz/geometry/AABB2D.hpp"
+#include "sfz/geometry/Circle.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SFZ_BATCH_INTERSECTION_SSE
+#include <emmintrin.h>
+#endif
+
+namespace sfz {
+
+// Kernels
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Each kernel tests one primitive against element i (scalar()) or elements [i, i+4) (simd()),
+// the simd version returns a 4-bit mask where bit j is the result for element i+j.
+
+struct PointInsideCircleKernel final {
+	const PointArray& points;
+	float cx, cy, r2;
+
+	bool scalar(size_t i) const noexcept
+	{
+		float dx = points.x[i] - cx;
+		float dy = points.y[i] - cy;
+		return (dx*dx + dy*dy) <= r2;
+	}
+
+#ifdef SFZ_BATCH_INTERSECTION_SSE
+	int simd(size_t i) const noexcept
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(points.x + i), _mm_set1_ps(cx));
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(points.y + i), _mm_set1_ps(cy));
+		__m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		return _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_set1_ps(r2)));
+	}
+#endif
+};
+
+struct PointInsideRectKernel final {
+	const PointArray& points;
+	float minX, minY, maxX, maxY;
+
+	bool scalar(size_t i) const noexcept
+	{
+		return minX <= points.x[i] && points.x[i] <= maxX &&
+		       minY <= points.y[i] && points.y[i] <= maxY;
+	}
+
+#ifdef SFZ_BATCH_INTERSECTION_SSE
+	int simd(size_t i) const noexcept
+	{
+		__m128 x = _mm_loadu_ps(points.x + i);
+		__m128 y = _mm_loadu_ps(points.y + i);
+		__m128 inX = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(minX), x), _mm_cmple_ps(x, _mm_set1_ps(maxX)));
+		__m128 inY = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(minY), y), _mm_cmple_ps(y, _mm_set1_ps(maxY)));
+		return _mm_movemask_ps(_mm_and_ps(inX, inY));
+	}
+#endif
+};
+
+struct CircleCircleKernel final {
+	const CircleArray& circles;
+	float cx, cy, r;
+
+	bool scalar(size_t i) const noexcept
+	{
+		float dx = circles.x[i] - cx;
+		float dy = circles.y[i] - cy;
+		float radiusSum = circles.radius[i] + r;
+		return (dx*dx + dy*dy) <= (radiusSum * radiusSum);
+	}
+
+#ifdef SFZ_BATCH_INTERSECTION_SSE
+	int simd(size_t i) const noexcept
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(circles.x + i), _mm_set1_ps(cx));
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(circles.y + i), _mm_set1_ps(cy));
+		__m128 radiusSum = _mm_add_ps(_mm_loadu_ps(circles.radius + i), _mm_set1_ps(r));
+		__m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		return _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_mul_ps(radiusSum, radiusSum)));
+	}
+#endif
+};
+
+// One circle vs many rects, same algorithm as overlaps(const Circle&, const AABB2D&)
+struct CircleRectsKernel final {
+	const AABB2DArray& rects;
+	float cx, cy, r2;
+
+	bool scalar(size_t i) const noexcept
+	{
+		float ex = std::max(rects.minX[i] - cx, 0.0f) + std::max(cx - rects.maxX[i], 0.0f);
+		float ey = std::max(rects.minY[i] - cy, 0.0f) + std::max(cy - rects.maxY[i], 0.0f);
+		return (ex*ex + ey*ey) <= r2;
+	}
+
+#ifdef SFZ_BATCH_INTERSECTION_SSE
+	int simd(size_t i) const noexcept
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 x = _mm_set1_ps(cx), y = _mm_set1_ps(cy);
+		__m128 ex = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(rects.minX + i), x), zero),
+		                       _mm_max_ps(_mm_sub_ps(x, _mm_loadu_ps(rects.maxX + i)), zero));
+		__m128 ey = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(rects.minY + i), y), zero),
+		                       _mm_max_ps(_mm_sub_ps(y, _mm_loadu_ps(rects.maxY + i)), zero));
+		__m128 dist2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+		return _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_set1_ps(r2)));
+	}
+#endif
+};
+
+// One rect vs many circles
+struct RectCirclesKernel final {
+	const CircleArray& circles;
+	float minX, minY, maxX, maxY;
+
+	bool scalar(size_t i) const noexcept
+	{
+		float ex = std::max(minX - circles.x[i], 0.0f) + std::max(circles.x[i] - maxX, 0.0f);
+		float ey = std::max(minY - circles.y[i], 0.0f) + std::max(circles.y[i] - maxY, 0.0f);
+		return (ex*ex + ey*ey) <= (circles.radius[i] * circles.radius[i]);
+	}
+
+#ifdef SFZ_BATCH_INTERSECTION_SSE
+	int simd(size_t i) const noexcept
+	{
+		const __m128 zero = _mm_setzero_ps();
+		__m128 x = _mm_loadu_ps(circles.x + i);
+		__m128 y = _mm_loadu_ps(circles.y + i);
+		__m128 r = _mm_loadu_ps(circles.radius + i);
+		__m128 ex = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(minX), x), zero),
+		                       _mm_max_ps(_mm_sub_ps(x, _mm_set1_ps(maxX)), zero));
+		__m128 ey = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(minY), y), zero),
+		                       _mm_max_ps(_mm_sub_ps(y, _mm_set1_ps(maxY)), zero));
+		__m128 dist2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+		return _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_mul_ps(r, r)));
+	}
+#endif
+};
+
+struct RectRectKernel final {
+	const AABB2DArray& rects;
+	float minX, minY, maxX, maxY;
+
+	bool scalar(size_t i) const noexcept
+	{
+		return minX <= rects.maxX[i] && maxX >= rects.minX[i] &&
+		       minY <= rects.maxY[i] && maxY >= rects.minY[i];
+	}
+
+#ifdef SFZ_BATCH_INTERSECTION_SSE
+	int simd(size_t i) const noexcept
+	{
+		__m128 overlapX = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(minX), _mm_loadu_ps(rects.maxX + i)),
+		                             _mm_cmpge_ps(_mm_set1_ps(maxX), _mm_loadu_ps(rects.minX + i)));
+		__m128 overlapY = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(minY), _mm_loadu_ps(rects.maxY + i)),
+		                             _mm_cmpge_ps(_mm_set1_ps(maxY), _mm_loadu_ps(rects.minY + i)));
+		return _mm_movemask_ps(_mm_and_ps(overlapX, overlapY));
+	}
+#endif
+};
+
+// Outputs
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+struct BitmaskOutput final {
+	uint32_t* bitmask;
+
+	void add4(size_t i, int mask) noexcept { bitmask[i / 32] |= uint32_t(mask) << (i % 32); }
+	void add1(size_t i) noexcept { bitmask[i / 32] |= 1u << (i % 32); }
+};
+
+struct IndexOutput final {
+	uint32_t* indices;
+	size_t count;
+
+	void add4(size_t i, int mask) noexcept
+	{
+		for (uint32_t j = 0; j < 4; j++) {
+			indices[count] = uint32_t(i + j);
+			count += (mask >> j) & 1;
+		}
+	}
+	void add1(size_t i) noexcept { indices[count++] = uint32_t(i); }
+};
+
+struct PairOutput final {
+	vector<IndexPair>& pairs;
+	uint32_t first;
+
+	void add4(size_t i, int mask) noexcept
+	{
+		for (uint32_t j = 0; j < 4; j++) {
+			if ((mask >> j) & 1) pairs.push_back(IndexPair{first, uint32_t(i + j)});
+		}
+	}
+	void add1(size_t i) noexcept { pairs.push_back(IndexPair{first, uint32_t(i)}); }
+};
+
+// Static functions
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<typename Kernel, typename Output>
+static void runKernel(const Kernel& kernel, size_t count, Output& output) noexcept
+{
+	size_t i = 0;
+#ifdef SFZ_BATCH_INTERSECTION_SSE
+	for (; (i + 4) <= count; i += 4) {
+		int mask = kernel.simd(i);
+		if (mask != 0) output.add4(i, mask);
+	}
+#endif
+	for (; i < count; i++) {
+		if (kernel.scalar(i)) output.add1(i);
+	}
+}
+
+template<typename Kernel>
+static void runBitmask(const Kernel& kernel, size_t count, uint32_t* bitmaskOut) noexcept
+{
+	std::memset(bitmaskOut, 0, bitmaskNumWords(count) * sizeof(uint32_t));
+	BitmaskOutput output{bitmaskOut};
+	runKernel(kernel, count, output);
+}
+
+template<typename Kernel>
+static size_t runIndices(const Kernel& kernel, size_t count, uint32_t* indicesOut) noexcept
+{
+	IndexOutput output{indicesOut, 0};
+	runKernel(kernel, count, output);
+	return output.count;
+}
+
+// One vs many, bitmask output
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void pointInside(const Circle& circle, const PointArray& points, uint32_t* bitmaskOut) noexcept
+{
+	PointInsideCircleKernel kernel{points, circle.pos.x, circle.pos.y, circle.radius * circle.radius};
+	runBitmask(kernel, points.count, bitmaskOut);
+}
+
+void pointInside(const AABB2D& rect, const PointArray& points, uint32_t* bitmaskOut) noexcept
+{
+	PointInsideRectKernel kernel{points, rect.min.x, rect.min.y, rect.max.x, rect.max.y};
+	runBitmask(kernel, points.count, bitmaskOut);
+}
+
+void overlaps(const Circle& circle, const CircleArray& circles, uint32_t* bitmaskOut) noexcept
+{
+	CircleCircleKernel kernel{circles, circle.pos.x, circle.pos.y, circle.radius};
+	runBitmask(kernel, circles.count, bitmaskOut);
+}
+
+void overlaps(const Circle& circle, const AABB2DArray& rects, uint32_t* bitmaskOut) noexcept
+{
+	CircleRectsKernel kernel{rects, circle.pos.x, circle.pos.y, circle.radius * circle.radius};
+	runBitmask(kernel, rects.count, bitmaskOut);
+}
+
+void overlaps(const AABB2D& rect, const CircleArray& circles, uint32_t* bitmaskOut) noexcept
+{
+	RectCirclesKernel kernel{circles, rect.min.x, rect.min.y, rect.max.x, rect.max.y};
+	runBitmask(kernel, circles.count, bitmaskOut);
+}
+
+void overlaps(const AABB2D& rect, const AABB2DArray& rects, uint32_t* bitmaskOut) noexcept
+{
+	RectRectKernel kernel{rects, rect.min.x, rect.min.y, rect.max.x, rect.max.y};
+	runBitmask(kernel, rects.count, bitmaskOut);
+}
+
+// One vs many, index list output
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+size_t pointInsideIndices(const Circle& circle, const PointArray& points, uint32_t* indicesOut) noexcept
+{
+	PointInsideCircleKernel kernel{points, circle.pos.x, circle.pos.y, circle.radius * circle.radius};
+	return runIndices(kernel, points.count, indicesOut);
+}
+
+size_t pointInsideIndices(const AABB2D& rect, const PointArray& points, uint32_t* indicesOut) noexcept
+{
+	PointInsideRectKernel kernel{points, rect.min.x, rect.min.y, rect.max.x, rect.max.y};
+	return runIndices(kernel, points.count, indicesOut);
+}
+
+size_t overlapsIndices(const Circle& circle, const CircleArray& circles, uint32_t* indicesOut) noexcept
+{
+	CircleCircleKernel kernel{circles, circle.pos.x, circle.pos.y, circle.radius};
+	return runIndices(kernel, circles.count, indicesOut);
+}
+
+size_t overlapsIndices(const Circle& circle, const AABB2DArray& rects, uint32_t* indicesOut) noexcept
+{
+	CircleRectsKernel kernel{rects, circle.pos.x, circle.pos.y, circle.radius * circle.radius};
+	return runIndices(kernel, rects.count, indicesOut);
+}
+
+size_t overlapsIndices(const AABB2D& rect, const CircleArray& circles, uint32_t* indicesOut) noexcept
+{
+	RectCirclesKernel kernel{circles, rect.min.x, rect.min.y, rect.max.x, rect.max.y};
+	return runIndices(kernel, circles.count, indicesOut);
+}
+
+size_t overlapsIndices(const AABB2D& rect, const AABB2DArray& rects, uint32_t* indicesOut) noexcept
+{
+	RectRectKernel kernel{rects, rect.min.x, rect.min.y, rect.max.x, rect.max.y};
+	return runIndices(kernel, rects.count, indicesOut);
+}
+
+// Many vs many
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+size_t overlappingPairs(const CircleArray& lhs, const CircleArray& rhs,
+                        vector<IndexPair>& pairsOut) noexcept
+{
+	const size_t sizeBefore = pairsOut.size();
+	for (size_t i = 0; i < lhs.count; i++) {
+		CircleCircleKernel kernel{rhs, lhs.x[i], lhs.y[i], lhs.radius[i]};
+		PairOutput output{pairsOut, uint32_t(i)};
+		runKernel(kernel, rhs.count, output);
+	}
+	return pairsOut.size() - sizeBefore;
+}
+
+size_t overlappingPairs(const CircleArray& lhs, const AABB2DArray& rhs,
+                        vector<IndexPair>& pairsOut) noexcept
+{
+	const size_t sizeBefore = pairsOut.size();
+	for (size_t i = 0; i < lhs.count; i++) {
+		CircleRectsKernel kernel{rhs, lhs.x[i], lhs.y[i], lhs.radius[i] * lhs.radius[i]};
+		PairOutput output{pairsOut, uint32_t(i)};
+		runKernel(kernel, rhs.count, output);
+	}
+	return pairsOut.size() - sizeBefore;
+}
+
+size_t overlappingPairs(const AABB2DArray& lhs, const AABB2DArray& rhs,
+                        vector<IndexPair>& pairsOut) noexcept
+{
+	const size_t sizeBefore = pairsOut.size();
+	for (size_t i = 0; i < lhs.count; i++) {
+		RectRectKernel kernel{rhs, lhs.minX[i], lhs.minY[i], lhs.maxX[i], lhs.maxY[i]};
+		PairOutput output{pairsOut, uint32_t(i)};
+		runKernel(kernel, rhs.count, output);
+	}
+	return pairsOut.size() - sizeBefore;
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "sfz/geometry/KdTree.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/AABB2D.hpp"
+#include "sfz/geometry/Circle.hpp"
+#include "sfz/geometry/Sphere.hpp"
+
+namespace sfz {
+
+// Static functions & constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Ranges smaller than this are always built on the current thread
+static const uint32_t PARALLEL_BUILD_THRESHOLD = 16384;
+
+// Minimum number of queries per thread in batched queries
+static const size_t QUERIES_PER_THREAD = 64;
+
+static uint32_t resolveNumThreads(uint32_t numThreads) noexcept
+{
+	return numThreads != 0 ? numThreads : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Max heap on distance, i.e. the farthest of the current k nearest is at the top
+static bool closer(const KdNeighbour& lhs, const KdNeighbour& rhs) noexcept
+{
+	return lhs.distSquared < rhs.distSquared;
+}
+
+static void addToHeap(KdNeighbour* heap, size_t& heapSize, size_t k, KdNeighbour neighbour) noexcept
+{
+	if (heapSize < k) {
+		heap[heapSize] = neighbour;
+		heapSize += 1;
+		std::push_heap(heap, heap + heapSize, closer);
+	}
+	else if (neighbour.distSquared < heap[0].distSquared) {
+		std::pop_heap(heap, heap + heapSize, closer);
+		heap[heapSize - 1] = neighbour;
+		std::push_heap(heap, heap + heapSize, closer);
+	}
+}
+
+// KdTree: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<size_t N> const uint32_t KdTree<N>::LEAF_SIZE;
+template<size_t N> const uint32_t KdTree<N>::NO_INDEX;
+
+// KdTree: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<size_t N>
+KdTree<N>::KdTree(const VecN* points, size_t numPoints, uint32_t numThreads) noexcept
+{
+	this->build(points, numPoints, numThreads);
+}
+
+// KdTree: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<size_t N>
+void KdTree<N>::build(const VecN* points, size_t numPoints, uint32_t numThreads) noexcept
+{
+	sfz_assert_debug(numPoints < size_t(NO_INDEX));
+	const uint32_t count = uint32_t(numPoints);
+
+	mIndices.resize(count);
+	for (uint32_t i = 0; i < count; i++) mIndices[i] = i;
+	mSplitAxes.assign(count, 0);
+
+	buildRange(points, 0, count, resolveNumThreads(numThreads));
+
+	// Store points in tree order so that queries don't need to go through the indices
+	mPoints.resize(count);
+	for (uint32_t i = 0; i < count; i++) mPoints[i] = points[mIndices[i]];
+}
+
+template<size_t N>
+KdNeighbour KdTree<N>::findNearest(const VecN& point) const noexcept
+{
+	KdNeighbour nearest{NO_INDEX, std::numeric_limits<float>::infinity()};
+	size_t heapSize = 0;
+	searchKNearest(0, uint32_t(mPoints.size()), point, 1, &nearest, heapSize);
+	return nearest;
+}
+
+template<size_t N>
+void KdTree<N>::findKNearest(const VecN& point, size_t k, vector<KdNeighbour>& out) const noexcept
+{
+	out.resize(std::min(k, mPoints.size()));
+	size_t heapSize = 0;
+	if (!out.empty()) {
+		searchKNearest(0, uint32_t(mPoints.size()), point, out.size(), out.data(), heapSize);
+		std::sort_heap(out.data(), out.data() + heapSize, closer);
+	}
+	out.resize(heapSize);
+}
+
+template<size_t N>
+void KdTree<N>::findKNearest(const VecN* queries, size_t numQueries, size_t k, KdNeighbour* out,
+                             uint32_t numThreads) const noexcept
+{
+	if (k == 0 || numQueries == 0) return;
+
+	auto processRange = [this, queries, k, out](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			KdNeighbour* heap = out + i * k;
+			size_t heapSize = 0;
+			searchKNearest(0, uint32_t(mPoints.size()), queries[i], k, heap, heapSize);
+			std::sort_heap(heap, heap + heapSize, closer);
+			for (size_t j = heapSize; j < k; j++) {
+				heap[j] = KdNeighbour{NO_INDEX, std::numeric_limits<float>::infinity()};
+			}
+		}
+	};
+
+	// Each thread owns a contiguous range of queries, so no synchronization is needed
+	const size_t maxThreads = std::max(numQueries / QUERIES_PER_THREAD, size_t(1));
+	const size_t numRanges = std::min(size_t(resolveNumThreads(numThreads)), maxThreads);
+	const size_t queriesPerRange = (numQueries + numRanges - 1) / numRanges;
+	vector<std::thread> threads;
+	threads.reserve(numRanges - 1);
+	for (size_t i = 1; i < numRanges; i++) {
+		size_t begin = std::min(i * queriesPerRange, numQueries);
+		size_t end = std::min(begin + queriesPerRange, numQueries);
+		threads.emplace_back(processRange, begin, end);
+	}
+	processRange(0, std::min(queriesPerRange, numQueries));
+	for (std::thread& thread : threads) thread.join();
+}
+
+template<size_t N>
+void KdTree<N>::findInRadius(const VecN& point, float radius, vector<KdNeighbour>& out) const noexcept
+{
+	out.clear();
+	auto add = [&out, this](uint32_t i, float distSquared) {
+		out.push_back(KdNeighbour{mIndices[i], distSquared});
+	};
+	searchRadius(0, uint32_t(mPoints.size()), point, radius * radius, add);
+}
+
+template<size_t N>
+void KdTree<N>::findInRadius(const VecN& point, float radius, vector<uint32_t>& out) const noexcept
+{
+	out.clear();
+	auto add = [&out, this](uint32_t i, float) {
+		out.push_back(mIndices[i]);
+	};
+	searchRadius(0, uint32_t(mPoints.size()), point, radius * radius, add);
+}
+
+template<size_t N>
+void KdTree<N>::findInBox(const VecN& min, const VecN& max, vector<uint32_t>& out) const noexcept
+{
+	out.clear();
+	searchBox(0, uint32_t(mPoints.size()), min, max, out);
+}
+
+// KdTree: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<size_t N>
+void KdTree<N>::buildRange(const VecN* points, uint32_t begin, uint32_t end,
+                           uint32_t numThreads) noexcept
+{
+	if ((end - begin) <= LEAF_SIZE) return;
+
+	// Split along the axis with the largest extent
+	VecN min = points[mIndices[begin]];
+	VecN max = min;
+	for (uint32_t i = begin + 1; i < end; i++) {
+		min = sfz::min(min, points[mIndices[i]]);
+		max = sfz::max(max, points[mIndices[i]]);
+	}
+	const VecN extents = max - min;
+	uint32_t axis = 0;
+	for (uint32_t i = 1; i < N; i++) {
+		if (extents[i] > extents[axis]) axis = i;
+	}
+
+	const uint32_t mid = (begin + end) / 2;
+	std::nth_element(mIndices.begin() + begin, mIndices.begin() + mid, mIndices.begin() + end,
+	                 [points, axis](uint32_t lhs, uint32_t rhs) {
+		return points[lhs][axis] < points[rhs][axis];
+	});
+	mSplitAxes[mid] = uint8_t(axis);
+
+	// The two subtrees are disjoint ranges of the arrays, so they can be built in parallel
+	if (numThreads > 1 && (end - begin) >= PARALLEL_BUILD_THRESHOLD) {
+		const uint32_t leftThreads = numThreads / 2;
+		std::thread leftThread([this, points, begin, mid, leftThreads]() {
+			this->buildRange(points, begin, mid, leftThreads);
+		});
+		buildRange(points, mid + 1, end, numThreads - leftThreads);
+		leftThread.join();
+	} else {
+		buildRange(points, begin, mid, 1);
+		buildRange(points, mid + 1, end, 1);
+	}
+}
+
+template<size_t N>
+void KdTree<N>::searchKNearest(uint32_t begin, uint32_t end, const VecN& point, size_t k,
+                               KdNeighbour* heap, size_t& heapSize) const noexcept
+{
+	if ((end - begin) <= LEAF_SIZE) {
+		for (uint32_t i = begin; i < end; i++) {
+			addToHeap(heap, heapSize, k, KdNeighbour{mIndices[i], squaredLength(mPoints[i] - point)});
+		}
+		return;
+	}
+
+	const uint32_t mid = (begin + end) / 2;
+	addToHeap(heap, heapSize, k, KdNeighbour{mIndices[mid], squaredLength(mPoints[mid] - point)});
+
+	// Search the side containing the point first, then the other side only if it can contain
+	// points closer than the current k nearest
+	const uint32_t axis = mSplitAxes[mid];
+	const float diff = point[axis] - mPoints[mid][axis];
+	if (diff < 0.0f) {
+		searchKNearest(begin, mid, point, k, heap, heapSize);
+		if (heapSize < k || (diff * diff) < heap[0].distSquared) {
+			searchKNearest(mid + 1, end, point, k, heap, heapSize);
+		}
+	} else {
+		searchKNearest(mid + 1, end, point, k, heap, heapSize);
+		if (heapSize < k || (diff * diff) < heap[0].distSquared) {
+			searchKNearest(begin, mid, point, k, heap, heapSize);
+		}
+	}
+}
+
+template<size_t N>
+template<typename Func>
+void KdTree<N>::searchRadius(uint32_t begin, uint32_t end, const VecN& point, float radiusSquared,
+                             Func& func) const noexcept
+{
+	if ((end - begin) <= LEAF_SIZE) {
+		for (uint32_t i = begin; i < end; i++) {
+			float distSquared = squaredLength(mPoints[i] - point);
+			if (distSquared <= radiusSquared) func(i, distSquared);
+		}
+		return;
+	}
+
+	const uint32_t mid = (begin + end) / 2;
+	const float distSquared = squaredLength(mPoints[mid] - point);
+	if (distSquared <= radiusSquared) func(mid, distSquared);
+
+	const uint32_t axis = mSplitAxes[mid];
+	const float diff = point[axis] - mPoints[mid][axis];
+	const bool planeInRadius = (diff * diff) <= radiusSquared;
+	if (diff <= 0.0f || planeInRadius) searchRadius(begin, mid, point, radiusSquared, func);
+	if (diff >= 0.0f || planeInRadius) searchRadius(mid + 1, end, point, radiusSquared, func);
+}
+
+template<size_t N>
+void KdTree<N>::searchBox(uint32_t begin, uint32_t end, const VecN& min, const VecN& max,
+                          vector<uint32_t>& out) const noexcept
+{
+	auto inside = [&min, &max](const VecN& p) {
+		for (size_t i = 0; i < N; i++) {
+			if (p[i] < min[i] || max[i] < p[i]) return false;
+		}
+		return true;
+	};
+
+	if ((end - begin) <= LEAF_SIZE) {
+		for (uint32_t i = begin; i < end; i++) {
+			if (inside(mPoints[i])) out.push_back(mIndices[i]);
+		}
+		return;
+	}
+
+	const uint32_t mid = (begin + end) / 2;
+	if (inside(mPoints[mid])) out.push_back(mIndices[mid]);
+
+	const uint32_t axis = mSplitAxes[mid];
+	const float split = mPoints[mid][axis];
+	if (min[axis] <= split) searchBox(begin, mid, min, max, out);
+	if (max[axis] >= split) searchBox(mid + 1, end, min, max, out);
+}
+
+// Explicit instantiations
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template class KdTree<2>;
+template class KdTree<3>;
+
+// Range queries using geometry primitives
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void pointsInside(const KdTree2& tree, const Circle& circle, vector<uint32_t>& indicesOut) noexcept
+{
+	tree.findInRadius(circle.pos, circle.radius, indicesOut);
+}
+
+void pointsInside(const KdTree2& tree, const AABB2D& rect, vector<uint32_t>& indicesOut) noexcept
+{
+	tree.findInBox(rect.min, rect.max, indicesOut);
+}
+
+void pointsInside(const KdTree3& tree, const Sphere& sphere, vector<uint32_t>& indicesOut) noexcept
+{
+	tree.findInRadius(sphere.position(), sphere.radius(), indicesOut);
+}
+
+void pointsInside(const KdTree3& tree, const AABB& box, vector<uint32_t>& indicesOut) noexcept
+{
+	tree.findInBox(box.min(), box.max(), indicesOut);
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "sfz/geometry/LodSelection.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+#include "sfz/math/MathConstants.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SFZ_LOD_SELECTION_SSE
+#include <emmintrin.h>
+#endif
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+struct ScreenSizeParams final {
+	float camX, camY, camZ, near, tanHalfFovY;
+};
+
+static ScreenSizeParams screenSizeParams(const ViewFrustum& camera) noexcept
+{
+	ScreenSizeParams params;
+	params.camX = camera.pos().x;
+	params.camY = camera.pos().y;
+	params.camZ = camera.pos().z;
+	params.near = camera.near();
+	params.tanHalfFovY = std::tan((camera.verticalFov() / 2.0f) * DEG_TO_RAD());
+	return params;
+}
+
+static inline float screenSize(const ScreenSizeParams& p, float x, float y, float z,
+                               float radius) noexcept
+{
+	float dx = x - p.camX, dy = y - p.camY, dz = z - p.camZ;
+	float dist = std::max(std::sqrt(dx*dx + dy*dy + dz*dz), p.near);
+	return radius / (dist * p.tanHalfFovY);
+}
+
+#ifdef SFZ_LOD_SELECTION_SSE
+static inline __m128 screenSize(const ScreenSizeParams& p, __m128 x, __m128 y, __m128 z,
+                                __m128 radius) noexcept
+{
+	__m128 dx = _mm_sub_ps(x, _mm_set1_ps(p.camX));
+	__m128 dy = _mm_sub_ps(y, _mm_set1_ps(p.camY));
+	__m128 dz = _mm_sub_ps(z, _mm_set1_ps(p.camZ));
+	__m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+	__m128 dist = _mm_max_ps(_mm_sqrt_ps(dist2), _mm_set1_ps(p.near));
+	return _mm_div_ps(radius, _mm_mul_ps(dist, _mm_set1_ps(p.tanHalfFovY)));
+}
+#endif
+
+// Screen size
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void screenSizes(const ViewFrustum& camera, const SphereArray& spheres, float* sizesOut) noexcept
+{
+	const ScreenSizeParams params = screenSizeParams(camera);
+	size_t i = 0;
+#ifdef SFZ_LOD_SELECTION_SSE
+	for (; (i + 4) <= spheres.count; i += 4) {
+		__m128 size = screenSize(params, _mm_loadu_ps(spheres.x + i), _mm_loadu_ps(spheres.y + i),
+		                         _mm_loadu_ps(spheres.z + i), _mm_loadu_ps(spheres.radius + i));
+		_mm_storeu_ps(sizesOut + i, size);
+	}
+#endif
+	for (; i < spheres.count; i++) {
+		sizesOut[i] = screenSize(params, spheres.x[i], spheres.y[i], spheres.z[i], spheres.radius[i]);
+	}
+}
+
+void screenSizes(const ViewFrustum& camera, const AABBArray& aabbs, float* sizesOut) noexcept
+{
+	const ScreenSizeParams params = screenSizeParams(camera);
+	size_t i = 0;
+#ifdef SFZ_LOD_SELECTION_SSE
+	const __m128 half = _mm_set1_ps(0.5f);
+	for (; (i + 4) <= aabbs.count; i += 4) {
+		__m128 minX = _mm_loadu_ps(aabbs.minX + i), maxX = _mm_loadu_ps(aabbs.maxX + i);
+		__m128 minY = _mm_loadu_ps(aabbs.minY + i), maxY = _mm_loadu_ps(aabbs.maxY + i);
+		__m128 minZ = _mm_loadu_ps(aabbs.minZ + i), maxZ = _mm_loadu_ps(aabbs.maxZ + i);
+		__m128 ex = _mm_sub_ps(maxX, minX), ey = _mm_sub_ps(maxY, minY), ez = _mm_sub_ps(maxZ, minZ);
+		__m128 diag2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), _mm_mul_ps(ez, ez));
+		__m128 size = screenSize(params, _mm_mul_ps(_mm_add_ps(minX, maxX), half),
+		                         _mm_mul_ps(_mm_add_ps(minY, maxY), half),
+		                         _mm_mul_ps(_mm_add_ps(minZ, maxZ), half),
+		                         _mm_mul_ps(_mm_sqrt_ps(diag2), half));
+		_mm_storeu_ps(sizesOut + i, size);
+	}
+#endif
+	for (; i < aabbs.count; i++) {
+		float ex = aabbs.maxX[i] - aabbs.minX[i];
+		float ey = aabbs.maxY[i] - aabbs.minY[i];
+		float ez = aabbs.maxZ[i] - aabbs.minZ[i];
+		float radius = std::sqrt(ex*ex + ey*ey + ez*ez) * 0.5f;
+		sizesOut[i] = screenSize(params, (aabbs.minX[i] + aabbs.maxX[i]) * 0.5f,
+		                         (aabbs.minY[i] + aabbs.maxY[i]) * 0.5f,
+		                         (aabbs.minZ[i] + aabbs.maxZ[i]) * 0.5f, radius);
+	}
+}
+
+// LOD selection
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void selectLods(const float* sizes, size_t count, const float* thresholds,
+                uint32_t numThresholds, float hysteresis, uint8_t* lodsInOut) noexcept
+{
+	sfz_assert_debug(numThresholds < 256);
+	const float lowerFactor = 1.0f - hysteresis;
+	const float upperFactor = 1.0f + hysteresis;
+
+	size_t i = 0;
+#ifdef SFZ_LOD_SELECTION_SSE
+	const __m128i one = _mm_set1_epi32(1);
+	for (; (i + 4) <= count; i += 4) {
+		__m128 size = _mm_loadu_ps(sizes + i);
+		__m128i current = _mm_setr_epi32(lodsInOut[i], lodsInOut[i+1], lodsInOut[i+2], lodsInOut[i+3]);
+		__m128i lod = _mm_setzero_si128();
+		for (uint32_t t = 0; t < numThresholds; t++) {
+			// Objects currently on the less detailed side of threshold t use the upper boundary
+			__m128 lessDetailed = _mm_castsi128_ps(_mm_cmpgt_epi32(current, _mm_set1_epi32(int(t))));
+			__m128 lower = _mm_set1_ps(thresholds[t] * lowerFactor);
+			__m128 upper = _mm_set1_ps(thresholds[t] * upperFactor);
+			__m128 boundary = _mm_or_ps(_mm_and_ps(lessDetailed, upper),
+			                            _mm_andnot_ps(lessDetailed, lower));
+			__m128i smaller = _mm_castps_si128(_mm_cmplt_ps(size, boundary));
+			lod = _mm_add_epi32(lod, _mm_and_si128(smaller, one));
+		}
+		alignas(16) int lods[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lods), lod);
+		for (size_t j = 0; j < 4; j++) lodsInOut[i+j] = uint8_t(lods[j]);
+	}
+#endif
+	for (; i < count; i++) {
+		uint32_t current = lodsInOut[i];
+		uint32_t lod = 0;
+		for (uint32_t t = 0; t < numThresholds; t++) {
+			float boundary = thresholds[t] * (current > t ? upperFactor : lowerFactor);
+			if (sizes[i] < boundary) lod++;
+		}
+		lodsInOut[i] = uint8_t(lod);
+	}
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "sfz/geometry/MultiFrustumCuller.hpp"
+
+#include <cmath>
+
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/Plane.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const uint32_t NUM_PLANES = 6;
+static const uint32_t CAMERA_FRUSTUM = ~0u;
+
+// Same test as belowPlane() in Intersection.cpp for all 6 planes
+static inline bool belowPlanes(const vec4* planes, vec3 pos, vec3 halfExtents) noexcept
+{
+	for (uint32_t i = 0; i < NUM_PLANES; i++) {
+		const vec4& p = planes[i];
+		float projectedRadius = halfExtents.x * std::abs(p.x)
+		                      + halfExtents.y * std::abs(p.y)
+		                      + halfExtents.z * std::abs(p.z);
+		if (dot(p.xyz, pos) - p.w > projectedRadius) return false;
+	}
+	return true;
+}
+
+static inline bool belowPlanes(const vec4* planes, vec3 pos, float radius) noexcept
+{
+	for (uint32_t i = 0; i < NUM_PLANES; i++) {
+		const vec4& p = planes[i];
+		if (dot(p.xyz, pos) - p.w > radius) return false;
+	}
+	return true;
+}
+
+// MultiFrustumCuller: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void MultiFrustumCuller::beginFrame(const ViewFrustum& camera) noexcept
+{
+	mNumLights = 0;
+	mPlanes.clear();
+	mBoundingSpheres.clear();
+	mBoundingMins.clear();
+	mBoundingMaxs.clear();
+	mFrustumLights.clear();
+	mLightActive.clear();
+	for (auto& casters : mCasters) casters.clear();
+	mCameraVisible.clear();
+
+	mCamera = camera;
+	addFrustum(camera);
+	mFrustumLights.push_back(CAMERA_FRUSTUM);
+}
+
+uint32_t MultiFrustumCuller::addLight(const ViewFrustum& lightFrustum) noexcept
+{
+	sfz_assert_debug(!mFrustumLights.empty()); // beginFrame() must be called first
+
+	const uint32_t light = mNumLights++;
+	if (mCasters.size() < mNumLights) mCasters.resize(mNumLights);
+
+	mLightActive.push_back(false);
+	if (!mCamera.isVisible(lightFrustum)) return light;
+
+	mLightActive[light] = true;
+	addFrustum(lightFrustum);
+	mFrustumLights.push_back(light);
+	return light;
+}
+
+void MultiFrustumCuller::cull(const AABB* aabbs, size_t count) noexcept
+{
+	const uint32_t numFrusta = uint32_t(mFrustumLights.size());
+	for (size_t i = 0; i < count; i++) {
+		const vec3 min = aabbs[i].min();
+		const vec3 max = aabbs[i].max();
+		const vec3 pos = aabbs[i].position();
+		const vec3 halfExtents = aabbs[i].halfExtents();
+
+		for (uint32_t f = 0; f < numFrusta; f++) {
+			// Cheap pre-rejection with the bounding AABB of the frustum
+			const vec3& fMin = mBoundingMins[f];
+			const vec3& fMax = mBoundingMaxs[f];
+			if (max.x < fMin.x || min.x > fMax.x) continue;
+			if (max.y < fMin.y || min.y > fMax.y) continue;
+			if (max.z < fMin.z || min.z > fMax.z) continue;
+			if (!belowPlanes(&mPlanes[f * NUM_PLANES], pos, halfExtents)) continue;
+
+			const uint32_t light = mFrustumLights[f];
+			if (light == CAMERA_FRUSTUM) mCameraVisible.push_back(uint32_t(i));
+			else mCasters[light].push_back(uint32_t(i));
+		}
+	}
+}
+
+void MultiFrustumCuller::cull(const Sphere* spheres, size_t count) noexcept
+{
+	const uint32_t numFrusta = uint32_t(mFrustumLights.size());
+	for (size_t i = 0; i < count; i++) {
+		const vec3 pos = spheres[i].position();
+		const float radius = spheres[i].radius();
+
+		for (uint32_t f = 0; f < numFrusta; f++) {
+			// Cheap pre-rejection with the bounding sphere of the frustum
+			const vec4& fSphere = mBoundingSpheres[f];
+			const vec3 distVec = pos - fSphere.xyz;
+			const float radiusSum = radius + fSphere.w;
+			if (dot(distVec, distVec) > radiusSum * radiusSum) continue;
+			if (!belowPlanes(&mPlanes[f * NUM_PLANES], pos, radius)) continue;
+
+			const uint32_t light = mFrustumLights[f];
+			if (light == CAMERA_FRUSTUM) mCameraVisible.push_back(uint32_t(i));
+			else mCasters[light].push_back(uint32_t(i));
+		}
+	}
+}
+
+// MultiFrustumCuller: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void MultiFrustumCuller::addFrustum(const ViewFrustum& frustum) noexcept
+{
+	Plane planes[NUM_PLANES];
+	frustum.planes(planes);
+	for (const Plane& plane : planes) mPlanes.push_back(vec4{plane.normal(), plane.d()});
+
+	const Sphere& sphere = frustum.boundingSphere();
+	mBoundingSpheres.push_back(vec4{sphere.position(), sphere.radius()});
+	mBoundingMins.push_back(frustum.boundingAABB().min());
+	mBoundingMaxs.push_back(frustum.boundingAABB().max());
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "sfz/geometry/OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <new> // std::nothrow
+#include <thread>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SFZ_OCCLUSION_CULLER_SSE
+#include <emmintrin.h>
+#endif
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static uint32_t roundUp(uint32_t value, uint32_t multiple) noexcept
+{
+	return ((value + multiple - 1) / multiple) * multiple;
+}
+
+static vec4 lerpClip(const vec4& a, const vec4& b, float t) noexcept
+{
+	return a + (b - a) * t;
+}
+
+/** Edge function E(x,y) = a*x + b*y + c, positive on the inside of a counter-clockwise edge. */
+struct EdgeFunction final {
+	float a, b, c;
+
+	inline EdgeFunction(vec3 p0, vec3 p1) noexcept
+	:
+		a{p0.y - p1.y},
+		b{p1.x - p0.x},
+		c{-(a * p0.x + b * p0.y)}
+	{ }
+};
+
+// Rasterizes one row of pixels [x0, x1) of a triangle into the depth buffer. x0 must be aligned
+// to 4 pixels and the row must be padded so that x1 rounded up to 4 is in bounds.
+static void rasterizeRow(float* row, uint32_t x0, uint32_t x1, float py,
+                         const EdgeFunction (&e)[3], const vec3& zPlane) noexcept
+{
+#ifdef SFZ_OCCLUSION_CULLER_SSE
+	const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 e0a = _mm_set1_ps(e[0].a), e1a = _mm_set1_ps(e[1].a), e2a = _mm_set1_ps(e[2].a);
+	const __m128 e0r = _mm_set1_ps(e[0].b * py + e[0].c);
+	const __m128 e1r = _mm_set1_ps(e[1].b * py + e[1].c);
+	const __m128 e2r = _mm_set1_ps(e[2].b * py + e[2].c);
+	const __m128 za = _mm_set1_ps(zPlane.x);
+	const __m128 zr = _mm_set1_ps(zPlane.y * py + zPlane.z);
+
+	for (uint32_t x = x0; x < x1; x += 4) {
+		__m128 px = _mm_add_ps(_mm_set1_ps(float(x)), laneOffsets);
+		__m128 w0 = _mm_add_ps(_mm_mul_ps(e0a, px), e0r);
+		__m128 w1 = _mm_add_ps(_mm_mul_ps(e1a, px), e1r);
+		__m128 w2 = _mm_add_ps(_mm_mul_ps(e2a, px), e2r);
+		__m128 inside = _mm_and_ps(_mm_cmpge_ps(w0, zero),
+		                _mm_and_ps(_mm_cmpge_ps(w1, zero), _mm_cmpge_ps(w2, zero)));
+		if (_mm_movemask_ps(inside) == 0) continue;
+
+		__m128 z = _mm_add_ps(_mm_mul_ps(za, px), zr);
+		__m128 old = _mm_loadu_ps(row + x);
+		__m128 newDepth = _mm_max_ps(old, z);
+		_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, newDepth), _mm_andnot_ps(inside, old)));
+	}
+#else
+	for (uint32_t x = x0; x < x1; x++) {
+		float px = float(x) + 0.5f;
+		bool inside = (e[0].a * px + e[0].b * py + e[0].c) >= 0.0f
+		           && (e[1].a * px + e[1].b * py + e[1].c) >= 0.0f
+		           && (e[2].a * px + e[2].b * py + e[2].c) >= 0.0f;
+		float z = zPlane.x * px + zPlane.y * py + zPlane.z;
+		if (inside) row[x] = std::max(row[x], z);
+	}
+#endif
+}
+
+// OcclusionCuller: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height, uint32_t numThreads) noexcept
+:
+	mWidth{roundUp(std::max(width, 1u), TILE_WIDTH)},
+	mHeight{roundUp(std::max(height, 1u), TILE_HEIGHT)},
+	mNumThreads{numThreads != 0 ? numThreads : std::max(std::thread::hardware_concurrency(), 1u)}
+{
+	static_assert(TILE_WIDTH % 4 == 0, "Rows are rasterized 4 pixels at a time");
+
+	mDepth = unique_ptr<float[]>{new (std::nothrow) float[mWidth * mHeight]};
+	sfz_assert_debug(mDepth != nullptr);
+	mTileDepth = unique_ptr<float[]>{
+	    new (std::nothrow) float[(mWidth / TILE_WIDTH) * (mHeight / TILE_HEIGHT)]};
+	sfz_assert_debug(mTileDepth != nullptr);
+
+	std::fill(mDepth.get(), mDepth.get() + mWidth * mHeight, 0.0f);
+	std::fill(mTileDepth.get(), mTileDepth.get() + (mWidth / TILE_WIDTH) * (mHeight / TILE_HEIGHT), 0.0f);
+}
+
+// OcclusionCuller: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void OcclusionCuller::beginFrame(const mat4& viewProjMatrix, float near) noexcept
+{
+	sfz_assert_debug(mDepth != nullptr);
+	sfz_assert_debug(0.0f < near);
+	mViewProjMatrix = viewProjMatrix;
+	mNear = near;
+	mTriangles.clear();
+	std::fill(mDepth.get(), mDepth.get() + mWidth * mHeight, 0.0f);
+	std::fill(mTileDepth.get(), mTileDepth.get() + (mWidth / TILE_WIDTH) * (mHeight / TILE_HEIGHT), 0.0f);
+}
+
+void OcclusionCuller::beginFrame(const ViewFrustum& viewFrustum) noexcept
+{
+	this->beginFrame(viewFrustum.viewProjMatrix(), viewFrustum.near());
+}
+
+void OcclusionCuller::addOccluder(const vec3* vertices, const uint32_t* indices,
+                                  size_t numTriangles, const mat4& modelMatrix) noexcept
+{
+	const mat4 transform = mViewProjMatrix * modelMatrix;
+	for (size_t i = 0; i < numTriangles; i++) {
+		size_t i0 = i * 3, i1 = i * 3 + 1, i2 = i * 3 + 2;
+		if (indices != nullptr) {
+			i0 = indices[i0];
+			i1 = indices[i1];
+			i2 = indices[i2];
+		}
+		addClipTriangle(transform * vec4{vertices[i0], 1.0f},
+		                transform * vec4{vertices[i1], 1.0f},
+		                transform * vec4{vertices[i2], 1.0f});
+	}
+}
+
+void OcclusionCuller::addOccluder(const AABB& aabb) noexcept
+{
+	static const uint32_t indices[] = {
+		0, 1, 3, 0, 3, 2, // Left
+		4, 6, 7, 4, 7, 5, // Right
+		0, 4, 5, 0, 5, 1, // Bottom
+		2, 3, 7, 2, 7, 6, // Top
+		0, 2, 6, 0, 6, 4, // Back
+		1, 5, 7, 1, 7, 3  // Front
+	};
+	vec3 corners[8];
+	aabb.corners(corners);
+	this->addOccluder(corners, indices, 12, identityMatrix4<float>());
+}
+
+void OcclusionCuller::rasterize() noexcept
+{
+	const uint32_t numTileRows = mHeight / TILE_HEIGHT;
+	const uint32_t numBands = std::min(mNumThreads, numTileRows);
+	if (numBands <= 1 || mTriangles.size() < 64) {
+		rasterizeBand(0, numTileRows);
+		return;
+	}
+
+	// Each thread owns a horizontal band of tiles, so no synchronization is needed
+	vector<std::thread> threads;
+	threads.reserve(numBands - 1);
+	const uint32_t rowsPerBand = (numTileRows + numBands - 1) / numBands;
+	for (uint32_t i = 1; i < numBands; i++) {
+		uint32_t begin = std::min(i * rowsPerBand, numTileRows);
+		uint32_t end = std::min(begin + rowsPerBand, numTileRows);
+		threads.emplace_back([this, begin, end]() { this->rasterizeBand(begin, end); });
+	}
+	rasterizeBand(0, std::min(rowsPerBand, numTileRows));
+	for (std::thread& thread : threads) thread.join();
+}
+
+bool OcclusionCuller::isVisible(const AABB& aabb) const noexcept
+{
+	vec3 corners[8];
+	aabb.corners(corners);
+	return isVisible(corners);
+}
+
+bool OcclusionCuller::isVisible(const OBB& obb) const noexcept
+{
+	vec3 corners[8];
+	obb.corners(corners);
+	return isVisible(corners);
+}
+
+// OcclusionCuller: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void OcclusionCuller::addClipTriangle(const vec4& a, const vec4& b, const vec4& c) noexcept
+{
+	// Trivially reject triangles completely outside one of the side planes
+	if (a.x > a.w && b.x > b.w && c.x > c.w) return;
+	if (a.x < -a.w && b.x < -b.w && c.x < -c.w) return;
+	if (a.y > a.w && b.y > b.w && c.y > c.w) return;
+	if (a.y < -a.w && b.y < -b.w && c.y < -c.w) return;
+
+	// Clips triangle against near plane (w >= near), Sutherland-Hodgman
+	const vec4 in[3] = {a, b, c};
+	vec4 out[4];
+	uint32_t numOut = 0;
+	for (uint32_t i = 0; i < 3; i++) {
+		const vec4& curr = in[i];
+		const vec4& next = in[(i + 1) % 3];
+		float currDist = curr.w - mNear;
+		float nextDist = next.w - mNear;
+		if (currDist >= 0.0f) out[numOut++] = curr;
+		if ((currDist >= 0.0f) != (nextDist >= 0.0f)) {
+			out[numOut++] = lerpClip(curr, next, currDist / (currDist - nextDist));
+		}
+	}
+
+	if (numOut >= 3) addScreenTriangle(out[0], out[1], out[2]);
+	if (numOut == 4) addScreenTriangle(out[0], out[2], out[3]);
+}
+
+void OcclusionCuller::addScreenTriangle(const vec4& a, const vec4& b, const vec4& c) noexcept
+{
+	const vec4* clip[3] = {&a, &b, &c};
+	Triangle tri;
+	for (uint32_t i = 0; i < 3; i++) {
+		float invW = 1.0f / clip[i]->w;
+		tri.v[i].x = (clip[i]->x * invW * 0.5f + 0.5f) * float(mWidth);
+		tri.v[i].y = (clip[i]->y * invW * 0.5f + 0.5f) * float(mHeight);
+		tri.v[i].z = invW;
+	}
+
+	// Makes triangle counter-clockwise, occluders are rendered double-sided
+	float area = (tri.v[1].x - tri.v[0].x) * (tri.v[2].y - tri.v[0].y)
+	           - (tri.v[2].x - tri.v[0].x) * (tri.v[1].y - tri.v[0].y);
+	if (std::abs(area) < 0.0001f) return;
+	if (area < 0.0f) std::swap(tri.v[1], tri.v[2]);
+
+	mTriangles.push_back(tri);
+}
+
+void OcclusionCuller::rasterizeBand(uint32_t tileRowBegin, uint32_t tileRowEnd) noexcept
+{
+	const float bandMinY = float(tileRowBegin * TILE_HEIGHT);
+	const float bandMaxY = float(tileRowEnd * TILE_HEIGHT);
+
+	for (const Triangle& tri : mTriangles) {
+		const vec3& v0 = tri.v[0];
+		const vec3& v1 = tri.v[1];
+		const vec3& v2 = tri.v[2];
+
+		// Bounding box clamped to band, pixel centers inside [min, max) are candidates
+		float minX = std::max(std::min(v0.x, std::min(v1.x, v2.x)), 0.0f);
+		float maxX = std::min(std::max(v0.x, std::max(v1.x, v2.x)), float(mWidth));
+		float minY = std::max(std::min(v0.y, std::min(v1.y, v2.y)), bandMinY);
+		float maxY = std::min(std::max(v0.y, std::max(v1.y, v2.y)), bandMaxY);
+		if (minX >= maxX || minY >= maxY) continue;
+
+		uint32_t x0 = uint32_t(minX) & ~3u;
+		uint32_t x1 = std::min(uint32_t(std::ceil(maxX)), mWidth);
+		uint32_t y0 = uint32_t(minY);
+		uint32_t y1 = std::min(uint32_t(std::ceil(maxY)), uint32_t(bandMaxY));
+
+		// Edge i is opposite of vertex i, i.e. it's the barycentric weight of vertex i
+		const EdgeFunction e[3] = {EdgeFunction{v1, v2}, EdgeFunction{v2, v0}, EdgeFunction{v0, v1}};
+
+		// Inverse depth is linear in screen space, z(x,y) = zPlane.x*x + zPlane.y*y + zPlane.z
+		const float invArea = 1.0f / (e[0].a * v0.x + e[0].b * v0.y + e[0].c);
+		vec3 zPlane;
+		zPlane.x = (e[0].a * v0.z + e[1].a * v1.z + e[2].a * v2.z) * invArea;
+		zPlane.y = (e[0].b * v0.z + e[1].b * v1.z + e[2].b * v2.z) * invArea;
+		zPlane.z = (e[0].c * v0.z + e[1].c * v1.z + e[2].c * v2.z) * invArea;
+
+		for (uint32_t y = y0; y < y1; y++) {
+			rasterizeRow(mDepth.get() + y * mWidth, x0, x1, float(y) + 0.5f, e, zPlane);
+		}
+	}
+
+	// Updates hierarchical depth, each tile stores its farthest depth
+	const uint32_t numTileCols = mWidth / TILE_WIDTH;
+	for (uint32_t ty = tileRowBegin; ty < tileRowEnd; ty++) {
+		for (uint32_t tx = 0; tx < numTileCols; tx++) {
+			float farthest = mDepth[ty * TILE_HEIGHT * mWidth + tx * TILE_WIDTH];
+			for (uint32_t y = ty * TILE_HEIGHT; y < (ty + 1) * TILE_HEIGHT; y++) {
+				const float* row = mDepth.get() + y * mWidth + tx * TILE_WIDTH;
+				for (uint32_t x = 0; x < TILE_WIDTH; x++) {
+					farthest = std::min(farthest, row[x]);
+				}
+			}
+			mTileDepth[ty * numTileCols + tx] = farthest;
+		}
+	}
+}
+
+bool OcclusionCuller::isVisible(const vec3* corners) const noexcept
+{
+	// Projects corners to find screen space bounding rectangle and nearest depth
+	float minX = float(mWidth), maxX = 0.0f, minY = float(mHeight), maxY = 0.0f;
+	float nearest = 0.0f;
+	for (uint32_t i = 0; i < 8; i++) {
+		vec4 clip = mViewProjMatrix * vec4{corners[i], 1.0f};
+
+		// Occludees intersecting the near plane are always considered visible
+		if (clip.w < mNear) return true;
+
+		float invW = 1.0f / clip.w;
+		float x = (clip.x * invW * 0.5f + 0.5f) * float(mWidth);
+		float y = (clip.y * invW * 0.5f + 0.5f) * float(mHeight);
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		nearest = std::max(nearest, invW);
+	}
+
+	// Clamps rectangle to screen, outside screen means not visible (by this test)
+	minX = std::max(minX, 0.0f);
+	maxX = std::min(maxX, float(mWidth));
+	minY = std::max(minY, 0.0f);
+	maxY = std::min(maxY, float(mHeight));
+	if (minX >= maxX || minY >= maxY) return false;
+
+	const uint32_t x0 = uint32_t(minX), x1 = std::min(uint32_t(std::ceil(maxX)), mWidth);
+	const uint32_t y0 = uint32_t(minY), y1 = std::min(uint32_t(std::ceil(maxY)), mHeight);
+
+	// Hierarchical test, only tiles where some occluder is farther away than the occludee need
+	// to be tested per pixel
+	const uint32_t numTileCols = mWidth / TILE_WIDTH;
+	for (uint32_t ty = y0 / TILE_HEIGHT; ty <= (y1 - 1) / TILE_HEIGHT; ty++) {
+		for (uint32_t tx = x0 / TILE_WIDTH; tx <= (x1 - 1) / TILE_WIDTH; tx++) {
+			if (mTileDepth[ty * numTileCols + tx] > nearest) continue;
+
+			uint32_t py0 = std::max(y0, ty * TILE_HEIGHT);
+			uint32_t py1 = std::min(y1, (ty + 1) * TILE_HEIGHT);
+			uint32_t px0 = std::max(x0, tx * TILE_WIDTH);
+			uint32_t px1 = std::min(x1, (tx + 1) * TILE_WIDTH);
+			for (uint32_t y = py0; y < py1; y++) {
+				const float* row = mDepth.get() + y * mWidth;
+				for (uint32_t x = px0; x < px1; x++) {
+					if (row[x] <= nearest) return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+} // namespace sfz
\ No newline at end of file
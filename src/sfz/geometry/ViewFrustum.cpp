@@ -1,24 +1,49 @@
 #include "sfz/geometry/ViewFrustum.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include <sfz/geometry/AABB.hpp>
 #include <sfz/geometry/Intersection.hpp>
 #include <sfz/geometry/OBB.hpp>
 #include <sfz/geometry/Sphere.hpp>
+#include <sfz/math/MathConstants.hpp>
+#include <sfz/math/MatrixSupport.hpp>
 
 namespace sfz {
 
-// Statiics
+// Dirty flags
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const uint32_t DIRTY_VIEW_MATRIX = 1u << 0;
+static const uint32_t DIRTY_PROJ_MATRIX = 1u << 1;
+static const uint32_t DIRTY_VIEW_PROJ_MATRIX = 1u << 2;
+static const uint32_t DIRTY_SHAPE = 1u << 3; // tan of half fovs, bounding sphere dist & radius
+static const uint32_t DIRTY_PLANE_NORMALS = 1u << 4;
+static const uint32_t DIRTY_PLANES = 1u << 5;
+static const uint32_t DIRTY_CORNERS = 1u << 6; // Corners and bounding AABB
+static const uint32_t DIRTY_BOUNDING_SPHERE = 1u << 7;
+
+// Which derived data needs to be recalculated when a given parameter changes
+static const uint32_t DIRTY_ON_POS_CHANGE = DIRTY_VIEW_MATRIX | DIRTY_VIEW_PROJ_MATRIX |
+                                            DIRTY_PLANES | DIRTY_CORNERS | DIRTY_BOUNDING_SPHERE;
+static const uint32_t DIRTY_ON_DIR_CHANGE = DIRTY_ON_POS_CHANGE | DIRTY_PLANE_NORMALS;
+static const uint32_t DIRTY_ON_CLIP_CHANGE = DIRTY_PROJ_MATRIX | DIRTY_VIEW_PROJ_MATRIX | DIRTY_SHAPE |
+                                             DIRTY_PLANES | DIRTY_CORNERS | DIRTY_BOUNDING_SPHERE;
+static const uint32_t DIRTY_ON_FOV_CHANGE = DIRTY_ON_CLIP_CHANGE | DIRTY_PLANE_NORMALS;
+
+// Statics
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 static OBB obbApproximation(const ViewFrustum& frustum) noexcept
 {
-	using std::tanf;
 	const float yHalfRadAngle = (frustum.verticalFov() / 2.0f) * sfz::DEG_TO_RAD();
-	const float xHalfRadAngle = frustum.aspectRatio() * yHalfRadAngle;
+	const float tanHalfFovY = std::tan(yHalfRadAngle);
+	const float tanHalfFovX = frustum.aspectRatio() * tanHalfFovY;
 	const float nearMFar = frustum.far() - frustum.near();
 	return OBB{frustum.pos() + frustum.dir() * (frustum.near() + (nearMFar / 2.0f)),
 	           cross(frustum.up(), frustum.dir()), frustum.up(), frustum.dir(),
-	           frustum.far() * tanf(xHalfRadAngle) * 2.0f, frustum.far() * tanf(yHalfRadAngle) * 2.0f, nearMFar};
+	           frustum.far() * tanHalfFovX * 2.0f, frustum.far() * tanHalfFovY * 2.0f, nearMFar};
 }
 
 // ViewFrustum: Constructors & destructors
@@ -35,6 +60,7 @@ ViewFrustum::ViewFrustum(vec3 position, vec3 direction, vec3 up, float verticalF
 
 bool ViewFrustum::isVisible(const AABB& aabb) const noexcept
 {
+	if (!intersects(mBoundingAABB, aabb)) return false;
 	if (!(belowPlane(mLeftPlane, aabb) && belowPlane(mRightPlane, aabb))) return false;
 	if (!(belowPlane(mNearPlane, aabb) && belowPlane(mFarPlane, aabb))) return false;
 	if (!(belowPlane(mUpPlane, aabb) && belowPlane(mDownPlane, aabb))) return false;
@@ -51,6 +77,7 @@ bool ViewFrustum::isVisible(const OBB& obb) const noexcept
 
 bool ViewFrustum::isVisible(const Sphere& sphere) const noexcept
 {
+	if (!intersects(mBoundingSphere, sphere)) return false;
 	if (!(belowPlane(mLeftPlane, sphere) && belowPlane(mRightPlane, sphere))) return false;
 	if (!(belowPlane(mNearPlane, sphere) && belowPlane(mFarPlane, sphere))) return false;
 	if (!(belowPlane(mUpPlane, sphere) && belowPlane(mDownPlane, sphere))) return false;
@@ -59,64 +86,76 @@ bool ViewFrustum::isVisible(const Sphere& sphere) const noexcept
 
 bool ViewFrustum::isVisible(const ViewFrustum& viewFrustum) const noexcept
 {
+	if (!intersects(mBoundingSphere, viewFrustum.mBoundingSphere)) return false;
+
 	// TODO: This sucks. Replace with better algorithm.
 	OBB approx = obbApproximation(viewFrustum);
 	return this->isVisible(approx);
 }
 
+// ViewFrustum: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void ViewFrustum::planes(Plane planesOut[6]) const noexcept
+{
+	planesOut[0] = mNearPlane;
+	planesOut[1] = mFarPlane;
+	planesOut[2] = mUpPlane;
+	planesOut[3] = mDownPlane;
+	planesOut[4] = mLeftPlane;
+	planesOut[5] = mRightPlane;
+}
+
 // ViewFrustum: Setters
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 void ViewFrustum::setPos(vec3 position) noexcept
 {
-	mPos = position;
-	update();
+	this->set(position, mDir, mUp, mVerticalFovDeg, mAspectRatio, mNear, mFar);
 }
 
 void ViewFrustum::setVerticalFov(float verticalFovDeg) noexcept
 {
-	sfz_assert_debug(0.0f < verticalFovDeg && verticalFovDeg < 180.0f);
-	mVerticalFovDeg = verticalFovDeg;
-	update();
+	this->set(mPos, mDir, mUp, verticalFovDeg, mAspectRatio, mNear, mFar);
 }
 
 void ViewFrustum::setAspectRatio(float aspect) noexcept
 {
-	sfz_assert_debug(0.0f < aspect);
-	mAspectRatio = aspect;
-	update();
+	this->set(mPos, mDir, mUp, mVerticalFovDeg, aspect, mNear, mFar);
 }
 
 void ViewFrustum::setDir(vec3 direction, vec3 up) noexcept
 {
-	mDir = normalize(direction);
-	mUp = normalize(up - dot(up, mDir) * mDir);
-	sfz_assert_debug(approxEqual(dot(mDir, mUp), 0.0f));
-	update();
+	this->set(mPos, direction, up, mVerticalFovDeg, mAspectRatio, mNear, mFar);
 }
 
 void ViewFrustum::setClipDist(float near, float far) noexcept
 {
-	sfz_assert_debug(0.0f < near);
-	mNear = near;
-	sfz_assert_debug(near < far);
-	mFar = far;
+	this->set(mPos, mDir, mUp, mVerticalFovDeg, mAspectRatio, near, far);
 }
 
 void ViewFrustum::set(vec3 position, vec3 direction, vec3 up, float verticalFovDeg, float aspect,
                       float near, float far) noexcept
 {
-	mPos = position;
-	mDir = normalize(direction);
-	mUp = normalize(up - dot(up, mDir) * mDir);
-	sfz_assert_debug(approxEqual(dot(mDir, mUp), 0.0f));
+	const vec3 dir = normalize(direction);
+	const vec3 orthoUp = normalize(up - dot(up, dir) * dir);
+	sfz_assert_debug(approxEqual(dot(dir, orthoUp), 0.0f));
 	sfz_assert_debug(0.0f < verticalFovDeg && verticalFovDeg < 180.0f);
-	mVerticalFovDeg = verticalFovDeg;
 	sfz_assert_debug(0.0f < aspect);
-	mAspectRatio = aspect;
 	sfz_assert_debug(0.0f < near);
-	mNear = near;
 	sfz_assert_debug(near < far);
+
+	if (position != mPos) mDirtyFlags |= DIRTY_ON_POS_CHANGE;
+	if (dir != mDir || orthoUp != mUp) mDirtyFlags |= DIRTY_ON_DIR_CHANGE;
+	if (verticalFovDeg != mVerticalFovDeg || aspect != mAspectRatio) mDirtyFlags |= DIRTY_ON_FOV_CHANGE;
+	if (near != mNear || far != mFar) mDirtyFlags |= DIRTY_ON_CLIP_CHANGE;
+
+	mPos = position;
+	mDir = dir;
+	mUp = orthoUp;
+	mVerticalFovDeg = verticalFovDeg;
+	mAspectRatio = aspect;
+	mNear = near;
 	mFar = far;
 
 	update();
@@ -127,44 +166,90 @@ void ViewFrustum::set(vec3 position, vec3 direction, vec3 up, float verticalFovD
 
 void ViewFrustum::update() noexcept
 {
-	updateMatrices();
+	updateShape();
+	if ((mDirtyFlags & DIRTY_VIEW_MATRIX) != 0) {
+		mViewMatrix = lookAt(mPos, mPos + mDir, mUp);
+	}
+	if ((mDirtyFlags & DIRTY_PROJ_MATRIX) != 0) {
+		mProjMatrix = glPerspectiveProjectionMatrix(mVerticalFovDeg, mAspectRatio, mNear, mFar);
+	}
+	if ((mDirtyFlags & DIRTY_VIEW_PROJ_MATRIX) != 0) {
+		mViewProjMatrix = mProjMatrix * mViewMatrix;
+	}
 	updatePlanes();
+	updateCorners();
+	if ((mDirtyFlags & DIRTY_BOUNDING_SPHERE) != 0) {
+		mBoundingSphere = Sphere{mPos + mDir * mSphereDist, mSphereRadius};
+	}
+	mDirtyFlags = 0;
 }
 
-void ViewFrustum::updateMatrices() noexcept
+void ViewFrustum::updateShape() noexcept
 {
-	mViewMatrix = lookAt(mPos, mPos + mDir, mUp);
-	mProjMatrix = glPerspectiveProjectionMatrix(mVerticalFovDeg, mAspectRatio, mNear, mFar);
+	if ((mDirtyFlags & DIRTY_SHAPE) == 0) return;
+
+	// Same half extents as glPerspectiveProjectionMatrix()
+	mTanHalfFovY = std::tan((mVerticalFovDeg / 2.0f) * DEG_TO_RAD());
+	mTanHalfFovX = mAspectRatio * mTanHalfFovY;
+
+	// Smallest sphere containing both the near and far rectangle. The center lies on the view
+	// direction, at the point equidistant to the near and far corners (clamped to far plane).
+	const float k2 = mTanHalfFovX * mTanHalfFovX + mTanHalfFovY * mTanHalfFovY;
+	mSphereDist = std::min((mNear + mFar) * (1.0f + k2) / 2.0f, mFar);
+	const float distToFar = mFar - mSphereDist;
+	mSphereRadius = std::sqrt(distToFar * distToFar + mFar * mFar * k2);
 }
 
 void ViewFrustum::updatePlanes() noexcept
 {
-	const vec3 right = normalize(cross(mDir, mUp));
-	const float yHalfRadAngle = (mVerticalFovDeg/2.0f) * DEG_TO_RAD();
-	const float xHalfRadAngle = mAspectRatio * yHalfRadAngle;
-	
-	sfz_assert_debug(approxEqual(dot(mDir, mUp), 0.0f));
-	sfz_assert_debug(approxEqual(dot(mDir, right), 0.0f));
-	sfz_assert_debug(approxEqual(dot(mUp, right), 0.0f));
+	if ((mDirtyFlags & DIRTY_PLANES) == 0) return;
+
+	if ((mDirtyFlags & DIRTY_PLANE_NORMALS) != 0) {
+		mRight = normalize(cross(mDir, mUp));
+		sfz_assert_debug(approxEqual(dot(mDir, mUp), 0.0f));
+		sfz_assert_debug(approxEqual(dot(mDir, mRight), 0.0f));
+		sfz_assert_debug(approxEqual(dot(mUp, mRight), 0.0f));
+
+		// Outward facing normals of the side planes, perpendicular to the edge directions
+		// (mDir + tan * side) of the frustum.
+		mUpNormal = normalize(mUp - mTanHalfFovY * mDir);
+		mDownNormal = normalize(-mUp - mTanHalfFovY * mDir);
+		mRightNormal = normalize(mRight - mTanHalfFovX * mDir);
+		mLeftNormal = normalize(-mRight - mTanHalfFovX * mDir);
+	}
 
 	mNearPlane = Plane{-mDir, mPos + mDir*mNear};
 	mFarPlane = Plane{mDir, mPos + mDir*mFar};
-	
-	vec3 upPlaneDir = rotationMatrix3(right, yHalfRadAngle) * mDir;
-	vec3 upPlaneNormal = normalize(cross(upPlaneDir, -right));
-	mUpPlane = Plane{upPlaneNormal, mPos};
-
-	vec3 downPlaneDir = rotationMatrix3(-right, yHalfRadAngle) * mDir;
-	vec3 downPlaneNormal = normalize(cross(downPlaneDir, right));
-	mDownPlane = Plane{downPlaneNormal, mPos};
-
-	vec3 rightPlaneDir = rotationMatrix3(-mUp, xHalfRadAngle) * mDir;
-	vec3 rightPlaneNormal = normalize(cross(rightPlaneDir, mUp));
-	mRightPlane = Plane{rightPlaneNormal, mPos};
-
-	vec3 leftPlaneDir = rotationMatrix3(mUp, xHalfRadAngle) * mDir;
-	vec3 leftPlaneNormal = normalize(cross(leftPlaneDir, -mUp));
-	mLeftPlane = Plane{leftPlaneNormal, mPos};
+	mUpPlane = Plane{mUpNormal, mPos};
+	mDownPlane = Plane{mDownNormal, mPos};
+	mRightPlane = Plane{mRightNormal, mPos};
+	mLeftPlane = Plane{mLeftNormal, mPos};
+}
+
+void ViewFrustum::updateCorners() noexcept
+{
+	if ((mDirtyFlags & DIRTY_CORNERS) == 0) return;
+
+	const vec3 right = normalize(cross(mDir, mUp));
+	const float dists[2] = {mNear, mFar};
+	for (int i = 0; i < 2; i++) {
+		const vec3 center = mPos + mDir * dists[i];
+		const vec3 xOffs = right * (dists[i] * mTanHalfFovX);
+		const vec3 yOffs = mUp * (dists[i] * mTanHalfFovY);
+		mCorners[i*4 + 0] = center - xOffs - yOffs;
+		mCorners[i*4 + 1] = center + xOffs - yOffs;
+		mCorners[i*4 + 2] = center - xOffs + yOffs;
+		mCorners[i*4 + 3] = center + xOffs + yOffs;
+	}
+
+	vec3 min = mCorners[0], max = mCorners[0];
+	for (int i = 1; i < 8; i++) {
+		for (int j = 0; j < 3; j++) {
+			min[j] = std::min(min[j], mCorners[i][j]);
+			max[j] = std::max(max[j], mCorners[i][j]);
+		}
+	}
+	mBoundingAABB = AABB{min, max};
 }
 
 } // namespace sfz
\ No newline at end of file
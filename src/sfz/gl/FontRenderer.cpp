@@ -11,7 +11,8 @@
 #include "sfz/gl/OpenGL.hpp"
 #include "sfz/gl/GLUtils.hpp"
 
-#include "sfz/util/IO.hpp"
+#include "sfz/util/MappedFile.hpp"
+#include "sfz/util/Profiler.hpp"
 
 #include <cstdio>
 #include <cstdlib> // malloc
@@ -142,13 +143,15 @@ FontRenderer::FontRenderer(const char* fontPath, uint32_t texWidth, uint32_t tex
 
 	stbtt_PackSetOversampling(&packContext, 2, 2);
 
-	std::vector<uint8_t> ttfBuffer = sfz::readBinaryFile(fontPath);
-	if (ttfBuffer.size() == 0) {
+	// stb_truetype only reads the parts of the font it needs, so map instead of reading it all
+	sfz::MappedFile ttfFile{fontPath, sfz::FileAccessHint::RANDOM};
+	if (ttfFile.size() == 0) {
 		std::cerr << "Couldn't open TTF file at: " << fontPath << std::endl;
 		std::terminate();
 	}
 
-	if (stbtt_PackFontRange(&packContext, ttfBuffer.data(), 0, mFontSize, FIRST_CHAR, CHAR_COUNT,
+	uint8_t* ttfData = const_cast<uint8_t*>(ttfFile.data()); // stb_truetype never writes to it
+	if (stbtt_PackFontRange(&packContext, ttfData, 0, mFontSize, FIRST_CHAR, CHAR_COUNT,
 	                    reinterpret_cast<stbtt_packedchar*>(mPackedChars)) == 0) {
 		std::cerr << "FontRenderer: Couldn't pack font, texture likely too small." << std::endl;
 		std::terminate();
@@ -213,6 +216,7 @@ void FontRenderer::begin(vec2 cameraPosition, vec2 cameraDimensions) noexcept
 
 float FontRenderer::write(vec2 position, float size, const char* text) noexcept
 {
+	sfz_profile_function();
 	const float scale = size / mFontSize;
 
 	vec2 currPos = position;
@@ -254,7 +258,7 @@ void FontRenderer::end(uint32_t fbo, vec2 viewportDimensions, vec4 textColor) no
 void FontRenderer::end(uint32_t fbo, const AABB2D& viewport, vec4 textColor) noexcept
 {
 	glUseProgram(mSpriteBatch.shaderProgram().handle());
-	gl::setUniform(mSpriteBatch.shaderProgram(), "uTextColor", textColor);
+	gl::setUniform(mSpriteBatch.shaderProgram(), "uTextColor"_sid, textColor);
 	mSpriteBatch.end(fbo, viewport, mFontTexture);
 }
 
@@ -1,10 +1,12 @@
 #include "sfz/gl/Program.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <new>
 
 #include "sfz/gl/OpenGL.hpp"
+#include "sfz/util/Allocators.hpp"
 #include "sfz/util/IO.hpp"
 
 namespace gl {
@@ -91,6 +93,7 @@ Program Program::fromSource(const char* vertexSrc, const char* geometrySrc, cons
 	Program temp;
 	temp.mHandle = shaderProgram;
 	temp.mBindAttribFragFunc = bindAttribFragFunc;
+	temp.cacheUniformLocations();
 	return std::move(temp);
 }
 
@@ -134,6 +137,7 @@ Program Program::fromSource(const char* vertexSrc, const char* fragmentSrc,
 	Program temp;
 	temp.mHandle = shaderProgram;
 	temp.mBindAttribFragFunc = bindAttribFragFunc;
+	temp.cacheUniformLocations();
 	return temp;
 }
 
@@ -203,6 +207,7 @@ bool Program::reload() noexcept
 		tmp.mIsPostProcess = true;
 		tmp.mWasReloaded = true;
 		*this = std::move(tmp);
+		this->swapWatch(tmp); // Keep watching
 		return true;
 	}
 	else if ((vertexSrc.size() > 0) && (geometrySrc.size() > 0) && (fragmentSrc.size() > 0)) {
@@ -216,6 +221,7 @@ bool Program::reload() noexcept
 		tmp.mBindAttribFragFunc = this->mBindAttribFragFunc;
 		tmp.mWasReloaded = true;
 		*this = std::move(tmp);
+		this->swapWatch(tmp); // Keep watching
 		return true;
 	}
 	else if ((vertexSrc.size() > 0) && (fragmentSrc.size() > 0)) {
@@ -227,12 +233,45 @@ bool Program::reload() noexcept
 		tmp.mBindAttribFragFunc = this->mBindAttribFragFunc;
 		tmp.mWasReloaded = true;
 		*this = std::move(tmp);
+		this->swapWatch(tmp); // Keep watching
 		return true;
 	}
 
 	return false;
 }
 
+void Program::watchFiles(sfz::FileWatcher& watcher) noexcept
+{
+	this->stopWatching();
+	std::vector<string> paths;
+	for (const string* path : {&mVertexPath, &mGeometryPath, &mFragmentPath}) {
+		if (!path->empty()) paths.push_back(*path);
+	}
+	if (paths.empty()) return;
+
+	mWatchTarget = std::make_shared<Program*>(this);
+	std::shared_ptr<Program*> target = mWatchTarget;
+	mWatchId = watcher.watch(paths, [target](const std::vector<string>&) {
+		if (*target != nullptr) (*target)->reload();
+	});
+	mWatcher = &watcher;
+}
+
+int Program::uniformLocation(StringID name) const noexcept
+{
+	const int* location = mUniformLocations.get(name);
+	return location != nullptr ? *location : -1;
+}
+
+void Program::stopWatching() noexcept
+{
+	if (mWatcher == nullptr) return;
+	mWatcher->unwatch(mWatchId);
+	*mWatchTarget = nullptr;
+	mWatcher = nullptr;
+	mWatchId = sfz::FileWatcher::INVALID_ID;
+	mWatchTarget = nullptr;
+}
 
 // Program: Constructors & destructors
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -246,6 +285,8 @@ Program::Program(Program&& other) noexcept
 	std::swap(this->mIsPostProcess, other.mIsPostProcess);
 	std::swap(this->mWasReloaded, other.mWasReloaded);
 	std::swap(this->mBindAttribFragFunc, other.mBindAttribFragFunc);
+	std::swap(this->mUniformLocations, other.mUniformLocations);
+	this->swapWatch(other);
 }
 
 Program& Program::operator= (Program&& other) noexcept
@@ -257,14 +298,55 @@ Program& Program::operator= (Program&& other) noexcept
 	std::swap(this->mIsPostProcess, other.mIsPostProcess);
 	std::swap(this->mWasReloaded, other.mWasReloaded);
 	std::swap(this->mBindAttribFragFunc, other.mBindAttribFragFunc);
+	std::swap(this->mUniformLocations, other.mUniformLocations);
+	this->swapWatch(other);
 	return *this;
 }
 
 Program::~Program() noexcept
 {
+	this->stopWatching();
 	glDeleteProgram(mHandle); // Silently ignored if mHandle == 0.
 }
 
+// Program: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void Program::swapWatch(Program& other) noexcept
+{
+	std::swap(this->mWatcher, other.mWatcher);
+	std::swap(this->mWatchId, other.mWatchId);
+	std::swap(this->mWatchTarget, other.mWatchTarget);
+	if (this->mWatchTarget != nullptr) *this->mWatchTarget = this;
+	if (other.mWatchTarget != nullptr) *other.mWatchTarget = &other;
+}
+
+void Program::cacheUniformLocations() noexcept
+{
+	mUniformLocations.clear();
+	int numUniforms = 0, maxNameLength = 0;
+	glGetProgramiv(mHandle, GL_ACTIVE_UNIFORMS, &numUniforms);
+	glGetProgramiv(mHandle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	if (numUniforms <= 0 || maxNameLength <= 0) return;
+
+	sfz::ScratchScope scratch;
+	char* name = scratch.allocateArray<char>(size_t(maxNameLength));
+	for (int i = 0; i < numUniforms; i++) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(mHandle, GLuint(i), maxNameLength, &length, &size, &type, name);
+		int location = glGetUniformLocation(mHandle, name);
+		if (location < 0) continue; // Uniform block members do not have a location
+
+		// Names are interned so that internedString() can be used when debugging
+		mUniformLocations.put(sfz::internString(name, size_t(length)), location);
+		if (length > 3 && std::strcmp(name + length - 3, "[0]") == 0) {
+			mUniformLocations.put(sfz::internString(name, size_t(length - 3)), location);
+		}
+	}
+}
+
 // Program compilation & linking helper functions
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -326,6 +408,11 @@ void setUniform(const Program& program, const char* name, int i) noexcept
 	setUniform(loc, i);
 }
 
+void setUniform(const Program& program, StringID name, int i) noexcept
+{
+	setUniform(program.uniformLocation(name), i);
+}
+
 void setUniform(int location, const int* intArray, size_t count) noexcept
 {
 	glUniform1iv(location, count, intArray);
@@ -337,6 +424,11 @@ void setUniform(const Program& program, const char* name, const int* intArray, s
 	setUniform(loc, intArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const int* intArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), intArray, count);
+}
+
 // Uniform setters: uint
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -351,6 +443,11 @@ void setUniform(const Program& program, const char* name, uint32_t u) noexcept
 	setUniform(loc, u);
 }
 
+void setUniform(const Program& program, StringID name, uint32_t u) noexcept
+{
+	setUniform(program.uniformLocation(name), u);
+}
+
 void setUniform(int location, const uint32_t* uintArray, size_t count) noexcept
 {
 	glUniform1uiv(location, count, uintArray);
@@ -362,6 +459,11 @@ void setUniform(const Program& program, const char* name, const uint32_t* uintAr
 	setUniform(loc, uintArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const uint32_t* uintArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), uintArray, count);
+}
+
 // Uniform setters: float
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -376,6 +478,11 @@ void setUniform(const Program& program, const char* name, float f) noexcept
 	setUniform(loc, f);
 }
 
+void setUniform(const Program& program, StringID name, float f) noexcept
+{
+	setUniform(program.uniformLocation(name), f);
+}
+
 void setUniform(int location, const float* floatArray, size_t count) noexcept
 {
 	glUniform1fv(location, count, floatArray);
@@ -387,6 +494,11 @@ void setUniform(const Program& program, const char* name, const float* floatArra
 	setUniform(loc, floatArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const float* floatArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), floatArray, count);
+}
+
 // Uniform setters: vec2
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -401,6 +513,11 @@ void setUniform(const Program& program, const char* name, vec2 vector) noexcept
 	setUniform(loc, vector);
 }
 
+void setUniform(const Program& program, StringID name, vec2 vector) noexcept
+{
+	setUniform(program.uniformLocation(name), vector);
+}
+
 void setUniform(int location, const vec2* vectorArray, size_t count) noexcept
 {
 	static_assert(sizeof(vec2) == sizeof(float)*2, "vec2 is padded");
@@ -413,6 +530,11 @@ void setUniform(const Program& program, const char* name, const vec2* vectorArra
 	setUniform(loc, vectorArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const vec2* vectorArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), vectorArray, count);
+}
+
 // Uniform setters: vec3
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -427,6 +549,11 @@ void setUniform(const Program& program, const char* name, const vec3& vector) no
 	setUniform(loc, vector);
 }
 
+void setUniform(const Program& program, StringID name, const vec3& vector) noexcept
+{
+	setUniform(program.uniformLocation(name), vector);
+}
+
 void setUniform(int location, const vec3* vectorArray, size_t count) noexcept
 {
 	static_assert(sizeof(vec3) == sizeof(float)*3, "vec3 is padded");
@@ -439,6 +566,11 @@ void setUniform(const Program& program, const char* name, const vec3* vectorArra
 	setUniform(loc, vectorArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const vec3* vectorArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), vectorArray, count);
+}
+
 // Uniform setters: vec4
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -453,6 +585,11 @@ void setUniform(const Program& program, const char* name, const vec4& vector) no
 	setUniform(loc, vector);
 }
 
+void setUniform(const Program& program, StringID name, const vec4& vector) noexcept
+{
+	setUniform(program.uniformLocation(name), vector);
+}
+
 void setUniform(int location, const vec4* vectorArray, size_t count) noexcept
 {
 	static_assert(sizeof(vec4) == sizeof(float)*4, "vec4 is padded");
@@ -465,6 +602,11 @@ void setUniform(const Program& program, const char* name, const vec4* vectorArra
 	setUniform(loc, vectorArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const vec4* vectorArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), vectorArray, count);
+}
+
 // Uniform setters: mat3
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -479,6 +621,11 @@ void setUniform(const Program& program, const char* name, const mat3& matrix) no
 	setUniform(loc, matrix);
 }
 
+void setUniform(const Program& program, StringID name, const mat3& matrix) noexcept
+{
+	setUniform(program.uniformLocation(name), matrix);
+}
+
 void setUniform(int location, const mat3* matrixArray, size_t count) noexcept
 {
 	static_assert(sizeof(mat3) == sizeof(float)*9, "mat3 is padded");
@@ -491,6 +638,11 @@ void setUniform(const Program& program, const char* name, const mat3* matrixArra
 	setUniform(loc, matrixArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const mat3* matrixArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), matrixArray, count);
+}
+
 // Uniform setters: mat4
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -505,6 +657,11 @@ void setUniform(const Program& program, const char* name, const mat4& matrix) no
 	setUniform(loc, matrix);
 }
 
+void setUniform(const Program& program, StringID name, const mat4& matrix) noexcept
+{
+	setUniform(program.uniformLocation(name), matrix);
+}
+
 void setUniform(int location, const mat4* matrixArray, size_t count) noexcept
 {
 	static_assert(sizeof(mat4) == sizeof(float)*16, "mat4 is padded");
@@ -517,4 +674,9 @@ void setUniform(const Program& program, const char* name, const mat4* matrixArra
 	setUniform(loc, matrixArray, count);
 }
 
+void setUniform(const Program& program, StringID name, const mat4* matrixArray, size_t count) noexcept
+{
+	setUniform(program.uniformLocation(name), matrixArray, count);
+}
+
 } // namespace gl
\ No newline at end of file
@@ -219,24 +219,24 @@ uint32_t SSAO::calculate(uint32_t linearDepthTex, uint32_t normalTex, const mat4
 	// Texture buffer uniforms
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, linearDepthTex);
-	gl::setUniform(mSSAOProgram, "uLinearDepthTexture", 0);
+	gl::setUniform(mSSAOProgram, "uLinearDepthTexture"_sid, 0);
 
 	glActiveTexture(GL_TEXTURE1);
 	glBindTexture(GL_TEXTURE_2D, normalTex);
-	gl::setUniform(mSSAOProgram, "uNormalTexture", 1);
+	gl::setUniform(mSSAOProgram, "uNormalTexture"_sid, 1);
 
 	// Other uniforms
-	gl::setUniform(mSSAOProgram, "uProjMatrix", projMatrix);
-	gl::setUniform(mSSAOProgram, "uInvProjMatrix", inverse(projMatrix));
-	gl::setUniform(mSSAOProgram, "uFarPlaneDist", farPlaneDist);
+	gl::setUniform(mSSAOProgram, "uProjMatrix"_sid, projMatrix);
+	gl::setUniform(mSSAOProgram, "uInvProjMatrix"_sid, inverse(projMatrix));
+	gl::setUniform(mSSAOProgram, "uFarPlaneDist"_sid, farPlaneDist);
 
-	gl::setUniform(mSSAOProgram, "uDimensions", vec2{(float)mDimensions.x, (float)mDimensions.y});
-	gl::setUniform(mSSAOProgram, "uRadius", mRadius);
-	gl::setUniform(mSSAOProgram, "uOcclusionPower", mOcclusionPower);
+	gl::setUniform(mSSAOProgram, "uDimensions"_sid, vec2{(float)mDimensions.x, (float)mDimensions.y});
+	gl::setUniform(mSSAOProgram, "uRadius"_sid, mRadius);
+	gl::setUniform(mSSAOProgram, "uOcclusionPower"_sid, mOcclusionPower);
 
-	gl::setUniform(mSSAOProgram, "uKernelSize", (int32_t)mKernelSize);
-	gl::setUniform(mSSAOProgram, "uKernel", mKernel.get(), mKernelSize);
-	gl::setUniform(mSSAOProgram, "uNoise", mNoise.get(), 16);
+	gl::setUniform(mSSAOProgram, "uKernelSize"_sid, (int32_t)mKernelSize);
+	gl::setUniform(mSSAOProgram, "uKernel"_sid, mKernel.get(), mKernelSize);
+	gl::setUniform(mSSAOProgram, "uNoise"_sid, mNoise.get(), 16);
 	
 	mPostProcessQuad.render();
 
@@ -251,8 +251,8 @@ uint32_t SSAO::calculate(uint32_t linearDepthTex, uint32_t normalTex, const mat4
 
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, mOcclusionFBO.texture(0));
-		gl::setUniform(mHorizontalBlurProgram, "uTexture", 0);
-		gl::setUniform(mHorizontalBlurProgram, "uTexelWidth", 1.0f / mDimensions.x);
+		gl::setUniform(mHorizontalBlurProgram, "uTexture"_sid, 0);
+		gl::setUniform(mHorizontalBlurProgram, "uTexelWidth"_sid, 1.0f / mDimensions.x);
 
 		mPostProcessQuad.render();
 
@@ -266,8 +266,8 @@ uint32_t SSAO::calculate(uint32_t linearDepthTex, uint32_t normalTex, const mat4
 
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, mTempFBO.texture(0));
-		gl::setUniform(mVerticalBlurProgram, "uTexture", 0);
-		gl::setUniform(mVerticalBlurProgram, "uTexelHeight", 1.0f / mDimensions.y);
+		gl::setUniform(mVerticalBlurProgram, "uTexture"_sid, 0);
+		gl::setUniform(mVerticalBlurProgram, "uTexelHeight"_sid, 1.0f / mDimensions.y);
 
 		mPostProcessQuad.render();
 	}
@@ -439,11 +439,11 @@ void Scaler::scale(uint32_t dstFBO, const AABB2D& dstViewport, uint32_t srcTex,
 	// Bind src texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, srcTex);
-	gl::setUniform(mProgram, "uSrcTex", 0);
+	gl::setUniform(mProgram, "uSrcTex"_sid, 0);
 	glBindSampler(0, mSamplerObject);
 
-	gl::setUniform(mProgram, "uDstDimensions", dstViewport.dimensions());
-	gl::setUniform(mProgram, "uSrcDimensions", srcDimensions);
+	gl::setUniform(mProgram, "uDstDimensions"_sid, dstViewport.dimensions());
+	gl::setUniform(mProgram, "uSrcDimensions"_sid, srcDimensions);
 
 	mQuad.render();
 
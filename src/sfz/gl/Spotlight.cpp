@@ -45,7 +45,7 @@ mat4 Spotlight::lightMatrix(const mat4& inverseViewMatrix) const noexcept
 {
 	static const mat4 translScale = sfz::translationMatrix(0.5f, 0.5f, 0.5f)
 	                              * sfz::scalingMatrix4(0.5f);
-	return translScale * mViewFrustum.projMatrix() * mViewFrustum.viewMatrix() * inverseViewMatrix;
+	return translScale * mViewFrustum.viewProjMatrix() * inverseViewMatrix;
 }
 
 void Spotlight::renderViewFrustum() noexcept
@@ -2,8 +2,8 @@
 
 #include "sfz/Assert.hpp"
 #include "sfz/gl/OpenGL.hpp"
+#include "sfz/util/Profiler.hpp"
 
-#include <new> // std::nothrow
 #include <algorithm> // std::swap
 #include <cmath>
 
@@ -84,8 +84,8 @@ SpriteBatch::SpriteBatch(size_t capacity, const char* fragmentShaderSrc) noexcep
 :
 	mCapacity{capacity},
 	mCurrentDrawCount{0},
-	mTransformArray{new (std::nothrow) mat3[mCapacity]},
-	mUVArray{new (std::nothrow) vec4[mCapacity]}
+	mTransformArray{sfz::makeTaggedArray<mat3>(sfz::MemoryTag::GRAPHICS, mCapacity)},
+	mUVArray{sfz::makeTaggedArray<vec4>(sfz::MemoryTag::GRAPHICS, mCapacity)}
 {
 	static_assert(sizeof(vec2) == sizeof(float)*2, "vec2 is padded");
 	static_assert(sizeof(mat3) == sizeof(float)*9, "mat3 is padded");
@@ -242,6 +242,7 @@ void SpriteBatch::end(uint32_t fbo, vec2 viewportDimensions, uint32_t texture) n
 
 void SpriteBatch::end(uint32_t fbo, const AABB2D& viewport, uint32_t texture) noexcept
 {
+	sfz_profile_function();
 	sfz_assert_debug(mCurrentDrawCount <= mCapacity);
 
 	// Get old values
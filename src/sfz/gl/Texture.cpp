@@ -8,11 +8,12 @@
 
 #include "sfz/Assert.hpp"
 #include "sfz/gl/OpenGL.hpp"
+#include "sfz/util/Allocators.hpp"
+#include "sfz/util/MappedFile.hpp"
 
 #include <algorithm> // std::swap
 #include <cstring> // std::memcpy
 #include <iostream>
-#include <new>
 
 namespace gl {
 
@@ -23,7 +24,8 @@ static void flipImage(uint8_t* const pixels, int w, int h, int pitch, int numCha
 {
 	const int bytesPerRow = w*numChannels;
 	const int bytePitch = pitch*numChannels;
-	uint8_t* const buffer = new (std::nothrow) uint8_t[bytesPerRow];
+	sfz::ScratchScope scratch;
+	uint8_t* const buffer = scratch.allocateArray<uint8_t>(size_t(bytesPerRow));
 
 	for (int i = 0; i < (h/2); ++i) {
 		uint8_t* begin = pixels + i*bytePitch;
@@ -33,8 +35,6 @@ static void flipImage(uint8_t* const pixels, int w, int h, int pitch, int numCha
 		std::memcpy(begin, end, bytesPerRow);
 		std::memcpy(end, buffer, bytesPerRow);
 	}
-
-	delete[] buffer;
 }
 
 static float anisotropicFactor(TextureFiltering filtering) noexcept
@@ -52,9 +52,15 @@ static float anisotropicFactor(TextureFiltering filtering) noexcept
 
 static GLuint loadTexture(const char* path, int numChannelsWanted, TextureFiltering filtering, AABB2D& dims) noexcept
 {
-	// Loading image
+	// Loading image, decoded directly from the mapped file
+	sfz::MappedFile file{path, sfz::FileAccessHint::SEQUENTIAL};
+	if (!file.isValid()) {
+		std::cerr << "Unable to open image at: " << path << std::endl;
+		return 0;
+	}
 	int width, height, numChannels;
-	uint8_t* img = stbi_load(path, &width, &height, &numChannels, numChannelsWanted);
+	uint8_t* img = stbi_load_from_memory(file.data(), int(file.size()), &width, &height,
+	                                     &numChannels, numChannelsWanted);
 
 	// Some error checking
 	if (img == NULL) {		
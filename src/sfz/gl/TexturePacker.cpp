@@ -1,6 +1,5 @@
 #include "sfz/gl/TexturePacker.hpp"
 
-#include <new> // std::nothrow
 #include <cstring> // std::memcpy
 #include <iostream>
 #include <exception> // std::terminate
@@ -18,6 +17,9 @@
 
 #include "sfz/Assert.hpp"
 #include "sfz/gl/GLUtils.hpp"
+#include "sfz/util/Allocators.hpp"
+#include "sfz/util/MappedFile.hpp"
+#include "sfz/util/MemoryTracking.hpp"
 #include "sfz/gl/OpenGL.hpp"
 #include "sfz/math/vector.hpp"
 
@@ -32,7 +34,8 @@ static void flipImage(uint8_t* const pixels, int w, int h, int pitch, int numCha
 {
 	const int bytesPerRow = w*numChannels;
 	const int bytePitch = pitch*numChannels;
-	uint8_t* const buffer = new (std::nothrow) uint8_t[bytesPerRow];
+	sfz::ScratchScope scratch;
+	uint8_t* const buffer = scratch.allocateArray<uint8_t>(size_t(bytesPerRow));
 
 	for (int i = 0; i < (h/2); ++i) {
 		uint8_t* begin = pixels + i*bytePitch;
@@ -42,8 +45,6 @@ static void flipImage(uint8_t* const pixels, int w, int h, int pitch, int numCha
 		std::memcpy(begin, end, bytesPerRow);
 		std::memcpy(end, buffer, bytesPerRow);
 	}
-
-	delete[] buffer;
 }
 
 static float anisotropicFactor(TextureFiltering filtering) noexcept
@@ -61,9 +62,15 @@ static float anisotropicFactor(TextureFiltering filtering) noexcept
 
 static SDL_Surface* loadTexture(const string& path) noexcept
 {
-	// Loading image
+	// Loading image, decoded directly from the mapped file
+	sfz::MappedFile file{path.c_str(), sfz::FileAccessHint::SEQUENTIAL};
+	if (!file.isValid()) {
+		std::cerr << "Unable to open image at: " << path << std::endl;
+		std::terminate();
+	}
 	int width, height, numChannels;
-	uint8_t* data = stbi_load(path.c_str(), &width, &height, &numChannels, 4);
+	uint8_t* data = stbi_load_from_memory(file.data(), int(file.size()), &width, &height,
+	                                      &numChannels, 4);
 
 	// Some error checking
 	if (data == NULL) {		
@@ -76,6 +83,7 @@ static SDL_Surface* loadTexture(const string& path) noexcept
 		std::cerr << "Number of channels in image not equal to 4 at: " << path << std::endl;
 		std::terminate();
 	}
+	sfz::trackAllocation(sfz::MemoryTag::TEXTURES, size_t(width) * size_t(height) * 4);
 
 	// Flips image so UV coordinates will be in a right-handed system in OpenGL.
 	flipImage(data, width, height, width, numChannels);
@@ -106,13 +114,13 @@ static SDL_Surface* loadTexture(const string& path) noexcept
 	return surface;
 }
 
-static bool packRects(vector<stbrp_rect>& rects, int width, int height) noexcept
+static bool packRects(sfz::LinearVector<stbrp_rect>& rects, int width, int height) noexcept
 {
+	sfz::ScratchScope scratch;
 	stbrp_context packContext;
-	stbrp_node* nodes = new (std::nothrow) stbrp_node[width+2];
+	stbrp_node* nodes = scratch.allocateArray<stbrp_node>(size_t(width+2));
 	stbrp_init_target(&packContext, width, height, nodes, width);
 	stbrp_pack_rects(&packContext, rects.data(), rects.size());
-	delete[] nodes;
 	
 	// Check if all rects were packed
 	for (auto& rect : rects) {
@@ -134,9 +142,12 @@ TexturePacker::TexturePacker(const string& dirPath, const vector<string>& filena
 {
 	size_t size = filenames.size();
 
-	// Loads surfaces and creates rects for packing
-	vector<SDL_Surface*> surfaces;
-	vector<stbrp_rect> rects;
+	// Loads surfaces and creates rects for packing, temporary arrays are allocated from scratch
+	sfz::ScratchScope scratch;
+	sfz::LinearVector<SDL_Surface*> surfaces(scratch.allocator());
+	sfz::LinearVector<stbrp_rect> rects(scratch.allocator());
+	surfaces.reserve(size);
+	rects.reserve(size);
 	for (auto& filename : filenames) {
 		surfaces.emplace_back(loadTexture(dirPath + filename));
 		struct stbrp_rect r;
@@ -169,9 +180,11 @@ TexturePacker::TexturePacker(const string& dirPath, const vector<string>& filena
 	SDL_Surface* surface = SDL_CreateRGBSurface(0, mWidth, mHeight, 32, rmask, gmask, bmask, amask);
 	SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
 	SDL_FillRect(surface, NULL, 0);
+	sfz::trackAllocation(sfz::MemoryTag::TEXTURES, size_t(surface->pitch) * size_t(surface->h));
 
 	// Blitting individual surfaces to common surface and calculating TextureRegions
 	vec2 texDimInv{1.0f/(float)mWidth, 1.0f/(float)mHeight};
+	mTextureRegionMap.reserve(size);
 	for (size_t i = 0; i < size; ++i) {
 		SDL_Rect dstRect;
 		dstRect.w = surfaces[i]->w - 2*padding;
@@ -185,12 +198,15 @@ TexturePacker::TexturePacker(const string& dirPath, const vector<string>& filena
 		const vec2 offset{0.35f, 0.35f}; // Small hack to fix pixel imprecision
 		vec2 min = (vec2{(float)(dstRect.x + padding), (float)(dstRect.y + padding)} - offset) * texDimInv;
 		vec2 max = (vec2{(float)(dstRect.x + dstRect.w - padding), (float)(dstRect.y + dstRect.h - padding)} + offset) * texDimInv;
-		mTextureRegionMap[filenames[i]] = TextureRegion{min, max};
+		const string& filename = filenames[i];
+		mTextureRegionMap.put(sfz::internString(filename.c_str(), filename.size()),
+		                      TextureRegion{min, max});
 	}
 
 	// Cleaning up surfaces
 	for (SDL_Surface* surface : surfaces) {
 		uint8_t* data = (uint8_t*)surface->pixels;
+		sfz::trackDeallocation(sfz::MemoryTag::TEXTURES, size_t(surface->w) * size_t(surface->h) * 4);
 		SDL_FreeSurface(surface);
 		stbi_image_free(data);
 	}
@@ -217,6 +233,7 @@ TexturePacker::TexturePacker(const string& dirPath, const vector<string>& filena
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
 		break;
 	}
+	sfz::trackDeallocation(sfz::MemoryTag::TEXTURES, size_t(surface->pitch) * size_t(surface->h));
 	SDL_FreeSurface(surface);
 
 	// Sets specified texture filtering, generating mipmaps if needed.
@@ -258,9 +275,12 @@ TexturePacker::~TexturePacker() noexcept
 
 const TextureRegion* TexturePacker::textureRegion(const string& filename) const noexcept
 {
-	auto it = mTextureRegionMap.find(filename);
-	if (it == mTextureRegionMap.end()) return nullptr;
-	return &it->second;
+	return mTextureRegionMap.get(StringID(filename.c_str(), filename.size()));
+}
+
+const TextureRegion* TexturePacker::textureRegion(StringID filename) const noexcept
+{
+	return mTextureRegionMap.get(filename);
 }
 
 } // namespace sfz
\ No newline at end of file
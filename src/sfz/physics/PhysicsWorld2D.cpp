@@ -0,0 +1,723 @@
+#include "sfz/physics/PhysicsWorld2D.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility> // std::swap
+
+#include "sfz/Assert.hpp"
+
+namespace sfz {
+
+// Static constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Allowed penetration before position correction kicks in, avoids jitter in resting contacts
+static const float PENETRATION_SLOP = 0.005f;
+
+// Fraction of the penetration corrected each step (Baumgarte stabilization)
+static const float BAUMGARTE = 0.2f;
+
+// Relative normal velocity required for restitution to be applied
+static const float RESTITUTION_THRESHOLD = 1.0f;
+
+// A body slower than this for TIME_TO_SLEEP seconds is considered still
+static const float SLEEP_VELOCITY = 0.05f;
+static const float TIME_TO_SLEEP = 0.5f;
+
+// Islands are only solved in parallel if there are enough contacts to make it worth it
+static const uint32_t PARALLEL_CONTACTS_THRESHOLD = 256;
+
+// Number of islands claimed at a time by each thread when solving in parallel
+static const uint32_t ISLAND_BATCH_SIZE = 16;
+
+// PhysicsWorld2D: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const uint32_t PhysicsWorld2D::NO_BODY;
+const uint32_t PhysicsWorld2D::MAX_STEPS_PER_UPDATE;
+
+// Static functions
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static float signOf(float value) noexcept
+{
+	return value < 0.0f ? -1.0f : 1.0f;
+}
+
+// All narrowphase functions return the normal pointing from the first to the second shape
+
+static bool circleVsCircle(vec2 posA, float radiusA, vec2 posB, float radiusB,
+                           vec2& normalOut, float& penetrationOut) noexcept
+{
+	const vec2 diff = posB - posA;
+	const float radiusSum = radiusA + radiusB;
+	const float distSquared = squaredLength(diff);
+	if (distSquared >= (radiusSum * radiusSum)) return false;
+
+	const float dist = std::sqrt(distSquared);
+	normalOut = dist > 0.0f ? (diff / dist) : vec2{0.0f, 1.0f};
+	penetrationOut = radiusSum - dist;
+	return true;
+}
+
+static bool boxVsBox(vec2 posA, vec2 halfExtA, vec2 posB, vec2 halfExtB,
+                     vec2& normalOut, float& penetrationOut) noexcept
+{
+	const vec2 diff = posB - posA;
+	const float overlapX = (halfExtA.x + halfExtB.x) - std::abs(diff.x);
+	const float overlapY = (halfExtA.y + halfExtB.y) - std::abs(diff.y);
+	if (overlapX <= 0.0f || overlapY <= 0.0f) return false;
+
+	// Separate along the axis with least penetration
+	if (overlapX < overlapY) {
+		normalOut = vec2{signOf(diff.x), 0.0f};
+		penetrationOut = overlapX;
+	} else {
+		normalOut = vec2{0.0f, signOf(diff.y)};
+		penetrationOut = overlapY;
+	}
+	return true;
+}
+
+static bool circleVsBox(vec2 circlePos, float radius, vec2 boxPos, vec2 halfExt,
+                        vec2& normalOut, float& penetrationOut) noexcept
+{
+	const vec2 diff = circlePos - boxPos;
+	const vec2 clamped = sfz::max(sfz::min(diff, halfExt), -halfExt);
+
+	if (clamped == diff) {
+		// Circle center inside box, push out through the closest side
+		const float distX = halfExt.x - std::abs(diff.x);
+		const float distY = halfExt.y - std::abs(diff.y);
+		if (distX < distY) {
+			normalOut = vec2{-signOf(diff.x), 0.0f};
+			penetrationOut = radius + distX;
+		} else {
+			normalOut = vec2{0.0f, -signOf(diff.y)};
+			penetrationOut = radius + distY;
+		}
+		return true;
+	}
+
+	const vec2 boxToCircle = diff - clamped;
+	const float distSquared = squaredLength(boxToCircle);
+	if (distSquared >= (radius * radius)) return false;
+	const float dist = std::sqrt(distSquared);
+	normalOut = -boxToCircle / dist;
+	penetrationOut = radius - dist;
+	return true;
+}
+
+static bool contactLess(const Contact2D& lhs, const Contact2D& rhs) noexcept
+{
+	return lhs.bodyA < rhs.bodyA || (lhs.bodyA == rhs.bodyA && lhs.bodyB < rhs.bodyB);
+}
+
+// PhysicsWorld2D: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+PhysicsWorld2D::PhysicsWorld2D(uint32_t maxBodies, uint32_t maxContacts, uint32_t numThreads) noexcept
+:
+	mMaxBodies{maxBodies},
+	mMaxContacts{maxContacts != 0 ? maxContacts : 4 * maxBodies}
+{
+	sfz_assert_debug(maxBodies < NO_BODY);
+
+	mFlags.resize(mMaxBodies, 0);
+	mShapes.resize(mMaxBodies, BodyShape2D::CIRCLE);
+	mPositions.resize(mMaxBodies, vec2{0.0f});
+	mVelocities.resize(mMaxBodies, vec2{0.0f});
+	mForces.resize(mMaxBodies, vec2{0.0f});
+	mHalfExtents.resize(mMaxBodies, vec2{0.0f});
+	mBoundsMin.resize(mMaxBodies, vec2{0.0f});
+	mBoundsMax.resize(mMaxBodies, vec2{0.0f});
+	mInvMasses.resize(mMaxBodies, 0.0f);
+	mFrictions.resize(mMaxBodies, 0.0f);
+	mRestitutions.resize(mMaxBodies, 0.0f);
+	mSleepTimers.resize(mMaxBodies, 0.0f);
+
+	// Free list is popped from the back, so lowest indices are used first
+	mFreeList.resize(mMaxBodies);
+	for (uint32_t i = 0; i < mMaxBodies; i++) mFreeList[i] = mMaxBodies - i - 1;
+	mSortedBodies.reserve(mMaxBodies);
+
+	mContacts.resize(mMaxContacts);
+	mOldContacts.resize(mMaxContacts);
+
+	mIslandParents.resize(mMaxBodies);
+	mIslandIndices.resize(mMaxBodies);
+	mIslandNext.resize(mMaxBodies);
+	mIslandContactOffsets.resize(mMaxBodies + 1);
+	mIslandContacts.resize(mMaxContacts);
+	mIslandBodyOffsets.resize(mMaxBodies + 1);
+	mIslandBodies.resize(mMaxBodies);
+	mIslandCursors.resize(mMaxBodies);
+
+	if (numThreads == 0) numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	mWorkers.reserve(numThreads - 1);
+	for (uint32_t i = 1; i < numThreads; i++) {
+		mWorkers.emplace_back([this]() { this->workerMain(); });
+	}
+}
+
+PhysicsWorld2D::~PhysicsWorld2D() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(mWorkMutex);
+		mShutdown = true;
+	}
+	mWorkCondition.notify_all();
+	for (std::thread& worker : mWorkers) worker.join();
+}
+
+// PhysicsWorld2D: Bodies
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint32_t PhysicsWorld2D::addBody(const Circle& circle, float mass, float friction,
+                                 float restitution) noexcept
+{
+	return this->addBody(BodyShape2D::CIRCLE, circle.pos, vec2{circle.radius}, mass, friction,
+	                     restitution);
+}
+
+uint32_t PhysicsWorld2D::addBody(const AABB2D& box, float mass, float friction,
+                                 float restitution) noexcept
+{
+	return this->addBody(BodyShape2D::BOX, box.position(), box.dimensions() / 2.0f, mass, friction,
+	                     restitution);
+}
+
+void PhysicsWorld2D::removeBody(uint32_t body) noexcept
+{
+	sfz_assert_debug(body < mMaxBodies);
+	sfz_assert_debug(isValid(body));
+
+	// Make sure body is not part of a sleeping island's list, bodies resting on a static body
+	// must fall when it is removed
+	wakeBody(body);
+	if ((mFlags[body] & FLAG_STATIC) != 0) wakeOverlapping(body);
+
+	// Remove contacts involving the body, so they are not used for warm starting a new body
+	uint32_t numKept = 0;
+	for (uint32_t i = 0; i < mNumContacts; i++) {
+		if (mContacts[i].bodyA == body || mContacts[i].bodyB == body) continue;
+		mContacts[numKept++] = mContacts[i];
+	}
+	mNumContacts = numKept;
+
+	mSortedBodies.erase(std::find(mSortedBodies.begin(), mSortedBodies.end(), body));
+	mFlags[body] = 0;
+	mFreeList.push_back(body);
+	mNumBodies -= 1;
+}
+
+void PhysicsWorld2D::wakeBody(uint32_t body) noexcept
+{
+	sfz_assert_debug(body < mMaxBodies);
+	if ((mFlags[body] & (FLAG_STATIC | FLAG_AWAKE)) != 0) return;
+
+	// Sleeping bodies are linked to the other bodies of their island in a circular list
+	uint32_t current = body;
+	do {
+		mFlags[current] |= FLAG_AWAKE;
+		mSleepTimers[current] = 0.0f;
+		current = mIslandNext[current];
+	} while (current != body);
+}
+
+void PhysicsWorld2D::setPosition(uint32_t body, vec2 position) noexcept
+{
+	sfz_assert_debug(isValid(body));
+	// Static bodies never wake, instead wake the bodies touching it before and after moving
+	const bool isStatic = (mFlags[body] & FLAG_STATIC) != 0;
+	if (isStatic) wakeOverlapping(body);
+	mPositions[body] = position;
+	mBoundsMin[body] = position - mHalfExtents[body];
+	mBoundsMax[body] = position + mHalfExtents[body];
+	if (isStatic) wakeOverlapping(body);
+	wakeBody(body);
+}
+
+void PhysicsWorld2D::setVelocity(uint32_t body, vec2 velocity) noexcept
+{
+	sfz_assert_debug(isValid(body));
+	if (isStatic(body)) return;
+	mVelocities[body] = velocity;
+	wakeBody(body);
+}
+
+void PhysicsWorld2D::applyImpulse(uint32_t body, vec2 impulse) noexcept
+{
+	sfz_assert_debug(isValid(body));
+	if (isStatic(body)) return;
+	mVelocities[body] += impulse * mInvMasses[body];
+	wakeBody(body);
+}
+
+void PhysicsWorld2D::applyForce(uint32_t body, vec2 force) noexcept
+{
+	sfz_assert_debug(isValid(body));
+	if (isStatic(body)) return;
+	mForces[body] += force;
+	wakeBody(body);
+}
+
+// PhysicsWorld2D: Simulation
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint32_t PhysicsWorld2D::update(float deltaSeconds) noexcept
+{
+	mAccumulator += deltaSeconds;
+	uint32_t numSteps = 0;
+	while (mAccumulator >= mTimestep && numSteps < MAX_STEPS_PER_UPDATE) {
+		step();
+		mAccumulator -= mTimestep;
+		numSteps += 1;
+	}
+
+	// Drop time the simulation couldn't keep up with
+	if (mAccumulator >= mTimestep) mAccumulator = std::fmod(mAccumulator, mTimestep);
+	return numSteps;
+}
+
+void PhysicsWorld2D::step() noexcept
+{
+	const float dt = mTimestep;
+
+	collide();
+
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) == 0) continue;
+		mVelocities[body] += (mGravity + mForces[body] * mInvMasses[body]) * dt;
+		mForces[body] = vec2{0.0f};
+	}
+
+	buildIslands();
+	solveIslands();
+
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) == 0) continue;
+		mPositions[body] += mVelocities[body] * dt;
+	}
+
+	updateSleeping();
+}
+
+// PhysicsWorld2D: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint32_t PhysicsWorld2D::numAwakeBodies() const noexcept
+{
+	uint32_t numAwake = 0;
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) != 0) numAwake++;
+	}
+	return numAwake;
+}
+
+Circle PhysicsWorld2D::circle(uint32_t body) const noexcept
+{
+	sfz_assert_debug(mShapes[body] == BodyShape2D::CIRCLE);
+	return Circle{mPositions[body], mHalfExtents[body].x};
+}
+
+AABB2D PhysicsWorld2D::box(uint32_t body) const noexcept
+{
+	sfz_assert_debug(mShapes[body] == BodyShape2D::BOX);
+	return AABB2D{mPositions[body], mHalfExtents[body] * 2.0f};
+}
+
+// PhysicsWorld2D: Setters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void PhysicsWorld2D::timestep(float timestep) noexcept
+{
+	sfz_assert_debug(timestep > 0.0f);
+	mTimestep = timestep;
+}
+
+// PhysicsWorld2D: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint32_t PhysicsWorld2D::addBody(BodyShape2D shape, vec2 pos, vec2 halfExtents, float mass,
+                                 float friction, float restitution) noexcept
+{
+	sfz_assert_debug(mass >= 0.0f);
+	if (mFreeList.empty()) return NO_BODY;
+	const uint32_t body = mFreeList.back();
+	mFreeList.pop_back();
+
+	mFlags[body] = FLAG_VALID | (mass > 0.0f ? FLAG_AWAKE : FLAG_STATIC);
+	mShapes[body] = shape;
+	mPositions[body] = pos;
+	mVelocities[body] = vec2{0.0f};
+	mForces[body] = vec2{0.0f};
+	mHalfExtents[body] = halfExtents;
+	mBoundsMin[body] = pos - halfExtents;
+	mBoundsMax[body] = pos + halfExtents;
+	mInvMasses[body] = mass > 0.0f ? (1.0f / mass) : 0.0f;
+	mFrictions[body] = friction;
+	mRestitutions[body] = restitution;
+	mSleepTimers[body] = 0.0f;
+	mIslandNext[body] = body;
+
+	// Capacity reserved in constructor, insertion sort in collide() moves it to its place
+	mSortedBodies.push_back(body);
+	mNumBodies += 1;
+	return body;
+}
+
+void PhysicsWorld2D::wakeOverlapping(uint32_t body) noexcept
+{
+	// Sleeping bodies have no contacts with static bodies, so the bounds are used instead. The
+	// slop covers bodies resting exactly on the surface.
+	const vec2 min = mBoundsMin[body] - vec2{PENETRATION_SLOP};
+	const vec2 max = mBoundsMax[body] + vec2{PENETRATION_SLOP};
+	for (uint32_t other : mSortedBodies) {
+		if ((mFlags[other] & (FLAG_STATIC | FLAG_AWAKE)) != 0) continue;
+		if (mBoundsMin[other].x > max.x || min.x > mBoundsMax[other].x) continue;
+		if (mBoundsMin[other].y > max.y || min.y > mBoundsMax[other].y) continue;
+		wakeBody(other);
+	}
+}
+
+void PhysicsWorld2D::collide() noexcept
+{
+	std::swap(mContacts, mOldContacts);
+	mNumOldContacts = mNumContacts;
+	mNumContacts = 0;
+
+	// Only awake bodies have moved since last step
+	bool anySleeping = false;
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) == 0) {
+			anySleeping = anySleeping || (mFlags[body] & FLAG_STATIC) == 0;
+			continue;
+		}
+		mBoundsMin[body] = mPositions[body] - mHalfExtents[body];
+		mBoundsMax[body] = mPositions[body] + mHalfExtents[body];
+	}
+
+	// Insertion sort, bodies rarely move far relative to each other between steps
+	const uint32_t numSorted = uint32_t(mSortedBodies.size());
+	for (uint32_t i = 1; i < numSorted; i++) {
+		const uint32_t body = mSortedBodies[i];
+		const float minX = mBoundsMin[body].x;
+		uint32_t j = i;
+		while (j > 0 && mBoundsMin[mSortedBodies[j - 1]].x > minX) {
+			mSortedBodies[j] = mSortedBodies[j - 1];
+			j--;
+		}
+		mSortedBodies[j] = body;
+	}
+
+	// Wake the islands of sleeping bodies touched by awake bodies before generating contacts, as
+	// waking them during the sweep would skip their pairs earlier in the sweep (e.g. the ground).
+	// Repeated until nothing more wakes, a woken island may in turn touch another sleeping one.
+	bool wokeAny = anySleeping;
+	while (wokeAny) {
+		wokeAny = false;
+		for (uint32_t i = 0; i < numSorted; i++) {
+			const uint32_t a = mSortedBodies[i];
+			bool aAwake = (mFlags[a] & FLAG_AWAKE) != 0;
+			const float maxX = mBoundsMax[a].x;
+			for (uint32_t j = i + 1; j < numSorted; j++) {
+				const uint32_t b = mSortedBodies[j];
+				if (mBoundsMin[b].x > maxX) break;
+				if (aAwake == ((mFlags[b] & FLAG_AWAKE) != 0)) continue;
+				const uint32_t sleeping = aAwake ? b : a;
+				if ((mFlags[sleeping] & FLAG_STATIC) != 0) continue;
+				if (mBoundsMin[a].y > mBoundsMax[b].y || mBoundsMin[b].y > mBoundsMax[a].y) continue;
+				vec2 normal;
+				float penetration;
+				if (!testContact(std::min(a, b), std::max(a, b), normal, penetration)) continue;
+				wakeBody(sleeping);
+				wokeAny = true;
+				aAwake = true;
+			}
+		}
+	}
+
+	// Sweep and prune, awake bodies can no longer touch sleeping bodies
+	for (uint32_t i = 0; i < numSorted; i++) {
+		const uint32_t a = mSortedBodies[i];
+		const bool aAwake = (mFlags[a] & FLAG_AWAKE) != 0;
+		const float maxX = mBoundsMax[a].x;
+		for (uint32_t j = i + 1; j < numSorted; j++) {
+			const uint32_t b = mSortedBodies[j];
+			if (mBoundsMin[b].x > maxX) break;
+			if (!aAwake && (mFlags[b] & FLAG_AWAKE) == 0) continue;
+			if (mBoundsMin[a].y > mBoundsMax[b].y || mBoundsMin[b].y > mBoundsMax[a].y) continue;
+			addContact(std::min(a, b), std::max(a, b));
+		}
+	}
+
+	// Warm starting, match contacts with the previous step's contacts of the same pair
+	std::sort(mContacts.begin(), mContacts.begin() + mNumContacts, contactLess);
+	uint32_t oldIndex = 0;
+	for (uint32_t i = 0; i < mNumContacts; i++) {
+		Contact2D& contact = mContacts[i];
+		while (oldIndex < mNumOldContacts && contactLess(mOldContacts[oldIndex], contact)) {
+			oldIndex++;
+		}
+		if (oldIndex >= mNumOldContacts) break;
+		const Contact2D& old = mOldContacts[oldIndex];
+		if (old.bodyA == contact.bodyA && old.bodyB == contact.bodyB) {
+			contact.normalImpulse = old.normalImpulse;
+			contact.tangentImpulse = old.tangentImpulse;
+		}
+	}
+}
+
+bool PhysicsWorld2D::testContact(uint32_t a, uint32_t b, vec2& normalOut,
+                                 float& penetrationOut) const noexcept
+{
+	const BodyShape2D shapeA = mShapes[a], shapeB = mShapes[b];
+	if (shapeA == BodyShape2D::CIRCLE && shapeB == BodyShape2D::CIRCLE) {
+		return circleVsCircle(mPositions[a], mHalfExtents[a].x, mPositions[b], mHalfExtents[b].x,
+		                      normalOut, penetrationOut);
+	}
+	else if (shapeA == BodyShape2D::BOX && shapeB == BodyShape2D::BOX) {
+		return boxVsBox(mPositions[a], mHalfExtents[a], mPositions[b], mHalfExtents[b],
+		                normalOut, penetrationOut);
+	}
+	else if (shapeA == BodyShape2D::CIRCLE) {
+		return circleVsBox(mPositions[a], mHalfExtents[a].x, mPositions[b], mHalfExtents[b],
+		                   normalOut, penetrationOut);
+	}
+	bool touching = circleVsBox(mPositions[b], mHalfExtents[b].x, mPositions[a], mHalfExtents[a],
+	                            normalOut, penetrationOut);
+	normalOut = -normalOut;
+	return touching;
+}
+
+void PhysicsWorld2D::addContact(uint32_t a, uint32_t b) noexcept
+{
+	if ((mFlags[a] & mFlags[b] & FLAG_STATIC) != 0) return;
+	if (mNumContacts >= mMaxContacts) return;
+
+	vec2 normal;
+	float penetration;
+	if (!testContact(a, b, normal, penetration)) return;
+
+	const float dt = mTimestep;
+	const float relNormalVel = dot(mVelocities[b] - mVelocities[a], normal);
+	float bias = (BAUMGARTE / dt) * std::max(penetration - PENETRATION_SLOP, 0.0f);
+	if (relNormalVel < -RESTITUTION_THRESHOLD) {
+		bias += -std::max(mRestitutions[a], mRestitutions[b]) * relNormalVel;
+	}
+
+	Contact2D& contact = mContacts[mNumContacts++];
+	contact.bodyA = a;
+	contact.bodyB = b;
+	contact.normal = normal;
+	contact.penetration = penetration;
+	contact.normalImpulse = 0.0f;
+	contact.tangentImpulse = 0.0f;
+	contact.normalMass = 1.0f / (mInvMasses[a] + mInvMasses[b]);
+	contact.friction = std::sqrt(mFrictions[a] * mFrictions[b]);
+	contact.bias = bias;
+}
+
+void PhysicsWorld2D::buildIslands() noexcept
+{
+	// Every awake dynamic body starts as its own island. Sleeping bodies touched by awake bodies
+	// have been woken in collide(), so all dynamic bodies in contacts are awake at this point.
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) != 0) mIslandParents[body] = body;
+	}
+
+	// Static bodies do not connect islands
+	for (uint32_t i = 0; i < mNumContacts; i++) {
+		const Contact2D& contact = mContacts[i];
+		if (((mFlags[contact.bodyA] | mFlags[contact.bodyB]) & FLAG_STATIC) != 0) continue;
+		uint32_t rootA = findIslandRoot(contact.bodyA);
+		uint32_t rootB = findIslandRoot(contact.bodyB);
+		if (rootA != rootB) mIslandParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+	}
+
+	mNumIslands = 0;
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) == 0) continue;
+		if (findIslandRoot(body) == body) mIslandIndices[body] = mNumIslands++;
+	}
+
+	// Group bodies by island (counting sort)
+	std::fill(mIslandBodyOffsets.begin(), mIslandBodyOffsets.begin() + mNumIslands + 1, 0u);
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) == 0) continue;
+		mIslandBodyOffsets[mIslandIndices[findIslandRoot(body)] + 1] += 1;
+	}
+	for (uint32_t i = 0; i < mNumIslands; i++) {
+		mIslandBodyOffsets[i + 1] += mIslandBodyOffsets[i];
+		mIslandCursors[i] = mIslandBodyOffsets[i];
+	}
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) == 0) continue;
+		uint32_t island = mIslandIndices[findIslandRoot(body)];
+		mIslandBodies[mIslandCursors[island]++] = body;
+	}
+
+	// Group contacts by island, a contact belongs to the island of its dynamic body (or bodies)
+	std::fill(mIslandContactOffsets.begin(), mIslandContactOffsets.begin() + mNumIslands + 1, 0u);
+	for (uint32_t i = 0; i < mNumContacts; i++) {
+		const Contact2D& contact = mContacts[i];
+		uint32_t body = (mFlags[contact.bodyA] & FLAG_STATIC) != 0 ? contact.bodyB : contact.bodyA;
+		mIslandContactOffsets[mIslandIndices[findIslandRoot(body)] + 1] += 1;
+	}
+	for (uint32_t i = 0; i < mNumIslands; i++) {
+		mIslandContactOffsets[i + 1] += mIslandContactOffsets[i];
+		mIslandCursors[i] = mIslandContactOffsets[i];
+	}
+	for (uint32_t i = 0; i < mNumContacts; i++) {
+		const Contact2D& contact = mContacts[i];
+		uint32_t body = (mFlags[contact.bodyA] & FLAG_STATIC) != 0 ? contact.bodyB : contact.bodyA;
+		uint32_t island = mIslandIndices[findIslandRoot(body)];
+		mIslandContacts[mIslandCursors[island]++] = i;
+	}
+}
+
+void PhysicsWorld2D::solveIslands() noexcept
+{
+	const uint32_t minParallelIslands = 2 * numThreads();
+	if (mWorkers.empty() || mNumIslands < minParallelIslands ||
+	    mNumContacts < PARALLEL_CONTACTS_THRESHOLD) {
+		for (uint32_t i = 0; i < mNumIslands; i++) solveIsland(i);
+		return;
+	}
+
+	// Islands share no dynamic bodies, so they can be solved in parallel without synchronization
+	mNextIsland = 0;
+	{
+		std::lock_guard<std::mutex> lock(mWorkMutex);
+		mWorkGeneration += 1;
+		mNumBusyWorkers = uint32_t(mWorkers.size());
+	}
+	mWorkCondition.notify_all();
+
+	solveClaimedIslands();
+
+	std::unique_lock<std::mutex> lock(mWorkMutex);
+	mDoneCondition.wait(lock, [this]() { return mNumBusyWorkers == 0; });
+}
+
+void PhysicsWorld2D::solveIsland(uint32_t island) noexcept
+{
+	const uint32_t begin = mIslandContactOffsets[island];
+	const uint32_t end = mIslandContactOffsets[island + 1];
+	if (begin == end) return;
+
+	// Static bodies have inverse mass 0 and are never written to, they may be shared between
+	// islands solved on different threads.
+
+	// Warm starting
+	for (uint32_t i = begin; i < end; i++) {
+		const Contact2D& c = mContacts[mIslandContacts[i]];
+		const vec2 tangent{-c.normal.y, c.normal.x};
+		const vec2 impulse = c.normal * c.normalImpulse + tangent * c.tangentImpulse;
+		if (mInvMasses[c.bodyA] != 0.0f) mVelocities[c.bodyA] -= impulse * mInvMasses[c.bodyA];
+		if (mInvMasses[c.bodyB] != 0.0f) mVelocities[c.bodyB] += impulse * mInvMasses[c.bodyB];
+	}
+
+	for (uint32_t iteration = 0; iteration < mVelocityIterations; iteration++) {
+		for (uint32_t i = begin; i < end; i++) {
+			Contact2D& c = mContacts[mIslandContacts[i]];
+			const float invMassA = mInvMasses[c.bodyA];
+			const float invMassB = mInvMasses[c.bodyB];
+			vec2 velA = mVelocities[c.bodyA];
+			vec2 velB = mVelocities[c.bodyB];
+
+			// Friction, clamped by the current normal impulse
+			const vec2 tangent{-c.normal.y, c.normal.x};
+			float lambda = -dot(velB - velA, tangent) * c.normalMass;
+			const float maxFriction = c.friction * c.normalImpulse;
+			float newImpulse = std::max(-maxFriction, std::min(c.tangentImpulse + lambda, maxFriction));
+			lambda = newImpulse - c.tangentImpulse;
+			c.tangentImpulse = newImpulse;
+			velA -= tangent * (lambda * invMassA);
+			velB += tangent * (lambda * invMassB);
+
+			// Normal, accumulated impulse may never become negative (pulling bodies together)
+			lambda = (c.bias - dot(velB - velA, c.normal)) * c.normalMass;
+			newImpulse = std::max(c.normalImpulse + lambda, 0.0f);
+			lambda = newImpulse - c.normalImpulse;
+			c.normalImpulse = newImpulse;
+			velA -= c.normal * (lambda * invMassA);
+			velB += c.normal * (lambda * invMassB);
+
+			if (invMassA != 0.0f) mVelocities[c.bodyA] = velA;
+			if (invMassB != 0.0f) mVelocities[c.bodyB] = velB;
+		}
+	}
+}
+
+void PhysicsWorld2D::solveClaimedIslands() noexcept
+{
+	while (true) {
+		const uint32_t begin = mNextIsland.fetch_add(ISLAND_BATCH_SIZE);
+		if (begin >= mNumIslands) return;
+		const uint32_t end = std::min(begin + ISLAND_BATCH_SIZE, mNumIslands);
+		for (uint32_t i = begin; i < end; i++) solveIsland(i);
+	}
+}
+
+void PhysicsWorld2D::updateSleeping() noexcept
+{
+	const float sleepVelSquared = SLEEP_VELOCITY * SLEEP_VELOCITY;
+	for (uint32_t body : mSortedBodies) {
+		if ((mFlags[body] & FLAG_AWAKE) == 0) continue;
+		if (squaredLength(mVelocities[body]) > sleepVelSquared) mSleepTimers[body] = 0.0f;
+		else mSleepTimers[body] += mTimestep;
+	}
+
+	// An island sleeps when all of its bodies have been still long enough
+	for (uint32_t island = 0; island < mNumIslands; island++) {
+		const uint32_t begin = mIslandBodyOffsets[island];
+		const uint32_t end = mIslandBodyOffsets[island + 1];
+		bool still = true;
+		for (uint32_t i = begin; i < end && still; i++) {
+			still = mSleepTimers[mIslandBodies[i]] >= TIME_TO_SLEEP;
+		}
+		if (!still) continue;
+
+		for (uint32_t i = begin; i < end; i++) {
+			const uint32_t body = mIslandBodies[i];
+			mFlags[body] &= uint8_t(~FLAG_AWAKE);
+			mVelocities[body] = vec2{0.0f};
+			mIslandNext[body] = mIslandBodies[(i + 1) < end ? (i + 1) : begin];
+		}
+	}
+}
+
+void PhysicsWorld2D::workerMain() noexcept
+{
+	uint64_t lastGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mWorkMutex);
+			mWorkCondition.wait(lock, [this, lastGeneration]() {
+				return mShutdown || mWorkGeneration != lastGeneration;
+			});
+			if (mShutdown) return;
+			lastGeneration = mWorkGeneration;
+		}
+
+		solveClaimedIslands();
+
+		std::lock_guard<std::mutex> lock(mWorkMutex);
+		mNumBusyWorkers -= 1;
+		if (mNumBusyWorkers == 0) mDoneCondition.notify_one();
+	}
+}
+
+uint32_t PhysicsWorld2D::findIslandRoot(uint32_t body) noexcept
+{
+	// Path halving
+	while (mIslandParents[body] != body) {
+		mIslandParents[body] = mIslandParents[mIslandParents[body]];
+		body = mIslandParents[body];
+	}
+	return body;
+}
+
+} // namespace sfz
\ No newline at end of file
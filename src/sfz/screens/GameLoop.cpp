@@ -1,14 +1,18 @@
 #include "sfz/screens/GameLoop.hpp"
 
 #include <algorithm>
-#include <chrono>
 #include <cstdint>
 #include <iostream>
-#include <unordered_map>
 #include <vector>
 
 #include "sfz/math/Vector.hpp"
 #include "sfz/sdl/GameController.hpp"
+#include "sfz/util/Allocators.hpp"
+#include "sfz/util/HashMap.hpp"
+#include "sfz/util/MemoryTracking.hpp"
+#include "sfz/util/Profiler.hpp"
+#include "sfz/util/StopWatch.hpp"
+#include "sfz/util/Timer.hpp"
 
 namespace sfz {
 
@@ -16,25 +20,21 @@ namespace sfz {
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 using std::int32_t;
-using time_point = std::chrono::high_resolution_clock::time_point;
-using std::unordered_map;
+using std::uint64_t;
 using std::vector;
 
 // Static helper functions
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
-static float calculateDelta(time_point& previousTime) noexcept
+static float calculateDelta(uint64_t& previousTicks) noexcept
 {
-	time_point currentTime = std::chrono::high_resolution_clock::now();
-
-	using FloatSecond = std::chrono::duration<float>;
-	float delta = std::chrono::duration_cast<FloatSecond>(currentTime - previousTime).count();
-
-	previousTime = currentTime;
+	uint64_t currentTicks = timerTicks();
+	float delta = float(ticksToSeconds(currentTicks - previousTicks));
+	previousTicks = currentTicks;
 	return delta;
 }
 
-static void initControllers(unordered_map<int32_t, sdl::GameController>& controllers) noexcept
+static void initControllers(HashMap<int32_t, sdl::GameController>& controllers) noexcept
 {
 	controllers.clear();
 
@@ -44,16 +44,17 @@ static void initControllers(unordered_map<int32_t, sdl::GameController>& control
 		
 		sdl::GameController c{i};
 		if (c.id() == -1) continue;
-		if (controllers.find(c.id()) != controllers.end()) continue;
+		if (controllers.contains(c.id())) continue;
 
-		controllers[c.id()] = std::move(c);
+		controllers.put(c.id(), std::move(c));
 	}
 }
 
 // GameLoop function
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
-void runGameLoop(sdl::Window& window, shared_ptr<BaseScreen> currentScreen)
+void runGameLoop(sdl::Window& window, shared_ptr<BaseScreen> currentScreen,
+                 FileWatcher* fileWatcher, HitchDetector* hitchDetector)
 {
 	UpdateState state{window};
 
@@ -61,75 +62,107 @@ void runGameLoop(sdl::Window& window, shared_ptr<BaseScreen> currentScreen)
 	initControllers(state.controllers);
 
 	// Initialize time delta
-	time_point previousTime;
-	state.delta = calculateDelta(previousTime);
+	uint64_t previousTicks = 0;
+	state.delta = calculateDelta(previousTicks);
 
 	// Initialize SDL events
 	SDL_GameControllerEventState(SDL_ENABLE);
 	SDL_Event event;
 
+	// Timing of frame phases
+	StopWatch frameWatch;
+	FrameTimings timings;
+	auto endPhase = [&](FramePhase phase) {
+		timings.phaseTime(phase) = frameWatch.lapSeconds();
+	};
+
 	while (true) {
+		sfz_profile_frame();
+		sfz_profile_zone("Frame");
+
 		// Calculate delta
-		state.delta = std::min(calculateDelta(previousTime), 0.2f);
+		state.delta = std::min(calculateDelta(previousTicks), 0.2f);
+		frameWatch.start();
+
+		// Memory from the frame allocator is only valid during the frame it was allocated in
+		frameAllocator().reset();
+		frameAllocationCounter().beginFrame();
 
 		// Process events
 		state.events.clear();
 		state.controllerEvents.clear();
 		state.mouseEvents.clear();
-		while (SDL_PollEvent(&event) != 0) {
-			switch (event.type) {
-
-			// Quitting and resizing window
-			case SDL_QUIT:
-				currentScreen->onQuit();
-				return;
-			case SDL_WINDOWEVENT:
-				switch (event.window.event) {
-				case SDL_WINDOWEVENT_RESIZED:
-					currentScreen->onResize(window.dimensions(), window.drawableDimensions());
+		{
+			sfz_profile_zone("Process events");
+			while (SDL_PollEvent(&event) != 0) {
+				switch (event.type) {
+
+				// Quitting and resizing window
+				case SDL_QUIT:
+					currentScreen->onQuit();
+					return;
+				case SDL_WINDOWEVENT:
+					switch (event.window.event) {
+					case SDL_WINDOWEVENT_RESIZED:
+						currentScreen->onResize(window.dimensions(), window.drawableDimensions());
+						break;
+					default:
+						state.events.push_back(event);
+						break;
+					}
 					break;
+
+				// SDL_GameController events
+				case SDL_CONTROLLERDEVICEADDED:
+				case SDL_CONTROLLERDEVICEREMOVED:
+				case SDL_CONTROLLERDEVICEREMAPPED:
+				case SDL_CONTROLLERBUTTONDOWN:
+				case SDL_CONTROLLERBUTTONUP:
+				case SDL_CONTROLLERAXISMOTION:
+					state.controllerEvents.push_back(event);
+					break;
+
+				// Mouse events
+				case SDL_MOUSEMOTION:
+				case SDL_MOUSEBUTTONDOWN:
+				case SDL_MOUSEBUTTONUP:
+				case SDL_MOUSEWHEEL:
+					state.mouseEvents.push_back(event);
+					break;
+
 				default:
 					state.events.push_back(event);
 					break;
 				}
-				break;
-
-			// SDL_GameController events
-			case SDL_CONTROLLERDEVICEADDED:
-			case SDL_CONTROLLERDEVICEREMOVED:
-			case SDL_CONTROLLERDEVICEREMAPPED:
-			case SDL_CONTROLLERBUTTONDOWN:
-			case SDL_CONTROLLERBUTTONUP:
-			case SDL_CONTROLLERAXISMOTION:
-				state.controllerEvents.push_back(event);
-				break;
-
-			// Mouse events
-			case SDL_MOUSEMOTION:
-			case SDL_MOUSEBUTTONDOWN:
-			case SDL_MOUSEBUTTONUP:
-			case SDL_MOUSEWHEEL:
-				state.mouseEvents.push_back(event);
-				break;
-
-			default:
-				state.events.push_back(event);
-				break;
 			}
 		}
 
-		// Updates controllers
-		state.controllersLastFrameState.clear();
-		for (auto& pair : state.controllers) {
-			state.controllersLastFrameState[pair.first] = pair.second.state();
+		// Reload changed files
+		if (fileWatcher != nullptr) {
+			sfz_profile_zone("Reload changed files");
+			fileWatcher->dispatch();
+		}
+		endPhase(FramePhase::EVENTS);
+
+		// Updates controllers and mouse
+		{
+			sfz_profile_zone("Update input");
+			// Cleared and refilled every frame, HashMap keeps its memory so this does not allocate
+			state.controllersLastFrameState.clear();
+			for (auto& pair : state.controllers) {
+				state.controllersLastFrameState.put(pair.first, pair.second.state());
+			}
+			update(state.controllers, state.controllerEvents);
+			state.rawMouse.update(window, state.mouseEvents);
 		}
-		update(state.controllers, state.controllerEvents);
-
-		// Updates mouse
-		state.rawMouse.update(window, state.mouseEvents);
 
 		// Update current screen
-		UpdateOp op = currentScreen->update(state);
+		UpdateOp op;
+		{
+			sfz_profile_zone("Update screen");
+			op = currentScreen->update(state);
+		}
+		endPhase(FramePhase::UPDATE);
 
 		// Perform eventual operations requested by screen update
 		switch (op.type) {
@@ -150,9 +183,26 @@ void runGameLoop(sdl::Window& window, shared_ptr<BaseScreen> currentScreen)
 		}
 
 		// Render current screen
-		currentScreen->render(state);
+		{
+			sfz_profile_zone("Render screen");
+			currentScreen->render(state);
+		}
+		endPhase(FramePhase::RENDER);
 
-		SDL_GL_SwapWindow(window.ptr);
+		{
+			sfz_profile_zone("Swap window");
+			SDL_GL_SwapWindow(window.ptr);
+		}
+		endPhase(FramePhase::SWAP);
+
+		// Checked before reporting timings, as logging a hitch may allocate
+		frameAllocationCounter().endFrame();
+
+		// Report frame timings, frames where the screen was switched are skipped
+		if (hitchDetector != nullptr) {
+			timings.frameTime = frameWatch.getTimeSeconds();
+			hitchDetector->addFrame(timings);
+		}
 	}
 }
 
@@ -157,7 +157,7 @@ static void updateProcessEvent(GameController& controller, const SDL_Event& even
 /** Finishes the update process, should be called once after all events have been processed. */
 static void updateFinish(GameController& controller) noexcept;
 
-void update(unordered_map<int32_t,GameController>& controllers, const vector<SDL_Event>& events) noexcept
+void update(HashMap<int32_t,GameController>& controllers, const vector<SDL_Event>& events) noexcept
 {
 	for (auto& c : controllers) updateStart(std::get<1>(c));
 
@@ -168,15 +168,13 @@ void update(unordered_map<int32_t,GameController>& controllers, const vector<SDL
 			{
 				GameController c{event.cdevice.which};
 				if (c.id() == -1) break;
-				if (controllers.find(c.id()) != controllers.end()) break;
-				controllers[c.id()] = std::move(c);
+				if (controllers.contains(c.id())) break;
+				controllers.put(c.id(), std::move(c));
 			}
 			break;
 		case SDL_CONTROLLERDEVICEREMOVED:
 			// 'which' is the joystick id in this context
-			if (controllers.find(event.cdevice.which) != controllers.end()) {
-				controllers.erase(event.cdevice.which);
-			}
+			controllers.erase(event.cdevice.which);
 			break;
 		case SDL_CONTROLLERDEVICEREMAPPED:
 			// TODO: Nothing of value to do here?
@@ -184,13 +182,15 @@ void update(unordered_map<int32_t,GameController>& controllers, const vector<SDL
 			
 		case SDL_CONTROLLERBUTTONDOWN:
 		case SDL_CONTROLLERBUTTONUP:
-			if (controllers.find(event.cbutton.which) != controllers.end()) {
-				updateProcessEvent(controllers[event.cbutton.which], event);
+			{
+				GameController* c = controllers.get(event.cbutton.which);
+				if (c != nullptr) updateProcessEvent(*c, event);
 			}
 			break;
 		case SDL_CONTROLLERAXISMOTION:
-			if (controllers.find(event.caxis.which) != controllers.end()) {
-				updateProcessEvent(controllers[event.caxis.which], event);
+			{
+				GameController* c = controllers.get(event.caxis.which);
+				if (c != nullptr) updateProcessEvent(*c, event);
 			}
 			break;
 
@@ -0,0 +1,229 @@
+#include "sfz/util/Allocators.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace sfz {
+
+using std::uintptr_t;
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static inline bool isPowerOfTwo(size_t value) noexcept
+{
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+static inline size_t alignUp(size_t value, size_t alignment) noexcept
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline void poison(void* ptr, size_t size) noexcept
+{
+#ifdef SFZ_ALLOCATOR_POISONING
+	std::memset(ptr, ALLOCATOR_POISON_BYTE, size);
+#else
+	(void)ptr;
+	(void)size;
+#endif
+}
+
+// Allocates memory with arbitrary (power of two) alignment from the heap, the original pointer is
+// stored right before the returned memory
+static void* heapAllocateAligned(size_t size, size_t alignment) noexcept
+{
+	alignment = std::max(alignment, sizeof(void*));
+	uint8_t* memory = static_cast<uint8_t*>(::operator new(size + alignment + sizeof(void*),
+	                                                       std::nothrow));
+	if (memory == nullptr) return nullptr;
+	uint8_t* aligned = reinterpret_cast<uint8_t*>(
+	    alignUp(reinterpret_cast<uintptr_t>(memory) + sizeof(void*), alignment));
+	reinterpret_cast<void**>(aligned)[-1] = memory;
+	return aligned;
+}
+
+static void heapFreeAligned(void* ptr) noexcept
+{
+	::operator delete(reinterpret_cast<void**>(ptr)[-1]);
+}
+
+// LinearAllocator: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+LinearAllocator::LinearAllocator(size_t capacity) noexcept
+:
+	mBlock(static_cast<uint8_t*>(::operator new(capacity, std::nothrow))),
+	mCapacity(mBlock != nullptr ? capacity : 0)
+{ }
+
+LinearAllocator::~LinearAllocator() noexcept
+{
+	this->rewind(Marker{0, 0});
+	::operator delete(mBlock);
+}
+
+// LinearAllocator: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void* LinearAllocator::allocate(size_t size, size_t alignment) noexcept
+{
+	sfz_assert_debug(isPowerOfTwo(alignment));
+	mNumAllocations++;
+
+	// Aligned relative to the actual address, the block itself is only aligned to 16 bytes
+	const uintptr_t base = reinterpret_cast<uintptr_t>(mBlock);
+	const size_t offset = alignUp(base + mOffset, alignment) - base;
+	if (mBlock != nullptr && offset + size <= mCapacity) {
+		mOffset = offset + size;
+		this->updatePeak(mOffset + mOverflowBytes);
+		return mBlock + offset;
+	}
+
+	// Block is full, fall back to the heap
+	void* memory = heapAllocateAligned(size, alignment);
+	if (memory == nullptr) sfz_error("LinearAllocator: out of memory");
+	mOverflow.push_back(Overflow{memory, size});
+	mOverflowBytes += size;
+	mNumOverflowAllocations++;
+	this->updatePeak(mOffset + mOverflowBytes);
+	return memory;
+}
+
+void LinearAllocator::deallocate(void* ptr, size_t size) noexcept
+{
+	if (ptr == nullptr) return;
+
+	uint8_t* bytes = static_cast<uint8_t*>(ptr);
+	if (mBlock != nullptr && bytes >= mBlock && bytes + size == mBlock + mOffset) {
+		poison(bytes, size);
+		mOffset = size_t(bytes - mBlock);
+		return;
+	}
+	if (!mOverflow.empty() && mOverflow.back().ptr == ptr) {
+		poison(ptr, size);
+		heapFreeAligned(ptr);
+		mOverflowBytes -= mOverflow.back().size;
+		mOverflow.pop_back();
+	}
+}
+
+void LinearAllocator::rewind(Marker marker) noexcept
+{
+	while (mOverflow.size() > marker.numOverflowAllocations) {
+		poison(mOverflow.back().ptr, mOverflow.back().size);
+		heapFreeAligned(mOverflow.back().ptr);
+		mOverflowBytes -= mOverflow.back().size;
+		mOverflow.pop_back();
+	}
+	// The offset may already be below the marker if an allocation made before the marker was
+	// taken was the last one and has been deallocated
+	if (marker.offset < mOffset) {
+		poison(mBlock + marker.offset, mOffset - marker.offset);
+		mOffset = marker.offset;
+	}
+}
+
+void LinearAllocator::reset() noexcept
+{
+	this->rewind(Marker{0, 0});
+	mLastPeak = mPeak;
+	mPeak = 0;
+	mNumAllocations = 0;
+	mNumOverflowAllocations = 0;
+}
+
+// LinearAllocator: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void LinearAllocator::updatePeak(size_t used) noexcept
+{
+	if (used > mPeak) mPeak = used;
+	if (used > mHighWaterMark) mHighWaterMark = used;
+}
+
+// PoolAllocator: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+PoolAllocator::PoolAllocator(size_t elementSize, size_t numElements, size_t alignment) noexcept
+:
+	mElementSize(alignUp(std::max(elementSize, sizeof(void*)),
+	                     std::max(alignment, sizeof(void*)))),
+	mNumElements(numElements),
+	mAlignment(std::max(alignment, sizeof(void*))),
+	mBlock(static_cast<uint8_t*>(heapAllocateAligned(mElementSize * numElements, mAlignment)))
+{
+	sfz_assert_debug(isPowerOfTwo(alignment));
+	if (mBlock == nullptr) sfz_error("PoolAllocator: out of memory");
+
+	// Free list in address order
+	for (size_t i = numElements; i > 0; i--) {
+		void* element = mBlock + (i - 1) * mElementSize;
+		*static_cast<void**>(element) = mFreeList;
+		mFreeList = element;
+	}
+}
+
+PoolAllocator::~PoolAllocator() noexcept
+{
+	sfz_assert_debug(mNumAllocated == 0);
+	heapFreeAligned(mBlock);
+}
+
+// PoolAllocator: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void* PoolAllocator::allocate() noexcept
+{
+	if (mFreeList == nullptr) return nullptr;
+	void* element = mFreeList;
+	mFreeList = *static_cast<void**>(element);
+	mNumAllocated++;
+	if (mNumAllocated > mPeak) mPeak = mNumAllocated;
+	return element;
+}
+
+void* PoolAllocator::allocate(size_t size, size_t alignment) noexcept
+{
+	if (size > mElementSize || alignment > mAlignment) return nullptr;
+	return this->allocate();
+}
+
+void PoolAllocator::deallocate(void* ptr, size_t) noexcept
+{
+	if (ptr == nullptr) return;
+	sfz_assert_debug(this->owns(ptr));
+	sfz_assert_debug(mNumAllocated > 0);
+
+	poison(ptr, mElementSize);
+	*static_cast<void**>(ptr) = mFreeList;
+	mFreeList = ptr;
+	mNumAllocated--;
+}
+
+bool PoolAllocator::owns(const void* ptr) const noexcept
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+	if (bytes < mBlock || bytes >= mBlock + mElementSize * mNumElements) return false;
+	return size_t(bytes - mBlock) % mElementSize == 0;
+}
+
+// Frame and scratch memory
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+LinearAllocator& frameAllocator() noexcept
+{
+	static LinearAllocator allocator(FRAME_ALLOCATOR_CAPACITY);
+	return allocator;
+}
+
+LinearAllocator& scratchAllocator() noexcept
+{
+	static thread_local LinearAllocator allocator(SCRATCH_ALLOCATOR_CAPACITY);
+	return allocator;
+}
+
+} // namespace sfz
\ No newline at end of file
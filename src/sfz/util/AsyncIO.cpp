@@ -0,0 +1,329 @@
+#include "sfz/util/AsyncIO.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "sfz/Assert.hpp"
+
+namespace sfz {
+
+// AsyncIO: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const uint64_t AsyncIO::INVALID_ID;
+const size_t AsyncIO::CHUNK_SIZE;
+
+// AsyncIO: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+AsyncIO::AsyncIO(uint32_t numThreads) noexcept
+{
+	if (numThreads == 0) numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	mActiveIds.resize(numThreads, INVALID_ID);
+	for (uint32_t i = 0; i < numThreads; i++) {
+		mWorkers.emplace_back([this, i]() { this->workerMain(i); });
+	}
+}
+
+AsyncIO::~AsyncIO() noexcept
+{
+	vector<Request> cancelled;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mShutdown = true;
+		for (auto& queue : mQueues) {
+			for (Request& request : queue) cancelled.push_back(std::move(request));
+			queue.clear();
+		}
+	}
+	mWorkCondition.notify_all();
+	for (std::thread& worker : mWorkers) worker.join();
+
+	// Fulfill the promises of the cancelled requests, callbacks will never be called
+	for (Request& request : cancelled) {
+		IOResult result;
+		result.id = request.id;
+		result.status = IOStatus::CANCELLED;
+		if (request.promise != nullptr) request.promise->set_value(std::move(result));
+	}
+}
+
+// AsyncIO: Requests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint64_t AsyncIO::readFile(const char* path, IOCallback callback, IOPriority priority) noexcept
+{
+	return this->readFile(path, nullptr, 0, std::move(callback), priority);
+}
+
+uint64_t AsyncIO::readFile(const char* path, uint8_t* buffer, size_t bufferSize,
+                           IOCallback callback, IOPriority priority) noexcept
+{
+	Request request;
+	request.path = path;
+	request.buffer = buffer;
+	request.bufferSize = bufferSize;
+	request.callback = std::move(callback);
+	return this->enqueue(std::move(request), priority);
+}
+
+std::future<IOResult> AsyncIO::readFileFuture(const char* path, IOPriority priority) noexcept
+{
+	return this->readFileFuture(path, nullptr, 0, priority);
+}
+
+std::future<IOResult> AsyncIO::readFileFuture(const char* path, uint8_t* buffer, size_t bufferSize,
+                                              IOPriority priority) noexcept
+{
+	Request request;
+	request.path = path;
+	request.buffer = buffer;
+	request.bufferSize = bufferSize;
+	request.promise = std::make_shared<std::promise<IOResult>>();
+	std::future<IOResult> future = request.promise->get_future();
+	this->enqueue(std::move(request), priority);
+	return future;
+}
+
+bool AsyncIO::cancel(uint64_t id) noexcept
+{
+	Request request;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		// In progress, the worker will notice when reading the next chunk or when completing
+		if (std::find(mActiveIds.begin(), mActiveIds.end(), id) != mActiveIds.end()) {
+			mCancelledActive.push_back(id);
+			return true;
+		}
+
+		// Queued, remove it from the queue
+		bool found = false;
+		for (auto& queue : mQueues) {
+			auto itr = std::find_if(queue.begin(), queue.end(), [id](const Request& r) {
+				return r.id == id;
+			});
+			if (itr != queue.end()) {
+				request = std::move(*itr);
+				queue.erase(itr);
+				found = true;
+				break;
+			}
+		}
+		if (!found) return false;
+	}
+
+	IOResult result;
+	result.id = id;
+	result.status = IOStatus::CANCELLED;
+	this->complete(request, std::move(result));
+	return true;
+}
+
+void AsyncIO::releaseBuffer(vector<uint8_t>&& buffer) noexcept
+{
+	if (buffer.capacity() == 0) return;
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBufferPool.push_back(std::move(buffer));
+}
+
+// AsyncIO: Completion
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+size_t AsyncIO::pollCompleted() noexcept
+{
+	mCompletedTemp.clear();
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		std::swap(mCompleted, mCompletedTemp);
+	}
+
+	// Callbacks are called without holding the lock, they may issue new requests
+	for (Completed& completed : mCompletedTemp) {
+		if (completed.callback) completed.callback(completed.result);
+	}
+	size_t numCompleted = mCompletedTemp.size();
+	mCompletedTemp.clear();
+	return numCompleted;
+}
+
+void AsyncIO::waitAll() noexcept
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		sfz_assert_debug(!mSuspended || mNumPending == 0);
+		mDoneCondition.wait(lock, [this]() { return mNumPending == 0; });
+	}
+	this->pollCompleted();
+}
+
+void AsyncIO::suspend() noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mSuspended = true;
+}
+
+void AsyncIO::resume() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mSuspended = false;
+	}
+	mWorkCondition.notify_all();
+}
+
+// AsyncIO: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+size_t AsyncIO::numPending() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mNumPending;
+}
+
+uint64_t AsyncIO::numBytesRead() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mNumBytesRead;
+}
+
+// AsyncIO: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint64_t AsyncIO::enqueue(Request&& request, IOPriority priority) noexcept
+{
+	uint64_t id;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		id = mNextId++;
+		request.id = id;
+		mQueues[uint32_t(priority)].push_back(std::move(request));
+		mNumPending++;
+	}
+	mWorkCondition.notify_one();
+	return id;
+}
+
+void AsyncIO::complete(Request& request, IOResult&& result) noexcept
+{
+	bool allDone;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto activeItr = std::find(mActiveIds.begin(), mActiveIds.end(), request.id);
+		if (activeItr != mActiveIds.end()) *activeItr = INVALID_ID;
+
+		// A request cancelled while in progress is reported as cancelled even if it finished
+		auto cancelledItr = std::find(mCancelledActive.begin(), mCancelledActive.end(), request.id);
+		if (cancelledItr != mCancelledActive.end()) {
+			mCancelledActive.erase(cancelledItr);
+			result.status = IOStatus::CANCELLED;
+		}
+
+		mNumBytesRead += result.numBytes;
+		if (request.promise == nullptr) {
+			mCompleted.push_back(Completed{std::move(request.callback), std::move(result)});
+		}
+		mNumPending--;
+		allDone = mNumPending == 0;
+	}
+	if (request.promise != nullptr) request.promise->set_value(std::move(result));
+	if (allDone) mDoneCondition.notify_all();
+}
+
+void AsyncIO::read(const Request& request, IOResult& result) noexcept
+{
+	result.id = request.id;
+	result.status = IOStatus::FAILED;
+	result.userBuffer = request.buffer;
+
+	std::FILE* file = std::fopen(request.path.c_str(), "rb");
+	if (file == NULL) return;
+	std::fseek(file, 0, SEEK_END);
+	long size = std::ftell(file);
+	std::rewind(file);
+	if (size < 0) {
+		std::fclose(file);
+		return;
+	}
+	const size_t fileSize = size_t(size);
+
+	// Find destination, either the provided buffer or the smallest large enough pooled buffer
+	uint8_t* dst = request.buffer;
+	if (dst != nullptr) {
+		if (fileSize > request.bufferSize) {
+			std::fclose(file);
+			result.status = IOStatus::BUFFER_TOO_SMALL;
+			return;
+		}
+	} else {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			size_t best = mBufferPool.size();
+			for (size_t i = 0; i < mBufferPool.size(); i++) {
+				if (mBufferPool[i].capacity() < fileSize) continue;
+				if (best == mBufferPool.size() ||
+				    mBufferPool[i].capacity() < mBufferPool[best].capacity()) best = i;
+			}
+			if (best != mBufferPool.size()) {
+				result.data = std::move(mBufferPool[best]);
+				mBufferPool[best] = std::move(mBufferPool.back());
+				mBufferPool.pop_back();
+			}
+		}
+		result.data.resize(fileSize);
+		dst = result.data.data();
+	}
+
+	// Read file in chunks directly into destination
+	size_t offset = 0;
+	while (offset < fileSize) {
+		if (isCancelled(request.id)) break;
+		size_t numToRead = std::min(CHUNK_SIZE, fileSize - offset);
+		size_t numRead = std::fread(dst + offset, 1, numToRead, file);
+		offset += numRead;
+		if (numRead != numToRead) break;
+	}
+	std::fclose(file);
+
+	result.numBytes = offset;
+	if (request.buffer == nullptr) result.data.resize(offset);
+	if (offset == fileSize) result.status = IOStatus::DONE;
+}
+
+bool AsyncIO::isCancelled(uint64_t id) noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return std::find(mCancelledActive.begin(), mCancelledActive.end(), id) != mCancelledActive.end();
+}
+
+void AsyncIO::workerMain(uint32_t workerIndex) noexcept
+{
+	while (true) {
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWorkCondition.wait(lock, [this]() {
+				if (mShutdown) return true;
+				if (mSuspended) return false;
+				for (const auto& queue : mQueues) if (!queue.empty()) return true;
+				return false;
+			});
+			if (mShutdown) return;
+
+			// Highest priority first
+			for (int p = 2; p >= 0; p--) {
+				if (mQueues[p].empty()) continue;
+				request = std::move(mQueues[p].front());
+				mQueues[p].pop_front();
+				break;
+			}
+			mActiveIds[workerIndex] = request.id;
+		}
+
+		IOResult result;
+		this->read(request, result);
+		this->complete(request, std::move(result));
+	}
+}
+
+} // namespace sfz
\ No newline at end of file
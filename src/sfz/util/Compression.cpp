@@ -0,0 +1,586 @@
+#include "sfz/util/Compression.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "sfz/util/IO.hpp"
+#include "sfz/util/MappedFile.hpp"
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const size_t MIN_MATCH = 4;
+static const size_t LAST_LITERALS = 5; // Last bytes of a block are always literals
+static const size_t MF_LIMIT = 12; // Last match must start at least this far from end of block
+static const size_t MAX_OFFSET = 65535;
+static const uint64_t MAX_EXPANSION = 255; // A block decompresses to at most 255x its size
+static const uint32_t HASH_LOG = 14;
+static const size_t PATTERN_DISTANCE[8] = {0, 8, 8, 9, 8, 10, 12, 14}; // Multiple of offset >= 8
+
+static const uint8_t STREAM_MAGIC[4] = {'S', 'F', 'Z', 'C'};
+static const uint32_t STREAM_VERSION = 1;
+static const size_t STREAM_HEADER_SIZE = 24;
+static const size_t CHUNK_TABLE_ENTRY_SIZE = 8;
+static const uint32_t RAW_CHUNK_BIT = 0x80000000u;
+static const uint32_t MAX_CHUNK_SIZE = 1u << 30;
+
+// Chunked streams are stored in native byte order, which is little endian on all supported
+// platforms. Unaligned loads and stores use memcpy(), which compiles to single instructions.
+
+static inline uint16_t load16(const uint8_t* ptr) noexcept
+{
+	uint16_t val;
+	std::memcpy(&val, ptr, sizeof(uint16_t));
+	return val;
+}
+
+static inline uint32_t load32(const uint8_t* ptr) noexcept
+{
+	uint32_t val;
+	std::memcpy(&val, ptr, sizeof(uint32_t));
+	return val;
+}
+
+static inline uint64_t load64(const uint8_t* ptr) noexcept
+{
+	uint64_t val;
+	std::memcpy(&val, ptr, sizeof(uint64_t));
+	return val;
+}
+
+static inline void store16(uint8_t* ptr, uint16_t val) noexcept
+{
+	std::memcpy(ptr, &val, sizeof(uint16_t));
+}
+
+static inline void store32(uint8_t* ptr, uint32_t val) noexcept
+{
+	std::memcpy(ptr, &val, sizeof(uint32_t));
+}
+
+static inline void store64(uint8_t* ptr, uint64_t val) noexcept
+{
+	std::memcpy(ptr, &val, sizeof(uint64_t));
+}
+
+static inline uint32_t hashSequence(uint32_t sequence) noexcept
+{
+	return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+static inline uint32_t rotl32(uint32_t x, int r) noexcept
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+// Number of equal bytes before the first differing byte, given XOR of two 8 byte sequences
+static inline size_t countEqualBytes(uint64_t diff) noexcept
+{
+#if defined(__GNUC__)
+	return size_t(__builtin_ctzll(diff) >> 3);
+#else
+	size_t count = 0;
+	while ((diff & 0xFF) == 0) {
+		diff >>= 8;
+		count++;
+	}
+	return count;
+#endif
+}
+
+// Writes a literal or match length continuation (the part not fitting in the token)
+static inline uint8_t* writeLength(uint8_t* op, size_t length) noexcept
+{
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = uint8_t(length);
+	return op;
+}
+
+// Reads a length continuation, returns false if the input ends prematurely
+static inline bool readLength(const uint8_t*& ip, const uint8_t* iend, size_t& length) noexcept
+{
+	uint8_t b;
+	do {
+		if (ip >= iend) return false;
+		b = *ip++;
+		length += b;
+	} while (b == 255);
+	return true;
+}
+
+struct StreamHeader final {
+	uint64_t uncompressedSize;
+	uint32_t chunkSize;
+	uint32_t numChunks;
+};
+
+static bool readStreamHeader(const uint8_t* src, size_t srcSize, StreamHeader& header) noexcept
+{
+	if (src == nullptr || srcSize < STREAM_HEADER_SIZE) return false;
+	if (std::memcmp(src, STREAM_MAGIC, sizeof(STREAM_MAGIC)) != 0) return false;
+	if (load32(src + 4) != STREAM_VERSION) return false;
+	header.uncompressedSize = load64(src + 8);
+	header.chunkSize = load32(src + 16);
+	header.numChunks = load32(src + 20);
+	if (header.chunkSize == 0 || header.chunkSize > MAX_CHUNK_SIZE) return false;
+
+	// Implies uncompressedSize <= numChunks * chunkSize, written to not overflow on forged sizes
+	const uint64_t expectedNumChunks = header.uncompressedSize / header.chunkSize +
+	                                   (header.uncompressedSize % header.chunkSize != 0 ? 1 : 0);
+	return header.numChunks == expectedNumChunks;
+}
+
+// Checks that the chunk table is consistent with the header before any output is allocated, so
+// that a corrupt or forged header can not request a huge allocation. dataSize is the number of
+// bytes after the chunk table, UINT64_MAX if not known yet (streaming).
+static bool checkChunkTable(const uint8_t* table, const StreamHeader& header,
+                            uint64_t dataSize) noexcept
+{
+	uint64_t totalStoredSize = 0, maxUncompressedSize = 0;
+	for (uint32_t i = 0; i < header.numChunks; i++) {
+		const uint32_t storedSize = load32(table + i * CHUNK_TABLE_ENTRY_SIZE);
+		const uint64_t size = storedSize & ~RAW_CHUNK_BIT;
+		totalStoredSize += size;
+		maxUncompressedSize += (storedSize & RAW_CHUNK_BIT) != 0 ? size : size * MAX_EXPANSION;
+	}
+	return totalStoredSize <= dataSize && header.uncompressedSize <= maxUncompressedSize;
+}
+
+// Verifies and decompresses a single chunk of a stream. The checksum is of the stored (possibly
+// compressed) bytes, which is cheaper and catches corruption before attempting to decompress.
+static bool decompressChunk(const uint8_t* src, uint32_t storedSize, uint32_t checksum,
+                            uint8_t* dst, size_t chunkSize) noexcept
+{
+	const size_t size = storedSize & ~RAW_CHUNK_BIT;
+	if (checksum32(src, size) != checksum) return false;
+	if ((storedSize & RAW_CHUNK_BIT) != 0) {
+		if (size != chunkSize) return false;
+		std::memcpy(dst, src, chunkSize);
+		return true;
+	}
+	return decompressBlock(src, size, dst, chunkSize) == int64_t(chunkSize);
+}
+
+// Blocks
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+size_t compressBound(size_t srcSize) noexcept
+{
+	return srcSize + (srcSize / 255) + 16;
+}
+
+size_t compressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst,
+                     size_t dstCapacity) noexcept
+{
+	if (dstCapacity < compressBound(srcSize)) return 0;
+	uint8_t* op = dst;
+	size_t anchor = 0; // Start of literals not yet written
+
+	if (srcSize > MF_LIMIT) {
+		uint32_t table[1 << HASH_LOG] = {};
+		const size_t matchLimit = srcSize - LAST_LITERALS;
+		const size_t mfLimit = srcSize - MF_LIMIT;
+		size_t ip = 1;
+		table[hashSequence(load32(src))] = 0;
+
+		while (ip < mfLimit) {
+			// Find match, step faster through incompressible data
+			const uint32_t sequence = load32(src + ip);
+			const uint32_t h = hashSequence(sequence);
+			size_t ref = table[h];
+			table[h] = uint32_t(ip);
+			if ((ip - ref) > MAX_OFFSET || load32(src + ref) != sequence) {
+				ip += 1 + ((ip - anchor) >> 6);
+				continue;
+			}
+
+			// Extend match backwards and forwards
+			while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+				ip--;
+				ref--;
+			}
+			size_t matchLength = MIN_MATCH;
+			while (ip + matchLength + 8 <= matchLimit) {
+				uint64_t diff = load64(src + ip + matchLength) ^ load64(src + ref + matchLength);
+				if (diff != 0) {
+					matchLength += countEqualBytes(diff);
+					break;
+				}
+				matchLength += 8;
+			}
+			while (ip + matchLength < matchLimit && src[ip + matchLength] == src[ref + matchLength]) {
+				matchLength++;
+			}
+
+			// Write sequence: token, literals, offset and match length
+			const size_t literalLength = ip - anchor;
+			uint8_t* token = op++;
+			*token = uint8_t(std::min(literalLength, size_t(15)) << 4);
+			if (literalLength >= 15) op = writeLength(op, literalLength - 15);
+			std::memcpy(op, src + anchor, literalLength);
+			op += literalLength;
+			store16(op, uint16_t(ip - ref));
+			op += 2;
+			const size_t matchCode = matchLength - MIN_MATCH;
+			*token |= uint8_t(std::min(matchCode, size_t(15)));
+			if (matchCode >= 15) op = writeLength(op, matchCode - 15);
+
+			ip += matchLength;
+			anchor = ip;
+			if (ip < mfLimit) table[hashSequence(load32(src + ip - 2))] = uint32_t(ip - 2);
+		}
+	}
+
+	// Last literals
+	const size_t literalLength = srcSize - anchor;
+	*op++ = uint8_t(std::min(literalLength, size_t(15)) << 4);
+	if (literalLength >= 15) op = writeLength(op, literalLength - 15);
+	if (literalLength != 0) std::memcpy(op, src + anchor, literalLength);
+	op += literalLength;
+	return size_t(op - dst);
+}
+
+int64_t decompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst,
+                        size_t dstCapacity) noexcept
+{
+	if (src == nullptr || srcSize == 0) return -1;
+	const uint8_t* ip = src;
+	const uint8_t* const iend = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* const oend = dst + dstCapacity;
+
+	while (true) {
+		const uint8_t token = *ip++;
+		size_t literalLength = token >> 4;
+		size_t matchLength = token & 15;
+		size_t offset;
+
+		if (literalLength != 15 && matchLength != 15 && (iend - ip) >= 32 && (oend - op) >= 32) {
+			// Fast path for short sequences far from the ends of the buffers (the common case),
+			// copies a fixed number of bytes regardless of actual lengths.
+			std::memcpy(op, ip, 16);
+			op += literalLength;
+			ip += literalLength;
+			offset = load16(ip);
+			ip += 2;
+			if (offset >= 8 && offset <= size_t(op - dst)) {
+				const uint8_t* match = op - offset;
+				std::memcpy(op, match, 8);
+				std::memcpy(op + 8, match + 8, 8);
+				std::memcpy(op + 16, match + 16, 2);
+				op += matchLength + MIN_MATCH;
+				continue;
+			}
+		} else {
+			// Literals, copied 16 bytes at a time when far enough from the ends of the buffers
+			if (literalLength == 15 && !readLength(ip, iend, literalLength)) return -1;
+			if (literalLength > size_t(iend - ip) || literalLength > size_t(oend - op)) return -1;
+			if (literalLength <= 16 && (iend - ip) >= 16 && (oend - op) >= 16) {
+				std::memcpy(op, ip, 16);
+			} else if (literalLength != 0) {
+				std::memcpy(op, ip, literalLength);
+			}
+			ip += literalLength;
+			op += literalLength;
+			if (ip == iend) break; // Last sequence only contains literals
+
+			if ((iend - ip) < 2) return -1;
+			offset = load16(ip);
+			ip += 2;
+			if (matchLength == 15 && !readLength(ip, iend, matchLength)) return -1;
+		}
+
+		// Match
+		if (offset == 0 || offset > size_t(op - dst)) return -1;
+		matchLength += MIN_MATCH;
+		if (matchLength > size_t(oend - op)) return -1;
+
+		const uint8_t* match = op - offset;
+		uint8_t* const matchEnd = op + matchLength;
+		if ((oend - matchEnd) >= 16) {
+			// Short offsets, copy first 8 bytes one at a time, which repeats the pattern. The
+			// rest can then be copied from a distance that is a multiple of the offset and >= 8.
+			if (offset < 8) {
+				for (int i = 0; i < 8; i++) op[i] = match[i];
+				match = op + 8 - PATTERN_DISTANCE[offset];
+				op += 8;
+			}
+
+			// Copies may write up to 15 bytes past end of match, which is later overwritten
+			if ((op - match) >= 16) {
+				do {
+					std::memcpy(op, match, 16);
+					op += 16;
+					match += 16;
+				} while (op < matchEnd);
+			} else {
+				do {
+					std::memcpy(op, match, 8);
+					op += 8;
+					match += 8;
+				} while (op < matchEnd);
+			}
+		} else {
+			while (op < matchEnd) *op++ = *match++;
+		}
+		op = matchEnd;
+		if (ip >= iend) return -1;
+	}
+	return int64_t(op - dst);
+}
+
+uint32_t checksum32(const uint8_t* data, size_t size, uint32_t seed) noexcept
+{
+	const uint32_t P1 = 2654435761u, P2 = 2246822519u, P3 = 3266489917u;
+	const uint32_t P4 = 668265263u, P5 = 374761393u;
+	const uint8_t* ptr = data;
+	const uint8_t* const end = data + size;
+
+	uint32_t h;
+	if (size >= 16) {
+		uint32_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+		const uint8_t* const limit = end - 16;
+		do {
+			v1 = rotl32(v1 + load32(ptr) * P2, 13) * P1;
+			v2 = rotl32(v2 + load32(ptr + 4) * P2, 13) * P1;
+			v3 = rotl32(v3 + load32(ptr + 8) * P2, 13) * P1;
+			v4 = rotl32(v4 + load32(ptr + 12) * P2, 13) * P1;
+			ptr += 16;
+		} while (ptr <= limit);
+		h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+	} else {
+		h = seed + P5;
+	}
+	h += uint32_t(size);
+
+	for (; (end - ptr) >= 4; ptr += 4) h = rotl32(h + load32(ptr) * P3, 17) * P4;
+	for (; ptr < end; ptr++) h = rotl32(h + (*ptr) * P5, 11) * P1;
+
+	h ^= h >> 15;
+	h *= P2;
+	h ^= h >> 13;
+	h *= P3;
+	h ^= h >> 16;
+	return h;
+}
+
+// Chunked streams
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+vector<uint8_t> compress(const uint8_t* src, size_t srcSize, uint32_t chunkSize) noexcept
+{
+	chunkSize = std::max(std::min(chunkSize, MAX_CHUNK_SIZE), 1u);
+	const size_t numChunks = (srcSize + chunkSize - 1) / chunkSize;
+	const size_t dataStart = STREAM_HEADER_SIZE + numChunks * CHUNK_TABLE_ENTRY_SIZE;
+
+	vector<uint8_t> dst(dataStart + numChunks * compressBound(chunkSize));
+	std::memcpy(dst.data(), STREAM_MAGIC, sizeof(STREAM_MAGIC));
+	store32(dst.data() + 4, STREAM_VERSION);
+	store64(dst.data() + 8, uint64_t(srcSize));
+	store32(dst.data() + 16, chunkSize);
+	store32(dst.data() + 20, uint32_t(numChunks));
+
+	size_t dstOffset = dataStart;
+	for (size_t i = 0; i < numChunks; i++) {
+		const uint8_t* chunk = src + i * chunkSize;
+		const size_t size = std::min(size_t(chunkSize), srcSize - i * chunkSize);
+		size_t storedSize = compressBlock(chunk, size, dst.data() + dstOffset, dst.size() - dstOffset);
+		uint32_t sizeField = uint32_t(storedSize);
+		if (storedSize >= size) {
+			std::memcpy(dst.data() + dstOffset, chunk, size);
+			storedSize = size;
+			sizeField = uint32_t(size) | RAW_CHUNK_BIT;
+		}
+		uint8_t* tableEntry = dst.data() + STREAM_HEADER_SIZE + i * CHUNK_TABLE_ENTRY_SIZE;
+		store32(tableEntry, sizeField);
+		store32(tableEntry + 4, checksum32(dst.data() + dstOffset, storedSize));
+		dstOffset += storedSize;
+	}
+	dst.resize(dstOffset);
+	dst.shrink_to_fit();
+	return dst;
+}
+
+bool isCompressed(const uint8_t* src, size_t srcSize) noexcept
+{
+	StreamHeader header;
+	return readStreamHeader(src, srcSize, header);
+}
+
+int64_t decompressedSize(const uint8_t* src, size_t srcSize) noexcept
+{
+	StreamHeader header;
+	if (!readStreamHeader(src, srcSize, header)) return -1;
+	return int64_t(header.uncompressedSize);
+}
+
+bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity,
+                uint32_t numThreads) noexcept
+{
+	StreamHeader header;
+	if (!readStreamHeader(src, srcSize, header)) return false;
+	if (header.uncompressedSize > dstCapacity) return false;
+	const size_t tableSize = size_t(header.numChunks) * CHUNK_TABLE_ENTRY_SIZE;
+	if (tableSize > srcSize - STREAM_HEADER_SIZE) return false;
+	const uint8_t* table = src + STREAM_HEADER_SIZE;
+	if (!checkChunkTable(table, header, srcSize - STREAM_HEADER_SIZE - tableSize)) return false;
+
+	// Find where each chunk starts
+	vector<size_t> offsets(header.numChunks);
+	size_t offset = STREAM_HEADER_SIZE + tableSize;
+	for (uint32_t i = 0; i < header.numChunks; i++) {
+		offsets[i] = offset;
+		offset += load32(table + i * CHUNK_TABLE_ENTRY_SIZE) & ~RAW_CHUNK_BIT;
+		if (offset > srcSize) return false;
+	}
+
+	std::atomic<uint32_t> nextChunk{0};
+	std::atomic<bool> failed{false};
+	auto decompressChunks = [&]() {
+		while (!failed.load(std::memory_order_relaxed)) {
+			const uint32_t i = nextChunk.fetch_add(1, std::memory_order_relaxed);
+			if (i >= header.numChunks) break;
+			const uint64_t dstOffset = uint64_t(i) * header.chunkSize;
+			const size_t size = size_t(std::min(uint64_t(header.chunkSize),
+			                                    header.uncompressedSize - dstOffset));
+			const uint8_t* entry = table + i * CHUNK_TABLE_ENTRY_SIZE;
+			if (!decompressChunk(src + offsets[i], load32(entry), load32(entry + 4),
+			                     dst + dstOffset, size)) {
+				failed = true;
+			}
+		}
+	};
+
+	// Calling thread decompresses chunks as well
+	if (numThreads == 0) numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	numThreads = std::min(numThreads, header.numChunks);
+	vector<std::thread> threads;
+	for (uint32_t i = 1; i < numThreads; i++) threads.emplace_back(decompressChunks);
+	decompressChunks();
+	for (std::thread& thread : threads) thread.join();
+	return !failed;
+}
+
+bool decompress(const uint8_t* src, size_t srcSize, vector<uint8_t>& dst,
+                uint32_t numThreads) noexcept
+{
+	dst.clear();
+	StreamHeader header;
+	if (!readStreamHeader(src, srcSize, header)) return false;
+	const size_t tableSize = size_t(header.numChunks) * CHUNK_TABLE_ENTRY_SIZE;
+	if (tableSize > srcSize - STREAM_HEADER_SIZE) return false;
+	const uint8_t* table = src + STREAM_HEADER_SIZE;
+	if (!checkChunkTable(table, header, srcSize - STREAM_HEADER_SIZE - tableSize)) return false;
+
+	dst.resize(size_t(header.uncompressedSize));
+	if (decompress(src, srcSize, dst.data(), dst.size(), numThreads)) return true;
+	dst.clear();
+	return false;
+}
+
+// StreamDecompressor: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+bool StreamDecompressor::feed(const uint8_t* data, size_t size) noexcept
+{
+	if (mError) return false;
+
+	// Drop consumed input before appending
+	if (mInputOffset != 0 && mInputOffset >= mInput.size() / 2) {
+		mInput.erase(mInput.begin(), mInput.begin() + mInputOffset);
+		mInputOffset = 0;
+	}
+	mInput.insert(mInput.end(), data, data + size);
+
+	if (!mHeaderParsed && !this->parseHeader()) return !mError;
+	if (!this->decompressChunks()) mError = true;
+	return !mError;
+}
+
+vector<uint8_t> StreamDecompressor::takeOutput() noexcept
+{
+	vector<uint8_t> output = std::move(mOutput);
+	*this = StreamDecompressor();
+	return output;
+}
+
+// StreamDecompressor: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+bool StreamDecompressor::parseHeader() noexcept
+{
+	const size_t available = mInput.size() - mInputOffset;
+	if (available < STREAM_HEADER_SIZE) return false;
+	StreamHeader header;
+	if (!readStreamHeader(mInput.data() + mInputOffset, available, header)) {
+		mError = true;
+		return false;
+	}
+	const size_t tableSize = size_t(header.numChunks) * CHUNK_TABLE_ENTRY_SIZE;
+	if (available < STREAM_HEADER_SIZE + tableSize) return false;
+
+	const uint8_t* table = mInput.data() + mInputOffset + STREAM_HEADER_SIZE;
+	if (!checkChunkTable(table, header, UINT64_MAX)) {
+		mError = true;
+		return false;
+	}
+	mChunkSizes.resize(header.numChunks);
+	mChunkChecksums.resize(header.numChunks);
+	for (uint32_t i = 0; i < header.numChunks; i++) {
+		mChunkSizes[i] = load32(table + i * CHUNK_TABLE_ENTRY_SIZE);
+		mChunkChecksums[i] = load32(table + i * CHUNK_TABLE_ENTRY_SIZE + 4);
+	}
+	mChunkSize = header.chunkSize;
+	mUncompressedSize = header.uncompressedSize;
+	mInputOffset += STREAM_HEADER_SIZE + tableSize;
+	mHeaderParsed = true;
+	return true;
+}
+
+bool StreamDecompressor::decompressChunks() noexcept
+{
+	while (mNextChunk < mChunkSizes.size()) {
+		const size_t storedSize = mChunkSizes[mNextChunk] & ~RAW_CHUNK_BIT;
+		if (mInput.size() - mInputOffset < storedSize) break;
+		// Output grows as chunks arrive, so the stored sizes bound the amount of memory allocated
+		const size_t size = size_t(std::min(uint64_t(mChunkSize),
+		                                    mUncompressedSize - mNumDecompressed));
+		mOutput.resize(mNumDecompressed + size);
+		if (!decompressChunk(mInput.data() + mInputOffset, mChunkSizes[mNextChunk],
+		                     mChunkChecksums[mNextChunk], mOutput.data() + mNumDecompressed, size)) {
+			return false;
+		}
+		mInputOffset += storedSize;
+		mNumDecompressed += size;
+		mNextChunk++;
+	}
+	return true;
+}
+
+// Files
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+bool writeCompressedFile(const char* path, const uint8_t* data, size_t numBytes) noexcept
+{
+	vector<uint8_t> compressed = compress(data, numBytes);
+	return writeBinaryFile(path, compressed.data(), compressed.size());
+}
+
+vector<uint8_t> readCompressedFile(const char* path, uint32_t numThreads) noexcept
+{
+	MappedFile file{path, FileAccessHint::SEQUENTIAL};
+	if (!file.isValid()) return vector<uint8_t>();
+	if (!isCompressed(file.data(), file.size())) return vector<uint8_t>(file.begin(), file.end());
+	vector<uint8_t> data;
+	decompress(file.data(), file.size(), data, numThreads);
+	return data;
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,396 @@
+#include "sfz/util/FileWatcher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h> // NAME_MAX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+#if defined(__linux__)
+static const uint32_t INOTIFY_MASK = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                                     IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB;
+#endif
+
+static void splitPath(const string& path, string& dirOut, string& nameOut) noexcept
+{
+	size_t slash = path.find_last_of("/\\");
+	if (slash == string::npos) {
+		dirOut = ".";
+		nameOut = path;
+	}
+	else {
+		dirOut = slash == 0 ? "/" : path.substr(0, slash);
+		nameOut = path.substr(slash + 1);
+	}
+}
+
+// FileWatcher: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const uint64_t FileWatcher::INVALID_ID;
+
+// FileWatcher: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+FileWatcher::FileWatcher(uint32_t coalesceMs, uint32_t pollIntervalMs, bool forcePolling) noexcept
+:
+	mCoalesceDelay(std::chrono::milliseconds(coalesceMs)),
+	mPollInterval(std::chrono::milliseconds(std::max(pollIntervalMs, 1u)))
+{
+#if defined(__linux__)
+	if (pipe2(mWakePipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+		std::fprintf(stderr, "FileWatcher: pipe2() failed, errno: %i\n", errno);
+		mWakePipe[0] = mWakePipe[1] = -1;
+	}
+	if (!forcePolling) {
+		mInotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (mInotifyFd < 0) {
+			std::fprintf(stderr, "FileWatcher: inotify unavailable (errno: %i), polling files\n",
+			             errno);
+		}
+	}
+#else
+	(void)forcePolling;
+#endif
+	mLastPoll = Clock::now();
+	mThread = std::thread([this]() { this->threadMain(); });
+}
+
+FileWatcher::~FileWatcher() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mShutdown = true;
+	}
+	this->wakeThread();
+	mThread.join();
+#if defined(__linux__)
+	if (mInotifyFd >= 0) close(mInotifyFd);
+	if (mWakePipe[0] >= 0) close(mWakePipe[0]);
+	if (mWakePipe[1] >= 0) close(mWakePipe[1]);
+#endif
+}
+
+// FileWatcher: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint64_t FileWatcher::watch(const vector<string>& paths, FileWatchCallback callback) noexcept
+{
+	Watch watch;
+	watch.paths = paths;
+	std::sort(watch.paths.begin(), watch.paths.end());
+	watch.paths.erase(std::unique(watch.paths.begin(), watch.paths.end()), watch.paths.end());
+	watch.callback = std::move(callback);
+
+	uint64_t id;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (const string& path : watch.paths) this->addFile(path);
+		id = mNextId++;
+		mWatches[id] = std::move(watch);
+	}
+	this->wakeThread(); // Might need to start polling
+	return id;
+}
+
+uint64_t FileWatcher::watch(const char* path, FileWatchCallback callback) noexcept
+{
+	return this->watch(vector<string>{path}, std::move(callback));
+}
+
+bool FileWatcher::unwatch(uint64_t id) noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto itr = mWatches.find(id);
+	if (itr == mWatches.end()) return false;
+	for (const string& path : itr->second.paths) this->removeFile(path);
+	mWatches.erase(itr);
+	return true;
+}
+
+size_t FileWatcher::dispatch() noexcept
+{
+	vector<std::pair<uint64_t, vector<string>>> calls;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mNumPending == 0) return 0;
+
+		// Files with no events during the coalesce delay that actually changed
+		vector<string> changed;
+		const Clock::time_point now = Clock::now();
+		for (auto& pair : mFiles) {
+			WatchedFile& file = pair.second;
+			if (!file.pending || (now - file.lastEvent) < mCoalesceDelay) continue;
+			file.pending = false;
+			mNumPending--;
+			Signature signature = FileWatcher::fileSignature(pair.first);
+			if (signature == file.dispatchedSignature) continue;
+			file.dispatchedSignature = signature;
+			changed.push_back(pair.first);
+		}
+		if (changed.empty()) return 0;
+		std::sort(changed.begin(), changed.end());
+
+		for (auto& pair : mWatches) {
+			vector<string> paths;
+			std::set_intersection(pair.second.paths.begin(), pair.second.paths.end(),
+			                      changed.begin(), changed.end(), std::back_inserter(paths));
+			if (!paths.empty()) calls.emplace_back(pair.first, std::move(paths));
+		}
+		std::sort(calls.begin(), calls.end()); // Called in the order the watches were created
+	}
+
+	// Callbacks are called without holding the lock, skipped if unwatched by an earlier callback
+	size_t numCalled = 0;
+	for (auto& call : calls) {
+		FileWatchCallback callback;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			auto itr = mWatches.find(call.first);
+			if (itr == mWatches.end()) continue;
+			callback = itr->second.callback;
+		}
+		if (callback) callback(call.second);
+		numCalled++;
+	}
+	return numCalled;
+}
+
+// FileWatcher: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+size_t FileWatcher::numWatchedFiles() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mFiles.size();
+}
+
+size_t FileWatcher::numPolledFiles() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	size_t numPolled = 0;
+	for (auto& pair : mFiles) {
+		if (pair.second.wd < 0) numPolled++;
+	}
+	return numPolled;
+}
+
+// FileWatcher: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+FileWatcher::Signature FileWatcher::fileSignature(const string& path) noexcept
+{
+	Signature signature;
+#if defined(_WIN32)
+	struct _stat64 info;
+	if (_stat64(path.c_str(), &info) != 0) return signature;
+	signature.size = int64_t(info.st_size);
+	signature.mtimeNs = int64_t(info.st_mtime) * 1000000000;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) return signature;
+	signature.size = int64_t(info.st_size);
+#if defined(__APPLE__)
+	signature.mtimeNs = int64_t(info.st_mtimespec.tv_sec) * 1000000000 +
+	                    int64_t(info.st_mtimespec.tv_nsec);
+#else
+	signature.mtimeNs = int64_t(info.st_mtim.tv_sec) * 1000000000 + int64_t(info.st_mtim.tv_nsec);
+#endif
+#endif
+	return signature;
+}
+
+void FileWatcher::addFile(const string& path) noexcept
+{
+	WatchedFile& file = mFiles[path];
+	if (file.refCount++ != 0) return;
+
+	string dir;
+	splitPath(path, dir, file.name);
+	file.polledSignature = FileWatcher::fileSignature(path);
+	file.dispatchedSignature = file.polledSignature;
+
+#if defined(__linux__)
+	if (mInotifyFd < 0) return;
+	file.wd = inotify_add_watch(mInotifyFd, dir.c_str(), INOTIFY_MASK);
+	if (file.wd >= 0) mDirRefCounts[file.wd]++;
+#endif
+}
+
+void FileWatcher::removeFile(const string& path) noexcept
+{
+	auto itr = mFiles.find(path);
+	if (itr == mFiles.end()) return;
+	WatchedFile& file = itr->second;
+	if (--file.refCount != 0) return;
+
+#if defined(__linux__)
+	auto dirItr = mDirRefCounts.find(file.wd);
+	if (dirItr != mDirRefCounts.end() && --dirItr->second == 0) {
+		inotify_rm_watch(mInotifyFd, file.wd);
+		mDirRefCounts.erase(dirItr);
+	}
+#endif
+	if (file.pending) mNumPending--;
+	mFiles.erase(itr);
+}
+
+void FileWatcher::wakeThread() noexcept
+{
+#if defined(__linux__)
+	if (mWakePipe[1] >= 0) {
+		char byte = 0;
+		ssize_t res = write(mWakePipe[1], &byte, 1); // Pipe being full is fine
+		(void)res;
+		return;
+	}
+#endif
+	mWakeCondition.notify_one();
+}
+
+void FileWatcher::readInotifyEvents() noexcept
+{
+#if defined(__linux__)
+	alignas(struct inotify_event) char buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+	while (true) {
+		ssize_t numBytes = read(mInotifyFd, buffer, sizeof(buffer));
+		if (numBytes <= 0) break;
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		const Clock::time_point now = Clock::now();
+		for (ssize_t offset = 0; offset < numBytes;) {
+			const struct inotify_event* event = (const struct inotify_event*)(buffer + offset);
+			offset += sizeof(struct inotify_event) + event->len;
+
+			for (auto& pair : mFiles) {
+				WatchedFile& file = pair.second;
+				if (event->mask & IN_Q_OVERFLOW) {
+					// Events were lost, check all files
+				}
+				else if (event->mask & IN_IGNORED) {
+					// Directory was deleted (or unwatched), poll files until it is recreated and
+					// pollFiles() can add the watch again
+					if (file.wd != event->wd) continue;
+					file.wd = -1;
+					file.polledSignature = FileWatcher::fileSignature(pair.first);
+				}
+				else if (file.wd != event->wd || event->len == 0 || file.name != event->name) {
+					continue;
+				}
+				if (!file.pending) mNumPending++;
+				file.pending = true;
+				file.lastEvent = now;
+			}
+			if (event->mask & IN_IGNORED) mDirRefCounts.erase(event->wd);
+		}
+	}
+#endif
+}
+
+void FileWatcher::pollFiles() noexcept
+{
+	vector<string> paths;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		Clock::time_point now = Clock::now();
+		if ((now - mLastPoll) < mPollInterval) return;
+		mLastPoll = now;
+		for (auto& pair : mFiles) {
+			if (pair.second.wd < 0) paths.push_back(pair.first);
+		}
+	}
+	if (paths.empty()) return;
+
+	// Stat without holding the lock, files might have been unwatched in the meantime
+	vector<Signature> signatures;
+	signatures.reserve(paths.size());
+	for (const string& path : paths) signatures.push_back(FileWatcher::fileSignature(path));
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	const Clock::time_point now = Clock::now();
+	for (size_t i = 0; i < paths.size(); i++) {
+		auto itr = mFiles.find(paths[i]);
+		if (itr == mFiles.end() || itr->second.wd >= 0) continue;
+		WatchedFile& file = itr->second;
+#if defined(__linux__)
+		// Go back to inotify once the directory exists (again), stat the file again since it might
+		// have changed before the watch was added
+		if (mInotifyFd >= 0) {
+			string dir, name;
+			splitPath(paths[i], dir, name);
+			file.wd = inotify_add_watch(mInotifyFd, dir.c_str(), INOTIFY_MASK);
+			if (file.wd >= 0) {
+				mDirRefCounts[file.wd]++;
+				signatures[i] = FileWatcher::fileSignature(paths[i]);
+			}
+		}
+#endif
+		if (signatures[i] == file.polledSignature) continue;
+		file.polledSignature = signatures[i];
+		if (!file.pending) mNumPending++;
+		file.pending = true;
+		file.lastEvent = now;
+	}
+}
+
+void FileWatcher::threadMain() noexcept
+{
+#if defined(__linux__)
+	while (true) {
+		bool hasPolledFiles = false;
+		Clock::duration untilPoll;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mShutdown) break;
+			for (auto& pair : mFiles) {
+				if (pair.second.wd < 0) hasPolledFiles = true;
+			}
+			untilPoll = mPollInterval - (Clock::now() - mLastPoll);
+		}
+
+		// Sleep until inotify events arrive, or until it's time to poll files
+		int timeout = -1;
+		if (hasPolledFiles || mWakePipe[0] < 0) {
+			using std::chrono::milliseconds;
+			timeout = int(std::max(std::chrono::duration_cast<milliseconds>(untilPoll).count() + 1,
+			                       int64_t(0)));
+		}
+		struct pollfd fds[2];
+		nfds_t numFds = 0;
+		if (mWakePipe[0] >= 0) fds[numFds++] = {mWakePipe[0], POLLIN, 0};
+		if (mInotifyFd >= 0) fds[numFds++] = {mInotifyFd, POLLIN, 0};
+		poll(fds, numFds, timeout);
+
+		char drain[64];
+		while (mWakePipe[0] >= 0 && read(mWakePipe[0], drain, sizeof(drain)) > 0);
+		if (mInotifyFd >= 0) this->readInotifyEvents();
+		if (hasPolledFiles) this->pollFiles();
+	}
+#else
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mShutdown) {
+		mWakeCondition.wait_for(lock, mPollInterval);
+		if (mShutdown) break;
+		lock.unlock();
+		this->pollFiles();
+		lock.lock();
+	}
+#endif
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -1,45 +1,97 @@
 #include "sfz/util/FrametimeStats.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
-#include <new>
+#include <cstring>
 
 #include <sfz/Assert.hpp>
 
 namespace sfz {
 
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const size_t STRING_SIZE = 128;
+static const size_t HISTOGRAM_GROUP_SIZE = 32;
+static const size_t NUM_HISTOGRAM_GROUPS =
+	(FrametimeStats::NUM_HISTOGRAM_BUCKETS + HISTOGRAM_GROUP_SIZE - 1) / HISTOGRAM_GROUP_SIZE;
+
+static size_t histogramBucket(float sampleInSeconds) noexcept
+{
+	const float bucket = sampleInSeconds * (1000000.0f / FrametimeStats::HISTOGRAM_BUCKET_SIZE_US);
+	if (!(bucket >= 0.0f)) return 0; // Negative or NaN
+	const size_t lastBucket = FrametimeStats::NUM_HISTOGRAM_BUCKETS - 1;
+	if (bucket >= float(lastBucket)) return lastBucket;
+	return size_t(bucket);
+}
+
+// Index of next element in ring buffer, cheaper than modulo
+static size_t next(size_t index, size_t size) noexcept
+{
+	return (index + 1) == size ? 0 : (index + 1);
+}
+
+// Index of element offset steps (less than size) after index in ring buffer
+static size_t offset(size_t index, size_t offset, size_t size) noexcept
+{
+	const size_t result = index + offset;
+	return result >= size ? result - size : result;
+}
+
+// FrametimeStats: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const size_t FrametimeStats::NUM_HISTOGRAM_BUCKETS;
+const uint32_t FrametimeStats::HISTOGRAM_BUCKET_SIZE_US;
+
 // FrametimeStats: Constructors & destructors
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 FrametimeStats::FrametimeStats() noexcept
 :
 	mSamples{},
-	
+
 	mMaxNumSamples{0},
 	mCurrentNumSamples{0},
-
-	mMin{-1.0f}, 
-	mMax{-1.0f}, 
-	mAvg{-1.0f}, 
+	mFirstSample{0},
+
+	mMinQueue{},
+	mMaxQueue{},
+	mMinQueueFirst{0},
+	mMinQueueSize{0},
+	mMaxQueueFirst{0},
+	mMaxQueueSize{0},
+
+	mMean{0.0},
+	mM2{0.0},
+	mMin{-1.0f},
+	mMax{-1.0f},
+	mAvg{-1.0f},
 	mSD{-1.0f},
 
-	mString{}
+	mHistogram{},
+	mHistogramGroups{},
+	mPercentiles{-1.0f, -1.0f, -1.0f, -1.0f},
+	mPercentilesDirty{false},
+
+	mString{},
+	mStringDirty{false}
 { }
 
 FrametimeStats::FrametimeStats(size_t maxNumSamples) noexcept
 :
-	mSamples{new (std::nothrow) float[maxNumSamples]},
-	
-	mMaxNumSamples{maxNumSamples},
-	mCurrentNumSamples{0},
-
-	mMin{-1.0f}, 
-	mMax{-1.0f}, 
-	mAvg{-1.0f}, 
-	mSD{-1.0f},
-
-	mString{new (std::nothrow) char[128]}
-{ }
+	FrametimeStats{}
+{
+	mSamples = makeTaggedArray<float>(MemoryTag::PROFILING, maxNumSamples);
+	mMaxNumSamples = maxNumSamples;
+	mMinQueue = makeTaggedArray<size_t>(MemoryTag::PROFILING, maxNumSamples);
+	mMaxQueue = makeTaggedArray<size_t>(MemoryTag::PROFILING, maxNumSamples);
+	mHistogram = makeTaggedArray<uint32_t>(MemoryTag::PROFILING, NUM_HISTOGRAM_BUCKETS);
+	mHistogramGroups = makeTaggedArray<uint32_t>(MemoryTag::PROFILING, NUM_HISTOGRAM_GROUPS);
+	mString = makeTaggedArray<char>(MemoryTag::PROFILING, STRING_SIZE);
+	this->reset();
+}
 
 // FrametimeStats: Public methods
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -49,40 +101,137 @@ void FrametimeStats::addSample(float sampleInSeconds) noexcept
 	sfz_assert_debug(mMaxNumSamples > 0);
 	sfz_assert_debug(mCurrentNumSamples <= mMaxNumSamples);
 
+	const double x = sampleInSeconds;
+	size_t index;
+
+	// Replaces the oldest sample if full, updating the running moments incrementally
 	if (mMaxNumSamples == mCurrentNumSamples) {
-		for (size_t i = 0; i < (mMaxNumSamples-1); ++i) {
-			mSamples[i] = mSamples[i + 1];
+		index = mFirstSample;
+		const float removed = mSamples[index];
+		mFirstSample = next(mFirstSample, mMaxNumSamples);
+		const size_t removedBucket = histogramBucket(removed);
+		mHistogram[removedBucket]--;
+		mHistogramGroups[removedBucket / HISTOGRAM_GROUP_SIZE]--;
+
+		const double y = removed;
+		const double oldMean = mMean;
+		mMean += (x - y) / double(mCurrentNumSamples);
+		mM2 += (x - y) * (x - mMean + y - oldMean);
+
+		// The removed sample can only be in the front of the min and max queues
+		if (mMinQueueSize != 0 && mMinQueue[mMinQueueFirst] == index) {
+			mMinQueueFirst = next(mMinQueueFirst, mMaxNumSamples);
+			mMinQueueSize--;
+		}
+		if (mMaxQueueSize != 0 && mMaxQueue[mMaxQueueFirst] == index) {
+			mMaxQueueFirst = next(mMaxQueueFirst, mMaxNumSamples);
+			mMaxQueueSize--;
 		}
-		mSamples[mMaxNumSamples - 1] = sampleInSeconds;
 	}
 	else {
-		mSamples[mCurrentNumSamples] = sampleInSeconds;
+		index = offset(mFirstSample, mCurrentNumSamples, mMaxNumSamples);
 		mCurrentNumSamples++;
-	}
 
-	float sum = 0.0f;
-	mMin = 1000000000.0f;
-	mMax = -1000000000.0f;
-	for (size_t i = 0; i < mCurrentNumSamples; ++i) {
-		sum += mSamples[i];
-		mMin = std::min(mMin, mSamples[i]);
-		mMax = std::max(mMax, mSamples[i]);
+		const double delta = x - mMean;
+		mMean += delta / double(mCurrentNumSamples);
+		mM2 += delta * (x - mMean);
 	}
-	mAvg = sum / float(mCurrentNumSamples);
-
-	float varianceSum = 0.0f;
-	for (size_t i = 0; i < mCurrentNumSamples; ++i) {
-		varianceSum += std::pow((mSamples[i] - mAvg), 2);
+	mSamples[index] = sampleInSeconds;
+	const size_t bucket = histogramBucket(sampleInSeconds);
+	mHistogram[bucket]++;
+	mHistogramGroups[bucket / HISTOGRAM_GROUP_SIZE]++;
+
+	// Removes samples which can never become min (or max) again from the back of the queues,
+	// then adds the new sample. Each sample is added and removed once, so this is amortized O(1).
+	while (mMinQueueSize != 0 && mSamples[mMinQueue[offset(mMinQueueFirst, mMinQueueSize - 1,
+	                                       mMaxNumSamples)]] >= sampleInSeconds) {
+		mMinQueueSize--;
+	}
+	mMinQueue[offset(mMinQueueFirst, mMinQueueSize, mMaxNumSamples)] = index;
+	mMinQueueSize++;
+	while (mMaxQueueSize != 0 && mSamples[mMaxQueue[offset(mMaxQueueFirst, mMaxQueueSize - 1,
+	                                       mMaxNumSamples)]] <= sampleInSeconds) {
+		mMaxQueueSize--;
 	}
-	mSD = std::sqrt(varianceSum / float(mCurrentNumSamples));
+	mMaxQueue[offset(mMaxQueueFirst, mMaxQueueSize, mMaxNumSamples)] = index;
+	mMaxQueueSize++;
 
-	std::snprintf(&mString[0], 128, "Avg: %.1fms, SD: %.1fms, Min: %.1fms, Max: %.1fms",
-	              mAvg * 1000.0f, mSD * 1000.0f, mMin * 1000.0f, mMax * 1000.0f);
+	mMin = mSamples[mMinQueue[mMinQueueFirst]];
+	mMax = mSamples[mMaxQueue[mMaxQueueFirst]];
+	mAvg = float(mMean);
+	mSD = float(std::sqrt(std::max(mM2, 0.0) / double(mCurrentNumSamples)));
+
+	mPercentilesDirty = true;
+	mStringDirty = true;
 }
 
 void FrametimeStats::reset() noexcept
 {
 	mCurrentNumSamples = 0;
+	mFirstSample = 0;
+	mMinQueueFirst = mMinQueueSize = 0;
+	mMaxQueueFirst = mMaxQueueSize = 0;
+	mMean = mM2 = 0.0;
+	mMin = mMax = mAvg = mSD = -1.0f;
+	if (mHistogram != nullptr) {
+		std::memset(mHistogram.get(), 0, NUM_HISTOGRAM_BUCKETS * sizeof(uint32_t));
+		std::memset(mHistogramGroups.get(), 0, NUM_HISTOGRAM_GROUPS * sizeof(uint32_t));
+	}
+	mPercentilesDirty = true;
+	mStringDirty = true;
+}
+
+float FrametimeStats::percentile(float p) const noexcept
+{
+	if (mCurrentNumSamples == 0) return -1.0f;
+
+	// Nearest rank, the value of the sample which p of all samples are less than or equal to.
+	// Slightly reduced so that float percentiles such as 0.99f (0.99000001) round as expected.
+	const double exactRank = double(p) * double(mCurrentNumSamples) * (1.0 - 1e-6);
+	const size_t rank = std::max(size_t(1), std::min(mCurrentNumSamples,
+	                                                 size_t(std::ceil(exactRank))));
+
+	// Finds the group containing the rank, then the bucket within it
+	size_t count = 0, group = 0;
+	while (count + mHistogramGroups[group] < rank) {
+		count += mHistogramGroups[group];
+		group++;
+	}
+	size_t bucket = group * HISTOGRAM_GROUP_SIZE;
+	while (count + mHistogram[bucket] < rank) {
+		count += mHistogram[bucket];
+		bucket++;
+	}
+
+	if (bucket == NUM_HISTOGRAM_BUCKETS - 1) return mMax;
+	const float bucketMid = (float(bucket) + 0.5f) * (HISTOGRAM_BUCKET_SIZE_US / 1000000.0f);
+	return std::min(std::max(bucketMid, mMin), mMax);
+}
+
+const char* FrametimeStats::to_string() const noexcept
+{
+	if (mString == nullptr) return "";
+	if (mStringDirty) {
+		std::snprintf(&mString[0], STRING_SIZE, "Avg: %.1fms, SD: %.1fms, Min: %.1fms, Max: %.1fms",
+		              mAvg * 1000.0f, mSD * 1000.0f, mMin * 1000.0f, mMax * 1000.0f);
+		mStringDirty = false;
+	}
+	return &mString[0];
+}
+
+// FrametimeStats: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const float* FrametimeStats::cachedPercentiles() const noexcept
+{
+	if (mPercentilesDirty) {
+		mPercentiles[0] = percentile(0.5f);
+		mPercentiles[1] = percentile(0.9f);
+		mPercentiles[2] = percentile(0.99f);
+		mPercentiles[3] = percentile(0.999f);
+		mPercentilesDirty = false;
+	}
+	return mPercentiles;
 }
 
 } // namespace sfz
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "sfz/util/HitchDetector.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+
+#include "sfz/util/IO.hpp"
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const char* PHASE_NAMES[NUM_FRAME_PHASES] = { "events", "update", "render", "swap" };
+
+static const char* CSV_HEADER = "time_s,kind,frame,hitch_frame,frame_ms,events_ms,update_ms,"
+                                "render_ms,swap_ms,threshold_ms,num_frames,num_hitches,avg_ms,"
+                                "p50_ms,p99_ms,max_ms\n";
+
+static void writeCsvFrame(std::FILE* file, const char* kind, const FrameTimings& frame,
+                          const Hitch& hitch) noexcept
+{
+	std::fprintf(file, "%.6f,%s,%" PRIu64 ",%" PRIu64 ",%.3f", frame.timestamp, kind,
+	             frame.frameIndex, hitch.frame.frameIndex, frame.frameTime * 1000.0f);
+	for (float phaseTime : frame.phaseTimes) std::fprintf(file, ",%.3f", phaseTime * 1000.0f);
+	if (&frame == &hitch.frame) std::fprintf(file, ",%.3f,,,,,,\n", hitch.threshold * 1000.0f);
+	else std::fprintf(file, ",,,,,,,\n");
+}
+
+static void writeJsonFrame(std::FILE* file, const FrameTimings& frame) noexcept
+{
+	std::fprintf(file, "{\"time\":%.6f,\"frame\":%" PRIu64 ",\"frameMs\":%.3f,\"phasesMs\":{",
+	             frame.timestamp, frame.frameIndex, frame.frameTime * 1000.0f);
+	for (size_t i = 0; i < NUM_FRAME_PHASES; i++) {
+		std::fprintf(file, "%s\"%s\":%.3f", i == 0 ? "" : ",", PHASE_NAMES[i],
+		             frame.phaseTimes[i] * 1000.0f);
+	}
+	std::fprintf(file, "}}");
+}
+
+static void writeJsonFrames(std::FILE* file, const char* name,
+                            const vector<FrameTimings>& frames) noexcept
+{
+	std::fprintf(file, ",\"%s\":[", name);
+	for (size_t i = 0; i < frames.size(); i++) {
+		if (i != 0) std::fprintf(file, ",");
+		writeJsonFrame(file, frames[i]);
+	}
+	std::fprintf(file, "]");
+}
+
+// HitchDetector: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const size_t HitchDetector::MAX_NUM_STORED_HITCHES;
+
+// HitchDetector: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+HitchDetector::HitchDetector(float budget, float percentile, size_t numStatsSamples,
+                             size_t numContextFrames) noexcept
+:
+	mBudget{budget},
+	mPercentile{percentile},
+	mNumContextFrames{numContextFrames},
+	mStartTime{Clock::now()},
+	mStats{numStatsSamples},
+	mRecentFrames(numContextFrames)
+{ }
+
+HitchDetector::~HitchDetector() noexcept
+{
+	this->stopTelemetry();
+}
+
+// HitchDetector: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+bool HitchDetector::addFrame(const FrameTimings& timings) noexcept
+{
+	FrameTimings frame = timings;
+	frame.frameIndex = mNumFrames++;
+	frame.timestamp = std::chrono::duration<double>(Clock::now() - mStartTime).count();
+
+	// Threshold is determined before the frame is added to the statistics
+	const float frameThreshold = this->threshold();
+	const bool isHitch = frameThreshold > 0.0f && frame.frameTime > frameThreshold;
+	mStats.addSample(frame.frameTime);
+
+	// Adds frame as context to earlier hitches, completing them when enough frames are captured
+	for (size_t i = 0; i < mIncompleteHitches.size();) {
+		Hitch& hitch = mIncompleteHitches[i];
+		hitch.framesAfter.push_back(frame);
+		if (hitch.framesAfter.size() < mNumContextFrames) {
+			i++;
+			continue;
+		}
+		completeHitch(hitch);
+		mIncompleteHitches.erase(mIncompleteHitches.begin() + i);
+	}
+
+	if (isHitch) {
+		Hitch hitch;
+		hitch.frame = frame;
+		hitch.threshold = frameThreshold;
+		const uint64_t numBefore = std::min(uint64_t(mNumContextFrames), frame.frameIndex);
+		for (uint64_t i = numBefore; i > 0; i--) {
+			hitch.framesBefore.push_back(mRecentFrames[(frame.frameIndex - i) % mNumContextFrames]);
+		}
+		mNumHitches++;
+		mSummaryNumHitches++;
+		if (mNumContextFrames == 0) completeHitch(hitch);
+		else mIncompleteHitches.push_back(std::move(hitch));
+	}
+	if (mNumContextFrames != 0) mRecentFrames[frame.frameIndex % mNumContextFrames] = frame;
+
+	// Accumulates summary, which is queued once per flush interval
+	mSummaryNumFrames++;
+	for (size_t i = 0; i < NUM_FRAME_PHASES; i++) mSummaryPhaseSums[i] += frame.phaseTimes[i];
+	if (isTelemetryActive() && (frame.timestamp - mLastSummaryTime) >= mFlushInterval) {
+		queueSummary(frame.timestamp);
+	}
+
+	return isHitch;
+}
+
+bool HitchDetector::startTelemetry(const char* path, TelemetryFormat format,
+                                   uint32_t flushIntervalMs) noexcept
+{
+	this->stopTelemetry();
+
+	std::FILE* file = std::fopen(path, "ab");
+	if (file == nullptr) {
+		std::fprintf(stderr, "HitchDetector: Couldn't open telemetry file \"%s\"\n", path);
+		return false;
+	}
+	std::fseek(file, 0, SEEK_END);
+	if (format == TelemetryFormat::CSV && std::ftell(file) == 0) std::fputs(CSV_HEADER, file);
+	std::fclose(file);
+
+	mTelemetryFormat = format;
+	mTelemetryPath = path;
+	mFlushInterval = double(std::max(flushIntervalMs, 1u)) / 1000.0; // 0 would busy-wait
+	mLastSummaryTime = std::chrono::duration<double>(Clock::now() - mStartTime).count();
+	mSummaryNumFrames = 0;
+	mSummaryNumHitches = 0;
+	std::fill(mSummaryPhaseSums, mSummaryPhaseSums + NUM_FRAME_PHASES, 0.0);
+	mStopTelemetry = false;
+	mTelemetryThread = std::thread{&HitchDetector::telemetryThreadMain, this};
+	return true;
+}
+
+void HitchDetector::stopTelemetry() noexcept
+{
+	if (!mTelemetryThread.joinable()) return;
+
+	// Hitches still waiting for frames after them are completed with the frames available
+	for (Hitch& hitch : mIncompleteHitches) completeHitch(hitch);
+	mIncompleteHitches.clear();
+	if (mSummaryNumFrames != 0) {
+		queueSummary(std::chrono::duration<double>(Clock::now() - mStartTime).count());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mTelemetryMutex);
+		mStopTelemetry = true;
+	}
+	mTelemetryCondition.notify_one();
+	mTelemetryThread.join();
+}
+
+string HitchDetector::telemetryPath(const char* gameFolderName, TelemetryFormat format) noexcept
+{
+	const string& basePath = gameBaseFolderPath();
+	if (!directoryExists(basePath.c_str())) createDirectory(basePath.c_str());
+	const string folderPath = basePath + "/" + gameFolderName;
+	if (!directoryExists(folderPath.c_str())) createDirectory(folderPath.c_str());
+	return folderPath + (format == TelemetryFormat::CSV ? "/telemetry.csv" : "/telemetry.json");
+}
+
+// HitchDetector: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+float HitchDetector::threshold() const noexcept
+{
+	float result = mBudget;
+	if (mPercentile > 0.0f && mStats.currentNumSamples() == mStats.maxNumSamples()) {
+		const float percentileTime = mStats.percentile(mPercentile);
+		result = result > 0.0f ? std::min(result, percentileTime) : percentileTime;
+	}
+	return result;
+}
+
+// HitchDetector: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void HitchDetector::completeHitch(Hitch& hitch) noexcept
+{
+	if (isTelemetryActive()) {
+		std::lock_guard<std::mutex> lock(mTelemetryMutex);
+		mQueuedHitches.push_back(hitch);
+	}
+	if (mHitches.size() == MAX_NUM_STORED_HITCHES) mHitches.erase(mHitches.begin());
+	mHitches.push_back(std::move(hitch));
+}
+
+void HitchDetector::queueSummary(double timestamp) noexcept
+{
+	Summary summary;
+	summary.timestamp = timestamp;
+	summary.numFrames = mSummaryNumFrames;
+	summary.numHitches = mSummaryNumHitches;
+	summary.avg = mStats.avg();
+	summary.p50 = mStats.p50();
+	summary.p99 = mStats.p99();
+	summary.max = mStats.max();
+	for (size_t i = 0; i < NUM_FRAME_PHASES; i++) {
+		summary.phaseAvgs[i] = float(mSummaryPhaseSums[i] / double(std::max(mSummaryNumFrames,
+		                                                                    uint64_t(1))));
+		mSummaryPhaseSums[i] = 0.0;
+	}
+	mSummaryNumFrames = 0;
+	mSummaryNumHitches = 0;
+	mLastSummaryTime = timestamp;
+
+	std::lock_guard<std::mutex> lock(mTelemetryMutex);
+	mQueuedSummaries.push_back(summary);
+}
+
+void HitchDetector::telemetryThreadMain() noexcept
+{
+	const auto flushInterval = std::chrono::duration<double>(mFlushInterval);
+	vector<Hitch> hitches;
+	vector<Summary> summaries;
+	bool stop = false;
+	while (!stop) {
+		{
+			std::unique_lock<std::mutex> lock(mTelemetryMutex);
+			mTelemetryCondition.wait_for(lock, flushInterval, [this]() { return mStopTelemetry; });
+			stop = mStopTelemetry;
+			hitches.swap(mQueuedHitches);
+			summaries.swap(mQueuedSummaries);
+		}
+		if (hitches.empty() && summaries.empty()) continue;
+
+		std::FILE* file = std::fopen(mTelemetryPath.c_str(), "ab");
+		if (file == nullptr) {
+			std::fprintf(stderr, "HitchDetector: Couldn't open telemetry file \"%s\"\n",
+			             mTelemetryPath.c_str());
+		} else {
+			writeTelemetry(file, hitches, summaries);
+			std::fclose(file);
+		}
+		hitches.clear();
+		summaries.clear();
+	}
+}
+
+void HitchDetector::writeTelemetry(std::FILE* file, const vector<Hitch>& hitches,
+                                   const vector<Summary>& summaries) noexcept
+{
+	const bool csv = mTelemetryFormat == TelemetryFormat::CSV;
+	for (const Hitch& hitch : hitches) {
+		if (csv) {
+			for (const FrameTimings& frame : hitch.framesBefore) {
+				writeCsvFrame(file, "before", frame, hitch);
+			}
+			writeCsvFrame(file, "hitch", hitch.frame, hitch);
+			for (const FrameTimings& frame : hitch.framesAfter) {
+				writeCsvFrame(file, "after", frame, hitch);
+			}
+		} else {
+			std::fprintf(file, "{\"type\":\"hitch\",\"thresholdMs\":%.3f,\"frame\":",
+			             hitch.threshold * 1000.0f);
+			writeJsonFrame(file, hitch.frame);
+			writeJsonFrames(file, "before", hitch.framesBefore);
+			writeJsonFrames(file, "after", hitch.framesAfter);
+			std::fprintf(file, "}\n");
+		}
+	}
+
+	for (const Summary& summary : summaries) {
+		if (csv) {
+			std::fprintf(file, "%.6f,summary,,,", summary.timestamp);
+			for (float phaseAvg : summary.phaseAvgs) std::fprintf(file, ",%.3f", phaseAvg * 1000.0f);
+			std::fprintf(file, ",,%" PRIu64 ",%" PRIu64 ",%.3f,%.3f,%.3f,%.3f\n",
+			             summary.numFrames, summary.numHitches, summary.avg * 1000.0f,
+			             summary.p50 * 1000.0f, summary.p99 * 1000.0f, summary.max * 1000.0f);
+		} else {
+			std::fprintf(file, "{\"type\":\"summary\",\"time\":%.6f,\"numFrames\":%" PRIu64
+			             ",\"numHitches\":%" PRIu64 ",\"avgMs\":%.3f,\"p50Ms\":%.3f,"
+			             "\"p99Ms\":%.3f,\"maxMs\":%.3f,\"phaseAvgsMs\":{", summary.timestamp,
+			             summary.numFrames, summary.numHitches, summary.avg * 1000.0f,
+			             summary.p50 * 1000.0f, summary.p99 * 1000.0f, summary.max * 1000.0f);
+			for (size_t i = 0; i < NUM_FRAME_PHASES; i++) {
+				std::fprintf(file, "%s\"%s\":%.3f", i == 0 ? "" : ",", PHASE_NAMES[i],
+				             summary.phaseAvgs[i] * 1000.0f);
+			}
+			std::fprintf(file, "}}\n");
+		}
+	}
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -3,11 +3,14 @@
 
 #include <SDL.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio> // fopen, fwrite, BUFSIZ
 #include <cstdint>
 #include <cstring>
 
+#include <vector>
+
 #if defined(_WIN32)
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
@@ -15,11 +18,21 @@
 #include <shlobj.h>
 #include <direct.h>
 
-#elif defined(__APPLE__)
-#include <sys/stat.h>
-
-#elif defined(__unix)
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <copyfile.h>
+#elif defined(__linux__)
+#include <linux/fs.h> // FICLONE
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
 #endif
 
 namespace sfz {
@@ -61,29 +74,23 @@ const string& gameBaseFolderPath() noexcept
 
 bool fileExists(const char* path) noexcept
 {
-	std::FILE* file = std::fopen(path, "r");
-	if (file == NULL) return false;
-	std::fclose(file);
-	return true;
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(path);
+	return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+	struct stat info;
+	return stat(path, &info) == 0 && !S_ISDIR(info.st_mode);
+#endif
 }
 
 bool directoryExists(const char* path) noexcept
 {
 #ifdef _WIN32
-	std::FILE* file = std::fopen(path, "r");
-	if (file == NULL) {
-		DWORD ftyp = GetFileAttributesA(path);
-		if (ftyp == INVALID_FILE_ATTRIBUTES) return false;
-		if (ftyp & FILE_ATTRIBUTE_DIRECTORY) return true;
-		return false;
-	}
-	std::fclose(file);
-	return true;
+	DWORD attributes = GetFileAttributesA(path);
+	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
 #else
-	std::FILE* file = std::fopen(path, "r");
-	if (file == NULL) return false;
-	std::fclose(file);
-	return true;
+	struct stat info;
+	return stat(path, &info) == 0 && S_ISDIR(info.st_mode);
 #endif
 }
 
@@ -123,37 +130,300 @@ bool deleteDirectory(const char* path) noexcept
 #endif
 }
 
+// Records the first error of an operation
+static bool setError(FileOpResult& result, const string& path) noexcept
+{
+	if (result.errorCode == 0) {
+#ifdef _WIN32
+		result.errorCode = int(GetLastError());
+#else
+		result.errorCode = errno;
+#endif
+		if (result.errorCode == 0) result.errorCode = -1;
+		result.errorPath = path;
+	}
+	return false;
+}
+
+#ifndef _WIN32
+// Copies the contents of one file descriptor to another, trying the fastest methods first:
+// reflink (shares the data blocks on copy-on-write filesystems), kernel-side copy and finally a
+// user-space read/write loop. Returns number of bytes copied, negative value on error.
+static int64_t copyFileDescriptor(int srcFd, int dstFd, uint64_t size) noexcept
+{
+#if defined(__APPLE__)
+	(void)size;
+	if (fcopyfile(srcFd, dstFd, nullptr, COPYFILE_DATA) != 0) return -1;
+	struct stat info;
+	if (fstat(dstFd, &info) != 0) return -1;
+	return int64_t(info.st_size);
+#else
+	uint64_t numCopied = 0;
+
+#if defined(__linux__)
+#ifdef FICLONE
+	if (ioctl(dstFd, FICLONE, srcFd) == 0) return int64_t(size);
+#endif
+
+	// copy_file_range() (can also reflink or copy server-side on network filesystems), then
+	// sendfile(). Both copy without any data passing through user space.
+	bool kernelCopy = true;
+#ifdef SYS_copy_file_range
+	while (numCopied < size) {
+		size_t chunk = size_t(std::min(size - numCopied, uint64_t(1u << 30)));
+		ssize_t res = syscall(SYS_copy_file_range, srcFd, nullptr, dstFd, nullptr, chunk, 0u);
+		if (res > 0) {
+			numCopied += uint64_t(res);
+			continue;
+		}
+		if (res == 0) break; // File shrunk while copying
+		if (errno == EINTR) continue;
+		if (numCopied != 0) return -1;
+		kernelCopy = errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP;
+		if (!kernelCopy) return -1;
+		break;
+	}
+	if (numCopied == size) return int64_t(numCopied);
+#endif
+	while (kernelCopy && numCopied < size) {
+		size_t chunk = size_t(std::min(size - numCopied, uint64_t(1u << 30)));
+		ssize_t res = sendfile(dstFd, srcFd, nullptr, chunk);
+		if (res > 0) {
+			numCopied += uint64_t(res);
+			continue;
+		}
+		if (res == 0) return int64_t(numCopied);
+		if (errno == EINTR) continue;
+		if (numCopied != 0 || (errno != EINVAL && errno != ENOSYS)) return -1;
+		break;
+	}
+	if (numCopied == size) return int64_t(numCopied);
+#else
+	(void)size;
+#endif
+
+	// User-space fallback, continues from wherever the above stopped
+	std::vector<uint8_t> buffer(1024 * 1024);
+	while (true) {
+		ssize_t numRead = read(srcFd, buffer.data(), buffer.size());
+		if (numRead < 0 && errno == EINTR) continue;
+		if (numRead < 0) return -1;
+		if (numRead == 0) break;
+		ssize_t offset = 0;
+		while (offset < numRead) {
+			ssize_t numWritten = write(dstFd, buffer.data() + offset, size_t(numRead - offset));
+			if (numWritten < 0 && errno == EINTR) continue;
+			if (numWritten <= 0) return -1;
+			offset += numWritten;
+		}
+		numCopied += uint64_t(numRead);
+	}
+	return int64_t(numCopied);
+#endif
+}
+#endif
+
+// Lists the entries of a directory, excluding "." and "..". Symbolic links (reparse points on
+// Windows) are listed separately regardless of what they point to, so they are never followed.
+static bool listDirectory(const string& path, vector<string>& filesOut,
+                          vector<string>& directoriesOut, vector<string>& linksOut) noexcept
+{
+#ifdef _WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((path + "\\*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE) return false;
+	do {
+		if (std::strcmp(data.cFileName, ".") == 0 || std::strcmp(data.cFileName, "..") == 0) continue;
+		if ((data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0) {
+			linksOut.push_back(data.cFileName);
+		} else if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+			directoriesOut.push_back(data.cFileName);
+		} else {
+			filesOut.push_back(data.cFileName);
+		}
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+	return true;
+#else
+	DIR* dir = opendir(path.c_str());
+	if (dir == nullptr) return false;
+	while (struct dirent* entry = readdir(dir)) {
+		if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) continue;
+		struct stat info;
+		if (lstat((path + "/" + entry->d_name).c_str(), &info) != 0) {
+			filesOut.push_back(entry->d_name); // Reported by whoever tries to use it
+		} else if (S_ISLNK(info.st_mode)) {
+			linksOut.push_back(entry->d_name);
+		} else if (S_ISDIR(info.st_mode)) {
+			directoriesOut.push_back(entry->d_name);
+		} else {
+			filesOut.push_back(entry->d_name);
+		}
+	}
+	closedir(dir);
+	return true;
+#endif
+}
+
+// Copies a symbolic link itself rather than what it points to. The target is copied verbatim, so
+// relative links point into the destination tree. On Windows links to files are copied as
+// regular files and links to directories (e.g. junctions) are skipped.
+static bool copyLink(const string& srcPath, const string& dstPath, FileOpResult& result) noexcept
+{
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(srcPath.c_str());
+	if (attributes == INVALID_FILE_ATTRIBUTES) return setError(result, srcPath);
+	if ((attributes & FILE_ATTRIBUTE_DIRECTORY) != 0) return true;
+	return copyFile(srcPath.c_str(), dstPath.c_str(), result);
+#else
+	vector<char> target(256);
+	while (true) {
+		ssize_t length = readlink(srcPath.c_str(), target.data(), target.size());
+		if (length < 0) return setError(result, srcPath);
+		if (size_t(length) < target.size()) {
+			target[size_t(length)] = '\0';
+			break;
+		}
+		target.resize(target.size() * 2); // Possibly truncated
+	}
+	unlink(dstPath.c_str()); // symlink() does not overwrite
+	if (symlink(target.data(), dstPath.c_str()) != 0) return setError(result, dstPath);
+	result.numFiles += 1;
+	return true;
+#endif
+}
+
 bool copyFile(const char* srcPath, const char* dstPath) noexcept
 {
-	uint8_t buffer[BUFSIZ];
+	FileOpResult result;
+	return copyFile(srcPath, dstPath, result);
+}
 
-	std::FILE* source = std::fopen(srcPath, "rb");
-	if (source == NULL) return false;
-	std::FILE* destination = std::fopen(dstPath, "wb");
-	if (destination == NULL) {
-		std::fclose(source);
+bool copyFile(const char* srcPath, const char* dstPath, FileOpResult& result) noexcept
+{
+#ifdef _WIN32
+	// CopyFile() copies in the kernel, and uses block cloning where the filesystem supports it
+	int64_t size = sizeofFile(srcPath);
+	if (size < 0) return setError(result, srcPath);
+	if (!CopyFileA(srcPath, dstPath, FALSE)) return setError(result, dstPath);
+	result.numBytes += uint64_t(size);
+	result.numFiles += 1;
+	return true;
+#else
+	int srcFd = open(srcPath, O_RDONLY);
+	if (srcFd == -1) return setError(result, srcPath);
+	struct stat info;
+	if (fstat(srcFd, &info) != 0) {
+		setError(result, srcPath);
+		close(srcFd);
+		return false;
+	}
+	if (S_ISDIR(info.st_mode)) {
+		errno = EISDIR;
+		setError(result, srcPath);
+		close(srcFd);
+		return false;
+	}
+	int dstFd = open(dstPath, O_WRONLY | O_CREAT | O_TRUNC, info.st_mode & 0777);
+	if (dstFd == -1) {
+		setError(result, dstPath);
+		close(srcFd);
 		return false;
 	}
 
-	size_t size;
-	while ((size = std::fread(buffer, 1, BUFSIZ, source)) > 0) {
-		std::fwrite(buffer, 1, size, destination);
+	int64_t numCopied = copyFileDescriptor(srcFd, dstFd, uint64_t(info.st_size));
+	if (numCopied < 0) setError(result, dstPath);
+	close(srcFd);
+
+	// Errors when writing may not be reported until the file is closed
+	if (close(dstFd) != 0 && numCopied >= 0) {
+		setError(result, dstPath);
+		numCopied = -1;
+	}
+	if (numCopied < 0) {
+		unlink(dstPath); // Don't leave a partial copy
+		return false;
 	}
+	result.numBytes += uint64_t(numCopied);
+	result.numFiles += 1;
+	return true;
+#endif
+}
 
-	std::fclose(source);
-	std::fclose(destination);
+bool copyDirectory(const char* srcPath, const char* dstPath) noexcept
+{
+	FileOpResult result;
+	return copyDirectory(srcPath, dstPath, result);
+}
 
+bool copyDirectory(const char* srcPath, const char* dstPath, FileOpResult& result) noexcept
+{
+	vector<string> files, directories, links;
+	if (!listDirectory(srcPath, files, directories, links)) return setError(result, srcPath);
+	if (!directoryExists(dstPath) && !createDirectory(dstPath)) return setError(result, dstPath);
+
+	const string src = string(srcPath) + "/";
+	const string dst = string(dstPath) + "/";
+	for (const string& file : files) {
+		if (!copyFile((src + file).c_str(), (dst + file).c_str(), result)) return false;
+	}
+	for (const string& link : links) {
+		if (!copyLink(src + link, dst + link, result)) return false;
+	}
+	for (const string& directory : directories) {
+		if (!copyDirectory((src + directory).c_str(), (dst + directory).c_str(), result)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool deleteDirectoryRecursive(const char* path) noexcept
+{
+	FileOpResult result;
+	return deleteDirectoryRecursive(path, result);
+}
+
+bool deleteDirectoryRecursive(const char* path, FileOpResult& result) noexcept
+{
+	// Links are removed like files, without touching what they point to
+	vector<string> files, directories;
+	if (!listDirectory(path, files, directories, files)) return setError(result, path);
+
+	const string base = string(path) + "/";
+	for (const string& file : files) {
+		const string filePath = base + file;
+#ifdef _WIN32
+		// Junctions to directories are removed as directories, without touching the contents
+		DWORD attributes = GetFileAttributesA(filePath.c_str());
+		bool removed = (attributes != INVALID_FILE_ATTRIBUTES &&
+		                (attributes & FILE_ATTRIBUTE_DIRECTORY)) ?
+		               RemoveDirectoryA(filePath.c_str()) : DeleteFileA(filePath.c_str());
+		if (!removed) return setError(result, filePath);
+#else
+		if (unlink(filePath.c_str()) != 0) return setError(result, filePath);
+#endif
+		result.numFiles += 1;
+	}
+	for (const string& directory : directories) {
+		if (!deleteDirectoryRecursive((base + directory).c_str(), result)) return false;
+	}
+	if (!deleteDirectory(path)) return setError(result, path);
 	return true;
 }
 
 int64_t sizeofFile(const char* path) noexcept
 {
-	std::FILE* file = std::fopen(path, "rb");
-	if (file == NULL) return -1;
-	std::fseek(file, 0, SEEK_END);
-	int64_t size = std::ftell(file);
-	std::fclose(file);
-	return size;
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) return -1;
+	if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) return -1;
+	return (int64_t(data.nFileSizeHigh) << 32) | int64_t(data.nFileSizeLow);
+#else
+	struct stat info;
+	if (stat(path, &info) != 0 || S_ISDIR(info.st_mode)) return -1;
+	return int64_t(info.st_size);
+#endif
 }
 
 int32_t readBinaryFile(const char* path, uint8_t* dataOut, size_t maxNumBytes) noexcept
@@ -162,25 +432,11 @@ int32_t readBinaryFile(const char* path, uint8_t* dataOut, size_t maxNumBytes) n
 	std::FILE* file = std::fopen(path, "rb");
 	if (file == NULL) return -1;
 
-	// Read the file into memory
-	uint8_t buffer[BUFSIZ];
-	size_t readSize;
-	size_t currOffs = 0;
-	while ((readSize = std::fread(buffer, 1, BUFSIZ, file)) > 0) {
-
-		// Check if memory has enough space left
-		if ((currOffs + readSize) > maxNumBytes) {
-			std::fclose(file);
-			std::memcpy(dataOut + currOffs, buffer, maxNumBytes - currOffs);
-			return -2;
-		}
-
-		std::memcpy(dataOut + currOffs, buffer, readSize);
-		currOffs += readSize;
-	}
-
+	// Read directly into memory, one byte more than allowed to detect if file is too large
+	size_t readSize = std::fread(dataOut, 1, maxNumBytes, file);
+	bool tooLarge = (readSize == maxNumBytes) && (std::fgetc(file) != EOF);
 	std::fclose(file);
-	return 0;
+	return tooLarge ? -2 : 0;
 }
 
 vector<uint8_t> readBinaryFile(const char* path) noexcept
@@ -198,24 +454,10 @@ vector<uint8_t> readBinaryFile(const char* path) noexcept
 		return vector<uint8_t>{};
 	}
 
-	// Create vector with enough capacity to fit file
+	// Read the file directly into the vector with a single call
 	vector<uint8_t> temp(static_cast<size_t>(size));
-
-	// Read the file into the vector
-	uint8_t buffer[BUFSIZ];
-	size_t readSize;
-	size_t currOffs = 0;
-	while ((readSize = std::fread(buffer, 1, BUFSIZ, file)) > 0) {
-
-		// Ensure vector has space.
-		if ((temp.data() + currOffs + readSize) > (temp.data() + temp.size())) {
-			size_t diff = (temp.data() + currOffs + readSize) - (temp.data() + temp.size());
-			temp.resize(temp.size() + diff, 0);
-		}
-
-		std::memcpy(temp.data() + currOffs, buffer, readSize);
-		currOffs += readSize;
-	}
+	size_t readSize = std::fread(temp.data(), 1, temp.size(), file);
+	temp.resize(readSize);
 
 	std::fclose(file);
 	return std::move(temp);
@@ -1,23 +1,190 @@
 #include "sfz/util/IniParser.hpp"
 
 #include "sfz/Assert.hpp"
+#include "sfz/util/MappedFile.hpp"
 
 #include <algorithm>
 #include <cctype> // std::tolower()
-#include <fstream>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib> // std::strtol(), std::strtof()
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h> // fsync()
+#endif
 
 namespace sfz {
 
 // Static functions
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
-static void toLowerCase(string& str) noexcept
+static const uint32_t NOT_FOUND = ~0u;
+static const uint8_t IS_BOOL = 1, IS_INT = 2, IS_FLOAT = 4;
+
+static uint32_t hashString(const char* str, size_t length, uint32_t seed = 2166136261u) noexcept
 {
-	for (size_t i = 0; i < str.size(); ++i) {
-		str[i] = std::tolower(str[i]);
+	// FNV-1a
+	uint32_t hash = seed;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= uint8_t(str[i]);
+		hash *= 16777619u;
 	}
+	return hash;
 }
 
+// Keys are hashed with the hash of their section as seed
+static uint32_t hashItem(uint32_t sectionHash, const char* key, size_t keyLength) noexcept
+{
+	return hashString(key, keyLength, (sectionHash ^ 0xFFu) * 16777619u);
+}
+
+static bool equalsIgnoreCase(const char* str, size_t length, const char* lower) noexcept
+{
+	size_t i = 0;
+	for (; i < length; i++) {
+		if (lower[i] == '\0' || std::tolower(uint8_t(str[i])) != lower[i]) return false;
+	}
+	return lower[i] == '\0';
+}
+
+static void insertIndex(vector<uint32_t>& table, uint32_t hash, uint32_t index) noexcept
+{
+	const size_t mask = table.size() - 1;
+	size_t i = hash & mask;
+	while (table[i] != 0) i = (i + 1) & mask;
+	table[i] = index + 1;
+}
+
+// Rebuilds a hash table with at least twice the capacity needed by minNumEntries
+template<typename T>
+static void rebuildTable(vector<uint32_t>& table, const vector<T>& entries,
+                         size_t minNumEntries) noexcept
+{
+	size_t capacity = 16;
+	while (capacity < minNumEntries * 2) capacity *= 2;
+	table.assign(capacity, 0);
+	for (size_t i = 0; i < entries.size(); i++) insertIndex(table, entries[i].hash, uint32_t(i));
+}
+
+// Writes to a temporary file which then replaces the old file
+static bool writeFileAtomic(const string& path, const string& text) noexcept
+{
+	const string tmpPath = path + ".tmp";
+	std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+	if (file == nullptr) {
+		std::fprintf(stderr, "IniParser: Could not open \"%s\" for writing\n", tmpPath.c_str());
+		return false;
+	}
+	bool success = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+	success = std::fflush(file) == 0 && success;
+#ifndef _WIN32
+	success = success && fsync(fileno(file)) == 0; // Data must be on disk before renaming
+#endif
+	success = std::fclose(file) == 0 && success;
+
+	if (success) {
+#ifdef _WIN32
+		success = MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		success = std::rename(tmpPath.c_str(), path.c_str()) == 0;
+#endif
+	}
+	if (!success) {
+		std::fprintf(stderr, "IniParser: Failed to save \"%s\"\n", path.c_str());
+		std::remove(tmpPath.c_str());
+	}
+	return success;
+}
+
+// IniParser: AsyncSaver
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+struct IniParser::AsyncSaver final {
+	std::mutex mutex;
+	std::condition_variable condition;
+	string path, text;
+	std::chrono::steady_clock::time_point deadline;
+	bool hasPending = false, writing = false, flushing = false, shutdown = false, failed = false;
+	std::thread thread;
+
+	AsyncSaver() noexcept
+	{
+		thread = std::thread([this]() { this->threadMain(); });
+	}
+
+	// Writes any pending save before returning
+	~AsyncSaver() noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			shutdown = true;
+		}
+		condition.notify_all();
+		thread.join();
+	}
+
+	void save(const string& pathIn, const string& textIn, uint32_t delayMs) noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			path = pathIn;
+			text = textIn;
+			hasPending = true;
+			deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs);
+		}
+		condition.notify_all();
+	}
+
+	// Returns whether all writes since the last flush succeeded
+	bool flush() noexcept
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		flushing = true;
+		condition.notify_all();
+		condition.wait(lock, [this]() { return !hasPending && !writing; });
+		flushing = false;
+		bool success = !failed;
+		failed = false;
+		return success;
+	}
+
+	void threadMain() noexcept
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			if (!hasPending) {
+				if (shutdown) break;
+				condition.wait(lock);
+				continue;
+			}
+			if (!shutdown && !flushing && std::chrono::steady_clock::now() < deadline) {
+				condition.wait_until(lock, deadline);
+				continue;
+			}
+
+			string writePath = path, writeText;
+			std::swap(writeText, text);
+			hasPending = false;
+			writing = true;
+			lock.unlock();
+			bool success = writeFileAtomic(writePath, writeText);
+			lock.lock();
+			writing = false;
+			if (!success) failed = true;
+			condition.notify_all();
+		}
+	}
+};
+
 // IniParser: Constructors & destructors
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -25,78 +192,113 @@ IniParser::IniParser(const string& path) noexcept
 :
 	mPath{path}
 { }
-	
+
 // IniParser: Loading and saving to file functions
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 bool IniParser::load() noexcept
 {
-	std::ifstream file{mPath};
-	if (!file.is_open()) return false;
-
-	mIniTree.clear();
+	if (mAsyncSaver != nullptr) mAsyncSaver->flush(); // Don't load a file about to be replaced
+
+	MappedFile file{mPath.c_str(), FileAccessHint::SEQUENTIAL};
+	if (!file.isValid()) return false;
+
+	this->clear();
+	const char* const begin = reinterpret_cast<const char*>(file.data());
+	const char* const end = begin + file.size();
+	mFileText.assign(begin, end);
+
+	// Reserve enough memory for the entire file, so that loading only allocates a few times
+	size_t numLines = size_t(std::count(begin, end, '\n')) + 1;
+	mArena.reserve(file.size() + numLines + 1);
+	mItems.reserve(numLines);
+	mLines.reserve(numLines);
+	rebuildTable(mItemTable, mItems, numLines);
+
+	bool success = true;
+	uint32_t currentSection = NOT_FOUND; // The global section is created on its first item
+	const char* data = begin;
+	while (data < end) {
+		const char* line = data;
+		const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+		if (lineEnd == nullptr) lineEnd = end;
+		data = lineEnd == end ? end : lineEnd + 1;
+		const size_t length = size_t(lineEnd - line);
+
+		Line fileLine;
+		fileLine.offset = uint32_t(line - begin);
+		fileLine.length = uint32_t(length);
+		if (length == 0 || line[0] == ';') { // Empty lines and comments
+			mLines.push_back(fileLine);
+			continue;
+		}
 
-	std::string str;
-	std::string currentSection = "";
-	while (std::getline(file, str)) {
-		if (str == "") continue;
-		if (str[0] == ';') continue; // Remove comments
-		
 		// Check if new section
-		size_t sectLoc = str.find_first_of("[");
-		if (sectLoc != str.npos) {
-			size_t endLoc = str.find_first_of("]");
-			if (endLoc == str.npos) return false;
-			if (sectLoc >= endLoc) return false;
-			currentSection = str.substr(sectLoc+1, endLoc-sectLoc-1);
-			mIniTree.emplace(std::make_pair(currentSection, map<string,string>{}));
+		const char* sectStart = static_cast<const char*>(std::memchr(line, '[', length));
+		if (sectStart != nullptr) {
+			const char* sectEnd = static_cast<const char*>(std::memchr(line, ']', length));
+			if (sectEnd == nullptr || sectStart >= sectEnd) {
+				success = false;
+				break;
+			}
+			currentSection = this->findOrAddSection(sectStart + 1,
+			                                        size_t(sectEnd - sectStart - 1));
+			fileLine.type = LineType::SECTION;
+			fileLine.index = currentSection;
+			mLines.push_back(fileLine);
 			continue;
 		}
 
-		// Add item to tree
-		size_t delimLoc = str.find_first_of("=");
-		if (delimLoc == str.npos) return false;
-		if (delimLoc == 0) return false;
-		if (delimLoc+1 == str.size()) return false;
-		mIniTree[currentSection][str.substr(0, delimLoc)] = str.substr(delimLoc+1, str.size()-delimLoc+1);
+		// Add item
+		const char* delim = static_cast<const char*>(std::memchr(line, '=', length));
+		if (delim == nullptr || delim == line || delim + 1 == lineEnd) {
+			success = false;
+			break;
+		}
+		if (currentSection == NOT_FOUND) currentSection = this->findOrAddSection("", 0);
+		fileLine.type = LineType::ITEM;
+		fileLine.index = this->set(currentSection, line, size_t(delim - line), delim + 1,
+		                           size_t(lineEnd - delim - 1));
+		mLines.push_back(fileLine);
 	}
 
-	return true;
+	// Everything loaded is in the file, i.e. not dirty
+	for (Section& section : mSections) section.dirty = false;
+	for (Item& item : mItems) {
+		item.dirty = false;
+		item.inFile = true;
+	}
+	mDirty = false;
+	mWriteFailed = false;
+	return success;
 }
 
 bool IniParser::save() noexcept
 {
-	// Check if current file is correct
-	IniParser oldFileParser = *this;
-	oldFileParser.load();
-	if (mIniTree == oldFileParser.mIniTree) return true;
-
-	// Opens the file and clears it
-	std::ofstream file{mPath, std::ofstream::out | std::ofstream::trunc};
-	if (!file.is_open()) return false;
+	// Pending background saves are written first so that they can't overwrite this save
+	bool asyncFailed = mAsyncSaver != nullptr && !mAsyncSaver->flush();
+	if (!mDirty && !mWriteFailed && !asyncFailed) return true;
 
-	// Adds the global items first
-	auto globalItr = mIniTree.find("");
-	if (globalItr != mIniTree.end()) {
-		for (auto& keyPair : globalItr->second) {
-			file << keyPair.first << "=" << keyPair.second << "\n";
-		}
-		file << "\n";
-	}
+	this->updateFileText();
+	mWriteFailed = !writeFileAtomic(mPath, mFileText);
+	return !mWriteFailed;
+}
 
-	// Adds the rest of the sections and items
-	for (auto& sectionPair : mIniTree) {
-		if (sectionPair.first == "") continue;
-		file << "[" << sectionPair.first << "]" << "\n";
-		
-		for (auto& keyPair : sectionPair.second) {
-			file << keyPair.first << "=" << keyPair.second << "\n";
-		}
-		file << "\n";
-	}
+void IniParser::saveAsync(uint32_t delayMs) noexcept
+{
+	if (!mDirty && !mWriteFailed) return;
+	this->updateFileText();
+	mWriteFailed = false;
+	if (mAsyncSaver == nullptr) mAsyncSaver = std::make_shared<AsyncSaver>();
+	mAsyncSaver->save(mPath, mFileText, delayMs);
+}
 
-	file.flush();
-	return true;
+bool IniParser::flushAsyncSave() noexcept
+{
+	if (mAsyncSaver == nullptr) return true;
+	if (mAsyncSaver->flush()) return true;
+	mWriteFailed = true;
+	return false;
 }
 
 // IniParser: Info about a specific item
@@ -104,57 +306,25 @@ bool IniParser::save() noexcept
 
 bool IniParser::itemExists(const string& section, const string& key) const noexcept
 {
-	auto sectionItr = mIniTree.find(section);
-	if (sectionItr == mIniTree.end()) return false;
-	auto keyItr = sectionItr->second.find(key);
-	if (keyItr == sectionItr->second.end()) return false;
-	return true;
+	return this->findItem(section, key) != nullptr;
 }
 
 bool IniParser::itemIsBool(const string& section, const string& key) const noexcept
 {
-	auto sectionItr = mIniTree.find(section);
-	if (sectionItr == mIniTree.end()) return false;
-	auto keyItr = sectionItr->second.find(key);
-	if (keyItr == sectionItr->second.end()) return false;
-
-	string val = keyItr->second;
-	toLowerCase(val);
-	return val == "true" || val == "false"
-	    || val == "on" || val == "off"
-	    || val == "1" || val == "0";
+	const Item* item = this->findItem(section, key);
+	return item != nullptr && (item->typeFlags & IS_BOOL) != 0;
 }
 
 bool IniParser::itemIsInt(const string& section, const string& key) const noexcept
 {
-	auto sectionItr = mIniTree.find(section);
-	if (sectionItr == mIniTree.end()) return false;
-	auto keyItr = sectionItr->second.find(key);
-	if (keyItr == sectionItr->second.end()) return false;
-
-	string val = keyItr->second;
-	try {
-		std::stoi(val);
-		return true;
-	} catch (...) {
-		return false;
-	}
+	const Item* item = this->findItem(section, key);
+	return item != nullptr && (item->typeFlags & IS_INT) != 0;
 }
 
 bool IniParser::itemIsFloat(const string& section, const string& key) const noexcept
 {
-	auto sectionItr = mIniTree.find(section);
-	if (sectionItr == mIniTree.end()) return false;
-	auto keyItr = sectionItr->second.find(key);
-	if (keyItr == sectionItr->second.end()) return false;
-
-	string val = keyItr->second;
-	try {
-		std::stof(val);
-		return true;
-	} catch (...) {
-		return false;
-	}
+	const Item* item = this->findItem(section, key);
+	return item != nullptr && (item->typeFlags & IS_FLOAT) != 0;
 }
 
 // IniParser: Getters
@@ -163,50 +333,33 @@ bool IniParser::itemIsFloat(const string& section, const string& key) const noex
 string IniParser::getString(const string& section, const string& key,
                             const string& defaultValue) const noexcept
 {
-	auto sectionItr = mIniTree.find(section);
-	if (sectionItr == mIniTree.end()) return defaultValue;
-	auto keyItr = sectionItr->second.find(key);
-	if (keyItr == sectionItr->second.end()) return defaultValue;
-	return keyItr->second;
+	const Item* item = this->findItem(section, key);
+	if (item == nullptr) return defaultValue;
+	return string(str(item->value), item->value.length);
 }
 
 bool IniParser::getBool(const string& section, const string& key,
                         bool defaultValue) const noexcept
 {
-	string val = this->getString(section, key, defaultValue ? "true" : "false");
-	toLowerCase(val);
-	if (val == "true") return true;
-	if (val == "on") return true;
-	if (val == "1") return true;
-	return false;
-
+	const Item* item = this->findItem(section, key);
+	if (item == nullptr) return defaultValue;
+	return item->boolValue;
 }
 
 int32_t IniParser::getInt(const string& section, const string& key,
                           int32_t defaultValue) const noexcept
 {
-	string val = this->getString(section, key, std::to_string(defaultValue));
-	int32_t value;
-	try {
-		value = std::stoi(val);
-	} catch (...) {
-		value = defaultValue;
-	}
-	return value;
+	const Item* item = this->findItem(section, key);
+	if (item == nullptr || (item->typeFlags & IS_INT) == 0) return defaultValue;
+	return item->intValue;
 }
 
 float IniParser::getFloat(const string& section, const string& key,
                           float defaultValue) const noexcept
 {
-	string val = this->getString(section, key, std::to_string(defaultValue));
-	float value;
-	try {
-		value = std::stof(val);
-	}
-	catch (...) {
-		value = defaultValue;
-	}
-	return value;
+	const Item* item = this->findItem(section, key);
+	if (item == nullptr || (item->typeFlags & IS_FLOAT) == 0) return defaultValue;
+	return item->floatValue;
 }
 
 // IniParser: Setters
@@ -214,22 +367,34 @@ float IniParser::getFloat(const string& section, const string& key,
 
 void IniParser::setString(const string& section, const string& key, const string& value) noexcept
 {
-	mIniTree[section][key] = value;
+	uint32_t sectionIndex = this->findOrAddSection(section.data(), section.size());
+	this->set(sectionIndex, key.data(), key.size(), value.data(), value.size());
 }
 
+// The values are formatted into stack buffers (same format as std::to_string()) and passed on
+// directly, avoiding temporary strings
+
 void IniParser::setBool(const string& section, const string& key, bool value) noexcept
 {
-	this->setString(section, key, value ? "true" : "false");
+	uint32_t sectionIndex = this->findOrAddSection(section.data(), section.size());
+	if (value) this->set(sectionIndex, key.data(), key.size(), "true", 4);
+	else this->set(sectionIndex, key.data(), key.size(), "false", 5);
 }
 
 void IniParser::setInt(const string& section, const string& key, int32_t value) noexcept
 {
-	this->setString(section, key, std::to_string(value));
+	char buffer[16];
+	int length = std::snprintf(buffer, sizeof(buffer), "%d", int(value));
+	uint32_t sectionIndex = this->findOrAddSection(section.data(), section.size());
+	this->set(sectionIndex, key.data(), key.size(), buffer, size_t(length));
 }
 
 void IniParser::setFloat(const string& section, const string& key, float value) noexcept
 {
-	this->setString(section, key, std::to_string(value));
+	char buffer[64]; // Enough for FLT_MAX with 6 decimals
+	int length = std::snprintf(buffer, sizeof(buffer), "%f", double(value));
+	uint32_t sectionIndex = this->findOrAddSection(section.data(), section.size());
+	this->set(sectionIndex, key.data(), key.size(), buffer, size_t(length));
 }
 
 // Sanitizers
@@ -283,4 +448,282 @@ float IniParser::sanitizeFloat(const string& section, const string& key,
 	return this->getFloat(section, key);
 }
 
+// IniParser: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void IniParser::clear() noexcept
+{
+	mArena.clear();
+	mArenaGarbage = 0;
+	mSections.clear();
+	mItems.clear();
+	mSectionTable.clear();
+	mItemTable.clear();
+	mFileText.clear();
+	mLines.clear();
+}
+
+IniParser::StrRef IniParser::addString(const char* str, size_t length) noexcept
+{
+	StrRef ref;
+	ref.offset = uint32_t(mArena.size());
+	ref.length = uint32_t(length);
+	mArena.insert(mArena.end(), str, str + length);
+	mArena.push_back('\0'); // Null-terminated so values can be parsed in place
+	return ref;
+}
+
+bool IniParser::equals(StrRef ref, const char* str, size_t length) const noexcept
+{
+	return ref.length == length && std::memcmp(this->str(ref), str, length) == 0;
+}
+
+const IniParser::Item* IniParser::findItem(const string& section,
+                                           const string& key) const noexcept
+{
+	uint32_t sectionHash = hashString(section.data(), section.size());
+	uint32_t sectionIndex = this->findSection(section.data(), section.size(), sectionHash);
+	if (sectionIndex == NOT_FOUND) return nullptr;
+	uint32_t index = this->findItemIndex(sectionIndex, key.data(), key.size(),
+	                                     hashItem(sectionHash, key.data(), key.size()));
+	return index != NOT_FOUND ? &mItems[index] : nullptr;
+}
+
+uint32_t IniParser::findSection(const char* name, size_t length, uint32_t hash) const noexcept
+{
+	if (mSectionTable.empty()) return NOT_FOUND;
+	const size_t mask = mSectionTable.size() - 1;
+	for (size_t i = hash & mask; mSectionTable[i] != 0; i = (i + 1) & mask) {
+		const Section& section = mSections[mSectionTable[i] - 1];
+		if (section.hash == hash && this->equals(section.name, name, length)) {
+			return mSectionTable[i] - 1;
+		}
+	}
+	return NOT_FOUND;
+}
+
+uint32_t IniParser::findItemIndex(uint32_t section, const char* key, size_t keyLength,
+                                  uint32_t hash) const noexcept
+{
+	if (mItemTable.empty()) return NOT_FOUND;
+	const size_t mask = mItemTable.size() - 1;
+	for (size_t i = hash & mask; mItemTable[i] != 0; i = (i + 1) & mask) {
+		const Item& item = mItems[mItemTable[i] - 1];
+		if (item.hash == hash && item.section == section && this->equals(item.key, key, keyLength)) {
+			return mItemTable[i] - 1;
+		}
+	}
+	return NOT_FOUND;
+}
+
+uint32_t IniParser::findOrAddSection(const char* name, size_t length) noexcept
+{
+	uint32_t hash = hashString(name, length);
+	uint32_t index = this->findSection(name, length, hash);
+	if (index != NOT_FOUND) return index;
+
+	if ((mSections.size() + 1) * 2 > mSectionTable.size()) {
+		rebuildTable(mSectionTable, mSections, mSections.size() + 1);
+	}
+	Section section;
+	section.name = this->addString(name, length);
+	section.hash = hash;
+	index = uint32_t(mSections.size());
+	mSections.push_back(section);
+	insertIndex(mSectionTable, hash, index);
+	return index;
+}
+
+uint32_t IniParser::set(uint32_t section, const char* key, size_t keyLength, const char* value,
+                        size_t valueLength) noexcept
+{
+	uint32_t hash = hashItem(mSections[section].hash, key, keyLength);
+	uint32_t index = this->findItemIndex(section, key, keyLength, hash);
+
+	// Replace value of existing item, the old value is left in the arena until it's compacted
+	if (index != NOT_FOUND) {
+		Item& item = mItems[index];
+		if (this->equals(item.value, value, valueLength)) return index;
+		mArenaGarbage += item.value.length + 1;
+		item.value = this->addString(value, valueLength);
+		this->parseValue(item);
+		item.dirty = true;
+		mSections[section].dirty = true;
+		mDirty = true;
+		if (mArenaGarbage > 4096 && mArenaGarbage > mArena.size() / 2) this->compactArena();
+		return index;
+	}
+
+	if ((mItems.size() + 1) * 2 > mItemTable.size()) {
+		rebuildTable(mItemTable, mItems, mItems.size() + 1);
+	}
+	Item item;
+	item.section = section;
+	item.hash = hash;
+	item.key = this->addString(key, keyLength);
+	item.value = this->addString(value, valueLength);
+	this->parseValue(item);
+	item.dirty = true;
+	mSections[section].dirty = true;
+	mDirty = true;
+	index = uint32_t(mItems.size());
+	mItems.push_back(item);
+	insertIndex(mItemTable, hash, index);
+	return index;
+}
+
+void IniParser::parseValue(Item& item) noexcept
+{
+	const char* value = str(item.value);
+	const size_t length = item.value.length;
+	item.typeFlags = 0;
+
+	// Same rules as std::stoi() and std::stof(), i.e. a valid prefix (e.g. "12px") is accepted
+	item.boolValue = equalsIgnoreCase(value, length, "true") ||
+	                 equalsIgnoreCase(value, length, "on") || equalsIgnoreCase(value, length, "1");
+	if (item.boolValue || equalsIgnoreCase(value, length, "false") ||
+	    equalsIgnoreCase(value, length, "off") || equalsIgnoreCase(value, length, "0")) {
+		item.typeFlags |= IS_BOOL;
+	}
+
+	// Fast path for plain integers (fitting in 9 digits), which convert exactly to float
+	size_t numDigits = 0, start = (length != 0 && value[0] == '-') ? 1 : 0;
+	int32_t plainInt = 0;
+	while (start + numDigits < length && numDigits < 9) {
+		char c = value[start + numDigits];
+		if (c < '0' || c > '9') break;
+		plainInt = plainInt * 10 + (c - '0');
+		numDigits++;
+	}
+	if (numDigits != 0 && start + numDigits == length) {
+		item.typeFlags |= IS_INT | IS_FLOAT;
+		item.intValue = start == 1 ? -plainInt : plainInt;
+		item.floatValue = float(item.intValue);
+		return;
+	}
+
+	char* parseEnd = nullptr;
+	errno = 0;
+	long intValue = std::strtol(value, &parseEnd, 10);
+	if (parseEnd != value && errno != ERANGE && intValue >= numeric_limits<int32_t>::min() &&
+	    intValue <= numeric_limits<int32_t>::max()) {
+		item.typeFlags |= IS_INT;
+		item.intValue = int32_t(intValue);
+	}
+
+	errno = 0;
+	float floatValue = std::strtof(value, &parseEnd);
+	if (parseEnd != value && errno != ERANGE) {
+		item.typeFlags |= IS_FLOAT;
+		item.floatValue = floatValue;
+	}
+}
+
+void IniParser::compactArena() noexcept
+{
+	vector<char> oldArena;
+	std::swap(oldArena, mArena);
+	mArena.reserve(oldArena.size() - mArenaGarbage);
+	mArenaGarbage = 0;
+	for (Section& section : mSections) {
+		section.name = this->addString(oldArena.data() + section.name.offset, section.name.length);
+	}
+	for (Item& item : mItems) {
+		item.key = this->addString(oldArena.data() + item.key.offset, item.key.length);
+		item.value = this->addString(oldArena.data() + item.value.offset, item.value.length);
+	}
+}
+
+void IniParser::updateFileText() noexcept
+{
+	// New items are added after the last line of their section, except for new global items in
+	// a file without global items, which are added before the first section
+	vector<uint32_t> lastLine(mSections.size(), NOT_FOUND);
+	uint32_t firstSectionLine = uint32_t(mLines.size());
+	for (uint32_t i = 0; i < mLines.size(); i++) {
+		const Line& line = mLines[i];
+		if (line.type == LineType::OTHER) continue;
+		bool isSection = line.type == LineType::SECTION;
+		lastLine[isSection ? line.index : mItems[line.index].section] = i;
+		if (isSection && firstSectionLine == mLines.size()) firstSectionLine = i;
+	}
+	vector<vector<uint32_t>> newItems(mSections.size());
+	size_t numNewItems = 0;
+	for (uint32_t i = 0; i < mItems.size(); i++) {
+		if (mItems[i].inFile) continue;
+		newItems[mItems[i].section].push_back(i);
+		numNewItems++;
+	}
+	const uint32_t globalSection = this->findSection("", 0, hashString("", 0));
+
+	string text;
+	text.reserve(mFileText.size() + mArena.size() / 8);
+	vector<Line> lines;
+	lines.reserve(mLines.size() + numNewItems + 2 * mSections.size());
+	auto addLine = [&](const char* str, size_t length, LineType type, uint32_t index) {
+		Line line;
+		line.offset = uint32_t(text.size());
+		line.length = uint32_t(length);
+		line.index = index;
+		line.type = type;
+		text.append(str, length);
+		text += '\n';
+		lines.push_back(line);
+	};
+	auto addItem = [&](uint32_t index) {
+		const Item& item = mItems[index];
+		Line line;
+		line.offset = uint32_t(text.size());
+		line.index = index;
+		line.type = LineType::ITEM;
+		text.append(str(item.key), item.key.length);
+		text += '=';
+		text.append(str(item.value), item.value.length);
+		line.length = uint32_t(text.size() - line.offset);
+		text += '\n';
+		lines.push_back(line);
+	};
+	auto addNewItems = [&](uint32_t section) {
+		for (uint32_t index : newItems[section]) addItem(index);
+		newItems[section].clear();
+	};
+
+	// Unchanged lines are copied as is
+	for (uint32_t i = 0; i < mLines.size(); i++) {
+		if (i == firstSectionLine && globalSection != NOT_FOUND &&
+		    lastLine[globalSection] == NOT_FOUND) {
+			addNewItems(globalSection);
+		}
+		const Line& line = mLines[i];
+		if (line.type == LineType::ITEM && mItems[line.index].dirty) {
+			addItem(line.index);
+		}
+		else {
+			addLine(mFileText.data() + line.offset, line.length, line.type, line.index);
+		}
+		if (line.type == LineType::OTHER) continue;
+		uint32_t section = line.type == LineType::SECTION ? line.index : mItems[line.index].section;
+		if (lastLine[section] == i && mSections[section].dirty) addNewItems(section);
+	}
+
+	// Global items in a file without sections, then new sections
+	if (globalSection != NOT_FOUND) addNewItems(globalSection);
+	for (uint32_t i = 0; i < mSections.size(); i++) {
+		if (newItems[i].empty()) continue;
+		if (!lines.empty() && lines.back().length != 0) addLine("", 0, LineType::OTHER, 0);
+		string header = "[" + string(str(mSections[i].name), mSections[i].name.length) + "]";
+		addLine(header.data(), header.size(), LineType::SECTION, i);
+		addNewItems(i);
+	}
+
+	mFileText = std::move(text);
+	mLines = std::move(lines);
+	for (Section& section : mSections) section.dirty = false;
+	for (Item& item : mItems) {
+		item.dirty = false;
+		item.inFile = true;
+	}
+	mDirty = false;
+}
+
 } // namespace sfz
\ No newline at end of file
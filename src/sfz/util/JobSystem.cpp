@@ -0,0 +1,412 @@
+#include "sfz/util/JobSystem.hpp"
+
+#include <algorithm>
+#include <utility> // std::swap
+
+#include "sfz/Assert.hpp"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sfz {
+
+using std::int64_t;
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const uint32_t NO_THREAD_INDEX = ~0u;
+
+// Number of failed attempts to find a job before an idle worker goes to sleep
+static const uint32_t NUM_IDLE_SPINS = 64;
+
+// The system the calling thread belongs to, and the index of its deque in that system
+static thread_local const JobSystem* currentSystem = nullptr;
+static thread_local uint32_t currentIndex = NO_THREAD_INDEX;
+
+// State of xorshift generator used to select which thread to steal from
+static thread_local uint32_t stealRandomState = 0x9E3779B9u;
+
+static uint32_t nextRandom() noexcept
+{
+	uint32_t x = stealRandomState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	stealRandomState = x;
+	return x;
+}
+
+// JobSystem: Private types
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Chase-Lev work-stealing deque with a fixed capacity ("Correct and Efficient Work-Stealing for
+// Weak Memory Models", Le et al.). Only the owning thread pushes and pops at the bottom, other
+// threads steal from the top. top and bottom are padded to separate cache lines.
+struct JobSystem::ThreadData final {
+	static const int64_t MASK = int64_t(DEQUE_CAPACITY) - 1;
+
+	std::atomic<int64_t> top{0};
+	char padding1[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<int64_t> bottom{0};
+	char padding2[64 - sizeof(std::atomic<int64_t>)];
+	std::atomic<Job*> jobs[DEQUE_CAPACITY];
+
+	ThreadData() noexcept
+	{
+		for (std::atomic<Job*>& job : jobs) job.store(nullptr, std::memory_order_relaxed);
+	}
+
+	// Owner only, returns false if full
+	bool push(Job* job) noexcept
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed);
+		const int64_t t = top.load(std::memory_order_acquire);
+		if (b - t >= int64_t(DEQUE_CAPACITY)) return false;
+		jobs[b & MASK].store(job, std::memory_order_relaxed);
+		// seq_cst so that a worker about to sleep either sees the job or is seen as sleeping
+		bottom.store(b + 1, std::memory_order_seq_cst);
+		return true;
+	}
+
+	// Owner only
+	Job* pop() noexcept
+	{
+		const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_seq_cst);
+
+		if (t > b) {
+			// Empty
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* job = jobs[b & MASK].load(std::memory_order_relaxed);
+		if (t == b) {
+			// Last job, race against thieves for it
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+			                                 std::memory_order_relaxed)) {
+				job = nullptr;
+			}
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	// Any thread, returns nullptr if empty or if another thread took the job first
+	Job* steal() noexcept
+	{
+		int64_t t = top.load(std::memory_order_seq_cst);
+		const int64_t b = bottom.load(std::memory_order_seq_cst);
+		if (t >= b) return nullptr;
+
+		Job* job = jobs[t & MASK].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+		                                 std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return job;
+	}
+
+	bool isEmpty() const noexcept
+	{
+		const int64_t t = top.load(std::memory_order_seq_cst);
+		const int64_t b = bottom.load(std::memory_order_seq_cst);
+		return t >= b;
+	}
+};
+
+// JobSystem: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const uint32_t JobSystem::DEQUE_CAPACITY;
+
+// JobSystem: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+JobSystem::JobSystem(uint32_t numWorkers, bool pinThreads) noexcept
+{
+	static_assert((DEQUE_CAPACITY & (DEQUE_CAPACITY - 1)) == 0, "Must be power of 2");
+	if (numWorkers == 0) numWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	for (uint32_t i = 0; i <= numWorkers; i++) {
+		mThreads.push_back(std::unique_ptr<ThreadData>(new ThreadData()));
+	}
+
+	currentSystem = this;
+	currentIndex = 0;
+
+	for (uint32_t i = 1; i <= numWorkers; i++) {
+		mWorkers.emplace_back([this, i, pinThreads]() { this->workerMain(i, pinThreads); });
+	}
+}
+
+JobSystem::~JobSystem() noexcept
+{
+	mStop.store(true);
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mSleepCondition.notify_all();
+	}
+	for (std::thread& worker : mWorkers) worker.join();
+
+	if (currentSystem == this) {
+		currentSystem = nullptr;
+		currentIndex = NO_THREAD_INDEX;
+	}
+
+	// Jobs should not be left, but don't leak them if they are
+	size_t numLeft = mSharedQueue.size();
+	for (Job* job : mSharedQueue) delete job;
+	for (std::unique_ptr<ThreadData>& thread : mThreads) {
+		while (Job* job = thread->steal()) {
+			delete job;
+			numLeft++;
+		}
+	}
+	sfz_assert_debug(numLeft == 0);
+}
+
+// JobSystem: Jobs
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void JobSystem::run(JobFunction function, JobCounter* counter) noexcept
+{
+	Job* job = new Job();
+	job->function = std::move(function);
+	job->counter = counter;
+	if (counter != nullptr) counter->mCount.fetch_add(1, std::memory_order_relaxed);
+	this->submit(job);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, JobFunction function,
+                         JobCounter* counter) noexcept
+{
+	Job* job = new Job();
+	job->function = std::move(function);
+	job->counter = counter;
+	if (counter != nullptr) counter->mCount.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::lock_guard<std::mutex> lock(dependency.mMutex);
+		if (dependency.mCount.load(std::memory_order_acquire) != 0) {
+			dependency.mWaitingJobs.push_back(job);
+			return;
+		}
+	}
+	this->submit(job);
+}
+
+void JobSystem::wait(JobCounter& counter) noexcept
+{
+	const uint32_t threadIndex = this->currentThreadIndex();
+	while (!counter.isDone()) {
+		Job* job = this->findJob(threadIndex);
+		if (job != nullptr) this->execute(job);
+		else std::this_thread::yield();
+	}
+}
+
+bool JobSystem::runQueuedJob() noexcept
+{
+	Job* job = this->findJob(this->currentThreadIndex());
+	if (job == nullptr) return false;
+	this->execute(job);
+	return true;
+}
+
+bool JobSystem::pinCurrentThread(uint32_t core) noexcept
+{
+#if defined(_WIN32)
+	if (core >= sizeof(DWORD_PTR) * 8) return false;
+	return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+#elif defined(__linux__)
+	if (core >= CPU_SETSIZE) return false;
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+#else
+	(void)core; // Not supported (macOS only has affinity hints)
+	return false;
+#endif
+}
+
+// JobSystem: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void JobSystem::runRange(RangeFunction function, const void* context, size_t begin, size_t end,
+                         JobCounter& counter) noexcept
+{
+	Job* job = new Job();
+	job->rangeFunction = function;
+	job->context = context;
+	job->begin = begin;
+	job->end = end;
+	job->counter = &counter;
+	counter.mCount.fetch_add(1, std::memory_order_relaxed);
+	this->submit(job);
+}
+
+void JobSystem::submit(Job* job) noexcept
+{
+	const uint32_t threadIndex = this->currentThreadIndex();
+	if (threadIndex == NO_THREAD_INDEX || !mThreads[threadIndex]->push(job)) {
+		std::lock_guard<std::mutex> lock(mSharedMutex);
+		mSharedQueue.push_back(job);
+		mNumShared.fetch_add(1, std::memory_order_seq_cst);
+	}
+
+	// Wake a sleeping worker, see workerMain()
+	if (mNumSleeping.load(std::memory_order_seq_cst) != 0) {
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mSleepCondition.notify_one();
+	}
+}
+
+JobSystem::Job* JobSystem::findJob(uint32_t threadIndex) noexcept
+{
+	// Own deque
+	if (threadIndex != NO_THREAD_INDEX) {
+		Job* job = mThreads[threadIndex]->pop();
+		if (job != nullptr) return job;
+	}
+
+	// Shared queue
+	if (mNumShared.load(std::memory_order_relaxed) != 0) {
+		std::lock_guard<std::mutex> lock(mSharedMutex);
+		if (!mSharedQueue.empty()) {
+			Job* job = mSharedQueue.front();
+			mSharedQueue.pop_front();
+			mNumShared.fetch_sub(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	// Steal from the other threads, starting at a random one
+	const uint32_t numThreads = uint32_t(mThreads.size());
+	const uint32_t first = nextRandom() % numThreads;
+	for (uint32_t i = 0; i < numThreads; i++) {
+		uint32_t victim = first + i;
+		if (victim >= numThreads) victim -= numThreads;
+		if (victim == threadIndex) continue;
+		Job* job = mThreads[victim]->steal();
+		if (job != nullptr) {
+			mNumStolenJobs.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void JobSystem::execute(Job* job) noexcept
+{
+	if (job->rangeFunction != nullptr) job->rangeFunction(job->context, job->begin, job->end);
+	else job->function();
+
+	JobCounter* counter = job->counter;
+	delete job;
+	if (counter != nullptr) this->finish(*counter);
+}
+
+void JobSystem::finish(JobCounter& counter) noexcept
+{
+	// Not the last unfinished job, no need to lock
+	int32_t count = counter.mCount.load(std::memory_order_relaxed);
+	while (count > 1) {
+		if (counter.mCount.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel,
+		                                         std::memory_order_relaxed)) {
+			return;
+		}
+	}
+
+	// Possibly the last one. The count reaches zero while the lock is held, and isDone() locks
+	// before returning true, so the counter is not accessed after it can have been destroyed.
+	vector<Job*> releasedJobs;
+	{
+		std::lock_guard<std::mutex> lock(counter.mMutex);
+		if (counter.mCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			std::swap(releasedJobs, counter.mWaitingJobs);
+		}
+	}
+	for (Job* job : releasedJobs) this->submit(job);
+}
+
+bool JobSystem::hasQueuedJobs() const noexcept
+{
+	if (mNumShared.load(std::memory_order_seq_cst) != 0) return true;
+	for (const std::unique_ptr<ThreadData>& thread : mThreads) {
+		if (!thread->isEmpty()) return true;
+	}
+	return false;
+}
+
+uint32_t JobSystem::currentThreadIndex() const noexcept
+{
+	return currentSystem == this ? currentIndex : NO_THREAD_INDEX;
+}
+
+void JobSystem::workerMain(uint32_t threadIndex, bool pinThread) noexcept
+{
+	currentSystem = this;
+	currentIndex = threadIndex;
+	stealRandomState = 0x9E3779B9u * (threadIndex + 1);
+
+	if (pinThread) {
+		uint32_t numCores = std::max(std::thread::hardware_concurrency(), 1u);
+		JobSystem::pinCurrentThread(threadIndex % numCores);
+	}
+
+	uint32_t numFailed = 0;
+	while (!mStop.load(std::memory_order_acquire)) {
+		Job* job = this->findJob(threadIndex);
+		if (job != nullptr) {
+			this->execute(job);
+			numFailed = 0;
+			continue;
+		}
+
+		if (++numFailed < NUM_IDLE_SPINS) {
+			std::this_thread::yield();
+			continue;
+		}
+		numFailed = 0;
+
+		// Sleep until woken by submit(). Both sides use seq_cst, so either the submitting thread
+		// sees mNumSleeping incremented or this thread sees the submitted job.
+		std::unique_lock<std::mutex> lock(mSleepMutex);
+		mNumSleeping.fetch_add(1, std::memory_order_seq_cst);
+		if (!mStop.load(std::memory_order_acquire) && !this->hasQueuedJobs()) {
+			mSleepCondition.wait(lock);
+		}
+		mNumSleeping.fetch_sub(1, std::memory_order_seq_cst);
+	}
+}
+
+// JobCounter: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+JobCounter::~JobCounter() noexcept
+{
+	sfz_assert_debug(mWaitingJobs.empty());
+}
+
+// JobCounter: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+bool JobCounter::isDone() const noexcept
+{
+	if (mCount.load(std::memory_order_acquire) != 0) return false;
+	// Wait for the thread that decremented the count to zero to release the lock
+	std::lock_guard<std::mutex> lock(mMutex);
+	return true;
+}
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "sfz/util/MappedFile.hpp"
+
+#include <cstdio>
+#include <cstring> // std::memcpy
+#include <new> // std::nothrow
+#include <utility> // std::swap
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Reads entire file into a new[] allocated buffer, used when mapping is not possible. Reads until
+// end of file since the size reported for special files (e.g. in /proc) is often 0 or wrong.
+// Returns false on error, an empty file is read successfully into a null buffer.
+static bool readIntoBuffer(const char* path, const uint8_t*& dataOut, size_t& sizeOut) noexcept
+{
+	std::FILE* file = std::fopen(path, "rb");
+	if (file == NULL) return false;
+
+	uint8_t* buffer = nullptr;
+	size_t capacity = 0, size = 0;
+	while (true) {
+		if (size == capacity) {
+			size_t newCapacity = capacity == 0 ? 4096 : capacity * 2;
+			uint8_t* newBuffer = new (std::nothrow) uint8_t[newCapacity];
+			if (newBuffer == nullptr) {
+				delete[] buffer;
+				std::fclose(file);
+				return false;
+			}
+			if (size != 0) std::memcpy(newBuffer, buffer, size);
+			delete[] buffer;
+			buffer = newBuffer;
+			capacity = newCapacity;
+		}
+		size_t numRead = std::fread(buffer + size, 1, capacity - size, file);
+		size += numRead;
+		if (numRead == 0) break;
+	}
+	const bool error = std::ferror(file) != 0;
+	std::fclose(file);
+	if (error || size == 0) {
+		delete[] buffer;
+		return !error;
+	}
+
+	dataOut = buffer;
+	sizeOut = size;
+	return true;
+}
+
+#ifndef _WIN32
+static int toMadvise(FileAccessHint hint) noexcept
+{
+	switch (hint) {
+	case FileAccessHint::NORMAL: return MADV_NORMAL;
+	case FileAccessHint::SEQUENTIAL: return MADV_SEQUENTIAL;
+	case FileAccessHint::RANDOM: return MADV_RANDOM;
+	case FileAccessHint::WILL_NEED: return MADV_WILLNEED;
+	}
+	return MADV_NORMAL;
+}
+#endif
+
+// MappedFile: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator= (MappedFile&& other) noexcept
+{
+	std::swap(this->mData, other.mData);
+	std::swap(this->mSize, other.mSize);
+	std::swap(this->mValid, other.mValid);
+	std::swap(this->mMapped, other.mMapped);
+#ifdef _WIN32
+	std::swap(this->mFileHandle, other.mFileHandle);
+	std::swap(this->mMappingHandle, other.mMappingHandle);
+#endif
+	return *this;
+}
+
+MappedFile::~MappedFile() noexcept
+{
+	this->close();
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char* path, FileAccessHint hint) noexcept
+{
+	DWORD flags = FILE_ATTRIBUTE_NORMAL;
+	if (hint == FileAccessHint::SEQUENTIAL) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	else if (hint == FileAccessHint::RANDOM) flags |= FILE_FLAG_RANDOM_ACCESS;
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+	if (file == INVALID_HANDLE_VALUE) return;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return;
+	}
+
+	// Mapping empty files fails, they are read (i.e. found empty) by the fallback instead
+	HANDLE mapping = size.QuadPart == 0 ? NULL :
+	                 CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	void* view = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (view == NULL) {
+		if (mapping != NULL) CloseHandle(mapping);
+		CloseHandle(file);
+		mValid = readIntoBuffer(path, mData, mSize);
+		return;
+	}
+
+	mFileHandle = file;
+	mMappingHandle = mapping;
+	mData = static_cast<const uint8_t*>(view);
+	mSize = size_t(size.QuadPart);
+	mValid = true;
+	mMapped = true;
+}
+
+void MappedFile::advise(FileAccessHint) noexcept
+{
+	// Windows only takes access hints when opening the file
+}
+
+void MappedFile::close() noexcept
+{
+	if (mMapped) {
+		UnmapViewOfFile(mData);
+		CloseHandle(mMappingHandle);
+		CloseHandle(mFileHandle);
+	} else {
+		delete[] mData;
+	}
+	mData = nullptr;
+	mSize = 0;
+	mValid = false;
+	mMapped = false;
+	mFileHandle = nullptr;
+	mMappingHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const char* path, FileAccessHint hint) noexcept
+{
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) return;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || S_ISDIR(info.st_mode)) {
+		::close(fd);
+		return;
+	}
+
+	// Only non-empty regular files can be mapped. Files reporting size 0 are read instead, since
+	// special files (e.g. in /proc) are regular files with size 0 but still have contents.
+	void* view = MAP_FAILED;
+	if (S_ISREG(info.st_mode) && info.st_size > 0) {
+		view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	::close(fd); // The mapping keeps its own reference to the file
+
+	if (view == MAP_FAILED) {
+		mValid = readIntoBuffer(path, mData, mSize);
+		return;
+	}
+
+	mData = static_cast<const uint8_t*>(view);
+	mSize = size_t(info.st_size);
+	mValid = true;
+	mMapped = true;
+	if (hint != FileAccessHint::NORMAL) this->advise(hint);
+}
+
+void MappedFile::advise(FileAccessHint hint) noexcept
+{
+	if (!mMapped) return;
+	madvise(const_cast<uint8_t*>(mData), mSize, toMadvise(hint));
+}
+
+void MappedFile::close() noexcept
+{
+	if (mMapped) munmap(const_cast<uint8_t*>(mData), mSize);
+	else delete[] mData;
+	mData = nullptr;
+	mSize = 0;
+	mValid = false;
+	mMapped = false;
+}
+
+#endif
+
+} // namespace sfz
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include "sfz/util/MemoryTracking.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#include "sfz/Assert.hpp"
+#include "sfz/util/HashMap.hpp"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define SFZ_EXECINFO_CALLSTACKS
+#endif
+
+namespace sfz {
+
+using std::uintptr_t;
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace {
+
+const size_t MAX_CALLSTACK_DEPTH = 32;
+
+struct TagCounters final {
+	std::atomic<size_t> bytes{0}, peakBytes{0}, highWaterMark{0}, numLiveAllocations{0};
+	std::atomic<uint64_t> numTotalAllocations{0};
+};
+
+// Stored right before the memory returned by taggedAllocate()
+struct AllocationHeader final {
+	void* memory; // Pointer returned by malloc()
+	size_t size;
+	MemoryTag tag;
+	uint32_t hasCallstack;
+};
+
+struct LiveAllocation final {
+	MemoryTag tag = MemoryTag::GENERAL;
+	size_t size = 0;
+	void* callstack[MAX_CALLSTACK_DEPTH];
+	int depth = 0;
+};
+
+struct CallstackTable final {
+	std::mutex mutex;
+	HashMap<const void*, LiveAllocation> allocations;
+};
+
+} // anonymous namespace
+
+// Constant initialized, so safe to use during static initialization of other translation units
+static TagCounters tagCounterArray[NUM_MEMORY_TAGS];
+static std::atomic<bool> captureCallstacks{false};
+
+// Trivially initialized, so safe to use from operator new
+static thread_local uint64_t threadNumAllocations = 0;
+static thread_local uint64_t threadNumBytes = 0;
+
+static CallstackTable& callstackTable() noexcept
+{
+	static CallstackTable table;
+	return table;
+}
+
+static inline void countAllocation(size_t size) noexcept
+{
+	threadNumAllocations++;
+	threadNumBytes += size;
+}
+
+static inline void updateMax(std::atomic<size_t>& max, size_t value) noexcept
+{
+	size_t current = max.load(std::memory_order_relaxed);
+	while (current < value &&
+	       !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+}
+
+static inline TagCounters& counters(MemoryTag tag) noexcept
+{
+	sfz_assert_debug(uint32_t(tag) < NUM_MEMORY_TAGS);
+	return tagCounterArray[uint32_t(tag)];
+}
+
+static int captureCallstack(void** frames, int maxDepth) noexcept
+{
+#if defined(_WIN32)
+	return int(CaptureStackBackTrace(0, DWORD(maxDepth), frames, nullptr));
+#elif defined(SFZ_EXECINFO_CALLSTACKS)
+	return backtrace(frames, maxDepth);
+#else
+	(void)frames;
+	(void)maxDepth;
+	return 0;
+#endif
+}
+
+static void printCallstack(void* const* frames, int depth) noexcept
+{
+#if defined(SFZ_EXECINFO_CALLSTACKS)
+	char** symbols = backtrace_symbols(frames, depth);
+	if (symbols != nullptr) {
+		for (int i = 0; i < depth; i++) std::fprintf(stderr, "    %s\n", symbols[i]);
+		std::free(symbols);
+		return;
+	}
+#endif
+	for (int i = 0; i < depth; i++) std::fprintf(stderr, "    %p\n", frames[i]);
+}
+
+// Memory tags
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const char* memoryTagName(MemoryTag tag) noexcept
+{
+	switch (tag) {
+	case MemoryTag::GENERAL: return "GENERAL";
+	case MemoryTag::GRAPHICS: return "GRAPHICS";
+	case MemoryTag::TEXTURES: return "TEXTURES";
+	case MemoryTag::AUDIO: return "AUDIO";
+	case MemoryTag::PROFILING: return "PROFILING";
+	case MemoryTag::IO: return "IO";
+	}
+	return "UNKNOWN";
+}
+
+MemoryTagStats memoryTagStats(MemoryTag tag) noexcept
+{
+	const TagCounters& tagCounters = counters(tag);
+	MemoryTagStats stats;
+	stats.bytes = tagCounters.bytes.load(std::memory_order_relaxed);
+	stats.peakBytes = tagCounters.peakBytes.load(std::memory_order_relaxed);
+	stats.highWaterMark = tagCounters.highWaterMark.load(std::memory_order_relaxed);
+	stats.numLiveAllocations = tagCounters.numLiveAllocations.load(std::memory_order_relaxed);
+	stats.numTotalAllocations = tagCounters.numTotalAllocations.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void resetMemoryPeaks() noexcept
+{
+	for (TagCounters& tagCounters : tagCounterArray) {
+		tagCounters.peakBytes.store(tagCounters.bytes.load(std::memory_order_relaxed),
+		                            std::memory_order_relaxed);
+	}
+}
+
+void printMemoryStats() noexcept
+{
+	std::printf("%-10s %12s %12s %12s %10s %12s\n", "Tag", "Bytes", "Peak", "High water",
+	            "Live", "Total");
+	for (uint32_t i = 0; i < NUM_MEMORY_TAGS; i++) {
+		MemoryTagStats stats = memoryTagStats(MemoryTag(i));
+		std::printf("%-10s %12llu %12llu %12llu %10llu %12llu\n", memoryTagName(MemoryTag(i)),
+		            (unsigned long long)stats.bytes, (unsigned long long)stats.peakBytes,
+		            (unsigned long long)stats.highWaterMark,
+		            (unsigned long long)stats.numLiveAllocations,
+		            (unsigned long long)stats.numTotalAllocations);
+	}
+}
+
+void trackAllocation(MemoryTag tag, size_t size) noexcept
+{
+	TagCounters& tagCounters = counters(tag);
+	const size_t bytes = tagCounters.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+	updateMax(tagCounters.peakBytes, bytes);
+	updateMax(tagCounters.highWaterMark, bytes);
+	tagCounters.numLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+	tagCounters.numTotalAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void trackDeallocation(MemoryTag tag, size_t size) noexcept
+{
+	TagCounters& tagCounters = counters(tag);
+	sfz_assert_debug(tagCounters.bytes.load(std::memory_order_relaxed) >= size);
+	tagCounters.bytes.fetch_sub(size, std::memory_order_relaxed);
+	tagCounters.numLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Tagged allocations
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void* taggedAllocate(MemoryTag tag, size_t size, size_t alignment) noexcept
+{
+	sfz_assert_debug(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	alignment = std::max(alignment, alignof(AllocationHeader));
+
+	const size_t headerSize = sizeof(AllocationHeader);
+	uint8_t* memory = static_cast<uint8_t*>(std::malloc(size + alignment + headerSize));
+	if (memory == nullptr) return nullptr;
+	uintptr_t alignedAddress = reinterpret_cast<uintptr_t>(memory) + headerSize;
+	alignedAddress = (alignedAddress + alignment - 1) & ~uintptr_t(alignment - 1);
+	uint8_t* aligned = reinterpret_cast<uint8_t*>(alignedAddress);
+
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(aligned) - 1;
+	header->memory = memory;
+	header->size = size;
+	header->tag = tag;
+	header->hasCallstack = 0;
+
+	countAllocation(size);
+	trackAllocation(tag, size);
+
+	if (captureCallstacks.load(std::memory_order_relaxed)) {
+		LiveAllocation allocation;
+		allocation.tag = tag;
+		allocation.size = size;
+		allocation.depth = captureCallstack(allocation.callstack, int(MAX_CALLSTACK_DEPTH));
+
+		CallstackTable& table = callstackTable();
+		std::lock_guard<std::mutex> lock(table.mutex);
+		table.allocations.put(aligned, allocation);
+		header->hasCallstack = 1;
+	}
+
+	return aligned;
+}
+
+void taggedDeallocate(void* ptr) noexcept
+{
+	if (ptr == nullptr) return;
+	AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+	trackDeallocation(header->tag, header->size);
+
+	if (header->hasCallstack != 0) {
+		CallstackTable& table = callstackTable();
+		std::lock_guard<std::mutex> lock(table.mutex);
+		table.allocations.erase(ptr);
+	}
+
+	std::free(header->memory);
+}
+
+void setMemoryCallstackCapture(bool enabled) noexcept
+{
+	captureCallstacks.store(enabled, std::memory_order_relaxed);
+}
+
+bool memoryCallstackCapture() noexcept
+{
+	return captureCallstacks.load(std::memory_order_relaxed);
+}
+
+size_t printLiveAllocations(MemoryTag tag) noexcept
+{
+	CallstackTable& table = callstackTable();
+	std::lock_guard<std::mutex> lock(table.mutex);
+	size_t numPrinted = 0;
+	for (const auto& pair : table.allocations) {
+		const LiveAllocation& allocation = pair.second;
+		if (allocation.tag != tag) continue;
+		std::fprintf(stderr, "Live %s allocation of %llu bytes at %p:\n", memoryTagName(tag),
+		             (unsigned long long)allocation.size, pair.first);
+		printCallstack(allocation.callstack, allocation.depth);
+		numPrinted++;
+	}
+	return numPrinted;
+}
+
+// Allocation counting
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+AllocationCount threadAllocationCount() noexcept
+{
+	AllocationCount count;
+	count.numAllocations = threadNumAllocations;
+	count.numBytes = threadNumBytes;
+	return count;
+}
+
+// FrameAllocationCounter: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void FrameAllocationCounter::beginFrame() noexcept
+{
+	mFrameStart = threadAllocationCount();
+}
+
+void FrameAllocationCounter::endFrame() noexcept
+{
+	const AllocationCount now = threadAllocationCount();
+	mLastFrame.numAllocations = now.numAllocations - mFrameStart.numAllocations;
+	mLastFrame.numBytes = now.numBytes - mFrameStart.numBytes;
+	mNumFrames++;
+
+	if (mExpectZero && mLastFrame.numAllocations != 0) {
+		mNumUnexpected++;
+		std::fprintf(stderr, "Frame %llu made %llu heap allocations (%llu bytes) in steady state\n",
+		             (unsigned long long)mNumFrames, (unsigned long long)mLastFrame.numAllocations,
+		             (unsigned long long)mLastFrame.numBytes);
+		sfz_assert_debug(mLastFrame.numAllocations == 0);
+	}
+}
+
+FrameAllocationCounter& frameAllocationCounter() noexcept
+{
+	static FrameAllocationCounter counter;
+	return counter;
+}
+
+} // namespace sfz
+
+// Global operator new and delete
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+#ifdef SFZ_ALLOCATION_COUNTING
+
+// Replaces the default versions, which also just call malloc() and free(). new_handler is not
+// supported.
+
+void* operator new(std::size_t size)
+{
+	sfz::countAllocation(size);
+	void* ptr = std::malloc(size != 0 ? size : 1);
+	if (ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+	return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	sfz::countAllocation(size);
+	return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& nothrow) noexcept
+{
+	return ::operator new(size, nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+#endif
\ No newline at end of file
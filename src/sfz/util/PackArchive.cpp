@@ -0,0 +1,345 @@
+#include "sfz/util/PackArchive.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "sfz/util/Compression.hpp"
+#include "sfz/util/IO.hpp"
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const char PACK_MAGIC[8] = {'S', 'F', 'Z', 'P', 'A', 'C', 'K', '\0'};
+
+struct PackHeader final {
+	char magic[8];
+	uint32_t version;
+	uint32_t alignment;
+	uint32_t numEntries;
+	uint32_t stringsSize;
+	uint64_t tocOffset;
+	uint64_t stringsOffset;
+};
+static_assert(sizeof(PackHeader) == 40, "PackHeader is padded");
+
+// Must match PackArchive::Entry
+struct PackEntry final {
+	uint64_t pathHash;
+	uint64_t offset;
+	uint64_t size;
+	uint64_t uncompressedSize;
+	uint32_t pathOffset;
+	uint32_t pathLength;
+};
+static_assert(sizeof(PackEntry) == 40, "PackEntry is padded");
+
+static string normalizePath(const char* path) noexcept
+{
+	string normalized{path};
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	size_t start = 0;
+	while (true) {
+		if (normalized.compare(start, 2, "./") == 0) start += 2;
+		else if (normalized.compare(start, 1, "/") == 0) start += 1;
+		else break;
+	}
+	return normalized.substr(start);
+}
+
+static uint64_t hashNormalized(const string& path) noexcept
+{
+	// 64-bit FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for (char c : path) {
+		hash ^= uint64_t(uint8_t(c));
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) noexcept
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static string withTrailingSlash(const char* dir) noexcept
+{
+	string str{dir};
+	if (!str.empty() && str.back() != '/' && str.back() != '\\') str += '/';
+	return str;
+}
+
+// Writer
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+bool writePackArchive(const char* packPath, const char* baseDir, const vector<string>& paths,
+                      uint32_t alignment, bool compress) noexcept
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+		std::fprintf(stderr, "writePackArchive(): Alignment %u is not a power of two\n", alignment);
+		return false;
+	}
+	const string base = withTrailingSlash(baseDir);
+
+	// Gather files and sort them by hash (and path, in case of collisions)
+	struct Input final {
+		string path;
+		uint64_t hash;
+	};
+	vector<Input> inputs;
+	inputs.reserve(paths.size());
+	for (const string& path : paths) {
+		Input input;
+		input.path = normalizePath(path.c_str());
+		input.hash = hashNormalized(input.path);
+		if (input.path.empty() || !fileExists((base + input.path).c_str())) {
+			std::fprintf(stderr, "writePackArchive(): Could not read \"%s\"\n", path.c_str());
+			return false;
+		}
+		inputs.push_back(std::move(input));
+	}
+	std::sort(inputs.begin(), inputs.end(), [](const Input& lhs, const Input& rhs) {
+		if (lhs.hash != rhs.hash) return lhs.hash < rhs.hash;
+		return lhs.path < rhs.path;
+	});
+	for (size_t i = 1; i < inputs.size(); i++) {
+		if (inputs[i].path == inputs[i - 1].path) {
+			std::fprintf(stderr, "writePackArchive(): \"%s\" specified twice\n", inputs[i].path.c_str());
+			return false;
+		}
+	}
+
+	// Layout: header, table of contents, path strings, aligned data
+	PackHeader header;
+	std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+	header.version = PackArchive::VERSION;
+	header.alignment = alignment;
+	header.numEntries = uint32_t(inputs.size());
+	header.tocOffset = sizeof(PackHeader);
+	header.stringsOffset = header.tocOffset + inputs.size() * sizeof(PackEntry);
+
+	string strings;
+	vector<PackEntry> entries(inputs.size());
+	for (size_t i = 0; i < inputs.size(); i++) {
+		entries[i].pathHash = inputs[i].hash;
+		entries[i].pathOffset = uint32_t(strings.size());
+		entries[i].pathLength = uint32_t(inputs[i].path.size());
+		strings += inputs[i].path;
+	}
+	header.stringsSize = uint32_t(strings.size());
+
+	// Write archive, the table of contents is written last as the stored sizes are not known
+	// until the files have been compressed
+	std::FILE* file = std::fopen(packPath, "wb");
+	if (file == NULL) {
+		std::fprintf(stderr, "writePackArchive(): Could not open \"%s\" for writing\n", packPath);
+		return false;
+	}
+	bool success = std::fwrite(&header, sizeof(PackHeader), 1, file) == 1;
+	success = success && std::fseek(file, long(header.stringsOffset), SEEK_SET) == 0;
+	success = success && std::fwrite(strings.data(), 1, strings.size(), file) == strings.size();
+	uint64_t offset = header.stringsOffset + strings.size();
+	const uint8_t padding[256] = {};
+	for (size_t i = 0; i < inputs.size() && success; i++) {
+		const uint64_t alignedOffset = alignUp(offset, alignment);
+		while (offset < alignedOffset && success) {
+			size_t numPadding = size_t(std::min(alignedOffset - offset, uint64_t(sizeof(padding))));
+			success = std::fwrite(padding, 1, numPadding, file) == numPadding;
+			offset += numPadding;
+		}
+
+		MappedFile input{(base + inputs[i].path).c_str(), FileAccessHint::SEQUENTIAL};
+		if (!input.isValid()) {
+			std::fprintf(stderr, "writePackArchive(): Could not read \"%s\"\n", inputs[i].path.c_str());
+			success = false;
+			break;
+		}
+		const uint8_t* data = input.data();
+		size_t size = input.size();
+		vector<uint8_t> compressed;
+		if (compress && size != 0) {
+			compressed = sfz::compress(input.data(), input.size());
+			if (compressed.size() < size) {
+				data = compressed.data();
+				size = compressed.size();
+			}
+		}
+
+		entries[i].offset = offset;
+		entries[i].size = size;
+		entries[i].uncompressedSize = input.size();
+		if (size != 0) success = success && std::fwrite(data, 1, size, file) == size;
+		offset += size;
+	}
+	success = success && std::fseek(file, long(header.tocOffset), SEEK_SET) == 0;
+	if (!entries.empty()) {
+		size_t numWritten = std::fwrite(entries.data(), sizeof(PackEntry), entries.size(), file);
+		success = success && numWritten == entries.size();
+	}
+	success = (std::fclose(file) == 0) && success;
+
+	if (!success) {
+		std::fprintf(stderr, "writePackArchive(): Failed to write \"%s\"\n", packPath);
+		deleteFile(packPath);
+	}
+	return success;
+}
+
+// PackArchive: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const uint32_t PackArchive::VERSION;
+
+// PackArchive: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+PackArchive::PackArchive(const char* packPath, const char* looseDir) noexcept
+{
+	if (looseDir != nullptr) {
+		mLooseEnabled = true;
+		mLooseDir = withTrailingSlash(looseDir);
+	}
+
+	mFile = MappedFile{packPath, FileAccessHint::RANDOM};
+	if (!mFile.isValid()) return;
+	mHasPack = this->validate();
+	if (!mHasPack) {
+		std::fprintf(stderr, "PackArchive: \"%s\" is not a valid pack archive\n", packPath);
+		mFile.close();
+		mEntries = nullptr;
+		mStrings = nullptr;
+		mNumEntries = 0;
+	}
+}
+
+// PackArchive: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+AssetView PackArchive::find(const char* path) const noexcept
+{
+	const string normalized = normalizePath(path);
+	const Entry* entry = this->findEntry(normalized);
+	if (entry != nullptr) {
+		AssetView view;
+		view.data = entry->size != 0 ? (mFile.data() + entry->offset) : nullptr;
+		view.size = size_t(entry->size);
+		view.uncompressedSize = size_t(entry->uncompressedSize);
+		view.found = true;
+		view.compressed = entry->size != entry->uncompressedSize;
+		return view;
+	}
+	if (mLooseEnabled) return this->findLoose(normalized);
+	return AssetView();
+}
+
+bool PackArchive::exists(const char* path) const noexcept
+{
+	return this->find(path).found;
+}
+
+int64_t PackArchive::sizeofFile(const char* path) const noexcept
+{
+	AssetView view = this->find(path);
+	if (!view.found) return -1;
+	return int64_t(view.uncompressedSize);
+}
+
+bool PackArchive::read(const char* path, vector<uint8_t>& dataOut,
+                       uint32_t numThreads) const noexcept
+{
+	AssetView view = this->find(path);
+	if (!view.found) return false;
+	if (view.compressed) return decompress(view.data, view.size, dataOut, numThreads);
+	dataOut.assign(view.begin(), view.end());
+	return true;
+}
+
+uint64_t PackArchive::hashPath(const char* path) noexcept
+{
+	return hashNormalized(normalizePath(path));
+}
+
+// PackArchive: Getters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+string PackArchive::entryPath(uint32_t index) const noexcept
+{
+	if (index >= mNumEntries) return string();
+	return string(mStrings + mEntries[index].pathOffset, mEntries[index].pathLength);
+}
+
+// PackArchive: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+bool PackArchive::validate() noexcept
+{
+	static_assert(sizeof(Entry) == sizeof(PackEntry), "Entry does not match PackEntry");
+	const uint64_t fileSize = mFile.size();
+	if (fileSize < sizeof(PackHeader)) return false;
+
+	PackHeader header;
+	std::memcpy(&header, mFile.data(), sizeof(PackHeader));
+	if (std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) return false;
+	if (header.version != VERSION) return false;
+	if (header.tocOffset % alignof(PackEntry) != 0) return false;
+	if (header.tocOffset > fileSize) return false;
+	if (uint64_t(header.numEntries) * sizeof(PackEntry) > fileSize - header.tocOffset) return false;
+	if (header.stringsOffset > fileSize) return false;
+	if (header.stringsSize > fileSize - header.stringsOffset) return false;
+
+	mEntries = reinterpret_cast<const Entry*>(mFile.data() + header.tocOffset);
+	mStrings = reinterpret_cast<const char*>(mFile.data() + header.stringsOffset);
+	mNumEntries = header.numEntries;
+
+	// Validate entries up front so lookups don't need any bounds checks
+	for (uint32_t i = 0; i < mNumEntries; i++) {
+		const Entry& entry = mEntries[i];
+		if (i > 0 && entry.pathHash < mEntries[i - 1].pathHash) return false;
+		if (entry.offset > fileSize || entry.size > fileSize - entry.offset) return false;
+		if (entry.size > entry.uncompressedSize) return false;
+		if (entry.pathOffset > header.stringsSize) return false;
+		if (entry.pathLength > header.stringsSize - entry.pathOffset) return false;
+	}
+	return true;
+}
+
+const PackArchive::Entry* PackArchive::findEntry(const string& normalizedPath) const noexcept
+{
+	if (mNumEntries == 0) return nullptr;
+	const uint64_t hash = hashNormalized(normalizedPath);
+	const Entry* end = mEntries + mNumEntries;
+	const Entry* itr = std::lower_bound(mEntries, end, hash, [](const Entry& entry, uint64_t h) {
+		return entry.pathHash < h;
+	});
+
+	// Compare paths in case of hash collisions
+	for (; itr != end && itr->pathHash == hash; itr++) {
+		if (itr->pathLength == normalizedPath.size() &&
+		    std::memcmp(mStrings + itr->pathOffset, normalizedPath.data(), itr->pathLength) == 0) {
+			return itr;
+		}
+	}
+	return nullptr;
+}
+
+AssetView PackArchive::findLoose(const string& normalizedPath) const noexcept
+{
+	std::lock_guard<std::mutex> lock(mLooseMutex);
+	auto itr = mLooseFiles.find(normalizedPath);
+	if (itr == mLooseFiles.end()) {
+		MappedFile file{(mLooseDir + normalizedPath).c_str()};
+		if (!file.isValid()) return AssetView();
+		itr = mLooseFiles.emplace(normalizedPath, std::move(file)).first;
+	}
+	AssetView view;
+	view.data = itr->second.data();
+	view.size = itr->second.size();
+	view.uncompressedSize = view.size;
+	view.found = true;
+	return view;
+}
+
+} // namespace sfz
\ No newline at end of file
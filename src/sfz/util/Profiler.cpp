@@ -0,0 +1,387 @@
+#include "sfz/util/Profiler.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <new> // std::nothrow
+#include <unordered_map>
+
+#include "sfz/util/IO.hpp"
+#include "sfz/util/Timer.hpp"
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static thread_local uint32_t zoneDepth = 0;
+
+static size_t roundUpPow2(size_t value) noexcept
+{
+	size_t pow2 = 1;
+	while (pow2 < value) pow2 *= 2;
+	return pow2;
+}
+
+static void appendEscaped(string& str, const char* text) noexcept
+{
+	for (const char* itr = text; *itr != '\0'; itr++) {
+		const char c = *itr;
+		if (c == '"' || c == '\\') {
+			str += '\\';
+			str += c;
+		} else if ((unsigned char)c < 0x20) {
+			char buffer[8];
+			std::snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned)c);
+			str += buffer;
+		} else {
+			str += c;
+		}
+	}
+}
+
+// Microseconds with nanosecond precision, as used by the Chrome trace format
+static void appendMicroseconds(string& str, uint64_t ns) noexcept
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%" PRIu64 ".%03u", ns / 1000, unsigned(ns % 1000));
+	str += buffer;
+}
+
+// ProfilerThreadHandle
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Marks the buffer of a thread as reusable when the thread exits
+struct ProfilerThreadHandle final {
+	static thread_local Profiler::ThreadBuffer* current; // Trivial, no initialization checks
+	Profiler::ThreadBuffer* buffer = nullptr;
+
+	~ProfilerThreadHandle() noexcept
+	{
+		if (buffer != nullptr) buffer->alive.store(false, std::memory_order_release);
+	}
+};
+
+thread_local Profiler::ThreadBuffer* ProfilerThreadHandle::current = nullptr;
+static thread_local ProfilerThreadHandle threadHandle;
+
+// Profiler: Constants
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+const size_t Profiler::DEFAULT_EVENTS_PER_THREAD;
+const size_t Profiler::MAX_NUM_FRAMES;
+
+// Profiler: Constructors & destructors
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+Profiler& Profiler::instance() noexcept
+{
+	// Never destroyed, threads may record zones during static destruction
+	static Profiler* profiler = new Profiler();
+	return *profiler;
+}
+
+Profiler::Profiler() noexcept
+:
+	mStartNs(now()),
+	mEnabled(true)
+{ }
+
+// Profiler: Public methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint64_t Profiler::now() noexcept
+{
+	return uint64_t(ticksToNanoseconds(timerTicks()));
+}
+
+void Profiler::recordZone(const char* name, uint64_t startNs, uint64_t endNs,
+                          uint32_t depth) noexcept
+{
+	ThreadBuffer* buffer = ProfilerThreadHandle::current;
+	if (buffer == nullptr) {
+		buffer = registerThread();
+		if (buffer == nullptr) return;
+	}
+
+	// Announces the write before overwriting the slot, so readers can detect torn events
+	const uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+	buffer->startedIndex.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Event& event = buffer->events[index & buffer->mask];
+	event.name.store(name, std::memory_order_relaxed);
+	event.startNs.store(startNs, std::memory_order_relaxed);
+	event.endNs.store(endNs, std::memory_order_relaxed);
+	event.depth.store(depth, std::memory_order_relaxed);
+
+	buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::markFrame() noexcept
+{
+	const uint64_t timeNs = now();
+	std::lock_guard<std::mutex> lock(mMutex);
+	mFrames[mNumFrames % MAX_NUM_FRAMES] = timeNs;
+	mNumFrames++;
+}
+
+void Profiler::setThreadName(const char* name) noexcept
+{
+	ThreadBuffer* buffer = ProfilerThreadHandle::current;
+	if (buffer == nullptr) {
+		buffer = registerThread();
+		if (buffer == nullptr) return;
+	}
+	std::lock_guard<std::mutex> lock(mMutex);
+	buffer->name = name;
+}
+
+void Profiler::clear() noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (auto& buffer : mBuffers) {
+		buffer->clearIndex.store(buffer->writeIndex.load(std::memory_order_acquire),
+		                         std::memory_order_relaxed);
+	}
+	mNumFrames = 0;
+}
+
+vector<ProfileZoneStats> Profiler::zoneStats(uint32_t numFrames) const noexcept
+{
+	// Zones started within [windowStart, windowEnd) are aggregated
+	uint64_t windowStart = 0, windowEnd = UINT64_MAX;
+	vector<RecordedZone> zones;
+	vector<vector<RecordedZone>> threadZones;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (numFrames != 0 && numFrames < MAX_NUM_FRAMES && mNumFrames > numFrames) {
+			windowEnd = mFrames[(mNumFrames - 1) % MAX_NUM_FRAMES];
+			windowStart = mFrames[(mNumFrames - 1 - numFrames) % MAX_NUM_FRAMES];
+		}
+		threadZones.resize(mBuffers.size());
+		for (size_t i = 0; i < mBuffers.size(); i++) {
+			readZones(*mBuffers[i], threadZones[i]);
+		}
+	}
+
+	std::unordered_map<const char*, ProfileZoneStats> statsMap;
+	vector<uint32_t> stack;
+	vector<uint64_t> childNs;
+	for (vector<RecordedZone>& zonesRef : threadZones) {
+		zones.clear();
+		for (const RecordedZone& zone : zonesRef) {
+			if (windowStart <= zone.startNs && zone.startNs < windowEnd) zones.push_back(zone);
+		}
+
+		// Zones are written when they end, so parents are written after their children
+		std::sort(zones.begin(), zones.end(), [](const RecordedZone& a, const RecordedZone& b) {
+			if (a.startNs != b.startNs) return a.startNs < b.startNs;
+			return a.depth < b.depth;
+		});
+
+		// Calculates time spent in direct children
+		stack.clear();
+		childNs.assign(zones.size(), 0);
+		for (uint32_t i = 0; i < uint32_t(zones.size()); i++) {
+			const RecordedZone& zone = zones[i];
+			while (!stack.empty() && zones[stack.back()].depth >= zone.depth) stack.pop_back();
+			if (!stack.empty() && zones[stack.back()].depth + 1 == zone.depth) {
+				childNs[stack.back()] += zone.endNs - zone.startNs;
+			}
+			stack.push_back(i);
+		}
+
+		for (size_t i = 0; i < zones.size(); i++) {
+			const RecordedZone& zone = zones[i];
+			const uint64_t durationNs = zone.endNs - zone.startNs;
+			ProfileZoneStats& stats = statsMap[zone.name];
+			if (stats.count == 0) {
+				stats.name = zone.name;
+				stats.minNs = durationNs;
+			}
+			stats.count++;
+			stats.totalNs += durationNs;
+			stats.selfNs += durationNs - std::min(durationNs, childNs[i]);
+			stats.minNs = std::min(stats.minNs, durationNs);
+			stats.maxNs = std::max(stats.maxNs, durationNs);
+		}
+	}
+
+	// Merges zones with equal names at different addresses (e.g. literals from different units)
+	vector<ProfileZoneStats> result;
+	std::unordered_map<string, size_t> indices;
+	for (auto& pair : statsMap) {
+		const ProfileZoneStats& stats = pair.second;
+		auto insertPair = indices.insert(std::make_pair(string(stats.name), result.size()));
+		if (insertPair.second) {
+			result.push_back(stats);
+			continue;
+		}
+		ProfileZoneStats& merged = result[insertPair.first->second];
+		merged.count += stats.count;
+		merged.totalNs += stats.totalNs;
+		merged.selfNs += stats.selfNs;
+		merged.minNs = std::min(merged.minNs, stats.minNs);
+		merged.maxNs = std::max(merged.maxNs, stats.maxNs);
+	}
+
+	std::sort(result.begin(), result.end(), [](const ProfileZoneStats& a,
+	                                           const ProfileZoneStats& b) {
+		if (a.totalNs != b.totalNs) return a.totalNs > b.totalNs;
+		return std::strcmp(a.name, b.name) < 0;
+	});
+	return result;
+}
+
+bool Profiler::writeChromeTrace(const char* path) const noexcept
+{
+	string json = "{\"traceEvents\":[\n";
+	vector<RecordedZone> zones;
+	bool first = true;
+	auto beginEvent = [&]() {
+		if (!first) json += ",\n";
+		first = false;
+	};
+	auto appendTime = [&](uint64_t timeNs) {
+		appendMicroseconds(json, timeNs < mStartNs ? 0 : timeNs - mStartNs);
+	};
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		for (auto& buffer : mBuffers) {
+			zones.clear();
+			readZones(*buffer, zones);
+			if (zones.empty() && buffer->name.empty()) continue;
+			const string tid = std::to_string(buffer->threadId);
+
+			beginEvent();
+			json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid;
+			json += ",\"args\":{\"name\":\"";
+			if (buffer->name.empty()) json += "Thread " + tid;
+			else appendEscaped(json, buffer->name.c_str());
+			json += "\"}}";
+
+			for (const RecordedZone& zone : zones) {
+				beginEvent();
+				json += "{\"name\":\"";
+				appendEscaped(json, zone.name);
+				json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+				appendTime(zone.startNs);
+				json += ",\"dur\":";
+				appendMicroseconds(json, zone.endNs - zone.startNs);
+				json += "}";
+			}
+		}
+
+		const uint64_t numFrames = std::min(mNumFrames, uint64_t(MAX_NUM_FRAMES));
+		for (uint64_t i = mNumFrames - numFrames; i < mNumFrames; i++) {
+			beginEvent();
+			json += "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":";
+			appendTime(mFrames[i % MAX_NUM_FRAMES]);
+			json += "}";
+		}
+	}
+
+	json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	if (!writeBinaryFile(path, (const uint8_t*)json.data(), json.size())) {
+		std::fprintf(stderr, "Profiler: Couldn't write trace to \"%s\"\n", path);
+		return false;
+	}
+	return true;
+}
+
+// Profiler: Getters & setters
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+void Profiler::setEventsPerThread(size_t numEvents) noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEventsPerThread = roundUpPow2(std::max(numEvents, size_t(2)));
+}
+
+uint64_t Profiler::numFrames() const noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mNumFrames;
+}
+
+// Profiler: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+Profiler::ThreadBuffer* Profiler::registerThread() noexcept
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// Reuses the buffer (and thread id) of an exited thread if possible, so that threads which
+	// are repeatedly created do not allocate new buffers. The events of the exited thread are
+	// kept, they all ended before the new thread starts recording.
+	ThreadBuffer* buffer = nullptr;
+	for (auto& candidate : mBuffers) {
+		if (!candidate->alive.load(std::memory_order_acquire) &&
+		    candidate->mask + 1 == mEventsPerThread) {
+			buffer = candidate.get();
+			break;
+		}
+	}
+
+	if (buffer == nullptr) {
+		std::unique_ptr<ThreadBuffer> newBuffer{new (std::nothrow) ThreadBuffer()};
+		if (newBuffer == nullptr) return nullptr;
+		newBuffer->events.reset(new (std::nothrow) Event[mEventsPerThread]);
+		if (newBuffer->events == nullptr) return nullptr;
+		newBuffer->mask = mEventsPerThread - 1;
+		newBuffer->startedIndex.store(0, std::memory_order_relaxed);
+		newBuffer->writeIndex.store(0, std::memory_order_relaxed);
+		newBuffer->clearIndex.store(0, std::memory_order_relaxed);
+		newBuffer->threadId = mNextThreadId++;
+		buffer = newBuffer.get();
+		mBuffers.push_back(std::move(newBuffer));
+	}
+
+	buffer->alive.store(true, std::memory_order_relaxed);
+	buffer->name.clear();
+	threadHandle.buffer = buffer;
+	ProfilerThreadHandle::current = buffer;
+	return buffer;
+}
+
+void Profiler::readZones(const ThreadBuffer& buffer, vector<RecordedZone>& zonesOut)
+                         const noexcept
+{
+	const uint64_t capacity = buffer.mask + 1;
+	const uint64_t end = buffer.writeIndex.load(std::memory_order_acquire);
+	const uint64_t begin = std::max(buffer.clearIndex.load(std::memory_order_relaxed),
+	                                end > capacity ? end - capacity : 0);
+	const size_t firstOut = zonesOut.size();
+	for (uint64_t i = begin; i < end; i++) {
+		const Event& event = buffer.events[i & buffer.mask];
+		RecordedZone zone;
+		zone.name = event.name.load(std::memory_order_relaxed);
+		zone.startNs = event.startNs.load(std::memory_order_relaxed);
+		zone.endNs = event.endNs.load(std::memory_order_relaxed);
+		zone.depth = event.depth.load(std::memory_order_relaxed);
+		zonesOut.push_back(zone);
+	}
+
+	// Discards the events which may have been overwritten while being read
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const uint64_t started = buffer.startedIndex.load(std::memory_order_relaxed);
+	const uint64_t firstValid = started > capacity ? started - capacity : 0;
+	if (firstValid > begin) {
+		const size_t numInvalid = size_t(std::min(firstValid, end) - begin);
+		zonesOut.erase(zonesOut.begin() + firstOut, zonesOut.begin() + firstOut + numInvalid);
+	}
+}
+
+// ProfileZone: Private methods
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+uint32_t& ProfileZone::currentDepth() noexcept
+{
+	return zoneDepth;
+}
+
+} // namespace sfz
\ No newline at end of file
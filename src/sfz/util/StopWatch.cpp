@@ -1,7 +1,5 @@
 #include "sfz/util/StopWatch.hpp"
 
-#include <ratio> // std::milli, std::nano
-
 namespace sfz {
 
 StopWatch::StopWatch() noexcept
@@ -12,40 +10,50 @@ StopWatch::StopWatch() noexcept
 void StopWatch::start() noexcept
 {
 	mHasTime = false;
-	mStartTime = std::chrono::high_resolution_clock::now();
+	mStartTicks = timerTicks();
+	mLapTicks = mStartTicks;
 }
 
 void StopWatch::stop() noexcept
 {
 	mHasTime = true;
-	mStopTime = std::chrono::high_resolution_clock::now();
+	mStopTicks = timerTicks();
 }
 
 float StopWatch::getTimeSeconds() noexcept
 {
-	if (!mHasTime) {
-		mStopTime = std::chrono::high_resolution_clock::now();
-	}
-	using FloatSecondDuration = std::chrono::duration<float>;
-	return std::chrono::duration_cast<FloatSecondDuration>(mStopTime - mStartTime).count();
+	return float(ticksToSeconds(getTimeTicks()));
 }
 
 float StopWatch::getTimeMilliSeconds() noexcept
 {
-	if (!mHasTime) {
-		mStopTime = std::chrono::high_resolution_clock::now();
-	}
-	using FloatMilliSecondDuration = std::chrono::duration<float, std::milli>;
-	return std::chrono::duration_cast<FloatMilliSecondDuration>(mStopTime - mStartTime).count();
+	return float(ticksToMilliseconds(getTimeTicks()));
 }
 
 float StopWatch::getTimeNanoSeconds() noexcept
+{
+	return float(ticksToNanoseconds(getTimeTicks()));
+}
+
+uint64_t StopWatch::getTimeTicks() noexcept
 {
 	if (!mHasTime) {
-		mStopTime = std::chrono::high_resolution_clock::now();
+		mStopTicks = timerTicks();
 	}
-	using FloatNanoSecondDuration = std::chrono::duration<float, std::nano>;
-	return std::chrono::duration_cast<FloatNanoSecondDuration>(mStopTime - mStartTime).count();
+	return mStopTicks - mStartTicks;
+}
+
+uint64_t StopWatch::lapTicks() noexcept
+{
+	const uint64_t now = timerTicks();
+	const uint64_t lap = now - mLapTicks;
+	mLapTicks = now;
+	return lap;
+}
+
+float StopWatch::lapSeconds() noexcept
+{
+	return float(ticksToSeconds(lapTicks()));
 }
 
 } // namespace sfz
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "sfz/util/StringID.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "sfz/util/HashMap.hpp"
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace {
+
+struct InternTable final {
+	std::mutex mutex;
+	HashMap<StringID, const char*> strings;
+	std::vector<std::unique_ptr<char[]>> storage; // Never moved, so returned pointers stay valid
+};
+
+} // anonymous namespace
+
+static InternTable& internTable() noexcept
+{
+	static InternTable table;
+	return table;
+}
+
+// Intern table
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+StringID internString(const char* str) noexcept
+{
+	return internString(str, std::strlen(str));
+}
+
+StringID internString(const char* str, size_t length) noexcept
+{
+	const StringID id(str, length);
+	InternTable& table = internTable();
+	std::lock_guard<std::mutex> lock(table.mutex);
+
+	const char** existing = table.strings.get(id);
+	if (existing != nullptr) {
+		if (std::strlen(*existing) != length || std::memcmp(*existing, str, length) != 0) {
+			std::fprintf(stderr, "StringID collision: \"%s\" and \"%.*s\" (0x%016llx)\n",
+			             *existing, int(length), str, (unsigned long long)id.id);
+		}
+		return id;
+	}
+
+	std::unique_ptr<char[]> copy(new char[length + 1]);
+	std::memcpy(copy.get(), str, length);
+	copy[length] = '\0';
+	table.strings.put(id, copy.get());
+	table.storage.push_back(std::move(copy));
+	return id;
+}
+
+const char* internedString(StringID id) noexcept
+{
+	InternTable& table = internTable();
+	std::lock_guard<std::mutex> lock(table.mutex);
+	const char** str = table.strings.get(id);
+	return str != nullptr ? *str : nullptr;
+}
+
+size_t numInternedStrings() noexcept
+{
+	InternTable& table = internTable();
+	std::lock_guard<std::mutex> lock(table.mutex);
+	return table.strings.size();
+}
+
+} // namespace sfz
\ No newline at end of file
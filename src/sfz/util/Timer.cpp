@@ -0,0 +1,88 @@
+#include "sfz/util/Timer.hpp"
+
+#include <thread>
+
+#ifdef SFZ_TIMER_TSC
+#if defined(_MSC_VER)
+#include <intrin.h> // __cpuid
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace sfz {
+
+// Statics
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+#ifdef SFZ_TIMER_TSC
+
+// Whether the TSC runs at a constant rate in all power states (CPUID.80000007H:EDX[8])
+static bool hasInvariantTsc() noexcept
+{
+	unsigned regs[4] = {0, 0, 0, 0};
+#if defined(_MSC_VER)
+	int msvcRegs[4];
+	__cpuid(msvcRegs, 0x80000000);
+	if (unsigned(msvcRegs[0]) < 0x80000007u) return false;
+	__cpuid(msvcRegs, 0x80000007);
+	regs[3] = unsigned(msvcRegs[3]);
+#else
+	if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+	if (!__get_cpuid(0x80000007u, &regs[0], &regs[1], &regs[2], &regs[3])) return false;
+#endif
+	return (regs[3] & (1u << 8)) != 0;
+}
+
+// Reads TSC and steady_clock as close together as possible, returns time in nanoseconds
+static uint64_t readTscAndClock(uint64_t& tscOut) noexcept
+{
+	using namespace std::chrono;
+	uint64_t bestNs = 0, bestGap = UINT64_MAX;
+	for (int i = 0; i < 5; i++) {
+		const uint64_t before = __rdtsc();
+		const auto time = steady_clock::now();
+		const uint64_t after = __rdtsc();
+		if (after - before < bestGap) {
+			bestGap = after - before;
+			tscOut = before + (after - before) / 2;
+			bestNs = uint64_t(duration_cast<nanoseconds>(time.time_since_epoch()).count());
+		}
+	}
+	return bestNs;
+}
+
+#endif
+
+// Timer ticks
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TimerInfo calibrateTimer() noexcept
+{
+	TimerInfo info;
+	info.usesTsc = false;
+	info.ticksPerSecond = 1000000000;
+	info.secondsPerTick = 1.0 / 1000000000.0;
+	info.nanosecondsPerTick = 1.0;
+
+#ifdef SFZ_TIMER_TSC
+	if (!hasInvariantTsc()) return info;
+
+	uint64_t tscBegin = 0, tscEnd = 0;
+	const uint64_t nsBegin = readTscAndClock(tscBegin);
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	const uint64_t nsEnd = readTscAndClock(tscEnd);
+	if (tscEnd <= tscBegin || nsEnd <= nsBegin) return info;
+
+	const double ticksPerSecond = double(tscEnd - tscBegin) * 1e9 / double(nsEnd - nsBegin);
+	if (ticksPerSecond < 1e8) return info; // Not plausible, e.g. emulated TSC
+
+	info.usesTsc = true;
+	info.ticksPerSecond = uint64_t(ticksPerSecond + 0.5);
+	info.secondsPerTick = 1.0 / ticksPerSecond;
+	info.nanosecondsPerTick = 1e9 / ticksPerSecond;
+#endif
+	return info;
+}
+
+} // namespace sfz
\ No newline at end of file
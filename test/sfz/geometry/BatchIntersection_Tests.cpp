@@ -0,0 +1,203 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sfz/Geometry.hpp"
+#include "sfz/Math.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+
+// Test data
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+struct TestData final {
+	std::vector<float> x, y, radius, minX, minY, maxX, maxY;
+	std::vector<Circle> circles;
+	std::vector<AABB2D> rects;
+
+	TestData(size_t count, unsigned seed)
+	{
+		std::mt19937 gen{seed};
+		std::uniform_real_distribution<float> posDist{-50.0f, 50.0f};
+		std::uniform_real_distribution<float> sizeDist{0.1f, 5.0f};
+		for (size_t i = 0; i < count; i++) {
+			circles.push_back(Circle{posDist(gen), posDist(gen), sizeDist(gen)});
+			rects.push_back(AABB2D{posDist(gen), posDist(gen), sizeDist(gen), sizeDist(gen)});
+			x.push_back(circles.back().pos.x);
+			y.push_back(circles.back().pos.y);
+			radius.push_back(circles.back().radius);
+			minX.push_back(rects.back().min.x);
+			minY.push_back(rects.back().min.y);
+			maxX.push_back(rects.back().max.x);
+			maxY.push_back(rects.back().max.y);
+		}
+	}
+
+	PointArray points() const { return PointArray{x.data(), y.data(), x.size()}; }
+	CircleArray circleArray() const { return CircleArray{x.data(), y.data(), radius.data(), x.size()}; }
+	AABB2DArray rectArray() const
+	{
+		return AABB2DArray{minX.data(), minY.data(), maxX.data(), maxY.data(), minX.size()};
+	}
+};
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Batch one vs many matches scalar tests", "[sfz::BatchIntersection]")
+{
+	const size_t COUNT = 1003; // Not a multiple of 4 or 32 to exercise tails
+	TestData data{COUNT, 1};
+	std::vector<uint32_t> bitmask(bitmaskNumWords(COUNT));
+	std::vector<uint32_t> indices(COUNT);
+
+	const Circle circle{vec2{3.0f, -2.0f}, 20.0f};
+	const AABB2D rect{vec2{-5.0f, 4.0f}, vec2{30.0f, 20.0f}};
+
+	pointInside(circle, data.points(), bitmask.data());
+	size_t numIndices = pointInsideIndices(circle, data.points(), indices.data());
+	size_t numExpected = 0;
+	for (size_t i = 0; i < COUNT; i++) {
+		bool expected = pointInside(circle, data.circles[i].pos);
+		REQUIRE(bitmaskIsSet(bitmask.data(), i) == expected);
+		if (expected) REQUIRE(indices[numExpected++] == i);
+	}
+	REQUIRE(numIndices == numExpected);
+	REQUIRE(numExpected > 0);
+
+	pointInside(rect, data.points(), bitmask.data());
+	numIndices = pointInsideIndices(rect, data.points(), indices.data());
+	numExpected = 0;
+	for (size_t i = 0; i < COUNT; i++) {
+		bool expected = pointInside(rect, data.circles[i].pos);
+		REQUIRE(bitmaskIsSet(bitmask.data(), i) == expected);
+		if (expected) REQUIRE(indices[numExpected++] == i);
+	}
+	REQUIRE(numIndices == numExpected);
+
+	overlaps(circle, data.circleArray(), bitmask.data());
+	numIndices = overlapsIndices(circle, data.circleArray(), indices.data());
+	numExpected = 0;
+	for (size_t i = 0; i < COUNT; i++) {
+		bool expected = overlaps(circle, data.circles[i]);
+		REQUIRE(bitmaskIsSet(bitmask.data(), i) == expected);
+		if (expected) REQUIRE(indices[numExpected++] == i);
+	}
+	REQUIRE(numIndices == numExpected);
+
+	overlaps(circle, data.rectArray(), bitmask.data());
+	numIndices = overlapsIndices(circle, data.rectArray(), indices.data());
+	numExpected = 0;
+	for (size_t i = 0; i < COUNT; i++) {
+		bool expected = overlaps(circle, data.rects[i]);
+		REQUIRE(bitmaskIsSet(bitmask.data(), i) == expected);
+		if (expected) REQUIRE(indices[numExpected++] == i);
+	}
+	REQUIRE(numIndices == numExpected);
+
+	overlaps(rect, data.circleArray(), bitmask.data());
+	numIndices = overlapsIndices(rect, data.circleArray(), indices.data());
+	numExpected = 0;
+	for (size_t i = 0; i < COUNT; i++) {
+		bool expected = overlaps(rect, data.circles[i]);
+		REQUIRE(bitmaskIsSet(bitmask.data(), i) == expected);
+		if (expected) REQUIRE(indices[numExpected++] == i);
+	}
+	REQUIRE(numIndices == numExpected);
+
+	overlaps(rect, data.rectArray(), bitmask.data());
+	numIndices = overlapsIndices(rect, data.rectArray(), indices.data());
+	numExpected = 0;
+	for (size_t i = 0; i < COUNT; i++) {
+		bool expected = overlaps(rect, data.rects[i]);
+		REQUIRE(bitmaskIsSet(bitmask.data(), i) == expected);
+		if (expected) REQUIRE(indices[numExpected++] == i);
+	}
+	REQUIRE(numIndices == numExpected);
+}
+
+TEST_CASE("Batch many vs many matches scalar tests", "[sfz::BatchIntersection]")
+{
+	TestData lhs{37, 2};
+	TestData rhs{61, 3};
+	std::vector<IndexPair> pairs;
+
+	size_t numPairs = overlappingPairs(lhs.circleArray(), rhs.circleArray(), pairs);
+	REQUIRE(numPairs == pairs.size());
+	size_t expected = 0;
+	for (size_t i = 0; i < lhs.circles.size(); i++) {
+		for (size_t j = 0; j < rhs.circles.size(); j++) {
+			if (!overlaps(lhs.circles[i], rhs.circles[j])) continue;
+			REQUIRE(pairs[expected].first == i);
+			REQUIRE(pairs[expected].second == j);
+			expected++;
+		}
+	}
+	REQUIRE(expected == numPairs);
+
+	pairs.clear();
+	numPairs = overlappingPairs(lhs.circleArray(), rhs.rectArray(), pairs);
+	expected = 0;
+	for (size_t i = 0; i < lhs.circles.size(); i++) {
+		for (size_t j = 0; j < rhs.rects.size(); j++) {
+			if (!overlaps(lhs.circles[i], rhs.rects[j])) continue;
+			REQUIRE(pairs[expected].first == i);
+			REQUIRE(pairs[expected].second == j);
+			expected++;
+		}
+	}
+	REQUIRE(expected == numPairs);
+
+	pairs.clear();
+	numPairs = overlappingPairs(lhs.rectArray(), rhs.rectArray(), pairs);
+	expected = 0;
+	for (size_t i = 0; i < lhs.rects.size(); i++) {
+		for (size_t j = 0; j < rhs.rects.size(); j++) {
+			if (!overlaps(lhs.rects[i], rhs.rects[j])) continue;
+			REQUIRE(pairs[expected].first == i);
+			REQUIRE(pairs[expected].second == j);
+			expected++;
+		}
+	}
+	REQUIRE(expected == numPairs);
+}
+
+// Benchmarks (hidden, run with "[benchmark]")
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Batch vs scalar benchmark", "[.][benchmark][sfz::BatchIntersection]")
+{
+	const size_t COUNT = 10000;
+	const size_t NUM_ITERATIONS = 1000;
+	TestData data{COUNT, 4};
+	std::vector<uint32_t> bitmask(bitmaskNumWords(COUNT));
+	std::vector<uint8_t> scalarResults(COUNT);
+	const Circle circle{vec2{3.0f, -2.0f}, 20.0f};
+
+	StopWatch stopWatch;
+	size_t scalarSum = 0;
+	for (size_t it = 0; it < NUM_ITERATIONS; it++) {
+		for (size_t i = 0; i < COUNT; i++) {
+			scalarResults[i] = overlaps(circle, data.rects[i]) ? 1 : 0;
+		}
+		scalarSum += scalarResults[it % COUNT];
+	}
+	float scalarTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	size_t batchSum = 0;
+	for (size_t it = 0; it < NUM_ITERATIONS; it++) {
+		overlaps(circle, data.rectArray(), bitmask.data());
+		batchSum += bitmaskIsSet(bitmask.data(), it % COUNT) ? 1 : 0;
+	}
+	float batchTime = stopWatch.getTimeMilliSeconds();
+
+	std::cout << "Circle vs " << COUNT << " AABB2Ds, " << NUM_ITERATIONS << " iterations:"
+	          << "\nScalar: " << scalarTime << "ms"
+	          << "\nBatch: " << batchTime << "ms" << std::endl;
+	REQUIRE(scalarSum == batchSum);
+}
\ No newline at end of file
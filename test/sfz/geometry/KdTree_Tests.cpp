@@ -0,0 +1,214 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sfz/Geometry.hpp"
+#include "sfz/Math.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+template<size_t N>
+static std::vector<Vector<float,N>> randomPoints(size_t count, unsigned seed)
+{
+	std::mt19937 gen{seed};
+	std::uniform_real_distribution<float> dist{-100.0f, 100.0f};
+	std::vector<Vector<float,N>> points(count);
+	for (auto& p : points) {
+		for (size_t i = 0; i < N; i++) p[i] = dist(gen);
+	}
+	return points;
+}
+
+template<size_t N>
+static std::vector<float> bruteForceDistances(const std::vector<Vector<float,N>>& points,
+                                              const Vector<float,N>& query)
+{
+	std::vector<float> dists;
+	for (const auto& p : points) dists.push_back(squaredLength(p - query));
+	std::sort(dists.begin(), dists.end());
+	return dists;
+}
+
+template<size_t N>
+static void checkAgainstBruteForce(const KdTree<N>& tree, const std::vector<Vector<float,N>>& points,
+                                   const std::vector<Vector<float,N>>& queries)
+{
+	std::vector<KdNeighbour> neighbours;
+	std::vector<uint32_t> indices;
+	const size_t K = 7;
+	const float RADIUS = 15.0f;
+
+	for (const auto& query : queries) {
+		std::vector<float> expected = bruteForceDistances(points, query);
+
+		KdNeighbour nearest = tree.findNearest(query);
+		REQUIRE(nearest.distSquared == expected[0]);
+		REQUIRE(squaredLength(points[nearest.index] - query) == expected[0]);
+
+		tree.findKNearest(query, K, neighbours);
+		REQUIRE(neighbours.size() == std::min(K, points.size()));
+		for (size_t i = 0; i < neighbours.size(); i++) {
+			REQUIRE(neighbours[i].distSquared == expected[i]);
+			REQUIRE(squaredLength(points[neighbours[i].index] - query) == expected[i]);
+		}
+
+		tree.findInRadius(query, RADIUS, neighbours);
+		size_t numInRadius = std::upper_bound(expected.begin(), expected.end(), RADIUS * RADIUS)
+		                   - expected.begin();
+		REQUIRE(neighbours.size() == numInRadius);
+		for (const KdNeighbour& n : neighbours) REQUIRE(n.distSquared <= RADIUS * RADIUS);
+
+		Vector<float,N> min = query - Vector<float,N>(RADIUS);
+		Vector<float,N> max = query + Vector<float,N>(RADIUS);
+		tree.findInBox(min, max, indices);
+		size_t numInBox = 0;
+		for (const auto& p : points) {
+			bool inside = true;
+			for (size_t i = 0; i < N; i++) inside = inside && min[i] <= p[i] && p[i] <= max[i];
+			if (inside) numInBox++;
+		}
+		REQUIRE(indices.size() == numInBox);
+	}
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Empty and tiny trees", "[sfz::KdTree]")
+{
+	KdTree2 empty;
+	REQUIRE(empty.size() == 0);
+	REQUIRE(empty.findNearest(vec2{0.0f}).index == KdTree2::NO_INDEX);
+	std::vector<KdNeighbour> neighbours;
+	empty.findKNearest(vec2{0.0f}, 3, neighbours);
+	REQUIRE(neighbours.empty());
+
+	vec2 points[] = {vec2{0.0f, 0.0f}, vec2{1.0f, 0.0f}, vec2{5.0f, 5.0f}};
+	KdTree2 tiny{points, 3};
+	REQUIRE(tiny.size() == 3);
+	REQUIRE(tiny.findNearest(vec2{4.0f, 4.0f}).index == 2);
+	tiny.findKNearest(vec2{0.9f, 0.0f}, 5, neighbours);
+	REQUIRE(neighbours.size() == 3);
+	REQUIRE(neighbours[0].index == 1);
+	REQUIRE(neighbours[1].index == 0);
+	REQUIRE(neighbours[2].index == 2);
+
+	KdNeighbour batch[2 * 4];
+	vec2 queries[] = {vec2{-1.0f, 0.0f}, vec2{6.0f, 6.0f}};
+	tiny.findKNearest(queries, 2, 4, batch);
+	REQUIRE(batch[0].index == 0);
+	REQUIRE(batch[3].index == KdTree2::NO_INDEX);
+	REQUIRE(batch[4].index == 2);
+	REQUIRE(batch[7].index == KdTree2::NO_INDEX);
+}
+
+TEST_CASE("2D queries match brute force", "[sfz::KdTree]")
+{
+	auto points = randomPoints<2>(2000, 1);
+	auto queries = randomPoints<2>(50, 2);
+	KdTree2 tree{points.data(), points.size(), 1};
+	REQUIRE(tree.size() == points.size());
+	checkAgainstBruteForce(tree, points, queries);
+
+	std::vector<uint32_t> indices;
+	Circle circle{vec2{10.0f, -20.0f}, 30.0f};
+	pointsInside(tree, circle, indices);
+	size_t expected = 0;
+	for (const vec2& p : points) if (pointInside(circle, p)) expected++;
+	REQUIRE(indices.size() == expected);
+	for (uint32_t i : indices) REQUIRE(pointInside(circle, points[i]));
+
+	AABB2D rect{vec2{-30.0f, 0.0f}, vec2{40.0f, 25.0f}};
+	pointsInside(tree, rect, indices);
+	expected = 0;
+	for (const vec2& p : points) if (pointInside(rect, p)) expected++;
+	REQUIRE(indices.size() == expected);
+	for (uint32_t i : indices) REQUIRE(pointInside(rect, points[i]));
+}
+
+TEST_CASE("3D queries match brute force", "[sfz::KdTree]")
+{
+	auto points = randomPoints<3>(3000, 3);
+	auto queries = randomPoints<3>(50, 4);
+	KdTree3 tree{points.data(), points.size(), 1};
+	checkAgainstBruteForce(tree, points, queries);
+
+	std::vector<uint32_t> indices;
+	Sphere sphere{vec3{0.0f, 10.0f, -5.0f}, 40.0f};
+	pointsInside(tree, sphere, indices);
+	size_t expected = 0;
+	for (const vec3& p : points) if (pointInside(sphere, p)) expected++;
+	REQUIRE(indices.size() == expected);
+}
+
+TEST_CASE("Parallel build and batched queries", "[sfz::KdTree]")
+{
+	auto points = randomPoints<3>(100000, 5);
+	auto queries = randomPoints<3>(1000, 6);
+	KdTree3 single{points.data(), points.size(), 1};
+	KdTree3 multi{points.data(), points.size(), 4};
+
+	// Same splits regardless of number of threads
+	for (size_t i = 0; i < points.size(); i++) {
+		REQUIRE(single.indices()[i] == multi.indices()[i]);
+	}
+
+	const size_t K = 5;
+	std::vector<KdNeighbour> batch(queries.size() * K);
+	multi.findKNearest(queries.data(), queries.size(), K, batch.data(), 4);
+	std::vector<KdNeighbour> neighbours;
+	for (size_t i = 0; i < queries.size(); i++) {
+		single.findKNearest(queries[i], K, neighbours);
+		for (size_t j = 0; j < K; j++) {
+			REQUIRE(batch[i * K + j].index == neighbours[j].index);
+		}
+	}
+}
+
+// Benchmarks (hidden, run with "[benchmark]")
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("KdTree vs linear scan benchmark", "[.][benchmark][sfz::KdTree]")
+{
+	auto points = randomPoints<3>(100000, 7);
+	auto queries = randomPoints<3>(1000, 8);
+
+	StopWatch stopWatch;
+	KdTree3 tree{points.data(), points.size()};
+	float buildTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	uint32_t linearSum = 0;
+	for (const vec3& query : queries) {
+		uint32_t nearest = 0;
+		float nearestDist = squaredLength(points[0] - query);
+		for (uint32_t i = 1; i < points.size(); i++) {
+			float dist = squaredLength(points[i] - query);
+			if (dist < nearestDist) {
+				nearest = i;
+				nearestDist = dist;
+			}
+		}
+		linearSum += nearest;
+	}
+	float linearTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	uint32_t treeSum = 0;
+	for (const vec3& query : queries) treeSum += tree.findNearest(query).index;
+	float treeTime = stopWatch.getTimeMilliSeconds();
+
+	std::cout << "Nearest neighbour, " << points.size() << " points, " << queries.size() << " queries:"
+	          << "\nBuild: " << buildTime << "ms"
+	          << "\nLinear scan: " << linearTime << "ms"
+	          << "\nKdTree: " << treeTime << "ms" << std::endl;
+	REQUIRE(linearSum == treeSum);
+}
\ No newline at end of file
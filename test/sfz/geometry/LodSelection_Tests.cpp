@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sfz/Geometry.hpp"
+#include "sfz/Math.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+
+TEST_CASE("Screen sizes", "[sfz::LodSelection]")
+{
+	const ViewFrustum camera{vec3{1.0f, 2.0f, 3.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                         90.0f, 16.0f / 9.0f, 0.5f, 100.0f};
+
+	// With 90 degrees fov the screen is 2 * distance high at distance
+	const float x[] = {1.0f, 1.0f, 11.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+	const float y[] = {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f};
+	const float z[] = {-7.0f, -17.0f, 3.0f, 13.0f, 3.0f, 3.1f, -97.0f};
+	const float radius[] = {1.0f, 1.0f, 5.0f, 2.0f, 1.0f, 1.0f, 1.0f};
+	const SphereArray spheres{x, y, z, radius, 7};
+	float sizes[7];
+	screenSizes(camera, spheres, sizes);
+	REQUIRE(approxEqual(sizes[0], 0.1f));
+	REQUIRE(approxEqual(sizes[1], 0.05f));
+	REQUIRE(approxEqual(sizes[2], 0.5f)); // Independent of direction
+	REQUIRE(approxEqual(sizes[3], 0.2f));
+	REQUIRE(approxEqual(sizes[4], 2.0f)); // Clamped to near plane
+	REQUIRE(approxEqual(sizes[5], 2.0f));
+	REQUIRE(approxEqual(sizes[6], 0.01f));
+
+	// SIMD and scalar paths agree, only approximately since rounding may differ (e.g. fast-math)
+	for (size_t i = 0; i < 7; i++) {
+		float single;
+		screenSizes(camera, SphereArray{x + i, y + i, z + i, radius + i, 1}, &single);
+		REQUIRE(approxEqual(single, sizes[i]));
+	}
+
+	// AABBs use their bounding sphere
+	const float minX[] = {0.0f, -1.0f, 0.5f, 0.0f, 0.0f};
+	const float minY[] = {1.0f, 0.0f, 1.5f, 1.0f, 1.0f};
+	const float minZ[] = {-8.0f, -20.0f, -13.5f, -8.0f, -8.0f};
+	const float maxX[] = {2.0f, 3.0f, 1.5f, 2.0f, 2.0f};
+	const float maxY[] = {3.0f, 4.0f, 2.5f, 3.0f, 3.0f};
+	const float maxZ[] = {-6.0f, -16.0f, -12.5f, -6.0f, -6.0f};
+	const AABBArray aabbs{minX, minY, minZ, maxX, maxY, maxZ, 5};
+	screenSizes(camera, aabbs, sizes);
+	REQUIRE(approxEqual(sizes[0], std::sqrt(3.0f) / 10.0f));
+	REQUIRE(approxEqual(sizes[1], 2.0f * std::sqrt(3.0f) / 21.0f));
+	REQUIRE(approxEqual(sizes[2], 0.5f * std::sqrt(3.0f) / 16.0f));
+	REQUIRE(approxEqual(sizes[3], sizes[0]));
+	REQUIRE(approxEqual(sizes[4], sizes[0]));
+}
+
+TEST_CASE("LOD selection with hysteresis", "[sfz::LodSelection]")
+{
+	const float thresholds[] = {0.5f, 0.2f, 0.05f};
+
+	// Without hysteresis
+	const float sizes[] = {1.0f, 0.5f, 0.49f, 0.2f, 0.1f, 0.05f, 0.01f, 0.0f, 0.3f};
+	uint8_t lods[9] = {};
+	selectLods(sizes, 9, thresholds, 3, 0.0f, lods);
+	const uint8_t expected[] = {0, 0, 1, 1, 2, 2, 3, 3, 1};
+	for (size_t i = 0; i < 9; i++) REQUIRE(lods[i] == expected[i]);
+
+	// No thresholds means a single LOD
+	selectLods(sizes, 9, thresholds, 0, 0.1f, lods);
+	for (size_t i = 0; i < 9; i++) REQUIRE(lods[i] == 0);
+
+	// An object moving back and forth around a threshold only switches outside of the band
+	const float band[] = {0.21f, 0.19f, 0.181f, 0.179f, 0.19f, 0.21f, 0.219f, 0.221f};
+	const uint8_t bandLods[] = {1, 1, 1, 2, 2, 2, 2, 1};
+	for (size_t simd = 0; simd < 2; simd++) {
+		// 8 objects with the same size, to cover the SIMD path
+		uint8_t lodsInOut[8] = {};
+		float sizes8[8];
+		for (size_t step = 0; step < 8; step++) {
+			for (float& s : sizes8) s = band[step];
+			selectLods(sizes8, simd == 0 ? 1 : 8, thresholds, 3, 0.1f, lodsInOut);
+			REQUIRE(lodsInOut[0] == bandLods[step]);
+			if (simd == 1) for (uint8_t lod : lodsInOut) REQUIRE(lod == bandLods[step]);
+		}
+	}
+
+	// Big jumps skip several LODs regardless of hysteresis
+	uint8_t lod = 0;
+	float size = 0.01f;
+	selectLods(&size, 1, thresholds, 3, 0.1f, &lod);
+	REQUIRE(lod == 3);
+	size = 0.6f;
+	selectLods(&size, 1, thresholds, 3, 0.1f, &lod);
+	REQUIRE(lod == 0);
+}
+
+TEST_CASE("LOD selection benchmark", "[.][benchmark][sfz::LodSelection]")
+{
+	const size_t COUNT = 1000000;
+	std::mt19937 gen{1};
+	std::uniform_real_distribution<float> posDist{-500.0f, 500.0f};
+	std::uniform_real_distribution<float> radiusDist{0.1f, 10.0f};
+	std::vector<float> x(COUNT), y(COUNT), z(COUNT), radius(COUNT);
+	for (size_t i = 0; i < COUNT; i++) {
+		x[i] = posDist(gen);
+		y[i] = posDist(gen);
+		z[i] = posDist(gen);
+		radius[i] = radiusDist(gen);
+	}
+	const ViewFrustum camera{vec3{0.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                         60.0f, 16.0f / 9.0f, 0.1f, 1000.0f};
+	const float thresholds[] = {0.5f, 0.25f, 0.1f, 0.05f, 0.01f};
+	std::vector<float> sizes(COUNT);
+	std::vector<uint8_t> lods(COUNT, 0);
+
+	StopWatch stopWatch;
+	screenSizes(camera, SphereArray{x.data(), y.data(), z.data(), radius.data(), COUNT}, sizes.data());
+	float sizeTime = stopWatch.getTimeMilliSeconds();
+	stopWatch.start();
+	selectLods(sizes.data(), COUNT, thresholds, 5, 0.1f, lods.data());
+	float selectTime = stopWatch.getTimeMilliSeconds();
+
+	size_t lodCounts[6] = {};
+	for (uint8_t lod : lods) lodCounts[lod]++;
+	std::cout << COUNT << " spheres:\nScreen sizes: " << sizeTime << "ms\nSelect LODs: "
+	          << selectTime << "ms\nLOD counts:";
+	for (size_t count : lodCounts) std::cout << " " << count;
+	std::cout << std::endl;
+	REQUIRE(lodCounts[5] > 0);
+}
\ No newline at end of file
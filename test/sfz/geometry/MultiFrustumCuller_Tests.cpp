@@ -0,0 +1,181 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sfz/Geometry.hpp"
+#include "sfz/Math.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static std::vector<AABB> randomAABBs(size_t count, unsigned seed)
+{
+	std::mt19937 gen{seed};
+	std::uniform_real_distribution<float> posDist{-100.0f, 100.0f};
+	std::uniform_real_distribution<float> sizeDist{0.1f, 5.0f};
+	std::vector<AABB> aabbs;
+	for (size_t i = 0; i < count; i++) {
+		vec3 pos{posDist(gen), posDist(gen), posDist(gen)};
+		aabbs.push_back(AABB{pos, sizeDist(gen), sizeDist(gen), sizeDist(gen)});
+	}
+	return aabbs;
+}
+
+static std::vector<ViewFrustum> spotlightFrusta()
+{
+	// Same parameters as gl::Spotlight uses (aspect 1, up generated from direction)
+	std::vector<ViewFrustum> lights;
+	lights.push_back(ViewFrustum{vec3{0.0f, 20.0f, -30.0f}, vec3{0.0f, -1.0f, 0.0f},
+	                             vec3{1.0f, 0.0f, 0.0f}, 60.0f, 1.0f, 0.1f, 40.0f});
+	lights.push_back(ViewFrustum{vec3{-40.0f, 5.0f, -40.0f}, normalize(vec3{1.0f, -0.2f, 0.0f}),
+	                             vec3{0.0f, 1.0f, 0.0f}, 45.0f, 1.0f, 0.1f, 60.0f});
+	// Behind the camera, pointing away from it
+	lights.push_back(ViewFrustum{vec3{0.0f, 0.0f, 80.0f}, vec3{0.0f, 0.0f, 1.0f},
+	                             vec3{0.0f, 1.0f, 0.0f}, 30.0f, 1.0f, 0.1f, 15.0f});
+	lights.push_back(ViewFrustum{vec3{30.0f, 10.0f, -10.0f}, normalize(vec3{-1.0f, -1.0f, -1.0f}),
+	                             vec3{0.0f, 1.0f, 0.0f}, 90.0f, 1.0f, 0.1f, 30.0f});
+	return lights;
+}
+
+static std::vector<uint32_t> visibleIndices(const ViewFrustum& frustum, const std::vector<AABB>& aabbs)
+{
+	std::vector<uint32_t> indices;
+	for (uint32_t i = 0; i < aabbs.size(); i++) {
+		if (frustum.isVisible(aabbs[i])) indices.push_back(i);
+	}
+	return indices;
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Results match ViewFrustum::isVisible()", "[sfz::MultiFrustumCuller]")
+{
+	const ViewFrustum camera{vec3{0.0f, 2.0f, 0.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                         75.0f, 16.0f / 9.0f, 0.5f, 70.0f};
+	const std::vector<ViewFrustum> lights = spotlightFrusta();
+	const std::vector<AABB> aabbs = randomAABBs(5000, 1);
+
+	MultiFrustumCuller culler;
+	for (int frame = 0; frame < 2; frame++) {
+		culler.beginFrame(camera);
+		for (uint32_t i = 0; i < lights.size(); i++) REQUIRE(culler.addLight(lights[i]) == i);
+		REQUIRE(culler.numLights() == 4);
+		REQUIRE(culler.isLightActive(0));
+		REQUIRE(culler.isLightActive(1));
+		REQUIRE(!culler.isLightActive(2));
+		REQUIRE(culler.isLightActive(3));
+
+		culler.cull(aabbs.data(), aabbs.size());
+		REQUIRE(culler.cameraVisible() == visibleIndices(camera, aabbs));
+		REQUIRE(!culler.cameraVisible().empty());
+		for (uint32_t i = 0; i < lights.size(); i++) {
+			if (!culler.isLightActive(i)) {
+				REQUIRE(culler.casters(i).empty());
+				continue;
+			}
+			REQUIRE(culler.casters(i) == visibleIndices(lights[i], aabbs));
+			REQUIRE(!culler.casters(i).empty());
+		}
+	}
+
+	// Spheres
+	std::vector<Sphere> spheres;
+	for (const AABB& aabb : aabbs) spheres.push_back(Sphere{aabb.position(), aabb.halfXExtent()});
+	culler.beginFrame(camera);
+	for (const ViewFrustum& light : lights) culler.addLight(light);
+	culler.cull(spheres.data(), spheres.size());
+	std::vector<uint32_t> expected;
+	for (uint32_t i = 0; i < spheres.size(); i++) {
+		if (camera.isVisible(spheres[i])) expected.push_back(i);
+	}
+	REQUIRE(culler.cameraVisible() == expected);
+	expected.clear();
+	for (uint32_t i = 0; i < spheres.size(); i++) {
+		if (lights[3].isVisible(spheres[i])) expected.push_back(i);
+	}
+	REQUIRE(culler.casters(3) == expected);
+}
+
+TEST_CASE("Casters outside of camera frustum", "[sfz::MultiFrustumCuller]")
+{
+	const ViewFrustum camera{vec3{0.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                         60.0f, 1.0f, 0.1f, 50.0f};
+	// Light above the camera pointing down in front of it
+	const ViewFrustum light{vec3{0.0f, 30.0f, -20.0f}, vec3{0.0f, -1.0f, 0.0f},
+	                        vec3{0.0f, 0.0f, -1.0f}, 60.0f, 1.0f, 0.1f, 40.0f};
+
+	// Object between light and ground is not visible to camera, but still casts a shadow into it
+	AABB objects[] = {
+		AABB{vec3{0.0f, 25.0f, -20.0f}, 1.0f, 1.0f, 1.0f},
+		AABB{vec3{0.0f, 0.0f, -20.0f}, 1.0f, 1.0f, 1.0f},
+		AABB{vec3{0.0f, 0.0f, 20.0f}, 1.0f, 1.0f, 1.0f}
+	};
+
+	MultiFrustumCuller culler;
+	culler.beginFrame(camera);
+	REQUIRE(culler.numLights() == 0);
+	REQUIRE(culler.addLight(light) == 0);
+	REQUIRE(culler.isLightActive(0));
+	culler.cull(objects, 3);
+
+	REQUIRE(culler.cameraVisible().size() == 1);
+	REQUIRE(culler.cameraVisible()[0] == 1);
+	REQUIRE(culler.casters(0).size() == 2);
+	REQUIRE(culler.casters(0)[0] == 0);
+	REQUIRE(culler.casters(0)[1] == 1);
+}
+
+// Benchmarks (hidden, run with "[benchmark]")
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("MultiFrustumCuller vs isVisible() per light benchmark", "[.][benchmark][sfz::MultiFrustumCuller]")
+{
+	const ViewFrustum camera{vec3{0.0f, 2.0f, 0.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                         75.0f, 16.0f / 9.0f, 0.5f, 70.0f};
+	const std::vector<AABB> aabbs = randomAABBs(100000, 2);
+	std::vector<ViewFrustum> lights;
+	for (int i = 0; i < 16; i++) {
+		vec3 pos{-60.0f + float(i % 4) * 40.0f, 15.0f, -float(i / 4) * 30.0f};
+		lights.push_back(ViewFrustum{pos, vec3{0.0f, -1.0f, 0.0f}, vec3{1.0f, 0.0f, 0.0f},
+		                             60.0f, 1.0f, 0.1f, 40.0f});
+	}
+
+	// Every light culls all objects (same as submitting everything, but on CPU)
+	StopWatch stopWatch;
+	size_t naiveSum = visibleIndices(camera, aabbs).size();
+	for (const ViewFrustum& light : lights) {
+		if (camera.isVisible(light)) naiveSum += visibleIndices(light, aabbs).size();
+	}
+	float naiveTime = stopWatch.getTimeMilliSeconds();
+
+	MultiFrustumCuller culler;
+	culler.beginFrame(camera);
+	for (const ViewFrustum& light : lights) culler.addLight(light);
+	culler.cull(aabbs.data(), aabbs.size());
+
+	stopWatch.start();
+	culler.beginFrame(camera);
+	for (const ViewFrustum& light : lights) culler.addLight(light);
+	culler.cull(aabbs.data(), aabbs.size());
+	float cullerTime = stopWatch.getTimeMilliSeconds();
+
+	size_t cullerSum = culler.cameraVisible().size();
+	size_t numActive = 0;
+	for (uint32_t i = 0; i < culler.numLights(); i++) {
+		cullerSum += culler.casters(i).size();
+		if (culler.isLightActive(i)) numActive++;
+	}
+
+	std::cout << aabbs.size() << " AABBs, " << lights.size() << " lights (" << numActive
+	          << " active), " << cullerSum << " visible in total:"
+	          << "\nisVisible() per frustum: " << naiveTime << "ms"
+	          << "\nMultiFrustumCuller: " << cullerTime << "ms" << std::endl;
+	REQUIRE(naiveSum == cullerSum);
+}
\ No newline at end of file
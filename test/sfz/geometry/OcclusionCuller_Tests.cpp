@@ -0,0 +1,75 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include "sfz/Geometry.hpp"
+#include "sfz/Math.hpp"
+
+TEST_CASE("Occluded AABBs and OBBs", "[sfz::OcclusionCuller]")
+{
+	using namespace sfz;
+
+	ViewFrustum frustum{vec3{0.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                    60.0f, 1.0f, 0.1f, 100.0f};
+	OcclusionCuller culler{128, 128, 1};
+	REQUIRE(culler.width() == 128);
+	REQUIRE(culler.height() == 128);
+
+	// Nothing rendered, everything in front of camera is visible
+	culler.beginFrame(frustum);
+	culler.rasterize();
+	REQUIRE(culler.isVisible(AABB{vec3{0.0f, 0.0f, -20.0f}, 1.0f, 1.0f, 1.0f}));
+
+	// Wall covering the middle of the screen
+	culler.beginFrame(frustum);
+	culler.addOccluder(AABB{vec3{-2.0f, -2.0f, -10.5f}, vec3{2.0f, 2.0f, -10.0f}});
+	REQUIRE(culler.numTriangles() > 0);
+	culler.rasterize();
+
+	REQUIRE(!culler.isVisible(AABB{vec3{0.0f, 0.0f, -20.0f}, 1.0f, 1.0f, 1.0f}));
+	REQUIRE(culler.isVisible(AABB{vec3{0.0f, 0.0f, -5.0f}, 1.0f, 1.0f, 1.0f}));
+	REQUIRE(culler.isVisible(AABB{vec3{5.0f, 0.0f, -20.0f}, 1.0f, 1.0f, 1.0f}));
+	REQUIRE(culler.isVisible(AABB{vec3{0.0f, 0.0f, -10.0f}, 1.0f, 1.0f, 1.0f}));
+
+	// Occludee intersecting near plane is always visible
+	REQUIRE(culler.isVisible(AABB{vec3{0.0f, 0.0f, 0.0f}, 1.0f, 1.0f, 1.0f}));
+
+	const vec3 axis = normalize(vec3{1.0f, 1.0f, 0.0f});
+	OBB rotatedBehind{vec3{0.0f, 0.0f, -20.0f}, axis, cross(vec3{0.0f, 0.0f, 1.0f}, axis),
+	                  vec3{0.0f, 0.0f, 1.0f}, 1.0f, 1.0f, 1.0f};
+	OBB rotatedFront{vec3{0.0f, 0.0f, -5.0f}, axis, cross(vec3{0.0f, 0.0f, 1.0f}, axis),
+	                 vec3{0.0f, 0.0f, 1.0f}, 1.0f, 1.0f, 1.0f};
+	REQUIRE(!culler.isVisible(rotatedBehind));
+	REQUIRE(culler.isVisible(rotatedFront));
+}
+
+TEST_CASE("Multithreaded rasterization", "[sfz::OcclusionCuller]")
+{
+	using namespace sfz;
+
+	ViewFrustum frustum{vec3{0.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                    60.0f, 1.5f, 0.1f, 100.0f};
+	OcclusionCuller single{96, 64, 1};
+	OcclusionCuller multi{96, 64, 4};
+	single.beginFrame(frustum);
+	multi.beginFrame(frustum);
+
+	for (int i = 0; i < 20; i++) {
+		float x = -10.0f + float(i);
+		float z = -5.0f - float(i % 7);
+		AABB box{vec3{x, -1.0f, z - 0.5f}, vec3{x + 0.5f, float(i % 5), z}};
+		single.addOccluder(box);
+		multi.addOccluder(box);
+	}
+	REQUIRE(multi.numTriangles() >= 64);
+	single.rasterize();
+	multi.rasterize();
+
+	const size_t numPixels = size_t(single.width()) * size_t(single.height());
+	for (size_t i = 0; i < numPixels; i++) {
+		REQUIRE(single.depthBuffer()[i] == multi.depthBuffer()[i]);
+	}
+	const size_t numTiles = numPixels / (OcclusionCuller::TILE_WIDTH * OcclusionCuller::TILE_HEIGHT);
+	for (size_t i = 0; i < numTiles; i++) {
+		REQUIRE(single.tileDepthBuffer()[i] == multi.tileDepthBuffer()[i]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include "sfz/Geometry.hpp"
+#include "sfz/Math.hpp"
+
+TEST_CASE("Corners and bounding volumes", "[sfz::ViewFrustum]")
+{
+	using namespace sfz;
+
+	ViewFrustum frustum{vec3{1.0f, 2.0f, 3.0f}, vec3{1.0f, -0.5f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                    70.0f, 1.6f, 0.5f, 50.0f};
+
+	// Corners project to the corners of the NDC cube
+	const vec3* corners = frustum.corners();
+	const mat4& viewProj = frustum.viewProjMatrix();
+	for (int i = 0; i < 8; i++) {
+		vec4 clip = viewProj * vec4{corners[i], 1.0f};
+		vec3 ndc = vec3{clip.x, clip.y, clip.z} / clip.w;
+		REQUIRE(approxEqual(ndc.x, (i & 1) != 0 ? 1.0f : -1.0f, 0.001f));
+		REQUIRE(approxEqual(ndc.y, (i & 2) != 0 ? 1.0f : -1.0f, 0.001f));
+		REQUIRE(approxEqual(ndc.z, (i & 4) != 0 ? 1.0f : -1.0f, 0.001f));
+	}
+
+	// Bounding volumes contain all corners
+	const Sphere& sphere = frustum.boundingSphere();
+	const AABB& aabb = frustum.boundingAABB();
+	for (int i = 0; i < 8; i++) {
+		REQUIRE(length(corners[i] - sphere.position()) <= (sphere.radius() * 1.0001f));
+		for (int j = 0; j < 3; j++) {
+			REQUIRE(aabb.min()[j] <= corners[i][j]);
+			REQUIRE(corners[i][j] <= aabb.max()[j]);
+		}
+	}
+
+	// Corners are just inside the frustum planes
+	for (int i = 0; i < 8; i++) {
+		vec3 inside = corners[i] + 0.05f * (frustum.pos() + frustum.dir() * 10.0f - corners[i]);
+		REQUIRE(frustum.isVisible(Sphere{inside, 0.001f}));
+	}
+}
+
+TEST_CASE("Setters update derived data", "[sfz::ViewFrustum]")
+{
+	using namespace sfz;
+
+	ViewFrustum frustum{vec3{0.0f}, vec3{0.0f, 0.0f, -1.0f}, vec3{0.0f, 1.0f, 0.0f},
+	                    60.0f, 2.0f, 1.0f, 10.0f};
+	const Sphere target{vec3{0.0f, 0.0f, -20.0f}, 0.5f};
+	REQUIRE(!frustum.isVisible(target));
+	mat4 viewBefore = frustum.viewMatrix();
+	mat4 projBefore = frustum.projMatrix();
+
+	frustum.setClipDist(1.0f, 30.0f);
+	REQUIRE(frustum.isVisible(target));
+	REQUIRE(frustum.viewMatrix() == viewBefore);
+	REQUIRE(frustum.projMatrix() != projBefore);
+	const mat4 expectedProj = glPerspectiveProjectionMatrix(60.0f, 2.0f, 1.0f, 30.0f);
+	REQUIRE(approxEqual(frustum.projMatrix(), expectedProj));
+
+	frustum.setPos(vec3{100.0f, 0.0f, 0.0f});
+	REQUIRE(!frustum.isVisible(target));
+	REQUIRE(frustum.isVisible(Sphere{vec3{100.0f, 0.0f, -20.0f}, 0.5f}));
+	REQUIRE(frustum.viewProjMatrix() == frustum.projMatrix() * frustum.viewMatrix());
+
+	frustum.setDir(vec3{0.0f, 0.0f, 1.0f}, vec3{0.0f, 1.0f, 0.0f});
+	REQUIRE(!frustum.isVisible(Sphere{vec3{100.0f, 0.0f, -20.0f}, 0.5f}));
+	REQUIRE(frustum.isVisible(Sphere{vec3{100.0f, 0.0f, 20.0f}, 0.5f}));
+
+	// Horizontal extent follows aspect ratio of projection matrix
+	const float yHalfExtent = 20.0f * std::tan(30.0f * DEG_TO_RAD());
+	const float xHalfExtent = 2.0f * yHalfExtent;
+	REQUIRE(frustum.isVisible(AABB{vec3{100.0f - xHalfExtent + 0.1f, 0.0f, 20.0f}, 0.1f, 0.1f, 0.1f}));
+	REQUIRE(!frustum.isVisible(AABB{vec3{100.0f - xHalfExtent - 0.2f, 0.0f, 20.0f}, 0.1f, 0.1f, 0.1f}));
+	frustum.setAspectRatio(1.0f);
+	REQUIRE(!frustum.isVisible(AABB{vec3{100.0f - xHalfExtent + 0.1f, 0.0f, 20.0f}, 0.1f, 0.1f, 0.1f}));
+	REQUIRE(frustum.isVisible(AABB{vec3{100.0f - yHalfExtent + 0.1f, 0.0f, 20.0f}, 0.1f, 0.1f, 0.1f}));
+
+	// Copies keep their derived data
+	ViewFrustum copy = frustum;
+	REQUIRE(copy.viewProjMatrix() == frustum.viewProjMatrix());
+	REQUIRE(copy.isVisible(frustum));
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <iostream>
+
+#include "sfz/Geometry.hpp"
+#include "sfz/Math.hpp"
+#include "sfz/Physics.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+
+TEST_CASE("Bodies and fixed timestep", "[sfz::PhysicsWorld2D]")
+{
+	PhysicsWorld2D world{4, 0, 1};
+	REQUIRE(world.maxBodies() == 4);
+	REQUIRE(world.maxContacts() == 16);
+	REQUIRE(world.numThreads() == 1);
+
+	uint32_t ground = world.addBody(AABB2D{vec2{0.0f, -1.0f}, vec2{20.0f, 2.0f}}, 0.0f);
+	uint32_t ball = world.addBody(Circle{vec2{0.0f, 5.0f}, 0.5f}, 1.0f);
+	REQUIRE(ground == 0);
+	REQUIRE(ball == 1);
+	REQUIRE(world.numBodies() == 2);
+	REQUIRE(world.isStatic(ground));
+	REQUIRE(!world.isAwake(ground));
+	REQUIRE(world.isAwake(ball));
+	REQUIRE(world.mass(ball) == 1.0f);
+	REQUIRE((world.box(ground).min == vec2{-10.0f, -2.0f}));
+	REQUIRE(world.circle(ball).radius == 0.5f);
+
+	// Free fall, time is accumulated between calls
+	world.timestep(1.0f / 60.0f);
+	REQUIRE(world.update(1.0f / 120.0f) == 0);
+	REQUIRE(world.update(1.0f / 120.0f + 0.0001f) == 1);
+	REQUIRE(world.update(2.0f / 60.0f) == 2);
+	REQUIRE(world.velocity(ball).y < 0.0f);
+	REQUIRE(world.position(ball).y < 5.0f);
+	REQUIRE((world.position(ground) == vec2{0.0f, -1.0f}));
+
+	// Spiral of death protection
+	REQUIRE(world.update(10.0f) == PhysicsWorld2D::MAX_STEPS_PER_UPDATE);
+	REQUIRE(world.interpolationAlpha() < 1.0f);
+
+	// Ball lands on ground and comes to rest
+	for (int i = 0; i < 300; i++) world.step();
+	REQUIRE(approxEqual(world.position(ball).y, 0.5f, 0.02f));
+	REQUIRE(!world.isAwake(ball));
+
+	// Removed slots are reused
+	world.removeBody(ball);
+	REQUIRE(world.numBodies() == 1);
+	REQUIRE(!world.isValid(ball));
+	REQUIRE(world.addBody(Circle{vec2{3.0f, 3.0f}, 1.0f}, 2.0f) == ball);
+
+	// Full world
+	REQUIRE(world.addBody(Circle{vec2{-3.0f, 3.0f}, 1.0f}, 1.0f) == 2);
+	REQUIRE(world.addBody(Circle{vec2{-6.0f, 3.0f}, 1.0f}, 1.0f) == 3);
+	REQUIRE(world.addBody(Circle{vec2{-9.0f, 3.0f}, 1.0f}, 1.0f) == PhysicsWorld2D::NO_BODY);
+}
+
+TEST_CASE("Collision response", "[sfz::PhysicsWorld2D]")
+{
+	PhysicsWorld2D world{8, 0, 1};
+	world.gravity(vec2{0.0f});
+
+	// Head on collision between equal circles, momentum is conserved
+	uint32_t a = world.addBody(Circle{vec2{-2.0f, 0.0f}, 0.5f}, 1.0f, 0.0f, 1.0f);
+	uint32_t b = world.addBody(Circle{vec2{2.0f, 0.0f}, 0.5f}, 1.0f, 0.0f, 1.0f);
+	world.setVelocity(a, vec2{5.0f, 0.0f});
+	world.setVelocity(b, vec2{-5.0f, 0.0f});
+	for (int i = 0; i < 60; i++) world.step();
+	vec2 momentum = world.velocity(a) + world.velocity(b);
+	REQUIRE(approxEqual(momentum.x, 0.0f, 0.001f));
+	REQUIRE(world.velocity(a).x < -4.0f);
+	REQUIRE(world.velocity(b).x > 4.0f);
+
+	// Circle vs box and box vs box push bodies apart along the shortest axis
+	PhysicsWorld2D world2{8, 0, 1};
+	world2.gravity(vec2{0.0f});
+	uint32_t box = world2.addBody(AABB2D{vec2{0.0f, 0.0f}, vec2{2.0f, 2.0f}}, 1.0f);
+	uint32_t circle = world2.addBody(Circle{vec2{1.4f, 0.1f}, 0.5f}, 1.0f);
+	uint32_t box2 = world2.addBody(AABB2D{vec2{0.1f, -1.9f}, vec2{2.0f, 2.0f}}, 1.0f);
+	world2.step();
+	REQUIRE(world2.numContacts() == 2);
+	const Contact2D* contacts = world2.contacts();
+	REQUIRE(contacts[0].bodyA == box);
+	REQUIRE(contacts[0].bodyB == circle);
+	REQUIRE(approxEqual(contacts[0].normal, vec2{1.0f, 0.0f}, 0.001f));
+	REQUIRE(approxEqual(contacts[0].penetration, 0.1f, 0.001f));
+	REQUIRE(contacts[1].bodyB == box2);
+	REQUIRE(approxEqual(contacts[1].normal, vec2{0.0f, -1.0f}, 0.001f));
+	REQUIRE(world2.velocity(circle).x > 0.0f);
+	REQUIRE(world2.velocity(box2).y < 0.0f);
+}
+
+TEST_CASE("Stacking, warm starting and sleeping islands", "[sfz::PhysicsWorld2D]")
+{
+	PhysicsWorld2D world{16, 0, 1};
+	world.addBody(AABB2D{vec2{0.0f, -0.5f}, vec2{20.0f, 1.0f}}, 0.0f);
+	uint32_t boxes[5];
+	for (int i = 0; i < 5; i++) {
+		boxes[i] = world.addBody(AABB2D{vec2{0.0f, 0.5f + float(i)}, vec2{1.0f, 1.0f}}, 1.0f);
+	}
+
+	for (int i = 0; i < 10; i++) world.step();
+	REQUIRE(world.numIslands() == 1);
+	for (int i = 0; i < 110; i++) world.step();
+
+	// Stack is stable, bottom contact carries the weight of all boxes
+	for (int i = 0; i < 5; i++) {
+		REQUIRE(approxEqual(world.position(boxes[i]).x, 0.0f, 0.001f));
+		REQUIRE(approxEqual(world.position(boxes[i]).y, 0.5f + float(i), 0.05f));
+	}
+	const Contact2D& bottom = world.contacts()[0];
+	REQUIRE(bottom.bodyB == boxes[0]);
+	REQUIRE(approxEqual(bottom.normalImpulse, 5.0f * 9.82f * world.timestep(), 0.05f));
+
+	// Whole island falls asleep, and is woken as a whole
+	for (int i = 0; i < 60; i++) world.step();
+	REQUIRE(world.numAwakeBodies() == 0);
+	world.applyImpulse(boxes[4], vec2{0.1f, 0.0f});
+	REQUIRE(world.numAwakeBodies() == 5);
+
+	// A new body touching the sleeping island wakes it
+	for (int i = 0; i < 120; i++) world.step();
+	REQUIRE(world.numAwakeBodies() == 0);
+	world.addBody(Circle{vec2{0.0f, 6.0f}, 0.5f}, 1.0f);
+	for (int i = 0; i < 30; i++) world.step();
+	REQUIRE(world.isAwake(boxes[0]));
+}
+
+TEST_CASE("Woken islands keep their contacts", "[sfz::PhysicsWorld2D]")
+{
+	PhysicsWorld2D world{16, 0, 1};
+	const uint32_t ground = world.addBody(AABB2D{vec2{0.0f, -0.5f}, vec2{20.0f, 1.0f}}, 0.0f);
+	uint32_t boxes[5];
+	for (int i = 0; i < 5; i++) {
+		boxes[i] = world.addBody(AABB2D{vec2{0.0f, 0.5f + float(i)}, vec2{1.0f, 1.0f}}, 1.0f);
+	}
+	for (int i = 0; i < 240; i++) world.step();
+	REQUIRE(world.numAwakeBodies() == 0);
+	vec2 restPositions[5];
+	for (int i = 0; i < 5; i++) restPositions[i] = world.position(boxes[i]);
+
+	// The stack is woken by the new box during collision detection, after the sweep has already
+	// passed the pairs with the ground
+	const float topY = restPositions[4].y + 0.5f;
+	world.addBody(AABB2D{vec2{0.0f, topY + 0.49f}, vec2{1.0f, 1.0f}}, 1.0f);
+	world.step();
+	REQUIRE(world.numAwakeBodies() == 6);
+	bool groundContact = false;
+	for (uint32_t i = 0; i < world.numContacts(); i++) {
+		const Contact2D& contact = world.contacts()[i];
+		if (contact.bodyA == ground && contact.bodyB == boxes[0]) groundContact = true;
+	}
+	REQUIRE(groundContact);
+
+	// The stack does not sink under the extra weight
+	REQUIRE(world.velocity(boxes[0]).y > -0.05f);
+	for (int i = 0; i < 30; i++) world.step();
+	for (int i = 0; i < 5; i++) {
+		REQUIRE(approxEqual(world.position(boxes[i]).y, restPositions[i].y, 0.01f));
+	}
+}
+
+TEST_CASE("Removing or moving static bodies wakes bodies resting on them", "[sfz::PhysicsWorld2D]")
+{
+	PhysicsWorld2D world{16, 0, 1};
+	const uint32_t floor = world.addBody(AABB2D{vec2{0.0f, -0.5f}, vec2{20.0f, 1.0f}}, 0.0f);
+	const uint32_t ledge = world.addBody(AABB2D{vec2{30.0f, -0.5f}, vec2{4.0f, 1.0f}}, 0.0f);
+	uint32_t boxes[3];
+	for (int i = 0; i < 3; i++) {
+		boxes[i] = world.addBody(AABB2D{vec2{0.0f, 0.5f + float(i)}, vec2{1.0f, 1.0f}}, 1.0f);
+	}
+	const uint32_t ledgeBox = world.addBody(AABB2D{vec2{30.0f, 0.5f}, vec2{1.0f, 1.0f}}, 1.0f);
+	for (int i = 0; i < 240; i++) world.step();
+	REQUIRE(world.numAwakeBodies() == 0);
+
+	// Stack falls when the floor is removed
+	world.removeBody(floor);
+	REQUIRE(world.isAwake(boxes[0]));
+	for (int i = 0; i < 60; i++) world.step();
+	for (int i = 0; i < 3; i++) REQUIRE(world.position(boxes[i]).y < -1.0f);
+
+	// Box falls when the ledge is moved away from under it
+	REQUIRE(!world.isAwake(ledgeBox));
+	world.setPosition(ledge, vec2{30.0f, -10.0f});
+	REQUIRE(world.isAwake(ledgeBox));
+	for (int i = 0; i < 30; i++) world.step();
+	REQUIRE(world.position(ledgeBox).y < 0.0f);
+}
+
+TEST_CASE("Islands are solved identically in parallel", "[sfz::PhysicsWorld2D]")
+{
+	PhysicsWorld2D single{2000, 0, 1};
+	PhysicsWorld2D multi{2000, 0, 4};
+	REQUIRE(multi.numThreads() == 4);
+
+	// Many separate piles of circles, each pile its own island
+	for (PhysicsWorld2D* world : {&single, &multi}) {
+		world->addBody(AABB2D{vec2{0.0f, -0.5f}, vec2{1000.0f, 1.0f}}, 0.0f);
+		for (int pile = 0; pile < 100; pile++) {
+			for (int i = 0; i < 10; i++) {
+				vec2 pos{float(pile) * 5.0f + 0.1f * float(i % 3), 0.5f + float(i) * 1.1f};
+				world->addBody(Circle{pos, 0.5f}, 1.0f);
+			}
+		}
+	}
+
+	for (int i = 0; i < 60; i++) {
+		single.step();
+		multi.step();
+	}
+	REQUIRE(multi.numIslands() >= 100);
+	REQUIRE(single.numContacts() == multi.numContacts());
+	for (uint32_t i = 0; i < single.numBodies(); i++) {
+		REQUIRE(single.position(i) == multi.position(i));
+	}
+}
+
+TEST_CASE("10k bodies benchmark", "[.][benchmark][sfz::PhysicsWorld2D]")
+{
+	PhysicsWorld2D world{10100};
+	world.addBody(AABB2D{vec2{0.0f, -0.5f}, vec2{400.0f, 1.0f}}, 0.0f);
+	for (int i = 0; i < 10000; i++) {
+		float x = -190.0f + float(i % 200) * 1.9f;
+		float y = 1.0f + float(i / 200) * 1.2f;
+		if (i % 2 == 0) world.addBody(Circle{vec2{x, y}, 0.45f}, 1.0f);
+		else world.addBody(AABB2D{vec2{x, y}, vec2{0.9f, 0.9f}}, 1.0f);
+	}
+
+	const int NUM_STEPS = 600;
+	float maxStepTime = 0.0f;
+	StopWatch total;
+	for (int i = 0; i < NUM_STEPS; i++) {
+		StopWatch stepTime;
+		world.step();
+		maxStepTime = std::max(maxStepTime, stepTime.getTimeMilliSeconds());
+	}
+	float totalTime = total.getTimeMilliSeconds();
+
+	std::cout << "10k bodies, " << NUM_STEPS << " steps using " << world.numThreads() << " threads:"
+	          << "\nAverage step: " << (totalTime / float(NUM_STEPS)) << "ms"
+	          << "\nMax step: " << maxStepTime << "ms"
+	          << "\nAwake bodies at end: " << world.numAwakeBodies()
+	          << ", contacts: " << world.numContacts() << ", islands: " << world.numIslands()
+	          << std::endl;
+	REQUIRE(world.numBodies() == 10001);
+}
\ No newline at end of file
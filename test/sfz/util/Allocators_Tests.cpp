@@ -0,0 +1,268 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <thread>
+#include <vector>
+
+#include "sfz/util/Allocators.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+using std::uint8_t;
+using std::uintptr_t;
+
+static bool isAligned(const void* ptr, size_t alignment) noexcept
+{
+	return (uintptr_t(ptr) & (alignment - 1)) == 0;
+}
+
+TEST_CASE("LinearAllocator", "[sfz::Allocators]")
+{
+	LinearAllocator allocator(1024);
+	REQUIRE(allocator.capacity() == 1024);
+	REQUIRE(allocator.used() == 0);
+
+	SECTION("Allocating and alignment") {
+		void* a = allocator.allocate(3, 1);
+		void* b = allocator.allocate(10, 64);
+		void* c = allocator.allocate(8);
+		REQUIRE(isAligned(b, 64));
+		REQUIRE(isAligned(c, ALLOCATOR_DEFAULT_ALIGNMENT));
+		REQUIRE(static_cast<uint8_t*>(b) >= static_cast<uint8_t*>(a) + 3);
+		REQUIRE(static_cast<uint8_t*>(c) >= static_cast<uint8_t*>(b) + 10);
+		REQUIRE(allocator.numAllocations() == 3);
+		REQUIRE(allocator.numOverflowAllocations() == 0);
+
+		int* ints = allocator.allocateArray<int>(10);
+		REQUIRE(isAligned(ints, alignof(int)));
+		for (int i = 0; i < 10; i++) ints[i] = i;
+		REQUIRE(ints[9] == 9);
+	}
+	SECTION("Deallocating last allocation") {
+		void* a = allocator.allocate(16);
+		void* b = allocator.allocate(32);
+		REQUIRE(allocator.used() == 48);
+		allocator.deallocate(a, 16); // Not last, does nothing
+		REQUIRE(allocator.used() == 48);
+		allocator.deallocate(b, 32);
+		REQUIRE(allocator.used() == 16);
+		void* c = allocator.allocate(32);
+		REQUIRE(c == b);
+	}
+	SECTION("Markers") {
+		allocator.allocate(100);
+		LinearAllocator::Marker marker = allocator.marker();
+		const size_t usedAtMarker = allocator.used();
+		allocator.allocate(200);
+		allocator.allocate(2000); // Overflow
+		REQUIRE(allocator.numOverflowAllocations() == 1);
+		REQUIRE(allocator.peak() >= 2300);
+		allocator.rewind(marker);
+		REQUIRE(allocator.used() == usedAtMarker);
+		REQUIRE(allocator.peak() >= 2300);
+	}
+	SECTION("Overflow and peaks") {
+		uint8_t* inBlock = static_cast<uint8_t*>(allocator.allocate(1000));
+		uint8_t* overflow = static_cast<uint8_t*>(allocator.allocate(100, 128));
+		REQUIRE(isAligned(overflow, 128));
+		for (int i = 0; i < 100; i++) overflow[i] = uint8_t(i);
+		REQUIRE(allocator.numOverflowAllocations() == 1);
+		REQUIRE(allocator.used() == 1000);
+		REQUIRE(allocator.peak() == 1100);
+
+		allocator.reset();
+		REQUIRE(allocator.used() == 0);
+		REQUIRE(allocator.peak() == 0);
+		REQUIRE(allocator.lastPeak() == 1100);
+		REQUIRE(allocator.highWaterMark() == 1100);
+		REQUIRE(allocator.numAllocations() == 0);
+		REQUIRE(allocator.numOverflowAllocations() == 0);
+
+		allocator.allocate(10);
+		allocator.reset();
+		REQUIRE(allocator.lastPeak() == 10);
+		REQUIRE(allocator.highWaterMark() == 1100);
+		REQUIRE(allocator.allocate(1000) == inBlock);
+	}
+#ifdef SFZ_ALLOCATOR_POISONING
+	SECTION("Poisoning") {
+		uint8_t* bytes = static_cast<uint8_t*>(allocator.allocate(64));
+		for (int i = 0; i < 64; i++) bytes[i] = 0;
+		allocator.reset();
+		for (int i = 0; i < 64; i++) REQUIRE(bytes[i] == ALLOCATOR_POISON_BYTE);
+	}
+#endif
+}
+
+TEST_CASE("PoolAllocator", "[sfz::Allocators]")
+{
+	struct Element final {
+		int value;
+		double d;
+		Element(int value) noexcept : value(value), d(2.0) { }
+	};
+
+	PoolAllocator pool(sizeof(Element), 4, alignof(Element));
+	REQUIRE(pool.capacity() == 4);
+	REQUIRE(pool.elementSize() >= sizeof(Element));
+
+	Element* elements[4];
+	for (int i = 0; i < 4; i++) {
+		elements[i] = pool.create<Element>(i);
+		REQUIRE(elements[i] != nullptr);
+		REQUIRE(pool.owns(elements[i]));
+		REQUIRE(isAligned(elements[i], alignof(Element)));
+	}
+	REQUIRE(pool.create<Element>(4) == nullptr);
+	REQUIRE(pool.numAllocated() == 4);
+	for (int i = 0; i < 4; i++) REQUIRE(elements[i]->value == i);
+
+	int local = 0;
+	REQUIRE(!pool.owns(&local));
+	REQUIRE(!pool.owns(reinterpret_cast<uint8_t*>(elements[0]) + 1));
+	REQUIRE(pool.allocate(pool.elementSize() + 1, 1) == nullptr);
+
+	pool.destroy(elements[2]);
+	REQUIRE(pool.numAllocated() == 3);
+	Element* reused = pool.create<Element>(7);
+	REQUIRE(reused == elements[2]);
+	REQUIRE(reused->value == 7);
+	REQUIRE(pool.peak() == 4);
+
+	pool.destroy(reused);
+	pool.destroy(elements[0]);
+	pool.destroy(elements[1]);
+	pool.destroy(elements[3]);
+	REQUIRE(pool.numAllocated() == 0);
+	REQUIRE(pool.peak() == 4);
+}
+
+TEST_CASE("StlAllocator", "[sfz::Allocators]")
+{
+	SECTION("LinearVector") {
+		LinearAllocator allocator(64 * 1024);
+		{
+			LinearVector<int> vec(allocator);
+			for (int i = 0; i < 1000; i++) vec.push_back(i);
+			REQUIRE(vec.size() == 1000);
+			for (int i = 0; i < 1000; i++) REQUIRE(vec[i] == i);
+
+			// Buffers left behind when growing are only freed by rewinding, about 2x final size
+			REQUIRE(allocator.used() < 3 * 1024 * sizeof(int));
+			LinearVector<int> copy(vec);
+			REQUIRE(copy == vec);
+		}
+		REQUIRE(allocator.numOverflowAllocations() == 0);
+	}
+	SECTION("Pool backed std::list") {
+		PoolAllocator pool(64, 100);
+		{
+			using ListAllocator = StlAllocator<int, PoolAllocator>;
+			std::list<int, ListAllocator> list{ListAllocator(pool)};
+			for (int i = 0; i < 100; i++) list.push_back(i);
+			REQUIRE(pool.numAllocated() == 100);
+			list.pop_front();
+			REQUIRE(pool.numAllocated() == 99);
+			REQUIRE(list.front() == 1);
+		}
+		REQUIRE(pool.numAllocated() == 0);
+	}
+}
+
+TEST_CASE("Frame and scratch allocators", "[sfz::Allocators]")
+{
+	SECTION("Frame allocator") {
+		LinearAllocator& allocator = frameAllocator();
+		REQUIRE(&allocator == &frameAllocator());
+		REQUIRE(allocator.capacity() == FRAME_ALLOCATOR_CAPACITY);
+		allocator.allocate(123);
+		allocator.reset();
+		REQUIRE(allocator.lastPeak() == 123);
+	}
+	SECTION("Scratch scopes") {
+		LinearAllocator& allocator = scratchAllocator();
+		REQUIRE(allocator.used() == 0);
+		{
+			ScratchScope outer;
+			int* a = outer.allocateArray<int>(10);
+			a[0] = 1;
+			const size_t usedOuter = allocator.used();
+			{
+				ScratchScope inner;
+				inner.allocateArray<double>(100);
+				REQUIRE(allocator.used() > usedOuter);
+			}
+			REQUIRE(allocator.used() == usedOuter);
+			LinearVector<int> vec(outer.allocator());
+			vec.push_back(3);
+		}
+		REQUIRE(allocator.used() == 0);
+
+		// Each thread has its own scratch allocator
+		LinearAllocator* other = nullptr;
+		std::thread thread([&]() { other = &scratchAllocator(); });
+		thread.join();
+		REQUIRE(other != &allocator);
+	}
+}
+
+TEST_CASE("Allocators performance", "[.][benchmark][sfz::Allocators]")
+{
+	const int NUM_ITERATIONS = 1000000;
+	volatile uintptr_t dummy = 0;
+
+	StopWatch watch;
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		uint8_t* ptr = new uint8_t[64];
+		dummy = dummy + uintptr_t(ptr);
+		delete[] ptr;
+	}
+	watch.stop();
+	std::cout << "new[] + delete[] (64 bytes): "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		ScratchScope scratch;
+		dummy = dummy + uintptr_t(scratch.allocateArray<uint8_t>(64));
+	}
+	watch.stop();
+	std::cout << "ScratchScope + allocateArray() (64 bytes): "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	PoolAllocator pool(64, 16);
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		void* ptr = pool.allocate();
+		dummy = dummy + uintptr_t(ptr);
+		pool.deallocate(ptr);
+	}
+	watch.stop();
+	std::cout << "PoolAllocator allocate() + deallocate(): "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	watch.start();
+	for (int i = 0; i < 10000; i++) {
+		std::vector<int> vec;
+		for (int j = 0; j < 1000; j++) vec.push_back(j);
+		dummy = dummy + uintptr_t(vec.data());
+	}
+	watch.stop();
+	std::cout << "std::vector 1000 push_backs: "
+	          << (watch.getTimeNanoSeconds() / 10000) << " ns\n";
+
+	LinearAllocator& frame = frameAllocator();
+	watch.start();
+	for (int i = 0; i < 10000; i++) {
+		LinearVector<int> vec(frame);
+		for (int j = 0; j < 1000; j++) vec.push_back(j);
+		dummy = dummy + uintptr_t(vec.data());
+		frame.reset();
+	}
+	watch.stop();
+	std::cout << "LinearVector 1000 push_backs: "
+	          << (watch.getTimeNanoSeconds() / 10000) << " ns\n";
+}
\ No newline at end of file
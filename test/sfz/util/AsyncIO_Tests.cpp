@@ -0,0 +1,193 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sfz/util/AsyncIO.hpp"
+#include "sfz/util/IO.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using std::string;
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static string testFilePath(size_t index)
+{
+	return basePath() + "afjeoajfoeajfoa_async_" + std::to_string(index) + ".bin";
+}
+
+static vector<uint8_t> testFileData(size_t index, size_t size)
+{
+	vector<uint8_t> data(size);
+	for (size_t i = 0; i < size; i++) data[i] = uint8_t(i * 31 + index);
+	return data;
+}
+
+static void writeTestFiles(size_t count, size_t size)
+{
+	for (size_t i = 0; i < count; i++) {
+		vector<uint8_t> data = testFileData(i, size);
+		REQUIRE(writeBinaryFile(testFilePath(i).c_str(), data.data(), data.size()));
+	}
+}
+
+static void deleteTestFiles(size_t count)
+{
+	for (size_t i = 0; i < count; i++) REQUIRE(deleteFile(testFilePath(i).c_str()));
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Callbacks and futures", "[sfz::AsyncIO]")
+{
+	const size_t NUM_FILES = 50;
+	writeTestFiles(NUM_FILES, 3000);
+	AsyncIO io{4};
+	REQUIRE(io.numThreads() == 4);
+
+	// Callbacks are only called from pollCompleted()
+	vector<bool> done(NUM_FILES, false);
+	for (size_t i = 0; i < NUM_FILES; i++) {
+		uint64_t id = io.readFile(testFilePath(i).c_str(), [&done, i](IOResult& result) {
+			REQUIRE(result.status == IOStatus::DONE);
+			REQUIRE(result.userBuffer == nullptr);
+			REQUIRE(result.data == testFileData(i, 3000));
+			REQUIRE(result.bytes() == result.data.data());
+			done[i] = true;
+		});
+		REQUIRE(id != AsyncIO::INVALID_ID);
+	}
+	io.waitAll();
+	REQUIRE(io.numPending() == 0);
+	REQUIRE(io.numBytesRead() == NUM_FILES * 3000);
+	for (bool d : done) REQUIRE(d);
+	REQUIRE(io.pollCompleted() == 0);
+
+	// Futures
+	std::future<IOResult> future = io.readFileFuture(testFilePath(3).c_str(), IOPriority::HIGH);
+	IOResult result = future.get();
+	REQUIRE(result.status == IOStatus::DONE);
+	REQUIRE(result.numBytes == 3000);
+	REQUIRE(result.data == testFileData(3, 3000));
+
+	// Caller provided buffers
+	vector<uint8_t> buffer(4000, 0);
+	result = io.readFileFuture(testFilePath(7).c_str(), buffer.data(), buffer.size()).get();
+	REQUIRE(result.status == IOStatus::DONE);
+	REQUIRE(result.userBuffer == buffer.data());
+	REQUIRE(result.bytes() == buffer.data());
+	REQUIRE(result.data.empty());
+	REQUIRE(std::equal(buffer.begin(), buffer.begin() + 3000, testFileData(7, 3000).begin()));
+	result = io.readFileFuture(testFilePath(7).c_str(), buffer.data(), 2999).get();
+	REQUIRE(result.status == IOStatus::BUFFER_TOO_SMALL);
+
+	// Missing files
+	deleteTestFiles(NUM_FILES);
+	bool failed = false;
+	io.readFile(testFilePath(0).c_str(), [&failed](IOResult& result) {
+		failed = result.status == IOStatus::FAILED;
+	});
+	io.waitAll();
+	REQUIRE(failed);
+}
+
+TEST_CASE("Priorities, cancellation and buffer pool", "[sfz::AsyncIO]")
+{
+	writeTestFiles(4, 1000);
+	AsyncIO io{1};
+
+	// Nothing starts while suspended, then requests are serviced by priority
+	vector<size_t> order;
+	auto recordOrder = [&order](size_t index) {
+		return [&order, index](IOResult& result) {
+			if (result.status == IOStatus::DONE) order.push_back(index);
+		};
+	};
+	io.suspend();
+	io.readFile(testFilePath(0).c_str(), recordOrder(0), IOPriority::LOW);
+	uint64_t cancelId = io.readFile(testFilePath(1).c_str(), recordOrder(1), IOPriority::NORMAL);
+	io.readFile(testFilePath(2).c_str(), recordOrder(2), IOPriority::HIGH);
+	io.readFile(testFilePath(3).c_str(), recordOrder(3), IOPriority::NORMAL);
+	REQUIRE(io.numPending() == 4);
+
+	REQUIRE(io.cancel(cancelId));
+	REQUIRE(!io.cancel(12345));
+	REQUIRE(io.numPending() == 3);
+	REQUIRE(io.pollCompleted() == 1); // Cancelled request
+
+	io.resume();
+	io.waitAll();
+	REQUIRE(order.size() == 3);
+	REQUIRE(order[0] == 2);
+	REQUIRE(order[1] == 3);
+	REQUIRE(order[2] == 0);
+	REQUIRE(!io.cancel(cancelId));
+
+	// Released buffers are reused
+	IOResult result = io.readFileFuture(testFilePath(0).c_str()).get();
+	const uint8_t* ptr = result.data.data();
+	io.releaseBuffer(std::move(result.data));
+	result = io.readFileFuture(testFilePath(1).c_str()).get();
+	REQUIRE(result.data.data() == ptr);
+	REQUIRE(result.data == testFileData(1, 1000));
+
+	// Queued requests are cancelled on destruction
+	std::future<IOResult> future;
+	{
+		AsyncIO suspended{1};
+		suspended.suspend();
+		future = suspended.readFileFuture(testFilePath(0).c_str());
+	}
+	REQUIRE(future.get().status == IOStatus::CANCELLED);
+
+	deleteTestFiles(4);
+}
+
+// Benchmarks (hidden, run with "[benchmark]")
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static void benchmark(size_t numFiles, size_t fileSize)
+{
+	writeTestFiles(numFiles, fileSize);
+
+	StopWatch stopWatch;
+	size_t syncBytes = 0;
+	for (size_t i = 0; i < numFiles; i++) syncBytes += readBinaryFile(testFilePath(i).c_str()).size();
+	float syncTime = stopWatch.getTimeMilliSeconds();
+
+	AsyncIO io;
+	size_t asyncBytes = 0;
+	stopWatch.start();
+	for (size_t i = 0; i < numFiles; i++) {
+		io.readFile(testFilePath(i).c_str(), [&](IOResult& result) {
+			asyncBytes += result.numBytes;
+			io.releaseBuffer(std::move(result.data));
+		});
+	}
+	float submitTime = stopWatch.getTimeMilliSeconds();
+	io.waitAll();
+	float asyncTime = stopWatch.getTimeMilliSeconds();
+
+	float mib = float(syncBytes) / (1024.0f * 1024.0f);
+	std::cout << numFiles << " files of " << fileSize << " bytes, " << io.numThreads() << " threads:"
+	          << "\nreadBinaryFile(): " << syncTime << "ms (" << (mib / syncTime * 1000.0f) << " MiB/s)"
+	          << "\nAsyncIO: " << asyncTime << "ms (" << (mib / asyncTime * 1000.0f)
+	          << " MiB/s), main thread blocked " << submitTime << "ms while submitting" << std::endl;
+	REQUIRE(syncBytes == asyncBytes);
+	deleteTestFiles(numFiles);
+}
+
+TEST_CASE("Many small files benchmark", "[.][benchmark][sfz::AsyncIO]")
+{
+	benchmark(2000, 8 * 1024);
+}
+
+TEST_CASE("Few large files benchmark", "[.][benchmark][sfz::AsyncIO]")
+{
+	benchmark(4, 64 * 1024 * 1024);
+}
\ No newline at end of file
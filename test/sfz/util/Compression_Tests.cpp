@@ -0,0 +1,301 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sfz/util/Compression.hpp"
+#include "sfz/util/IO.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using std::string;
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Somewhat realistic data, mix of text, repeated structures, runs and noise
+static vector<uint8_t> testData(size_t size, uint32_t seed)
+{
+	std::mt19937 rng{seed};
+	const char* words[] = {"vertex ", "normal ", "texcoord ", "material ", "0.5 ", "1.0 ", "-0.25 "};
+	vector<uint8_t> data;
+	data.reserve(size);
+	while (data.size() < size) {
+		switch (rng() % 4) {
+		case 0: {
+			const char* word = words[rng() % 7];
+			data.insert(data.end(), word, word + std::strlen(word));
+		} break;
+		case 1:
+			data.insert(data.end(), 1 + rng() % 40, uint8_t(rng()));
+			break;
+		case 2:
+			for (int i = 0; i < 8; i++) data.push_back(uint8_t(rng()));
+			break;
+		case 3: {
+			uint32_t value = rng() % 1024;
+			for (int i = 0; i < 4; i++) data.push_back(uint8_t(value >> (i * 8)));
+		} break;
+		}
+	}
+	data.resize(size);
+	return data;
+}
+
+static vector<uint8_t> randomData(size_t size, uint32_t seed)
+{
+	std::mt19937 rng{seed};
+	vector<uint8_t> data(size);
+	for (uint8_t& b : data) b = uint8_t(rng());
+	return data;
+}
+
+static void requireBlockRoundtrip(const vector<uint8_t>& data)
+{
+	vector<uint8_t> compressed(compressBound(data.size()));
+	size_t compressedSize = compressBlock(data.data(), data.size(), compressed.data(),
+	                                      compressed.size());
+	REQUIRE(compressedSize != 0);
+	vector<uint8_t> decompressed(data.size());
+	int64_t size = decompressBlock(compressed.data(), compressedSize, decompressed.data(),
+	                               decompressed.size());
+	REQUIRE(size == int64_t(data.size()));
+	REQUIRE(decompressed == data);
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Block compression", "[sfz::Compression]")
+{
+	// Small sizes around the end of block limits
+	for (size_t size = 0; size < 100; size++) {
+		requireBlockRoundtrip(testData(size, uint32_t(size)));
+		requireBlockRoundtrip(vector<uint8_t>(size, uint8_t(size)));
+	}
+
+	// Overlapping matches with short offsets
+	for (size_t period = 1; period <= 16; period++) {
+		vector<uint8_t> data(5000);
+		for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i % period);
+		requireBlockRoundtrip(data);
+	}
+
+	// Long literal and match lengths
+	vector<uint8_t> data = randomData(70000, 1);
+	data.insert(data.end(), 70000, 7);
+	data.insert(data.end(), data.begin(), data.begin() + 30000);
+	requireBlockRoundtrip(data);
+
+	// Compressible data compresses
+	vector<uint8_t> text = testData(100000, 2);
+	vector<uint8_t> compressed(compressBound(text.size()));
+	size_t compressedSize = compressBlock(text.data(), text.size(), compressed.data(),
+	                                      compressed.size());
+	REQUIRE(compressedSize < text.size() / 2);
+	REQUIRE(compressBlock(text.data(), text.size(), compressed.data(), 10) == 0);
+
+	// Too small destination
+	vector<uint8_t> small(text.size() - 1);
+	REQUIRE(decompressBlock(compressed.data(), compressedSize, small.data(), small.size()) < 0);
+}
+
+TEST_CASE("Corrupt blocks", "[sfz::Compression]")
+{
+	vector<uint8_t> data = testData(20000, 3);
+	vector<uint8_t> compressed(compressBound(data.size()));
+	compressed.resize(compressBlock(data.data(), data.size(), compressed.data(), compressed.size()));
+	vector<uint8_t> decompressed(data.size());
+
+	// Must never read or write out of bounds (checked by sanitizers)
+	std::mt19937 rng{4};
+	for (int i = 0; i < 2000; i++) {
+		vector<uint8_t> corrupt = compressed;
+		for (int j = 0; j < 4; j++) corrupt[rng() % corrupt.size()] = uint8_t(rng());
+		corrupt.resize(corrupt.size() - rng() % 16);
+		decompressBlock(corrupt.data(), corrupt.size(), decompressed.data(), decompressed.size());
+	}
+	REQUIRE(decompressBlock(nullptr, 0, decompressed.data(), decompressed.size()) < 0);
+	const uint8_t badOffset[] = {0x04, 'a', 'b', 'c', 'd', 0xFF, 0xFF, 0x00};
+	REQUIRE(decompressBlock(badOffset, sizeof(badOffset), decompressed.data(),
+	                        decompressed.size()) < 0);
+}
+
+TEST_CASE("Checksums", "[sfz::Compression]")
+{
+	// Reference xxHash32 values
+	REQUIRE(checksum32(nullptr, 0) == 0x02CC5D05u);
+	REQUIRE(checksum32((const uint8_t*)"abc", 3) == 0x32D153FFu);
+	const char* str = "Nobody inspects the spammish repetition";
+	REQUIRE(checksum32((const uint8_t*)str, std::strlen(str)) == 0xE2293B2Fu);
+	REQUIRE(checksum32((const uint8_t*)"abc", 3, 1) != checksum32((const uint8_t*)"abc", 3, 0));
+}
+
+TEST_CASE("Chunked streams", "[sfz::Compression]")
+{
+	vector<uint8_t> data = testData(1000000, 5);
+	data.insert(data.end(), 100000, 0);
+	vector<uint8_t> noise = randomData(100000, 6);
+	data.insert(data.end(), noise.begin(), noise.end());
+
+	vector<uint8_t> compressed = compress(data.data(), data.size(), 64 * 1024);
+	REQUIRE(compressed.size() < data.size() / 2);
+	REQUIRE(isCompressed(compressed.data(), compressed.size()));
+	REQUIRE(!isCompressed(data.data(), data.size()));
+	REQUIRE(decompressedSize(compressed.data(), compressed.size()) == int64_t(data.size()));
+
+	// Single and multithreaded
+	for (uint32_t numThreads : {1u, 4u, 0u}) {
+		vector<uint8_t> decompressed;
+		REQUIRE(decompress(compressed.data(), compressed.size(), decompressed, numThreads));
+		REQUIRE(decompressed == data);
+	}
+	vector<uint8_t> small(data.size() - 1);
+	REQUIRE(!decompress(compressed.data(), compressed.size(), small.data(), small.size()));
+	REQUIRE(!decompress(compressed.data(), compressed.size() - 1, small));
+	REQUIRE(small.empty());
+
+	// Checksum mismatch (corrupt data in last chunk, which is stored as is)
+	vector<uint8_t> corrupt = compressed;
+	corrupt[corrupt.size() - 10] ^= 1;
+	vector<uint8_t> decompressed;
+	REQUIRE(!decompress(corrupt.data(), corrupt.size(), decompressed, 2));
+
+	// Empty
+	vector<uint8_t> empty = compress(nullptr, 0);
+	REQUIRE(decompressedSize(empty.data(), empty.size()) == 0);
+	REQUIRE(decompress(empty.data(), empty.size(), decompressed));
+	REQUIRE(decompressed.empty());
+}
+
+TEST_CASE("Corrupt stream headers", "[sfz::Compression]")
+{
+	// Forged header claiming 2^45 bytes in 2^15 chunks of 2^30 bytes
+	auto forgedHeader = [](uint64_t uncompressedSize, uint32_t chunkSize, uint32_t numChunks) {
+		vector<uint8_t> header(24);
+		std::memcpy(header.data(), "SFZC", 4);
+		const uint32_t version = 1;
+		std::memcpy(header.data() + 4, &version, 4);
+		std::memcpy(header.data() + 8, &uncompressedSize, 8);
+		std::memcpy(header.data() + 16, &chunkSize, 4);
+		std::memcpy(header.data() + 20, &numChunks, 4);
+		return header;
+	};
+	vector<uint8_t> forged = forgedHeader(uint64_t(1) << 45, 1u << 30, 1u << 15);
+	vector<uint8_t> decompressed;
+	REQUIRE(!decompress(forged.data(), forged.size(), decompressed));
+	REQUIRE(decompressed.empty());
+	StreamDecompressor stream;
+	REQUIRE(stream.feed(forged.data(), forged.size())); // Waits for the chunk table
+	REQUIRE(!stream.isDone());
+
+	// Chunk table present but with stored sizes far too small for the claimed size
+	forged.resize(24 + 8 * (size_t(1) << 15), 0);
+	for (size_t i = 0; i < (size_t(1) << 15); i++) forged[24 + 8 * i] = 1;
+	forged.resize(forged.size() + (size_t(1) << 15), 0);
+	REQUIRE(!decompress(forged.data(), forged.size(), decompressed));
+	REQUIRE(!stream.feed(forged.data() + 24, forged.size() - 24));
+	REQUIRE(stream.hasError());
+
+	// Stored sizes pointing past the end of the data
+	vector<uint8_t> data = testData(10000, 3);
+	vector<uint8_t> compressed = compress(data.data(), data.size(), 4096);
+	compressed.resize(compressed.size() - 1);
+	REQUIRE(!decompress(compressed.data(), compressed.size(), decompressed));
+
+	// Inconsistent chunk count and sizes overflowing when rounded up
+	forged = forgedHeader(1000, 100, 11);
+	REQUIRE(!isCompressed(forged.data(), forged.size()));
+	forged = forgedHeader(UINT64_MAX, 1u << 30, 1);
+	REQUIRE(!isCompressed(forged.data(), forged.size()));
+	REQUIRE(decompressedSize(forged.data(), forged.size()) == -1);
+}
+
+TEST_CASE("Streaming decompression", "[sfz::Compression]")
+{
+	vector<uint8_t> data = testData(500000, 7);
+	vector<uint8_t> compressed = compress(data.data(), data.size(), 32 * 1024);
+
+	// Chunks are decompressed as soon as they are complete
+	StreamDecompressor stream;
+	size_t lastDecompressed = 0;
+	bool progressedEarly = false;
+	for (size_t offset = 0; offset < compressed.size(); offset += 1000) {
+		size_t size = std::min(size_t(1000), compressed.size() - offset);
+		REQUIRE(stream.feed(compressed.data() + offset, size));
+		REQUIRE(stream.numBytesDecompressed() >= lastDecompressed);
+		lastDecompressed = stream.numBytesDecompressed();
+		if (offset < compressed.size() / 2 && lastDecompressed != 0) progressedEarly = true;
+	}
+	REQUIRE(progressedEarly);
+	REQUIRE(stream.isDone());
+	REQUIRE(!stream.hasError());
+	REQUIRE(stream.takeOutput() == data);
+	REQUIRE(!stream.isDone());
+
+	// Reusable and detects corruption
+	vector<uint8_t> corrupt = compressed;
+	corrupt[corrupt.size() / 2] ^= 0x55;
+	REQUIRE(!stream.feed(corrupt.data(), corrupt.size()));
+	REQUIRE(stream.hasError());
+	REQUIRE(!stream.isDone());
+
+	StreamDecompressor notStream;
+	REQUIRE(!notStream.feed(data.data(), 100));
+}
+
+TEST_CASE("Compressed files", "[sfz::Compression]")
+{
+	const string path = basePath() + "feajfoeajofajoe_compressed.bin";
+	vector<uint8_t> data = testData(300000, 8);
+	REQUIRE(writeCompressedFile(path.c_str(), data.data(), data.size()));
+	REQUIRE(sizeofFile(path.c_str()) < int64_t(data.size()));
+	REQUIRE(readCompressedFile(path.c_str()) == data);
+	REQUIRE(readCompressedFile(path.c_str(), 2) == data);
+
+	// Uncompressed files are returned as is
+	REQUIRE(writeBinaryFile(path.c_str(), data.data(), data.size()));
+	REQUIRE(readCompressedFile(path.c_str()) == data);
+
+	REQUIRE(deleteFile(path.c_str()));
+	REQUIRE(readCompressedFile(path.c_str()).empty());
+}
+
+// Benchmarks (hidden, run with "[benchmark]")
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Compression benchmark", "[.][benchmark][sfz::Compression]")
+{
+	const size_t SIZE = 64 * 1024 * 1024;
+	vector<uint8_t> data = testData(SIZE, 9);
+	vector<uint8_t> decompressed(SIZE), copy(SIZE);
+	const float mib = float(SIZE) / (1024.0f * 1024.0f);
+
+	StopWatch stopWatch;
+	std::memcpy(copy.data(), data.data(), SIZE);
+	float memcpyTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	vector<uint8_t> compressed = compress(data.data(), data.size());
+	float compressTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	REQUIRE(decompress(compressed.data(), compressed.size(), decompressed.data(), SIZE, 1));
+	float decompressTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	REQUIRE(decompress(compressed.data(), compressed.size(), decompressed.data(), SIZE, 0));
+	float parallelTime = stopWatch.getTimeMilliSeconds();
+
+	std::cout << "64 MiB, ratio " << (float(compressed.size()) / float(SIZE)) << ":"
+	          << "\nmemcpy(): " << (mib / memcpyTime * 1000.0f) << " MiB/s"
+	          << "\ncompress(): " << (mib / compressTime * 1000.0f) << " MiB/s"
+	          << "\ndecompress(): " << (mib / decompressTime * 1000.0f) << " MiB/s"
+	          << "\ndecompress() all threads: " << (mib / parallelTime * 1000.0f) << " MiB/s"
+	          << std::endl;
+	REQUIRE(decompressed == data);
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sfz/util/FileWatcher.hpp"
+#include "sfz/util/IO.hpp"
+
+using std::string;
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static void writeText(const string& path, const string& text)
+{
+	REQUIRE(writeBinaryFile(path.c_str(), (const uint8_t*)text.data(), text.size()));
+}
+
+static void sleepMs(int ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Dispatches until a callback is called or the timeout is reached, returns number of callbacks
+static size_t dispatchFor(FileWatcher& watcher, int timeoutMs, bool stopOnCallback = true)
+{
+	size_t numCalled = 0;
+	for (int ms = 0; ms < timeoutMs; ms += 5) {
+		numCalled += watcher.dispatch();
+		if (stopOnCallback && numCalled != 0) break;
+		sleepMs(5);
+	}
+	return numCalled;
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Watching files", "[sfz::FileWatcher]")
+{
+	const string path = basePath() + "feajfoeajofajoe_watched.txt";
+	for (bool forcePolling : {false, true}) {
+		writeText(path, "a");
+		FileWatcher watcher(30, 20, forcePolling);
+#ifdef __linux__
+		REQUIRE(watcher.usesInotify() == !forcePolling);
+#endif
+
+		vector<string> changed;
+		size_t numCalls = 0;
+		uint64_t id = watcher.watch(path.c_str(), [&](const vector<string>& paths) {
+			changed = paths;
+			numCalls++;
+		});
+		REQUIRE(id != FileWatcher::INVALID_ID);
+		REQUIRE(watcher.numWatchedFiles() == 1);
+		REQUIRE(dispatchFor(watcher, 100, false) == 0);
+
+		// Modified
+		writeText(path, "bb");
+		REQUIRE(dispatchFor(watcher, 2000) == 1);
+		REQUIRE(changed == vector<string>{path});
+
+		// Burst of writes is reported once
+		for (int i = 0; i < 5; i++) {
+			writeText(path, string(size_t(3 + i), 'c'));
+			sleepMs(5);
+		}
+		numCalls = 0;
+		dispatchFor(watcher, 300, false);
+		REQUIRE(numCalls == 1);
+
+		// Opening for writing without changing anything is ignored
+		FILE* file = std::fopen(path.c_str(), "ab");
+		REQUIRE(file != nullptr);
+		std::fclose(file);
+		REQUIRE(dispatchFor(watcher, 200) == 0);
+
+		// Replaced by rename, as done by many editors
+		const string tmpPath = path + ".tmp";
+		writeText(tmpPath, "replaced");
+		REQUIRE(std::rename(tmpPath.c_str(), path.c_str()) == 0);
+		REQUIRE(dispatchFor(watcher, 2000) == 1);
+
+		// Deleted and recreated
+		REQUIRE(deleteFile(path.c_str()));
+		REQUIRE(dispatchFor(watcher, 2000) == 1);
+		writeText(path, "recreated");
+		REQUIRE(dispatchFor(watcher, 2000) == 1);
+
+		// Unwatched
+		REQUIRE(watcher.unwatch(id));
+		REQUIRE(!watcher.unwatch(id));
+		REQUIRE(watcher.numWatchedFiles() == 0);
+		writeText(path, "unwatched");
+		REQUIRE(dispatchFor(watcher, 200) == 0);
+	}
+	REQUIRE(deleteFile(path.c_str()));
+}
+
+TEST_CASE("Watching groups of files", "[sfz::FileWatcher]")
+{
+	const string path1 = basePath() + "feajfoeajofajoe_watched1.txt";
+	const string path2 = basePath() + "feajfoeajofajoe_watched2.txt";
+	writeText(path1, "1");
+	writeText(path2, "2");
+	FileWatcher watcher(30, 20);
+
+	// Both files changing results in a single callback
+	vector<string> changed;
+	uint64_t groupId = watcher.watch({path2, path1, path1}, [&](const vector<string>& paths) {
+		changed = paths;
+	});
+	size_t numSingleCalls = 0;
+	uint64_t singleId = watcher.watch(path1.c_str(), [&](const vector<string>&) {
+		numSingleCalls++;
+	});
+	REQUIRE(watcher.numWatchedFiles() == 2);
+	writeText(path1, "11");
+	writeText(path2, "22");
+	REQUIRE(dispatchFor(watcher, 2000) == 2);
+	REQUIRE(changed == (vector<string>{path1, path2}));
+	REQUIRE(numSingleCalls == 1);
+
+	// Callbacks may unwatch later watches
+	watcher.unwatch(groupId);
+	watcher.unwatch(singleId);
+	groupId = watcher.watch({path1}, [&](const vector<string>&) { watcher.unwatch(singleId); });
+	singleId = watcher.watch(path1.c_str(), [&](const vector<string>&) { numSingleCalls++; });
+	writeText(path1, "111");
+	REQUIRE(dispatchFor(watcher, 2000) == 1);
+	REQUIRE(numSingleCalls == 1);
+	REQUIRE(watcher.numWatchedFiles() == 1);
+
+	REQUIRE(deleteFile(path1.c_str()));
+	REQUIRE(deleteFile(path2.c_str()));
+}
+
+TEST_CASE("Watching files in missing directories", "[sfz::FileWatcher]")
+{
+	const string dir = basePath() + "feajfoeajofajoe_watched_dir";
+	const string path = dir + "/file.txt";
+	deleteDirectoryRecursive(dir.c_str());
+	FileWatcher watcher(30, 20);
+
+	size_t numCalls = 0;
+	watcher.watch(path.c_str(), [&](const vector<string>&) { numCalls++; });
+	REQUIRE(watcher.numPolledFiles() == 1);
+	REQUIRE(createDirectory(dir.c_str()));
+	writeText(path, "created");
+	REQUIRE(dispatchFor(watcher, 2000) == 1);
+	if (watcher.usesInotify()) REQUIRE(watcher.numPolledFiles() == 0);
+
+	// Directory deleted while watched
+	REQUIRE(deleteDirectoryRecursive(dir.c_str()));
+	REQUIRE(dispatchFor(watcher, 2000) == 1);
+	REQUIRE(createDirectory(dir.c_str()));
+	writeText(path, "recreated");
+	REQUIRE(dispatchFor(watcher, 2000) == 1);
+	REQUIRE(numCalls == 3);
+
+	// Watched with inotify again once the directory exists
+	if (watcher.usesInotify()) {
+		REQUIRE(watcher.numPolledFiles() == 0);
+		writeText(path, "modified");
+		REQUIRE(dispatchFor(watcher, 2000) == 1);
+		REQUIRE(numCalls == 4);
+	}
+	REQUIRE(deleteDirectoryRecursive(dir.c_str()));
+}
\ No newline at end of file
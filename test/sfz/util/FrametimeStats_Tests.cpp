@@ -0,0 +1,150 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+#include "sfz/util/FrametimeStats.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+using std::vector;
+
+TEST_CASE("Basic statistics", "[sfz::FrametimeStats]")
+{
+	FrametimeStats stats{4};
+	REQUIRE(stats.maxNumSamples() == 4);
+	REQUIRE(stats.currentNumSamples() == 0);
+	REQUIRE(stats.percentile(0.5f) == -1.0f);
+
+	stats.addSample(0.010f);
+	REQUIRE(stats.currentNumSamples() == 1);
+	REQUIRE(stats.min() == 0.010f);
+	REQUIRE(stats.max() == 0.010f);
+	REQUIRE(stats.avg() == Approx(0.010f));
+	REQUIRE(stats.sd() == 0.0f);
+
+	stats.addSample(0.020f);
+	stats.addSample(0.030f);
+	stats.addSample(0.040f);
+	REQUIRE(stats.currentNumSamples() == 4);
+	REQUIRE(stats.min() == 0.010f);
+	REQUIRE(stats.max() == 0.040f);
+	REQUIRE(stats.avg() == Approx(0.025f));
+	REQUIRE(stats.sd() == Approx(std::sqrt(0.000125f)));
+	const char* expected = "Avg: 25.0ms, SD: 11.2ms, Min: 10.0ms, Max: 40.0ms";
+	REQUIRE(std::strcmp(stats.to_string(), expected) == 0);
+
+	// Oldest samples are replaced when full
+	stats.addSample(0.005f);
+	stats.addSample(0.005f);
+	REQUIRE(stats.currentNumSamples() == 4);
+	REQUIRE(stats.min() == 0.005f);
+	REQUIRE(stats.max() == 0.040f);
+	REQUIRE(stats.avg() == Approx(0.020f));
+	stats.addSample(0.005f);
+	stats.addSample(0.005f);
+	REQUIRE(stats.max() == 0.005f);
+	REQUIRE(stats.avg() == Approx(0.005f));
+	REQUIRE(stats.sd() == Approx(0.0f));
+	expected = "Avg: 5.0ms, SD: 0.0ms, Min: 5.0ms, Max: 5.0ms";
+	REQUIRE(std::strcmp(stats.to_string(), expected) == 0);
+
+	stats.reset();
+	REQUIRE(stats.currentNumSamples() == 0);
+	REQUIRE(stats.avg() == -1.0f);
+	stats.addSample(0.1f);
+	REQUIRE(stats.min() == 0.1f);
+	REQUIRE(stats.max() == 0.1f);
+	REQUIRE(stats.avg() == Approx(0.1f));
+}
+
+TEST_CASE("Percentiles", "[sfz::FrametimeStats]")
+{
+	FrametimeStats stats{1000};
+	for (int i = 1; i <= 1000; i++) {
+		stats.addSample(float(i) * 0.00002f); // 0.02ms to 20ms
+	}
+	const float bucket = FrametimeStats::HISTOGRAM_BUCKET_SIZE_US / 1000000.0f;
+	REQUIRE(std::abs(stats.p50() - 0.010f) <= bucket);
+	REQUIRE(std::abs(stats.p90() - 0.018f) <= bucket);
+	REQUIRE(std::abs(stats.p99() - 0.0198f) <= bucket);
+	REQUIRE(std::abs(stats.p999() - 0.01998f) <= bucket);
+	REQUIRE(stats.percentile(1.0f) <= stats.max());
+	REQUIRE(stats.percentile(0.0001f) >= stats.min());
+
+	// Samples above the histogram range are reported as max
+	stats.reset();
+	for (int i = 0; i < 98; i++) stats.addSample(0.016f);
+	stats.addSample(0.5f);
+	stats.addSample(2.0f);
+	REQUIRE(std::abs(stats.p90() - 0.016f) <= bucket);
+	REQUIRE(stats.p99() == 2.0f);
+	REQUIRE(stats.p999() == 2.0f);
+}
+
+TEST_CASE("Matches brute force over sliding window", "[sfz::FrametimeStats]")
+{
+	const size_t WINDOW = 37;
+	FrametimeStats stats{WINDOW};
+	std::deque<float> window;
+	std::srand(1);
+	for (int i = 0; i < 2000; i++) {
+		// Occasional spikes and runs of equal samples
+		float sample = 0.016f + float(std::rand() % 1000) * 0.000001f;
+		if (std::rand() % 50 == 0) sample = 0.1f;
+		if ((i / 100) % 3 == 1) sample = 0.008f;
+
+		stats.addSample(sample);
+		window.push_back(sample);
+		if (window.size() > WINDOW) window.pop_front();
+
+		double sum = 0.0;
+		for (float s : window) sum += s;
+		const double avg = sum / double(window.size());
+		double varianceSum = 0.0;
+		for (float s : window) varianceSum += (s - avg) * (s - avg);
+
+		REQUIRE(stats.currentNumSamples() == window.size());
+		REQUIRE(stats.min() == *std::min_element(window.begin(), window.end()));
+		REQUIRE(stats.max() == *std::max_element(window.begin(), window.end()));
+		REQUIRE(std::abs(stats.avg() - avg) < 1e-6);
+		REQUIRE(std::abs(stats.sd() - std::sqrt(varianceSum / double(window.size()))) < 1e-5);
+
+		vector<float> sorted(window.begin(), window.end());
+		std::sort(sorted.begin(), sorted.end());
+		const float median = sorted[(sorted.size() + 1) / 2 - 1];
+		REQUIRE(std::abs(stats.p50() - median) <= 0.0001f);
+	}
+}
+
+TEST_CASE("FrametimeStats performance", "[.][benchmark][sfz::FrametimeStats]")
+{
+	const int NUM_SAMPLES = 1000000;
+	for (size_t maxNumSamples : {60, 1000, 100000}) {
+		FrametimeStats stats{maxNumSamples};
+		StopWatch watch;
+		float dummy = 0.0f;
+		for (int i = 0; i < NUM_SAMPLES; i++) {
+			stats.addSample(0.016f + float(i % 17) * 0.0001f);
+			dummy += stats.avg() + stats.sd() + stats.max();
+		}
+		watch.stop();
+		std::cout << "addSample() with " << maxNumSamples << " samples: "
+		          << (watch.getTimeNanoSeconds() / NUM_SAMPLES) << " ns (" << dummy << ")\n";
+
+		watch.start();
+		for (int i = 0; i < NUM_SAMPLES; i++) {
+			stats.addSample(0.016f + float(i % 17) * 0.0001f);
+			dummy += stats.p99();
+		}
+		watch.stop();
+		std::cout << "addSample() + p99() with " << maxNumSamples << " samples: "
+		          << (watch.getTimeNanoSeconds() / NUM_SAMPLES) << " ns (" << dummy << ")\n";
+	}
+}
\ No newline at end of file
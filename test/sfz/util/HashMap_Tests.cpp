@@ -0,0 +1,249 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sfz/util/HashMap.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+using std::int32_t;
+using std::int64_t;
+using std::string;
+
+// Hashes every key to the same value, to test collisions
+struct BadHash final {
+	size_t operator() (int32_t) const noexcept { return 0; }
+};
+
+struct MoveOnly final {
+	int value = 0;
+	MoveOnly() noexcept = default;
+	MoveOnly(int value) noexcept : value(value) { }
+	MoveOnly(const MoveOnly&) = delete;
+	MoveOnly& operator= (const MoveOnly&) = delete;
+	MoveOnly(MoveOnly&& o) noexcept : value(o.value) { o.value = -1; }
+	MoveOnly& operator= (MoveOnly&& o) noexcept { value = o.value; o.value = -1; return *this; }
+};
+
+TEST_CASE("HashMap basics", "[sfz::HashMap]")
+{
+	HashMap<int32_t, int32_t> map;
+	REQUIRE(map.size() == 0);
+	REQUIRE(map.capacity() == 0);
+	REQUIRE(map.get(0) == nullptr);
+	REQUIRE(map.find(0) == map.end());
+	REQUIRE(map.begin() == map.end());
+
+	SECTION("Inserting, finding and replacing") {
+		map.put(1, 10);
+		map[2] = 20;
+		REQUIRE(map.size() == 2);
+		REQUIRE(map.capacity() == (HashMap<int32_t, int32_t>::MIN_CAPACITY));
+		REQUIRE(*map.get(1) == 10);
+		REQUIRE(map[2] == 20);
+		REQUIRE(map.find(2)->second == 20);
+		REQUIRE(map.contains(1));
+		REQUIRE(!map.contains(3));
+
+		map.put(1, 11);
+		map[2]++;
+		REQUIRE(map.size() == 2);
+		REQUIRE(*map.get(1) == 11);
+		REQUIRE(*map.get(2) == 21);
+
+		REQUIRE(map[3] == 0);
+		REQUIRE(map.size() == 3);
+	}
+	SECTION("Erasing") {
+		for (int32_t i = 0; i < 10; i++) map.put(i, i * i);
+		REQUIRE(map.erase(5) == 1);
+		REQUIRE(map.erase(5) == 0);
+		REQUIRE(map.erase(100) == 0);
+		REQUIRE(map.size() == 9);
+		REQUIRE(map.get(5) == nullptr);
+		for (int32_t i = 0; i < 10; i++) {
+			if (i != 5) REQUIRE(*map.get(i) == i * i);
+		}
+	}
+	SECTION("Iterating") {
+		for (int32_t i = 0; i < 100; i++) map.put(i, i);
+		int32_t sum = 0;
+		size_t count = 0;
+		for (auto& pair : map) {
+			REQUIRE(pair.first == pair.second);
+			sum += pair.second;
+			count++;
+		}
+		REQUIRE(count == 100);
+		REQUIRE(sum == 4950);
+
+		const HashMap<int32_t, int32_t>& constMap = map;
+		count = 0;
+		for (auto itr = constMap.begin(); itr != constMap.end(); ++itr) count++;
+		REQUIRE(count == 100);
+	}
+	SECTION("Clearing keeps capacity") {
+		for (int32_t i = 0; i < 1000; i++) map.put(i, i);
+		const size_t capacity = map.capacity();
+		REQUIRE(capacity >= 1000);
+		map.clear();
+		REQUIRE(map.size() == 0);
+		REQUIRE(map.capacity() == capacity);
+		REQUIRE(map.get(10) == nullptr);
+		for (int32_t i = 0; i < 1000; i++) map.put(i, i);
+		REQUIRE(map.capacity() == capacity);
+	}
+	SECTION("Reserve") {
+		map.reserve(100);
+		const size_t capacity = map.capacity();
+		REQUIRE(capacity >= 100);
+		for (int32_t i = 0; i < 100; i++) map.put(i, i);
+		REQUIRE(map.capacity() == capacity);
+	}
+}
+
+TEST_CASE("HashMap collisions and tombstones", "[sfz::HashMap]")
+{
+	SECTION("All keys with the same hash") {
+		HashMap<int32_t, int32_t, BadHash> map;
+		for (int32_t i = 0; i < 100; i++) map.put(i, i);
+		REQUIRE(map.size() == 100);
+		for (int32_t i = 0; i < 100; i++) REQUIRE(*map.get(i) == i);
+		for (int32_t i = 0; i < 100; i += 2) REQUIRE(map.erase(i) == 1);
+		for (int32_t i = 0; i < 100; i++) {
+			if (i % 2 == 0) REQUIRE(map.get(i) == nullptr);
+			else REQUIRE(*map.get(i) == i);
+		}
+	}
+	SECTION("Repeated insert and erase does not grow") {
+		HashMap<int32_t, int32_t> map;
+		for (int32_t i = 0; i < 10; i++) map.put(i, i);
+		const size_t capacity = map.capacity();
+		for (int32_t i = 10; i < 100000; i++) {
+			map.put(i, i);
+			REQUIRE(map.erase(i - 10) == 1);
+		}
+		REQUIRE(map.size() == 10);
+		REQUIRE(map.capacity() == capacity);
+		for (int32_t i = 99990; i < 100000; i++) REQUIRE(*map.get(i) == i);
+	}
+	SECTION("Randomized against std::unordered_map") {
+		HashMap<int32_t, int32_t> map;
+		std::unordered_map<int32_t, int32_t> reference;
+		std::mt19937 rng(1337);
+		std::uniform_int_distribution<int32_t> keyDist(0, 2000);
+		for (int i = 0; i < 50000; i++) {
+			int32_t key = keyDist(rng);
+			if (rng() % 3 == 0) {
+				REQUIRE(map.erase(key) == reference.erase(key));
+			} else {
+				map.put(key, i);
+				reference[key] = i;
+			}
+		}
+		REQUIRE(map.size() == reference.size());
+		for (auto& pair : reference) REQUIRE(*map.get(pair.first) == pair.second);
+		size_t count = 0;
+		for (auto& pair : map) {
+			REQUIRE(reference.at(pair.first) == pair.second);
+			count++;
+		}
+		REQUIRE(count == reference.size());
+	}
+}
+
+TEST_CASE("HashMap with non-trivial types", "[sfz::HashMap]")
+{
+	SECTION("String keys") {
+		HashMap<string, string> map;
+		for (int i = 0; i < 200; i++) map.put(std::to_string(i), "value" + std::to_string(i));
+		REQUIRE(*map.get("42") == "value42");
+		REQUIRE(map.get("200") == nullptr);
+
+		HashMap<string, string> copy(map);
+		REQUIRE(copy.size() == 200);
+		REQUIRE(*copy.get("199") == "value199");
+		map.clear();
+		REQUIRE(*copy.get("0") == "value0");
+
+		HashMap<string, string> moved(std::move(copy));
+		REQUIRE(copy.size() == 0);
+		REQUIRE(copy.get("0") == nullptr);
+		REQUIRE(moved.size() == 200);
+		copy = moved;
+		REQUIRE(copy.size() == 200);
+		REQUIRE(*copy.get("100") == "value100");
+	}
+	SECTION("Move only values") {
+		HashMap<int32_t, MoveOnly> map;
+		for (int32_t i = 0; i < 100; i++) map.put(i, MoveOnly(i));
+		map[200] = MoveOnly(200);
+		for (int32_t i = 0; i < 100; i++) REQUIRE(map.get(i)->value == i);
+		REQUIRE(map.get(200)->value == 200);
+	}
+}
+
+TEST_CASE("HashMap performance", "[.][benchmark][sfz::HashMap]")
+{
+	const int NUM_ITERATIONS = 1000;
+	volatile int64_t dummy = 0;
+
+	std::vector<int32_t> keys;
+	std::mt19937 rng(42);
+	for (int i = 0; i < 1000; i++) keys.push_back(int32_t(rng()));
+
+	// Fill and clear every iteration, same as the controller maps in the game loop
+	StopWatch watch;
+	std::unordered_map<int32_t, int32_t> stdMap;
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		stdMap.clear();
+		for (int32_t key : keys) stdMap[key] = key;
+		for (int32_t key : keys) dummy = dummy + stdMap.find(key)->second;
+	}
+	watch.stop();
+	std::cout << "std::unordered_map 1000 inserts + 1000 lookups: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	watch.start();
+	HashMap<int32_t, int32_t> map;
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		map.clear();
+		for (int32_t key : keys) map[key] = key;
+		for (int32_t key : keys) dummy = dummy + *map.get(key);
+	}
+	watch.stop();
+	std::cout << "HashMap 1000 inserts + 1000 lookups: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	// String lookups, like TexturePacker regions
+	std::vector<string> names;
+	for (int i = 0; i < 100; i++) names.push_back("textures/sprite_" + std::to_string(i) + ".png");
+	std::unordered_map<string, int> stdStringMap;
+	HashMap<string, int> stringMap;
+	for (int i = 0; i < 100; i++) {
+		stdStringMap[names[i]] = i;
+		stringMap.put(names[i], i);
+	}
+
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		for (const string& name : names) dummy = dummy + stdStringMap.find(name)->second;
+	}
+	watch.stop();
+	std::cout << "std::unordered_map<string> lookup: "
+	          << (watch.getTimeNanoSeconds() / (NUM_ITERATIONS * 100)) << " ns\n";
+
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		for (const string& name : names) dummy = dummy + *stringMap.get(name);
+	}
+	watch.stop();
+	std::cout << "HashMap<string> lookup: "
+	          << (watch.getTimeNanoSeconds() / (NUM_ITERATIONS * 100)) << " ns\n";
+}
\ No newline at end of file
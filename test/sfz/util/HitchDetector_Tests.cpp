@@ -0,0 +1,163 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "sfz/util/HitchDetector.hpp"
+#include "sfz/util/IO.hpp"
+
+using std::string;
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static FrameTimings frame(float events, float update, float render, float swap)
+{
+	FrameTimings timings;
+	timings.phaseTime(FramePhase::EVENTS) = events;
+	timings.phaseTime(FramePhase::UPDATE) = update;
+	timings.phaseTime(FramePhase::RENDER) = render;
+	timings.phaseTime(FramePhase::SWAP) = swap;
+	timings.frameTime = events + update + render + swap;
+	return timings;
+}
+
+static size_t countOccurrences(const string& str, const string& pattern)
+{
+	size_t count = 0;
+	for (size_t pos = str.find(pattern); pos != string::npos; pos = str.find(pattern, pos + 1)) {
+		count++;
+	}
+	return count;
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Detecting hitches above budget", "[sfz::HitchDetector]")
+{
+	HitchDetector detector{0.020f, 0.0f, 100, 2};
+	REQUIRE(detector.threshold() == 0.020f);
+
+	for (int i = 0; i < 10; i++) {
+		REQUIRE(!detector.addFrame(frame(0.001f, 0.004f, 0.005f, 0.006f)));
+	}
+	REQUIRE(detector.addFrame(frame(0.001f, 0.030f, 0.005f, 0.006f)));
+	REQUIRE(detector.numHitches() == 1);
+
+	// Hitch is completed once the frames after it have been captured
+	REQUIRE(detector.hitches().empty());
+	REQUIRE(!detector.addFrame(frame(0.001f, 0.004f, 0.005f, 0.007f)));
+	REQUIRE(detector.hitches().empty());
+	REQUIRE(!detector.addFrame(frame(0.001f, 0.004f, 0.005f, 0.008f)));
+	REQUIRE(detector.hitches().size() == 1);
+
+	const Hitch& hitch = detector.hitches()[0];
+	REQUIRE(hitch.frame.frameIndex == 10);
+	REQUIRE(hitch.frame.phaseTime(FramePhase::UPDATE) == 0.030f);
+	REQUIRE(hitch.threshold == 0.020f);
+	REQUIRE(hitch.framesBefore.size() == 2);
+	REQUIRE(hitch.framesBefore[0].frameIndex == 8);
+	REQUIRE(hitch.framesBefore[1].frameIndex == 9);
+	REQUIRE(hitch.framesAfter.size() == 2);
+	REQUIRE(hitch.framesAfter[0].phaseTime(FramePhase::SWAP) == 0.007f);
+	REQUIRE(hitch.framesAfter[1].phaseTime(FramePhase::SWAP) == 0.008f);
+	REQUIRE(hitch.framesAfter[1].timestamp >= hitch.frame.timestamp);
+
+	REQUIRE(detector.numFrames() == 13);
+	REQUIRE(detector.stats().currentNumSamples() == 13);
+	REQUIRE(detector.stats().max() == Approx(0.042f));
+}
+
+TEST_CASE("Detecting hitches above percentile", "[sfz::HitchDetector]")
+{
+	HitchDetector detector{0.0f, 0.99f, 100, 0};
+	REQUIRE(detector.threshold() == 0.0f);
+
+	// Percentile is only used once the statistics window is full
+	REQUIRE(!detector.addFrame(frame(0.0f, 0.0f, 0.050f, 0.0f)));
+	for (int i = 0; i < 99; i++) {
+		REQUIRE(!detector.addFrame(frame(0.001f, 0.002f, 0.003f, 0.004f + 0.0001f * (i % 10))));
+	}
+	REQUIRE(detector.threshold() > 0.010f);
+	REQUIRE(detector.threshold() < 0.0112f);
+	REQUIRE(!detector.addFrame(frame(0.001f, 0.002f, 0.003f, 0.004f)));
+	REQUIRE(detector.addFrame(frame(0.001f, 0.002f, 0.003f, 0.008f)));
+	REQUIRE(detector.hitches().size() == 1);
+	REQUIRE(detector.hitches()[0].framesBefore.empty());
+}
+
+TEST_CASE("Writing telemetry", "[sfz::HitchDetector]")
+{
+	for (TelemetryFormat format : {TelemetryFormat::CSV, TelemetryFormat::JSON}) {
+		const string path = basePath() + "feajfoeajofajoe_telemetry.txt";
+		const bool csv = format == TelemetryFormat::CSV;
+		const string hitchPattern = csv ? ",hitch," : "{\"type\":\"hitch\"";
+		const string summaryPattern = csv ? ",summary," : "{\"type\":\"summary\"";
+		deleteFile(path.c_str());
+
+		HitchDetector detector{0.020f, 0.0f, 100, 1};
+		REQUIRE(detector.startTelemetry(path.c_str(), format, 10));
+		REQUIRE(detector.isTelemetryActive());
+		for (int i = 0; i < 20; i++) {
+			detector.addFrame(frame(0.001f, i == 10 ? 0.1f : 0.004f, 0.005f, 0.006f));
+			if (i < 10) std::this_thread::sleep_for(std::chrono::milliseconds(3));
+		}
+
+		// Flushed by the background thread without stopping
+		string text;
+		for (int i = 0; i < 200 && countOccurrences(text, hitchPattern) == 0; i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			text = readTextFile(path.c_str());
+		}
+		REQUIRE(countOccurrences(text, hitchPattern) == 1);
+		REQUIRE(countOccurrences(text, summaryPattern) != 0);
+
+		// Incomplete hitches are written when stopped
+		detector.addFrame(frame(0.001f, 0.004f, 0.005f, 0.5f));
+		detector.stopTelemetry();
+		REQUIRE(!detector.isTelemetryActive());
+		text = readTextFile(path.c_str());
+
+		REQUIRE(countOccurrences(text, hitchPattern) == 2);
+		if (csv) {
+			REQUIRE(text.find("time_s,kind,frame,hitch_frame,frame_ms,events_ms") == 0);
+			REQUIRE(countOccurrences(text, "time_s") == 1);
+			REQUIRE(countOccurrences(text, ",before,") == 2);
+			REQUIRE(countOccurrences(text, ",after,") == 1);
+			REQUIRE(text.find(",hitch,10,10,112.000,1.000,100.000,5.000,6.000,20.000,,,,,,\n")
+			        != string::npos);
+			REQUIRE(text.find(",before,9,10,") != string::npos);
+
+			// All rows have the same number of columns
+			size_t lineStart = 0;
+			while (lineStart < text.size()) {
+				size_t lineEnd = text.find('\n', lineStart);
+				REQUIRE(lineEnd != string::npos);
+				const string line = text.substr(lineStart, lineEnd - lineStart);
+				REQUIRE(countOccurrences(line, ",") == 15);
+				lineStart = lineEnd + 1;
+			}
+		}
+		else {
+			REQUIRE(text.find("\"thresholdMs\":20.000,\"frame\":{\"time\":") != string::npos);
+			REQUIRE(text.find("\"phasesMs\":{\"events\":1.000,\"update\":100.000,\"render\":5.000,"
+			                  "\"swap\":6.000}}") != string::npos);
+			REQUIRE(text.find("\"after\":[]") != string::npos);
+			REQUIRE(countOccurrences(text, "\n") == countOccurrences(text, "{\"type\":"));
+		}
+
+		// Appended to existing file, header is only written once
+		REQUIRE(detector.startTelemetry(path.c_str(), format, 1000));
+		detector.addFrame(frame(0.001f, 0.004f, 0.005f, 0.5f));
+		detector.stopTelemetry();
+		const string appended = readTextFile(path.c_str());
+		REQUIRE(appended.find(text) == 0);
+		REQUIRE(countOccurrences(appended, hitchPattern) == 3);
+		REQUIRE(countOccurrences(appended, "time_s") == (csv ? 1 : 0));
+		REQUIRE(deleteFile(path.c_str()));
+	}
+}
\ No newline at end of file
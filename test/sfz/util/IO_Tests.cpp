@@ -1,9 +1,17 @@
 #define CATCH_CONFIG_MAIN
 #include <catch.hpp>
 
+#include <cstdio>
+#include <iostream>
 #include <string>
+#include <vector>
 
 #include "sfz/util/IO.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+#ifndef _WIN32
+#include <unistd.h> // symlink(), readlink()
+#endif
 
 using std::string;
 
@@ -101,4 +109,131 @@ TEST_CASE("readTextFile()", "[sfz::IO]")
 	}
 
 	REQUIRE(sfz::deleteFile(fpath));
+}
+
+TEST_CASE("copyFile() & sizeofFile()", "[sfz::IO]")
+{
+	const string srcPath = sfz::basePath() + stupidFileName();
+	const string dstPath = srcPath + ".copy";
+
+	std::vector<uint8_t> data(3 * 1024 * 1024 + 17);
+	for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i * 13 + (i >> 12));
+	REQUIRE(sfz::writeBinaryFile(srcPath.c_str(), data.data(), data.size()));
+	REQUIRE(sfz::sizeofFile(srcPath.c_str()) == int64_t(data.size()));
+
+	sfz::FileOpResult result;
+	REQUIRE(sfz::copyFile(srcPath.c_str(), dstPath.c_str(), result));
+	REQUIRE(result.numBytes == data.size());
+	REQUIRE(result.numFiles == 1);
+	REQUIRE(result.errorCode == 0);
+	REQUIRE(sfz::readBinaryFile(dstPath.c_str()) == data);
+
+	// Overwrites existing (larger) destination
+	REQUIRE(sfz::writeBinaryFile(srcPath.c_str(), data.data(), 100));
+	REQUIRE(sfz::copyFile(srcPath.c_str(), dstPath.c_str()));
+	REQUIRE(sfz::sizeofFile(dstPath.c_str()) == 100);
+
+	// Errors
+	REQUIRE(sfz::deleteFile(srcPath.c_str()));
+	sfz::FileOpResult failed;
+	REQUIRE(!sfz::copyFile(srcPath.c_str(), dstPath.c_str(), failed));
+	REQUIRE(failed.errorCode != 0);
+	REQUIRE(failed.errorPath == srcPath);
+	REQUIRE(failed.numFiles == 0);
+	REQUIRE(sfz::sizeofFile(srcPath.c_str()) < 0);
+
+	REQUIRE(sfz::deleteFile(dstPath.c_str()));
+}
+
+TEST_CASE("copyDirectory() & deleteDirectoryRecursive()", "[sfz::IO]")
+{
+	const string srcPath = sfz::basePath() + stupidFileName() + "_src";
+	const string dstPath = sfz::basePath() + stupidFileName() + "_dst";
+	const uint8_t data[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+
+	REQUIRE(sfz::createDirectory(srcPath.c_str()));
+	REQUIRE(sfz::createDirectory((srcPath + "/sub").c_str()));
+	REQUIRE(sfz::createDirectory((srcPath + "/sub/empty").c_str()));
+	REQUIRE(sfz::writeBinaryFile((srcPath + "/a.bin").c_str(), data, 8));
+	REQUIRE(sfz::writeBinaryFile((srcPath + "/sub/b.bin").c_str(), data, 4));
+#ifndef _WIN32
+	// Symbolic links are copied as links, not followed
+	REQUIRE(symlink("sub", (srcPath + "/dirLink").c_str()) == 0);
+	REQUIRE(symlink("../a.bin", (srcPath + "/sub/fileLink").c_str()) == 0);
+	const uint32_t numLinks = 2;
+#else
+	const uint32_t numLinks = 0;
+#endif
+
+	// Directories are not files and have no size
+	REQUIRE(!sfz::fileExists(srcPath.c_str()));
+	REQUIRE(sfz::directoryExists(srcPath.c_str()));
+	REQUIRE(!sfz::directoryExists((srcPath + "/a.bin").c_str()));
+	REQUIRE(sfz::sizeofFile(srcPath.c_str()) < 0);
+
+	sfz::FileOpResult result;
+	REQUIRE(sfz::copyDirectory(srcPath.c_str(), dstPath.c_str(), result));
+	REQUIRE(result.numFiles == 2 + numLinks);
+	REQUIRE(result.numBytes == 12);
+	REQUIRE(sfz::sizeofFile((dstPath + "/a.bin").c_str()) == 8);
+	REQUIRE(sfz::sizeofFile((dstPath + "/sub/b.bin").c_str()) == 4);
+	REQUIRE(sfz::directoryExists((dstPath + "/sub/empty").c_str()));
+#ifndef _WIN32
+	char target[16] = {};
+	REQUIRE(readlink((dstPath + "/dirLink").c_str(), target, sizeof(target) - 1) == 3);
+	REQUIRE(string(target) == "sub");
+	REQUIRE(sfz::sizeofFile((dstPath + "/dirLink/b.bin").c_str()) == 4);
+	REQUIRE(sfz::sizeofFile((dstPath + "/sub/fileLink").c_str()) == 8);
+#endif
+
+#ifndef _WIN32
+	// Symbolic links are deleted, not followed
+	REQUIRE(symlink(srcPath.c_str(), (dstPath + "/link").c_str()) == 0);
+#endif
+
+	sfz::FileOpResult deleted;
+	REQUIRE(sfz::deleteDirectoryRecursive(dstPath.c_str(), deleted));
+	REQUIRE(!sfz::directoryExists(dstPath.c_str()));
+	REQUIRE(sfz::fileExists((srcPath + "/sub/b.bin").c_str()));
+	REQUIRE(!sfz::deleteDirectoryRecursive(dstPath.c_str()));
+
+	REQUIRE(sfz::deleteDirectoryRecursive(srcPath.c_str()));
+	REQUIRE(!sfz::directoryExists(srcPath.c_str()));
+}
+
+
+TEST_CASE("copyFile() benchmark", "[.][benchmark][sfz::IO]")
+{
+	const string srcPath = sfz::basePath() + stupidFileName();
+	const string dstPath = srcPath + ".copy";
+	std::vector<uint8_t> data(256 * 1024 * 1024);
+	for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i);
+	REQUIRE(sfz::writeBinaryFile(srcPath.c_str(), data.data(), data.size()));
+
+	// Previous implementation, fread() and fwrite() through a BUFSIZ buffer
+	sfz::StopWatch stopWatch;
+	{
+		uint8_t buffer[BUFSIZ];
+		std::FILE* source = std::fopen(srcPath.c_str(), "rb");
+		std::FILE* destination = std::fopen(dstPath.c_str(), "wb");
+		size_t size;
+		while ((size = std::fread(buffer, 1, BUFSIZ, source)) > 0) {
+			std::fwrite(buffer, 1, size, destination);
+		}
+		std::fclose(source);
+		std::fclose(destination);
+	}
+	float bufferedTime = stopWatch.getTimeMilliSeconds();
+	REQUIRE(sfz::deleteFile(dstPath.c_str()));
+
+	stopWatch.start();
+	REQUIRE(sfz::copyFile(srcPath.c_str(), dstPath.c_str()));
+	float copyTime = stopWatch.getTimeMilliSeconds();
+
+	std::cout << "Copying 256 MiB file:"
+	          << "\nfread() + fwrite(): " << bufferedTime << "ms"
+	          << "\ncopyFile(): " << copyTime << "ms" << std::endl;
+	REQUIRE(sfz::sizeofFile(dstPath.c_str()) == int64_t(data.size()));
+	REQUIRE(sfz::deleteFile(srcPath.c_str()));
+	REQUIRE(sfz::deleteFile(dstPath.c_str()));
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include "sfz/util/IniParser.hpp"
+#include "sfz/util/IO.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using std::string;
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static void writeText(const string& path, const string& text)
+{
+	REQUIRE(writeBinaryFile(path.c_str(), (const uint8_t*)text.data(), text.size()));
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Loading ini files", "[sfz::IniParser]")
+{
+	const string path = basePath() + "feajfoeajofajoe_parser.ini";
+	writeText(path,
+	    "globalInt=-2\n"
+	    "; comment=1\n"
+	    "\n"
+	    "[Graphics]\n"
+	    "fullscreen=On\n"
+	    "width=1920\n"
+	    "scale=1.5\n"
+	    "name=sfz window\n"
+	    "width=1280\n"
+	    "[Empty]\n"
+	    "[Audio]\n"
+	    "volume=12px\n"
+	    "big=99999999999\n"
+	    "off=OFF");
+
+	IniParser ini{path};
+	REQUIRE(!IniParser{path + "nope"}.load());
+	REQUIRE(ini.load());
+
+	REQUIRE(ini.itemExists("", "globalInt"));
+	REQUIRE(ini.getInt("", "globalInt") == -2);
+	REQUIRE(!ini.itemExists("", "; comment"));
+	REQUIRE(!ini.itemExists("Graphics", "globalInt"));
+	REQUIRE(!ini.itemExists("Missing", "width"));
+
+	REQUIRE(ini.itemIsBool("Graphics", "fullscreen"));
+	REQUIRE(ini.getBool("Graphics", "fullscreen"));
+	REQUIRE(!ini.itemIsInt("Graphics", "fullscreen"));
+	REQUIRE(ini.getInt("Graphics", "width") == 1280);
+	REQUIRE(ini.itemIsFloat("Graphics", "width"));
+	REQUIRE(ini.getFloat("Graphics", "scale") == 1.5f);
+	REQUIRE(ini.getInt("Graphics", "scale") == 1);
+	REQUIRE(ini.getString("Graphics", "name") == "sfz window");
+	REQUIRE(ini.getString("Graphics", "missing", "default") == "default");
+
+	// Same rules as std::stoi(), prefix is accepted but out of range values are not
+	REQUIRE(ini.getInt("Audio", "volume") == 12);
+	REQUIRE(!ini.itemIsInt("Audio", "big"));
+	REQUIRE(ini.getInt("Audio", "big", 7) == 7);
+	REQUIRE(ini.itemIsFloat("Audio", "big"));
+	REQUIRE(ini.itemIsBool("Audio", "off"));
+	REQUIRE(!ini.getBool("Audio", "off", true));
+	REQUIRE(!ini.getBool("Audio", "volume", true));
+	REQUIRE(ini.getBool("Audio", "missing", true));
+
+	// Invalid files
+	writeText(path, "[Section\nkey=value\n");
+	REQUIRE(!ini.load());
+	writeText(path, "=value\n");
+	REQUIRE(!ini.load());
+	writeText(path, "key=\n");
+	REQUIRE(!ini.load());
+	writeText(path, "");
+	REQUIRE(ini.load());
+	REQUIRE(!ini.itemExists("Graphics", "width"));
+
+	REQUIRE(deleteFile(path.c_str()));
+}
+
+TEST_CASE("Setting and saving ini files", "[sfz::IniParser]")
+{
+	const string path = basePath() + "feajfoeajofajoe_parser.ini";
+	deleteFile(path.c_str());
+
+	IniParser ini{path};
+	ini.setInt("Section", "int", 3);
+	ini.setBool("Section", "bool", true);
+	ini.setFloat("Section", "float", 2.0f);
+	ini.setString("", "global", "value");
+	REQUIRE(ini.getInt("Section", "int") == 3);
+	REQUIRE(ini.getBool("Section", "bool"));
+	REQUIRE(ini.getFloat("Section", "float") == 2.0f);
+
+	// Overwriting values many times
+	for (int32_t i = 0; i < 10000; i++) ini.setInt("Section", "int", i);
+	REQUIRE(ini.getInt("Section", "int") == 9999);
+	ini.setString("Section", "int", "not an int");
+	REQUIRE(!ini.itemIsInt("Section", "int"));
+	REQUIRE(ini.getInt("Section", "int", 5) == 5);
+
+	// Many items
+	for (int32_t i = 0; i < 1000; i++) {
+		ini.setInt("Many" + std::to_string(i % 10), std::to_string(i), i);
+	}
+	for (int32_t i = 0; i < 1000; i++) {
+		REQUIRE(ini.getInt("Many" + std::to_string(i % 10), std::to_string(i)) == i);
+	}
+
+	REQUIRE(ini.save());
+	IniParser copy = ini;
+	IniParser loaded{path};
+	REQUIRE(loaded.load());
+	REQUIRE(loaded.getString("", "global") == "value");
+	REQUIRE(loaded.getString("Section", "int") == "not an int");
+	REQUIRE(loaded.getFloat("Section", "float") == 2.0f);
+	REQUIRE(loaded.getInt("Many7", "997") == 997);
+	REQUIRE(copy.getInt("Many7", "997") == 997);
+
+	// Sanitizers
+	REQUIRE(ini.sanitizeInt("Section", "int", 4, 0, 10) == 4);
+	REQUIRE(ini.sanitizeInt("Many9", "999", 4, 0, 10) == 10);
+	REQUIRE(ini.sanitizeFloat("Section", "float", 0.0f, 0.0f, 1.0f) == 1.0f);
+	REQUIRE(ini.sanitizeBool("Section", "new", true));
+	REQUIRE(ini.sanitizeString("Section", "name", "default") == "default");
+	REQUIRE(ini.getString("Section", "name") == "default");
+
+	REQUIRE(deleteFile(path.c_str()));
+}
+
+TEST_CASE("Incremental saving", "[sfz::IniParser]")
+{
+	const string path = basePath() + "feajfoeajofajoe_parser.ini";
+	writeText(path,
+	    "; Settings\n"
+	    "\n"
+	    "[Graphics]\n"
+	    "; Window width\n"
+	    "width=1920\n"
+	    "height=1080\n"
+	    "\n"
+	    "[Audio]\n"
+	    "volume=10\n");
+
+	IniParser ini{path};
+	REQUIRE(ini.load());
+	REQUIRE(!ini.isDirty());
+
+	// Nothing changed, file is not touched
+	REQUIRE(deleteFile(path.c_str()));
+	REQUIRE(ini.save());
+	REQUIRE(!fileExists(path.c_str()));
+	ini.setInt("Graphics", "width", 1920);
+	REQUIRE(!ini.isDirty());
+
+	// Comments and order are preserved, new items are added to their sections
+	ini.setInt("Graphics", "width", 1280);
+	ini.setBool("Graphics", "vsync", true);
+	ini.setInt("", "version", 2);
+	ini.setString("Input", "jump", "space");
+	REQUIRE(ini.isDirty());
+	REQUIRE(ini.save());
+	REQUIRE(!ini.isDirty());
+	REQUIRE(!fileExists((path + ".tmp").c_str()));
+	REQUIRE(readTextFile(path.c_str()) ==
+	    "; Settings\n"
+	    "\n"
+	    "version=2\n"
+	    "[Graphics]\n"
+	    "; Window width\n"
+	    "width=1280\n"
+	    "height=1080\n"
+	    "vsync=true\n"
+	    "\n"
+	    "[Audio]\n"
+	    "volume=10\n"
+	    "\n"
+	    "[Input]\n"
+	    "jump=space\n");
+
+	// Saving again after further changes
+	ini.setInt("Audio", "volume", 5);
+	ini.setString("Input", "crouch", "c");
+	REQUIRE(ini.save());
+	IniParser loaded{path};
+	REQUIRE(loaded.load());
+	REQUIRE(loaded.getInt("Audio", "volume") == 5);
+	REQUIRE(loaded.getString("Input", "crouch") == "c");
+	REQUIRE(loaded.getInt("Graphics", "width") == 1280);
+	REQUIRE(readTextFile(path.c_str()).find("jump=space\ncrouch=c\n") != string::npos);
+
+	REQUIRE(deleteFile(path.c_str()));
+}
+
+TEST_CASE("Background saving", "[sfz::IniParser]")
+{
+	const string path = basePath() + "feajfoeajofajoe_parser.ini";
+	writeText(path, "[Audio]\nvolume=0\n");
+	{
+		IniParser ini{path};
+		REQUIRE(ini.load());
+		REQUIRE(ini.flushAsyncSave());
+
+		// Repeated saves are debounced, only written once no more saves are requested
+		for (int32_t i = 1; i <= 100; i++) {
+			ini.setInt("Audio", "volume", i);
+			ini.saveAsync(10000);
+		}
+		REQUIRE(!ini.isDirty());
+		REQUIRE(readTextFile(path.c_str()) == "[Audio]\nvolume=0\n");
+		REQUIRE(ini.flushAsyncSave());
+		REQUIRE(readTextFile(path.c_str()) == "[Audio]\nvolume=100\n");
+
+		// Written after delay
+		ini.setInt("Audio", "volume", 50);
+		ini.saveAsync(10);
+		for (int i = 0; i < 200 && readTextFile(path.c_str()) != "[Audio]\nvolume=50\n"; i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		REQUIRE(readTextFile(path.c_str()) == "[Audio]\nvolume=50\n");
+
+		// Pending save is written on destruction
+		ini.setInt("Audio", "volume", 75);
+		ini.saveAsync(10000);
+	}
+	REQUIRE(readTextFile(path.c_str()) == "[Audio]\nvolume=75\n");
+
+	// Failed writes are reported and retried by the next save
+	const string dirPath = basePath() + "feajfoeajofajoe_parser_dir";
+	REQUIRE(createDirectory(dirPath.c_str()));
+	IniParser dirIni{dirPath};
+	dirIni.setInt("", "a", 1);
+	dirIni.saveAsync(0);
+	REQUIRE(!dirIni.flushAsyncSave());
+	REQUIRE(!dirIni.save());
+	REQUIRE(deleteDirectory(dirPath.c_str()));
+	REQUIRE(!fileExists((dirPath + ".tmp").c_str()));
+	REQUIRE(dirIni.save());
+	REQUIRE(readTextFile(dirPath.c_str()) == "a=1\n");
+
+	REQUIRE(deleteFile(dirPath.c_str()));
+	REQUIRE(deleteFile(path.c_str()));
+}
+
+// Benchmarks (hidden, run with "[benchmark]")
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("IniParser benchmark", "[.][benchmark][sfz::IniParser]")
+{
+	const string path = basePath() + "feajfoeajofajoe_benchmark.ini";
+	const int NUM_SECTIONS = 1000, NUM_KEYS = 100;
+	string contents;
+	for (int s = 0; s < NUM_SECTIONS; s++) {
+		contents += "[Section" + std::to_string(s) + "]\n";
+		for (int k = 0; k < NUM_KEYS; k++) {
+			contents += "key" + std::to_string(k) + "=" + std::to_string(s * k) + "\n";
+		}
+	}
+	writeText(path, contents);
+	const float mib = float(contents.size()) / (1024.0f * 1024.0f);
+
+	StopWatch stopWatch;
+	IniParser ini{path};
+	REQUIRE(ini.load());
+	float loadTime = stopWatch.getTimeMilliSeconds();
+
+	// Baseline, the previous std::map based storage
+	std::map<string, std::map<string, string>> tree;
+	for (int s = 0; s < NUM_SECTIONS; s++) {
+		for (int k = 0; k < NUM_KEYS; k++) {
+			tree["Section" + std::to_string(s)]["key" + std::to_string(k)] = std::to_string(s * k);
+		}
+	}
+
+	vector<string> sections, keys;
+	for (int s = 0; s < NUM_SECTIONS; s++) sections.push_back("Section" + std::to_string(s));
+	for (int k = 0; k < NUM_KEYS; k++) keys.push_back("key" + std::to_string(k));
+
+	stopWatch.start();
+	int64_t sum = 0;
+	for (int s = 0; s < NUM_SECTIONS; s++) {
+		for (int k = 0; k < NUM_KEYS; k++) sum += ini.getInt(sections[s], keys[k]);
+	}
+	float lookupTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	int64_t mapSum = 0;
+	for (int s = 0; s < NUM_SECTIONS; s++) {
+		for (int k = 0; k < NUM_KEYS; k++) mapSum += std::stoi(tree[sections[s]][keys[k]]);
+	}
+	float mapLookupTime = stopWatch.getTimeMilliSeconds();
+	REQUIRE(sum == mapSum);
+
+	const float numLookups = float(NUM_SECTIONS * NUM_KEYS);
+	std::cout << "IniParser, " << (NUM_SECTIONS * NUM_KEYS) << " items (" << mib << " MiB):"
+	          << "\nload(): " << loadTime << "ms (" << (mib / loadTime * 1000.0f) << " MiB/s)"
+	          << "\ngetInt(): " << (lookupTime * 1000000.0f / numLookups) << "ns"
+	          << "\nstd::map + std::stoi(): " << (mapLookupTime * 1000000.0f / numLookups) << "ns"
+	          << std::endl;
+	REQUIRE(deleteFile(path.c_str()));
+}
\ No newline at end of file
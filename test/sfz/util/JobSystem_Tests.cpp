@@ -0,0 +1,275 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sfz/util/JobSystem.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+
+static void sleepMs(int ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static uint64_t fibonacci(JobSystem& jobs, uint32_t n)
+{
+	if (n < 2) return n;
+	if (n < 12) return fibonacci(jobs, n - 1) + fibonacci(jobs, n - 2);
+	uint64_t a = 0;
+	JobCounter counter;
+	jobs.run([&]() { a = fibonacci(jobs, n - 1); }, &counter);
+	uint64_t b = fibonacci(jobs, n - 2);
+	jobs.wait(counter);
+	return a + b;
+}
+
+TEST_CASE("Running jobs", "[sfz::JobSystem]")
+{
+	JobSystem jobs(3);
+	REQUIRE(jobs.numWorkers() == 3);
+	REQUIRE(jobs.numThreads() == 4);
+
+	SECTION("Counters") {
+		std::atomic<int> sum{0};
+		JobCounter counter;
+		REQUIRE(counter.isDone());
+		for (int i = 1; i <= 1000; i++) {
+			jobs.run([&sum, i]() { sum.fetch_add(i); }, &counter);
+		}
+		jobs.wait(counter);
+		REQUIRE(counter.isDone());
+		REQUIRE(counter.numUnfinished() == 0);
+		REQUIRE(sum.load() == 500500);
+
+		// Counters can be reused
+		jobs.run([&sum]() { sum.fetch_add(1); }, &counter);
+		jobs.wait(counter);
+		REQUIRE(sum.load() == 500501);
+	}
+	SECTION("More jobs than deque capacity") {
+		std::atomic<uint32_t> numRun{0};
+		JobCounter counter;
+		const uint32_t numJobs = 3 * JobSystem::DEQUE_CAPACITY;
+		for (uint32_t i = 0; i < numJobs; i++) {
+			jobs.run([&numRun]() { numRun.fetch_add(1); }, &counter);
+		}
+		jobs.wait(counter);
+		REQUIRE(numRun.load() == numJobs);
+	}
+	SECTION("Jobs are stolen by workers") {
+		std::atomic<int> numRun{0};
+		JobCounter counter;
+		for (int i = 0; i < 32; i++) {
+			jobs.run([&numRun]() { sleepMs(1); numRun.fetch_add(1); }, &counter);
+		}
+		jobs.wait(counter);
+		REQUIRE(numRun.load() == 32);
+		REQUIRE(jobs.numStolenJobs() > 0);
+	}
+	SECTION("Nested jobs") {
+		REQUIRE(fibonacci(jobs, 25) == 75025);
+	}
+	SECTION("Submitting from other threads") {
+		std::atomic<int> numRun{0};
+		JobCounter counter;
+		std::thread thread([&]() {
+			for (int i = 0; i < 100; i++) {
+				jobs.run([&numRun]() { numRun.fetch_add(1); }, &counter);
+			}
+			jobs.wait(counter);
+		});
+		thread.join();
+		REQUIRE(numRun.load() == 100);
+		REQUIRE(counter.isDone());
+	}
+	SECTION("runQueuedJob()") {
+		JobSystem single(1);
+		REQUIRE(!single.runQueuedJob());
+	}
+}
+
+TEST_CASE("Job dependencies", "[sfz::JobSystem]")
+{
+	JobSystem jobs(2);
+
+	SECTION("Chain") {
+		std::vector<int> order;
+		std::mutex mutex;
+		auto record = [&](int value) {
+			std::lock_guard<std::mutex> lock(mutex);
+			order.push_back(value);
+		};
+
+		JobCounter first, second, third;
+		jobs.run([&]() { sleepMs(5); record(1); }, &first);
+		jobs.run([&]() { sleepMs(10); record(1); }, &first);
+		jobs.runAfter(first, [&]() { record(2); }, &second);
+		jobs.runAfter(second, [&]() { record(3); }, &third);
+		jobs.runAfter(second, [&]() { record(3); }, &third);
+		REQUIRE(!third.isDone());
+		jobs.wait(third);
+
+		REQUIRE(first.isDone());
+		REQUIRE(second.isDone());
+		REQUIRE(order.size() == 5);
+		REQUIRE(order[0] == 1);
+		REQUIRE(order[1] == 1);
+		REQUIRE(order[2] == 2);
+		REQUIRE(order[3] == 3);
+		REQUIRE(order[4] == 3);
+	}
+	SECTION("Dependency already done") {
+		JobCounter done, counter;
+		bool ran = false;
+		jobs.runAfter(done, [&]() { ran = true; }, &counter);
+		jobs.wait(counter);
+		REQUIRE(ran);
+	}
+	SECTION("Many dependent jobs") {
+		std::atomic<int> numRun{0};
+		std::atomic<bool> dependencyRan{false};
+		std::atomic<bool> wrongOrder{false};
+		JobCounter dependency, counter;
+		jobs.run([&]() { sleepMs(5); dependencyRan.store(true); }, &dependency);
+		for (int i = 0; i < 1000; i++) {
+			jobs.runAfter(dependency, [&]() {
+				if (!dependencyRan.load()) wrongOrder.store(true);
+				numRun.fetch_add(1);
+			}, &counter);
+		}
+		jobs.wait(counter);
+		REQUIRE(numRun.load() == 1000);
+		REQUIRE(!wrongOrder.load());
+	}
+}
+
+TEST_CASE("parallelFor() and parallelReduce()", "[sfz::JobSystem]")
+{
+	JobSystem jobs(3, true);
+
+	SECTION("parallelFor() visits each element once") {
+		const size_t grainSizes[] = {0, 1, 7, 64, 1000, 5000};
+		for (size_t grainSize : grainSizes) {
+			std::vector<std::atomic<int>> visits(3333);
+			for (auto& v : visits) v.store(0);
+			std::atomic<bool> invalidRange{false};
+			jobs.parallelFor(100, 3333, grainSize, [&](size_t begin, size_t end) {
+				if (begin >= end || (grainSize != 0 && (end - begin) > grainSize)) {
+					invalidRange.store(true);
+				}
+				for (size_t i = begin; i < end; i++) visits[i].fetch_add(1);
+			});
+			REQUIRE(!invalidRange.load());
+			for (size_t i = 0; i < 100; i++) REQUIRE(visits[i].load() == 0);
+			for (size_t i = 100; i < 3333; i++) REQUIRE(visits[i].load() == 1);
+		}
+
+		bool called = false;
+		jobs.parallelFor(5, 5, 1, [&](size_t, size_t) { called = true; });
+		REQUIRE(!called);
+	}
+	SECTION("Nested parallelFor()") {
+		std::atomic<uint32_t> sum{0};
+		jobs.parallelFor(0, 64, 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				jobs.parallelFor(0, 64, 4, [&](size_t innerBegin, size_t innerEnd) {
+					sum.fetch_add(uint32_t(innerEnd - innerBegin));
+				});
+			}
+		});
+		REQUIRE(sum.load() == 64 * 64);
+	}
+	SECTION("parallelReduce()") {
+		std::vector<uint64_t> values;
+		for (uint64_t i = 0; i < 100000; i++) values.push_back(i);
+
+		auto sumRange = [&](size_t begin, size_t end) {
+			uint64_t sum = 0;
+			for (size_t i = begin; i < end; i++) sum += values[i];
+			return sum;
+		};
+		auto add = [](uint64_t lhs, uint64_t rhs) { return lhs + rhs; };
+		REQUIRE(jobs.parallelReduce(0, 100000, 0, uint64_t(0), sumRange, add) == 4999950000ull);
+		REQUIRE(jobs.parallelReduce(0, 100000, 333, uint64_t(0), sumRange, add) == 4999950000ull);
+		REQUIRE(jobs.parallelReduce(10, 20, 0, uint64_t(7), sumRange, add) == 152);
+		REQUIRE(jobs.parallelReduce(20, 10, 0, uint64_t(7), sumRange, add) == 7);
+
+		// Results are combined in order
+		auto rangeString = [](size_t begin, size_t end) {
+			return std::to_string(begin) + "-" + std::to_string(end) + " ";
+		};
+		auto concat = [](const std::string& lhs, const std::string& rhs) { return lhs + rhs; };
+		REQUIRE(jobs.parallelReduce(0, 10, 3, std::string(), rangeString, concat) ==
+		        "0-3 3-6 6-9 9-10 ");
+
+		// Boolean reductions, each range's result is stored separately (not in a vector<bool>)
+		auto anyAbove = [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) if (values[i] > 99990) return true;
+			return false;
+		};
+		auto logicalOr = [](bool lhs, bool rhs) { return lhs || rhs; };
+		REQUIRE(jobs.parallelReduce(0, 100000, 1, false, anyAbove, logicalOr));
+		REQUIRE(!jobs.parallelReduce(0, 99990, 1, false, anyAbove, logicalOr));
+	}
+}
+
+TEST_CASE("JobSystem performance", "[.][benchmark][sfz::JobSystem]")
+{
+	JobSystem jobs;
+	std::cout << "JobSystem threads: " << jobs.numThreads() << "\n";
+
+	const size_t NUM_VALUES = 1 << 24;
+	std::vector<float> values(NUM_VALUES);
+	for (size_t i = 0; i < NUM_VALUES; i++) values[i] = float(i % 1000) * 0.001f;
+	auto sumRange = [&](size_t begin, size_t end) {
+		double sum = 0.0;
+		for (size_t i = begin; i < end; i++) sum += std::sqrt(values[i]);
+		return sum;
+	};
+	auto add = [](double lhs, double rhs) { return lhs + rhs; };
+
+	StopWatch watch;
+	double serialSum = sumRange(0, NUM_VALUES);
+	watch.stop();
+	std::cout << "Serial sum: " << watch.getTimeMilliSeconds() << " ms\n";
+
+	watch.start();
+	double parallelSum = jobs.parallelReduce(0, NUM_VALUES, 0, 0.0, sumRange, add);
+	watch.stop();
+	std::cout << "parallelReduce() sum: " << watch.getTimeMilliSeconds() << " ms\n";
+	REQUIRE(parallelSum == Approx(serialSum));
+
+	const int NUM_JOBS = 1000000;
+	std::atomic<int> numRun{0};
+	JobCounter counter;
+	watch.start();
+	for (int i = 0; i < NUM_JOBS; i++) {
+		jobs.run([&numRun]() { numRun.fetch_add(1, std::memory_order_relaxed); }, &counter);
+		if ((i & 1023) == 1023) jobs.wait(counter);
+	}
+	jobs.wait(counter);
+	watch.stop();
+	REQUIRE(numRun.load() == NUM_JOBS);
+	std::cout << "Run and wait for empty job: "
+	          << (watch.getTimeNanoSeconds() / double(NUM_JOBS)) << " ns per job\n";
+
+	watch.start();
+	for (int i = 0; i < 10000; i++) {
+		jobs.parallelFor(0, 256, 16, [&numRun](size_t, size_t) {
+			numRun.fetch_add(1, std::memory_order_relaxed);
+		});
+	}
+	watch.stop();
+	std::cout << "parallelFor() with 16 subranges: "
+	          << (watch.getTimeNanoSeconds() / 10000.0) << " ns\n";
+}
\ No newline at end of file
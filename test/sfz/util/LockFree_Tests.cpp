@@ -0,0 +1,348 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sfz/util/LockFree.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+using std::uint32_t;
+using std::uint64_t;
+
+static std::atomic<int> numLiveObjects{0};
+
+struct Counted final {
+	int value = 0;
+	Counted() noexcept { numLiveObjects++; }
+	Counted(int value) noexcept : value(value) { numLiveObjects++; }
+	Counted(const Counted& other) noexcept : value(other.value) { numLiveObjects++; }
+	Counted& operator= (const Counted&) noexcept = default;
+	~Counted() noexcept { numLiveObjects--; }
+};
+
+TEST_CASE("SPSCQueue", "[sfz::LockFree]")
+{
+	SECTION("Basic usage") {
+		SPSCQueue<int> queue(5);
+		REQUIRE(queue.capacity() == 8);
+		REQUIRE(queue.sizeApprox() == 0);
+
+		int value = -1;
+		REQUIRE(!queue.tryPop(value));
+		for (int i = 0; i < 8; i++) REQUIRE(queue.tryPush(i));
+		REQUIRE(!queue.tryPush(8));
+		REQUIRE(queue.sizeApprox() == 8);
+
+		for (int i = 0; i < 8; i++) {
+			REQUIRE(queue.tryPop(value));
+			REQUIRE(value == i);
+		}
+		REQUIRE(!queue.tryPop(value));
+
+		// Wrap around
+		for (int i = 0; i < 100; i++) {
+			REQUIRE(queue.tryPush(i));
+			REQUIRE(queue.tryPush(i + 1000));
+			REQUIRE(queue.tryPop(value));
+			REQUIRE(value == i);
+			REQUIRE(queue.tryPop(value));
+			REQUIRE(value == i + 1000);
+		}
+	}
+	SECTION("Capacity 1") {
+		SPSCQueue<int> queue(0);
+		REQUIRE(queue.capacity() == 1);
+		REQUIRE(queue.tryPush(3));
+		REQUIRE(!queue.tryPush(4));
+		int value = 0;
+		REQUIRE(queue.tryPop(value));
+		REQUIRE(value == 3);
+		REQUIRE(!queue.tryPop(value));
+	}
+	SECTION("Move-only and non-trivial types") {
+		SPSCQueue<std::unique_ptr<int>> queue(4);
+		std::unique_ptr<int> ptr(new int(7));
+		REQUIRE(queue.tryPush(std::move(ptr)));
+		REQUIRE(ptr == nullptr);
+		REQUIRE(queue.tryPush(std::unique_ptr<int>(new int(8))));
+		std::unique_ptr<int> out;
+		REQUIRE(queue.tryPop(out));
+		REQUIRE(*out == 7);
+		// The remaining element is destroyed by the queue
+
+		{
+			SPSCQueue<Counted> countedQueue(16);
+			for (int i = 0; i < 10; i++) REQUIRE(countedQueue.tryPush(Counted(i)));
+			Counted counted;
+			REQUIRE(countedQueue.tryPop(counted));
+			REQUIRE(counted.value == 0);
+			REQUIRE(numLiveObjects.load() == 10);
+		}
+		REQUIRE(numLiveObjects.load() == 0);
+	}
+	SECTION("Stress") {
+		const uint32_t NUM_VALUES = 1000000;
+		SPSCQueue<uint32_t> queue(64);
+		std::thread producer([&]() {
+			for (uint32_t i = 0; i < NUM_VALUES; i++) {
+				while (!queue.tryPush(i)) std::this_thread::yield();
+			}
+		});
+
+		uint32_t numWrong = 0;
+		for (uint32_t i = 0; i < NUM_VALUES; i++) {
+			uint32_t value = 0;
+			while (!queue.tryPop(value)) std::this_thread::yield();
+			if (value != i) numWrong++;
+		}
+		producer.join();
+		REQUIRE(numWrong == 0);
+		REQUIRE(queue.sizeApprox() == 0);
+	}
+}
+
+TEST_CASE("MPMCQueue", "[sfz::LockFree]")
+{
+	SECTION("Basic usage") {
+		MPMCQueue<int> queue(1);
+		REQUIRE(queue.capacity() == 2);
+		REQUIRE(queue.tryPush(1));
+		REQUIRE(queue.tryPush(2));
+		REQUIRE(!queue.tryPush(3));
+		REQUIRE(queue.sizeApprox() == 2);
+
+		int value = 0;
+		REQUIRE(queue.tryPop(value));
+		REQUIRE(value == 1);
+		REQUIRE(queue.tryPush(3));
+		REQUIRE(queue.tryPop(value));
+		REQUIRE(value == 2);
+		REQUIRE(queue.tryPop(value));
+		REQUIRE(value == 3);
+		REQUIRE(!queue.tryPop(value));
+		REQUIRE(queue.sizeApprox() == 0);
+	}
+	SECTION("Non-trivial types") {
+		{
+			MPMCQueue<Counted> queue(16);
+			for (int i = 0; i < 16; i++) REQUIRE(queue.tryPush(Counted(i)));
+			REQUIRE(!queue.tryPush(Counted(16)));
+			Counted counted;
+			for (int i = 0; i < 6; i++) {
+				REQUIRE(queue.tryPop(counted));
+				REQUIRE(counted.value == i);
+			}
+			REQUIRE(numLiveObjects.load() == 11);
+		}
+		REQUIRE(numLiveObjects.load() == 0);
+	}
+	SECTION("Stress") {
+		const uint32_t NUM_PRODUCERS = 4, NUM_CONSUMERS = 4;
+		const uint32_t NUM_VALUES_PER_PRODUCER = 200000;
+		MPMCQueue<uint64_t> queue(128);
+
+		// Values are (producer << 32) | index, each consumer checks that the indices it receives
+		// from each producer are increasing
+		std::vector<std::thread> threads;
+		std::atomic<uint64_t> sum{0};
+		std::atomic<uint32_t> numReceived{0}, numOutOfOrder{0};
+		for (uint32_t p = 0; p < NUM_PRODUCERS; p++) {
+			threads.emplace_back([&, p]() {
+				for (uint32_t i = 0; i < NUM_VALUES_PER_PRODUCER; i++) {
+					uint64_t value = (uint64_t(p) << 32) | i;
+					while (!queue.tryPush(value)) std::this_thread::yield();
+				}
+			});
+		}
+		for (uint32_t c = 0; c < NUM_CONSUMERS; c++) {
+			threads.emplace_back([&]() {
+				std::vector<int64_t> lastIndex(NUM_PRODUCERS, -1);
+				uint64_t localSum = 0;
+				while (numReceived.load() < NUM_PRODUCERS * NUM_VALUES_PER_PRODUCER) {
+					uint64_t value = 0;
+					if (!queue.tryPop(value)) {
+						std::this_thread::yield();
+						continue;
+					}
+					numReceived++;
+					uint32_t producer = uint32_t(value >> 32);
+					int64_t index = int64_t(value & 0xFFFFFFFFu);
+					if (index <= lastIndex[producer]) numOutOfOrder++;
+					lastIndex[producer] = index;
+					localSum += uint64_t(index);
+				}
+				sum += localSum;
+			});
+		}
+		for (std::thread& thread : threads) thread.join();
+
+		const uint64_t n = NUM_VALUES_PER_PRODUCER;
+		REQUIRE(numReceived.load() == NUM_PRODUCERS * NUM_VALUES_PER_PRODUCER);
+		REQUIRE(numOutOfOrder.load() == 0);
+		REQUIRE(sum.load() == NUM_PRODUCERS * (n * (n - 1) / 2));
+		REQUIRE(queue.sizeApprox() == 0);
+	}
+}
+
+TEST_CASE("TripleBuffer", "[sfz::LockFree]")
+{
+	SECTION("Basic usage") {
+		TripleBuffer<int> buffer(-1);
+		REQUIRE(!buffer.update());
+		REQUIRE(buffer.readBuffer() == -1);
+
+		buffer.write(1);
+		REQUIRE(buffer.readBuffer() == -1);
+		REQUIRE(buffer.update());
+		REQUIRE(buffer.readBuffer() == 1);
+		REQUIRE(!buffer.update());
+		REQUIRE(buffer.readBuffer() == 1);
+
+		// Only the latest value is seen
+		buffer.write(2);
+		buffer.writeBuffer() = 3;
+		buffer.publish();
+		REQUIRE(buffer.read() == 3);
+		REQUIRE(buffer.read() == 3);
+	}
+	SECTION("Stress") {
+		struct State final {
+			uint64_t counter = 0;
+			uint64_t values[15]; // All equal to counter
+		};
+
+		const uint64_t NUM_WRITES = 1000000;
+		TripleBuffer<State> buffer;
+		std::thread writer([&]() {
+			for (uint64_t i = 1; i <= NUM_WRITES; i++) {
+				State& state = buffer.writeBuffer();
+				state.counter = i;
+				for (uint64_t& value : state.values) value = i;
+				buffer.publish();
+			}
+		});
+
+		uint64_t last = 0, numUpdates = 0, numTorn = 0, numBackwards = 0;
+		while (last < NUM_WRITES) {
+			if (!buffer.update()) {
+				std::this_thread::yield();
+				continue;
+			}
+			const State& state = buffer.readBuffer();
+			for (uint64_t value : state.values) {
+				if (value != state.counter) numTorn++;
+			}
+			if (state.counter <= last) numBackwards++;
+			last = state.counter;
+			numUpdates++;
+		}
+		writer.join();
+
+		REQUIRE(numUpdates > 0);
+		REQUIRE(numTorn == 0);
+		REQUIRE(numBackwards == 0);
+	}
+}
+
+// Reference for the benchmarks
+template<typename T>
+class MutexQueue final {
+public:
+	MutexQueue(size_t capacity) noexcept : mCapacity(capacity) { }
+	bool tryPush(const T& value) noexcept
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mQueue.size() >= mCapacity) return false;
+		mQueue.push_back(value);
+		return true;
+	}
+	bool tryPop(T& out) noexcept
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mQueue.empty()) return false;
+		out = mQueue.front();
+		mQueue.pop_front();
+		return true;
+	}
+private:
+	size_t mCapacity;
+	std::mutex mMutex;
+	std::deque<T> mQueue;
+};
+
+template<typename Queue>
+static void benchmarkQueue(const char* name, Queue& queue, uint32_t numProducers,
+                           uint32_t numConsumers)
+{
+	const uint64_t NUM_VALUES = 4000000;
+	const uint64_t numPerProducer = NUM_VALUES / numProducers;
+	std::atomic<uint64_t> numReceived{0};
+
+	StopWatch watch;
+	std::vector<std::thread> threads;
+	for (uint32_t p = 0; p < numProducers; p++) {
+		threads.emplace_back([&]() {
+			for (uint64_t i = 0; i < numPerProducer; i++) {
+				while (!queue.tryPush(i)) std::this_thread::yield();
+			}
+		});
+	}
+	for (uint32_t c = 0; c < numConsumers; c++) {
+		threads.emplace_back([&]() {
+			uint64_t value;
+			while (numReceived.load(std::memory_order_relaxed) < numPerProducer * numProducers) {
+				if (queue.tryPop(value)) numReceived.fetch_add(1, std::memory_order_relaxed);
+				else std::this_thread::yield();
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+	watch.stop();
+
+	std::cout << name << " (" << numProducers << "P" << numConsumers << "C): "
+	          << (double(NUM_VALUES) / watch.getTimeSeconds() / 1e6) << " M items/s\n";
+}
+
+TEST_CASE("LockFree performance", "[.][benchmark][sfz::LockFree]")
+{
+	{
+		SPSCQueue<uint64_t> queue(1024);
+		benchmarkQueue("SPSCQueue", queue, 1, 1);
+	}
+	{
+		MPMCQueue<uint64_t> queue(1024);
+		benchmarkQueue("MPMCQueue", queue, 1, 1);
+	}
+	{
+		MPMCQueue<uint64_t> queue(1024);
+		benchmarkQueue("MPMCQueue", queue, 2, 2);
+	}
+	{
+		MutexQueue<uint64_t> queue(1024);
+		benchmarkQueue("Mutex + std::deque", queue, 1, 1);
+	}
+	{
+		MutexQueue<uint64_t> queue(1024);
+		benchmarkQueue("Mutex + std::deque", queue, 2, 2);
+	}
+
+	const int NUM_WRITES = 10000000;
+	TripleBuffer<uint64_t> buffer;
+	StopWatch watch;
+	for (int i = 0; i < NUM_WRITES; i++) {
+		buffer.writeBuffer() = uint64_t(i);
+		buffer.publish();
+		buffer.update();
+	}
+	watch.stop();
+	std::cout << "TripleBuffer publish() + update(): "
+	          << (watch.getTimeNanoSeconds() / double(NUM_WRITES)) << " ns\n";
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sfz/util/IO.hpp"
+#include "sfz/util/MappedFile.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using std::string;
+using namespace sfz;
+
+static const string& mappedFileName()
+{
+	static const string name{"fjaoejfoajfeoajfaejfaoj.mapped"};
+	return name;
+}
+
+TEST_CASE("Mapping files", "[sfz::MappedFile]")
+{
+	const string filePath = basePath() + mappedFileName();
+	const char* fpath = filePath.c_str();
+
+	std::vector<uint8_t> data(100000);
+	for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i * 7);
+	REQUIRE(writeBinaryFile(fpath, data.data(), data.size()));
+
+	{
+		MappedFile file{fpath, FileAccessHint::SEQUENTIAL};
+		REQUIRE(file.isValid());
+		REQUIRE(file.isMapped());
+		REQUIRE(file.size() == data.size());
+		for (size_t i = 0; i < data.size(); i++) REQUIRE(file.data()[i] == data[i]);
+		file.advise(FileAccessHint::RANDOM);
+		REQUIRE(file.data()[1234] == data[1234]);
+
+		// Move
+		const uint8_t* ptr = file.data();
+		MappedFile moved = std::move(file);
+		REQUIRE(!file.isValid());
+		REQUIRE(file.data() == nullptr);
+		REQUIRE(moved.isValid());
+		REQUIRE(moved.data() == ptr);
+		REQUIRE((moved.end() - moved.begin()) == ptrdiff_t(data.size()));
+
+		moved.close();
+		REQUIRE(!moved.isValid());
+		REQUIRE(moved.size() == 0);
+	}
+
+	// Empty file
+	REQUIRE(writeBinaryFile(fpath, data.data(), 0));
+	{
+		MappedFile file{fpath};
+		REQUIRE(file.isValid());
+		REQUIRE(file.size() == 0);
+		REQUIRE(file.begin() == file.end());
+	}
+
+	REQUIRE(deleteFile(fpath));
+
+	// Non-existing file
+	MappedFile missing{fpath};
+	REQUIRE(!missing.isValid());
+	REQUIRE(missing.data() == nullptr);
+	REQUIRE(missing.size() == 0);
+
+#ifdef __linux__
+	// Special files can't be mapped and report size 0, but are read into a buffer anyway
+	MappedFile status{"/proc/self/status"};
+	REQUIRE(status.isValid());
+	REQUIRE(!status.isMapped());
+	REQUIRE(status.size() > 0);
+	REQUIRE(string(reinterpret_cast<const char*>(status.data()), 5) == "Name:");
+#endif
+}
+
+TEST_CASE("readBinaryFile() reads directly into memory", "[sfz::MappedFile]")
+{
+	const string filePath = basePath() + mappedFileName();
+	const char* fpath = filePath.c_str();
+
+	std::vector<uint8_t> data(50000);
+	for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i * 13);
+	REQUIRE(writeBinaryFile(fpath, data.data(), data.size()));
+
+	std::vector<uint8_t> read = readBinaryFile(fpath);
+	REQUIRE(read == data);
+
+	// Exactly fitting, too small and larger buffer
+	std::vector<uint8_t> buffer(data.size() + 10, 0);
+	REQUIRE(readBinaryFile(fpath, buffer.data(), data.size()) == 0);
+	REQUIRE(readBinaryFile(fpath, buffer.data(), data.size() - 1) == -2);
+	REQUIRE(buffer[data.size() - 2] == data[data.size() - 2]);
+	REQUIRE(readBinaryFile(fpath, buffer.data(), buffer.size()) == 0);
+	REQUIRE(std::equal(data.begin(), data.end(), buffer.begin()));
+
+	REQUIRE(deleteFile(fpath));
+	REQUIRE(readBinaryFile(fpath, buffer.data(), buffer.size()) == -1);
+}
+
+TEST_CASE("MappedFile vs readBinaryFile() benchmark", "[.][benchmark][sfz::MappedFile]")
+{
+	const string filePath = basePath() + mappedFileName();
+	const char* fpath = filePath.c_str();
+	std::vector<uint8_t> data(64 * 1024 * 1024);
+	for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i);
+	REQUIRE(writeBinaryFile(fpath, data.data(), data.size()));
+
+	StopWatch stopWatch;
+	uint64_t readSum = 0;
+	std::vector<uint8_t> read = readBinaryFile(fpath);
+	for (size_t i = 0; i < read.size(); i += 4096) readSum += read[i];
+	float readTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	uint64_t mappedSum = 0;
+	{
+		MappedFile file{fpath, FileAccessHint::SEQUENTIAL};
+		for (size_t i = 0; i < file.size(); i += 4096) mappedSum += file.data()[i];
+	}
+	float mappedTime = stopWatch.getTimeMilliSeconds();
+
+	std::cout << "Touching every page of a 64 MiB file (in page cache):"
+	          << "\nreadBinaryFile(): " << readTime << "ms"
+	          << "\nMappedFile: " << mappedTime << "ms" << std::endl;
+	REQUIRE(readSum == mappedSum);
+	REQUIRE(deleteFile(fpath));
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "sfz/util/MemoryTracking.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+
+TEST_CASE("Tagged allocations", "[sfz::MemoryTracking]")
+{
+	// AUDIO is not used by anything else in this test
+	const MemoryTagStats before = memoryTagStats(MemoryTag::AUDIO);
+
+	void* ptr = taggedAllocate(MemoryTag::AUDIO, 100, 64);
+	REQUIRE(ptr != nullptr);
+	REQUIRE((reinterpret_cast<uintptr_t>(ptr) % 64) == 0);
+	MemoryTagStats stats = memoryTagStats(MemoryTag::AUDIO);
+	REQUIRE(stats.bytes == before.bytes + 100);
+	REQUIRE(stats.numLiveAllocations == before.numLiveAllocations + 1);
+	REQUIRE(stats.numTotalAllocations == before.numTotalAllocations + 1);
+	REQUIRE(stats.peakBytes >= stats.bytes);
+	REQUIRE(stats.highWaterMark >= stats.bytes);
+
+	{
+		TaggedArray<float> arr = makeTaggedArray<float>(MemoryTag::AUDIO, 50);
+		REQUIRE(arr != nullptr);
+		arr[49] = 1.0f;
+		REQUIRE(memoryTagStats(MemoryTag::AUDIO).bytes == before.bytes + 100 + 50 * sizeof(float));
+	}
+	stats = memoryTagStats(MemoryTag::AUDIO);
+	REQUIRE(stats.bytes == before.bytes + 100);
+	REQUIRE(stats.peakBytes >= before.bytes + 100 + 50 * sizeof(float));
+	REQUIRE(stats.numLiveAllocations == before.numLiveAllocations + 1);
+	REQUIRE(stats.numTotalAllocations == before.numTotalAllocations + 2);
+
+	taggedDeallocate(ptr);
+	stats = memoryTagStats(MemoryTag::AUDIO);
+	REQUIRE(stats.bytes == before.bytes);
+	REQUIRE(stats.numLiveAllocations == before.numLiveAllocations);
+
+	// Peak is reset, high water mark is kept
+	resetMemoryPeaks();
+	stats = memoryTagStats(MemoryTag::AUDIO);
+	REQUIRE(stats.peakBytes == stats.bytes);
+	REQUIRE(stats.highWaterMark >= before.bytes + 100 + 50 * sizeof(float));
+
+	// Memory allocated by external libraries
+	trackAllocation(MemoryTag::AUDIO, 1000);
+	REQUIRE(memoryTagStats(MemoryTag::AUDIO).bytes == before.bytes + 1000);
+	REQUIRE(memoryTagStats(MemoryTag::AUDIO).peakBytes == before.bytes + 1000);
+	trackDeallocation(MemoryTag::AUDIO, 1000);
+	REQUIRE(memoryTagStats(MemoryTag::AUDIO).bytes == before.bytes);
+
+	void* empty = taggedAllocate(MemoryTag::AUDIO, 0);
+	REQUIRE(empty != nullptr);
+	taggedDeallocate(empty);
+	taggedDeallocate(nullptr);
+	REQUIRE(memoryTagStats(MemoryTag::AUDIO).numLiveAllocations == before.numLiveAllocations);
+}
+
+TEST_CASE("Tagged allocations from multiple threads", "[sfz::MemoryTracking]")
+{
+	const MemoryTagStats before = memoryTagStats(MemoryTag::IO);
+	std::thread threads[4];
+	for (std::thread& thread : threads) {
+		thread = std::thread([]() {
+			for (int i = 0; i < 1000; i++) {
+				void* ptr = taggedAllocate(MemoryTag::IO, 16);
+				taggedDeallocate(ptr);
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	MemoryTagStats stats = memoryTagStats(MemoryTag::IO);
+	REQUIRE(stats.bytes == before.bytes);
+	REQUIRE(stats.numLiveAllocations == before.numLiveAllocations);
+	REQUIRE(stats.numTotalAllocations == before.numTotalAllocations + 4000);
+	REQUIRE(stats.highWaterMark >= before.bytes + 16);
+	REQUIRE(stats.highWaterMark <= std::max(before.highWaterMark, before.bytes + 4 * 16));
+}
+
+TEST_CASE("Callstack capture", "[sfz::MemoryTracking]")
+{
+	REQUIRE(!memoryCallstackCapture());
+	void* uncaptured = taggedAllocate(MemoryTag::TEXTURES, 8);
+
+	setMemoryCallstackCapture(true);
+	void* captured1 = taggedAllocate(MemoryTag::TEXTURES, 16);
+	void* captured2 = taggedAllocate(MemoryTag::TEXTURES, 32);
+	setMemoryCallstackCapture(false);
+	REQUIRE(printLiveAllocations(MemoryTag::TEXTURES) == 2);
+	REQUIRE(printLiveAllocations(MemoryTag::GRAPHICS) == 0);
+
+	taggedDeallocate(captured1);
+	REQUIRE(printLiveAllocations(MemoryTag::TEXTURES) == 1);
+	taggedDeallocate(captured2);
+	taggedDeallocate(uncaptured);
+	REQUIRE(printLiveAllocations(MemoryTag::TEXTURES) == 0);
+}
+
+TEST_CASE("Frame allocation counting", "[sfz::MemoryTracking]")
+{
+	FrameAllocationCounter counter;
+
+	// Tagged allocations are always counted
+	counter.beginFrame();
+	void* ptr = taggedAllocate(MemoryTag::GENERAL, 32);
+	counter.endFrame();
+	taggedDeallocate(ptr);
+	REQUIRE(counter.lastFrame().numAllocations == 1);
+	REQUIRE(counter.lastFrame().numBytes == 32);
+
+#ifdef SFZ_ALLOCATION_COUNTING
+	// Explicit calls, the compiler may elide the allocations of matching new/delete expressions
+	counter.beginFrame();
+	void* i = ::operator new(sizeof(int));
+	void* arr = ::operator new[](8 * sizeof(int));
+	counter.endFrame();
+	::operator delete(i);
+	::operator delete[](arr);
+	REQUIRE(counter.lastFrame().numAllocations == 2);
+	REQUIRE(counter.lastFrame().numBytes == 9 * sizeof(int));
+#endif
+
+	// Allocations of other threads are not counted, the thread is started before the frame since
+	// creating it allocates
+	std::atomic<bool> start{false}, done{false};
+	std::thread thread([&start, &done]() {
+		while (!start) std::this_thread::yield();
+		std::unique_ptr<int> i(new int(3));
+		taggedDeallocate(taggedAllocate(MemoryTag::GENERAL, 32));
+		done = true;
+	});
+	const uint64_t numFramesBefore = counter.numFrames();
+	counter.setExpectZeroAllocations(true);
+	counter.beginFrame();
+	start = true;
+	while (!done) std::this_thread::yield();
+	counter.endFrame();
+	thread.join();
+	REQUIRE(counter.lastFrame().numAllocations == 0);
+	REQUIRE(counter.numUnexpectedAllocationFrames() == 0);
+	REQUIRE(counter.numFrames() == numFramesBefore + 1);
+
+	const AllocationCount total = threadAllocationCount();
+	REQUIRE(total.numAllocations >= 1);
+	REQUIRE(total.numBytes >= 32);
+}
+
+TEST_CASE("MemoryTracking performance", "[.][benchmark][sfz::MemoryTracking]")
+{
+	const int NUM_ITERATIONS = 1000000;
+	std::atomic<int> dummy{0};
+
+	StopWatch watch;
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		void* ptr = ::operator new(64);
+		dummy += int(reinterpret_cast<uintptr_t>(ptr) & 1);
+		::operator delete(ptr);
+	}
+	watch.stop();
+	std::cout << "operator new/delete: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		void* ptr = taggedAllocate(MemoryTag::GENERAL, 64);
+		dummy += int(reinterpret_cast<uintptr_t>(ptr) & 1);
+		taggedDeallocate(ptr);
+	}
+	watch.stop();
+	std::cout << "taggedAllocate/taggedDeallocate: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	setMemoryCallstackCapture(true);
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS / 10; i++) {
+		void* ptr = taggedAllocate(MemoryTag::GENERAL, 64);
+		dummy += int(reinterpret_cast<uintptr_t>(ptr) & 1);
+		taggedDeallocate(ptr);
+	}
+	watch.stop();
+	setMemoryCallstackCapture(false);
+	std::cout << "taggedAllocate/taggedDeallocate with callstacks: "
+	          << (watch.getTimeNanoSeconds() / (NUM_ITERATIONS / 10)) << " ns\n";
+}
\ No newline at end of file
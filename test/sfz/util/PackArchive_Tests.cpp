@@ -0,0 +1,242 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sfz/util/IO.hpp"
+#include "sfz/util/PackArchive.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using std::string;
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static const string& looseDir()
+{
+	static const string dir = basePath() + "jfoeajfoaejfoa_pack_dir";
+	return dir;
+}
+
+static const string& packPath()
+{
+	static const string path = basePath() + "jfoeajfoaejfoa_test.pack";
+	return path;
+}
+
+static string assetName(size_t index)
+{
+	return "asset_" + std::to_string(index) + ".bin";
+}
+
+static vector<uint8_t> assetData(size_t index, size_t size)
+{
+	vector<uint8_t> data;
+	data.reserve(size);
+	for (size_t i = 0; i < size; i++) data.push_back(uint8_t(i * 17 + index));
+	return data;
+}
+
+static vector<string> writeAssets(size_t count, size_t size)
+{
+	REQUIRE((directoryExists(looseDir().c_str()) || createDirectory(looseDir().c_str())));
+	vector<string> names;
+	for (size_t i = 0; i < count; i++) {
+		vector<uint8_t> data = assetData(i, size + i);
+		names.push_back(assetName(i));
+		REQUIRE(writeBinaryFile((looseDir() + "/" + names.back()).c_str(), data.data(), data.size()));
+	}
+	return names;
+}
+
+static void deleteAssets(size_t count)
+{
+	for (size_t i = 0; i < count; i++) REQUIRE(deleteFile((looseDir() + "/" + assetName(i)).c_str()));
+	REQUIRE(deleteDirectory(looseDir().c_str()));
+}
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Writing and reading pack archives", "[sfz::PackArchive]")
+{
+	const size_t NUM_ASSETS = 100;
+	vector<string> names = writeAssets(NUM_ASSETS, 100);
+	const uint8_t dummy = 0;
+	REQUIRE(writeBinaryFile((looseDir() + "/empty.txt").c_str(), &dummy, 0));
+	names.push_back("./empty.txt");
+	REQUIRE(writePackArchive(packPath().c_str(), looseDir().c_str(), names, 64));
+
+	PackArchive pack{packPath().c_str()};
+	REQUIRE(pack.isValid());
+	REQUIRE(pack.hasPack());
+	REQUIRE(!pack.looseFallbackEnabled());
+	REQUIRE(pack.numEntries() == NUM_ASSETS + 1);
+
+	for (size_t i = 0; i < NUM_ASSETS; i++) {
+		AssetView view = pack.find(assetName(i).c_str());
+		REQUIRE(view.found);
+		REQUIRE(view.size == 100 + i);
+		REQUIRE((uintptr_t(view.data) % 64) == 0);
+		vector<uint8_t> expected = assetData(i, 100 + i);
+		REQUIRE(std::equal(view.begin(), view.end(), expected.begin()));
+		REQUIRE(pack.sizeofFile(assetName(i).c_str()) == int64_t(100 + i));
+		REQUIRE(!view.compressed);
+	}
+	vector<uint8_t> data;
+	REQUIRE(pack.read(assetName(5).c_str(), data));
+	REQUIRE(data == assetData(5, 105));
+
+	// Normalized paths, empty files and missing files
+	REQUIRE(pack.exists("empty.txt"));
+	REQUIRE(pack.exists("/empty.txt"));
+	REQUIRE(pack.exists(".\\empty.txt"));
+	REQUIRE(pack.sizeofFile("empty.txt") == 0);
+	REQUIRE(pack.find("empty.txt").data == nullptr);
+	REQUIRE(!pack.exists("EMPTY.txt"));
+	REQUIRE(!pack.exists("missing.bin"));
+	REQUIRE(pack.sizeofFile("missing.bin") == -1);
+	REQUIRE(PackArchive::hashPath("a\\b.txt") == PackArchive::hashPath("a/b.txt"));
+
+	// Entries are sorted by hash
+	for (uint32_t i = 1; i < pack.numEntries(); i++) {
+		REQUIRE(PackArchive::hashPath(pack.entryPath(i - 1).c_str()) <=
+		        PackArchive::hashPath(pack.entryPath(i).c_str()));
+	}
+
+	// Invalid input
+	REQUIRE(!writePackArchive(packPath().c_str(), looseDir().c_str(), {"missing.bin"}));
+	REQUIRE(!writePackArchive(packPath().c_str(), looseDir().c_str(), {"empty.txt", "/empty.txt"}));
+	REQUIRE(!writePackArchive(packPath().c_str(), looseDir().c_str(), {"empty.txt"}, 3));
+
+	REQUIRE(deleteFile((looseDir() + "/empty.txt").c_str()));
+	deleteAssets(NUM_ASSETS);
+}
+
+TEST_CASE("Compressed entries", "[sfz::PackArchive]")
+{
+	vector<string> names = writeAssets(3, 1000);
+	vector<uint8_t> zeroes(100000, 0);
+	REQUIRE(writeBinaryFile((looseDir() + "/zeroes.bin").c_str(), zeroes.data(), zeroes.size()));
+	names.push_back("zeroes.bin");
+	REQUIRE(writePackArchive(packPath().c_str(), looseDir().c_str(), names, 16, true));
+
+	PackArchive pack{packPath().c_str()};
+	REQUIRE(pack.hasPack());
+	AssetView view = pack.find("zeroes.bin");
+	REQUIRE(view.found);
+	REQUIRE(view.compressed);
+	REQUIRE(view.size < 1000);
+	REQUIRE(view.uncompressedSize == zeroes.size());
+	REQUIRE(pack.sizeofFile("zeroes.bin") == int64_t(zeroes.size()));
+	vector<uint8_t> data;
+	REQUIRE(pack.read("zeroes.bin", data));
+	REQUIRE(data == zeroes);
+
+	for (size_t i = 0; i < 3; i++) {
+		REQUIRE(pack.read(assetName(i).c_str(), data));
+		REQUIRE(data == assetData(i, 1000 + i));
+	}
+	REQUIRE(!pack.read("missing.bin", data));
+
+	REQUIRE(deleteFile((looseDir() + "/zeroes.bin").c_str()));
+	REQUIRE(deleteFile(packPath().c_str()));
+	deleteAssets(3);
+}
+
+TEST_CASE("Loose file fallback", "[sfz::PackArchive]")
+{
+	vector<string> names = writeAssets(4, 10);
+	names.pop_back();
+	REQUIRE(writePackArchive(packPath().c_str(), looseDir().c_str(), names));
+
+	// Files missing from the archive are read from the loose directory
+	{
+		PackArchive pack{packPath().c_str(), looseDir().c_str()};
+		REQUIRE(pack.hasPack());
+		REQUIRE(pack.looseFallbackEnabled());
+		REQUIRE(pack.numEntries() == 3);
+		AssetView view = pack.find(assetName(3).c_str());
+		REQUIRE(view.found);
+		REQUIRE(view.size == 13);
+		REQUIRE(view.data[5] == assetData(3, 13)[5]);
+		REQUIRE(pack.find(assetName(3).c_str()).data == view.data);
+		REQUIRE(!pack.exists("missing.bin"));
+
+		PackArchive strict{packPath().c_str()};
+		REQUIRE(!strict.exists(assetName(3).c_str()));
+	}
+
+	// Missing archive
+	REQUIRE(deleteFile(packPath().c_str()));
+	{
+		PackArchive missing{packPath().c_str()};
+		REQUIRE(!missing.isValid());
+		REQUIRE(!missing.exists(assetName(0).c_str()));
+
+		PackArchive loose{packPath().c_str(), looseDir().c_str()};
+		REQUIRE(loose.isValid());
+		REQUIRE(!loose.hasPack());
+		REQUIRE(loose.numEntries() == 0);
+		REQUIRE(loose.sizeofFile(assetName(0).c_str()) == 10);
+	}
+
+	// Corrupt archive, the header is otherwise valid so only the entry count is rejected
+	uint8_t garbage[64] = {'S', 'F', 'Z', 'P', 'A', 'C', 'K', '\0',
+	                       uint8_t(PackArchive::VERSION), 0, 0, 0, 16, 0, 0, 0};
+	REQUIRE(writeBinaryFile(packPath().c_str(), garbage, sizeof(garbage)));
+	REQUIRE(PackArchive{packPath().c_str()}.isValid());
+	garbage[16] = 255; // numEntries larger than the file
+	REQUIRE(writeBinaryFile(packPath().c_str(), garbage, sizeof(garbage)));
+	{
+		PackArchive corrupt{packPath().c_str()};
+		REQUIRE(!corrupt.isValid());
+		REQUIRE(corrupt.numEntries() == 0);
+	}
+
+	REQUIRE(deleteFile(packPath().c_str()));
+	deleteAssets(4);
+}
+
+// Benchmarks (hidden, run with "[benchmark]")
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Loose files vs pack archive benchmark", "[.][benchmark][sfz::PackArchive]")
+{
+	const size_t NUM_ASSETS = 2000;
+	vector<string> names = writeAssets(NUM_ASSETS, 8 * 1024);
+	REQUIRE(writePackArchive(packPath().c_str(), looseDir().c_str(), names));
+
+	StopWatch stopWatch;
+	uint64_t looseSum = 0;
+	for (const string& name : names) {
+		string path = looseDir() + "/" + name;
+		if (!fileExists(path.c_str())) continue;
+		vector<uint8_t> data(size_t(sfz::sizeofFile(path.c_str())));
+		readBinaryFile(path.c_str(), data.data(), data.size());
+		for (uint8_t b : data) looseSum += b;
+	}
+	float looseTime = stopWatch.getTimeMilliSeconds();
+
+	stopWatch.start();
+	uint64_t packSum = 0;
+	{
+		PackArchive pack{packPath().c_str()};
+		for (const string& name : names) {
+			AssetView view = pack.find(name.c_str());
+			if (!view.found) continue;
+			for (uint8_t b : view) packSum += b;
+		}
+	}
+	float packTime = stopWatch.getTimeMilliSeconds();
+
+	std::cout << NUM_ASSETS << " files of ~8 KiB (in page cache):"
+	          << "\nfileExists() + sizeofFile() + readBinaryFile(): " << looseTime << "ms"
+	          << "\nPackArchive: " << packTime << "ms" << std::endl;
+	REQUIRE(looseSum == packSum);
+	REQUIRE(deleteFile(packPath().c_str()));
+	deleteAssets(NUM_ASSETS);
+}
\ No newline at end of file
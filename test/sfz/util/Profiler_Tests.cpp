@@ -0,0 +1,223 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sfz/util/IO.hpp"
+#include "sfz/util/Profiler.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using std::string;
+using namespace sfz;
+
+// Helpers
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+static void sleepMs(int ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static const ProfileZoneStats* findStats(const vector<ProfileZoneStats>& stats, const char* name)
+{
+	for (const ProfileZoneStats& s : stats) {
+		if (std::strcmp(s.name, name) == 0) return &s;
+	}
+	return nullptr;
+}
+
+static const uint64_t MS = 1000000;
+
+// Tests
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+TEST_CASE("Nested zones", "[sfz::Profiler]")
+{
+	Profiler& profiler = Profiler::instance();
+	profiler.clear();
+
+	{
+		sfz_profile_zone("Outer");
+		sleepMs(5);
+		for (int i = 0; i < 3; i++) {
+			sfz_profile_zone("Inner");
+			sleepMs(5);
+		}
+	}
+
+	vector<ProfileZoneStats> stats = profiler.zoneStats(0);
+	REQUIRE(stats.size() == 2);
+	REQUIRE(std::strcmp(stats[0].name, "Outer") == 0);
+	const ProfileZoneStats* outer = findStats(stats, "Outer");
+	const ProfileZoneStats* inner = findStats(stats, "Inner");
+	REQUIRE(inner != nullptr);
+
+	REQUIRE(outer->count == 1);
+	REQUIRE(outer->totalNs >= 20 * MS);
+	REQUIRE(outer->minNs == outer->totalNs);
+	REQUIRE(outer->maxNs == outer->totalNs);
+	REQUIRE(outer->selfNs >= 5 * MS);
+	REQUIRE(outer->selfNs == outer->totalNs - inner->totalNs);
+
+	REQUIRE(inner->count == 3);
+	REQUIRE(inner->selfNs == inner->totalNs);
+	REQUIRE(inner->minNs >= 5 * MS);
+	REQUIRE(inner->minNs <= inner->maxNs);
+	REQUIRE(inner->totalNs >= 3 * inner->minNs);
+
+	// Disabled at runtime
+	profiler.clear();
+	profiler.setEnabled(false);
+	{
+		sfz_profile_zone("Disabled");
+	}
+	profiler.setEnabled(true);
+	REQUIRE(profiler.zoneStats(0).empty());
+}
+
+TEST_CASE("Frames", "[sfz::Profiler]")
+{
+	Profiler& profiler = Profiler::instance();
+	profiler.clear();
+	REQUIRE(profiler.numFrames() == 0);
+
+	for (int frame = 0; frame < 4; frame++) {
+		sfz_profile_frame();
+		sfz_profile_zone("Frame work");
+		for (int i = 0; i <= frame; i++) {
+			sfz_profile_zone("Per frame");
+		}
+	}
+	sfz_profile_frame();
+	REQUIRE(profiler.numFrames() == 5);
+
+	// Only the last complete frames are aggregated
+	vector<ProfileZoneStats> stats = profiler.zoneStats(1);
+	REQUIRE(findStats(stats, "Per frame") != nullptr);
+	REQUIRE(findStats(stats, "Per frame")->count == 4);
+	stats = profiler.zoneStats(2);
+	REQUIRE(findStats(stats, "Per frame")->count == 7);
+	REQUIRE(findStats(stats, "Frame work")->count == 2);
+	stats = profiler.zoneStats(4);
+	REQUIRE(findStats(stats, "Per frame")->count == 10);
+	stats = profiler.zoneStats(10);
+	REQUIRE(findStats(stats, "Per frame")->count == 10);
+}
+
+TEST_CASE("Multiple threads", "[sfz::Profiler]")
+{
+	Profiler& profiler = Profiler::instance();
+	profiler.clear();
+
+	const int NUM_THREADS = 4, NUM_ZONES = 1000;
+	vector<std::thread> threads;
+	for (int t = 0; t < NUM_THREADS; t++) {
+		threads.emplace_back([&]() {
+			for (int i = 0; i < NUM_ZONES; i++) {
+				sfz_profile_zone("Thread zone");
+				sfz_profile_zone("Nested thread zone");
+			}
+		});
+	}
+
+	// Aggregation while recording only returns completely written events
+	for (int i = 0; i < 10; i++) {
+		for (const ProfileZoneStats& stats : profiler.zoneStats(0)) {
+			REQUIRE(stats.name != nullptr);
+			REQUIRE(stats.minNs <= stats.maxNs);
+		}
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	vector<ProfileZoneStats> stats = profiler.zoneStats(0);
+	REQUIRE(stats.size() == 2);
+	REQUIRE(findStats(stats, "Thread zone")->count == NUM_THREADS * NUM_ZONES);
+	REQUIRE(findStats(stats, "Nested thread zone")->count == NUM_THREADS * NUM_ZONES);
+	REQUIRE(stats[0].totalNs >= stats[1].totalNs);
+}
+
+TEST_CASE("Ring buffer overflow", "[sfz::Profiler]")
+{
+	Profiler& profiler = Profiler::instance();
+	profiler.setEventsPerThread(100);
+	std::thread thread([&]() {
+		for (int i = 0; i < 1000; i++) {
+			sfz_profile_zone("Overflowing");
+		}
+	});
+	thread.join();
+	profiler.setEventsPerThread(Profiler::DEFAULT_EVENTS_PER_THREAD);
+
+	// Rounded up to power of two, only the most recent events are kept
+	vector<ProfileZoneStats> stats = profiler.zoneStats(0);
+	REQUIRE(findStats(stats, "Overflowing") != nullptr);
+	REQUIRE(findStats(stats, "Overflowing")->count == 128);
+}
+
+TEST_CASE("Chrome trace export", "[sfz::Profiler]")
+{
+	Profiler& profiler = Profiler::instance();
+	profiler.clear();
+	profiler.setThreadName("Main \"thread\"");
+	sfz_profile_frame();
+	{
+		sfz_profile_function();
+		sfz_profile_zone("Zone");
+	}
+	sfz_profile_frame();
+
+	const string path = basePath() + "feajfoeajofajoe_trace.json";
+	REQUIRE(profiler.writeChromeTrace(path.c_str()));
+	vector<uint8_t> data = readBinaryFile(path.c_str());
+	const string json(data.begin(), data.end());
+	REQUIRE(deleteFile(path.c_str()));
+
+	REQUIRE(json.find("{\"traceEvents\":[") == 0);
+	REQUIRE(json.find("\"name\":\"Main \\\"thread\\\"\"") != string::npos);
+	REQUIRE(json.find("{\"name\":\"Zone\",\"ph\":\"X\"") != string::npos);
+	REQUIRE(json.find("\"ph\":\"i\"") != string::npos);
+	REQUIRE(json.find("\"dur\":") != string::npos);
+	REQUIRE(json.find("],\"displayTimeUnit\":\"ms\"}") != string::npos);
+
+	size_t numOpen = 0, numClose = 0;
+	for (char c : json) {
+		if (c == '{') numOpen++;
+		if (c == '}') numClose++;
+	}
+	REQUIRE(numOpen == numClose);
+}
+
+TEST_CASE("Profiler overhead", "[.][benchmark][sfz::Profiler]")
+{
+	Profiler& profiler = Profiler::instance();
+	const int NUM_ZONES = 10000000;
+	StopWatch watch;
+
+	profiler.clear();
+	watch.start();
+	for (int i = 0; i < NUM_ZONES; i++) {
+		sfz_profile_zone("Benchmark zone");
+	}
+	watch.stop();
+	std::cout << "Enabled zone: " << (watch.getTimeNanoSeconds() / NUM_ZONES) << " ns\n";
+
+	profiler.setEnabled(false);
+	watch.start();
+	for (int i = 0; i < NUM_ZONES; i++) {
+		sfz_profile_zone("Benchmark zone");
+	}
+	watch.stop();
+	profiler.setEnabled(true);
+	std::cout << "Disabled zone: " << (watch.getTimeNanoSeconds() / NUM_ZONES) << " ns\n";
+
+	watch.start();
+	vector<ProfileZoneStats> stats = profiler.zoneStats(0);
+	watch.stop();
+	std::cout << "Aggregating " << stats[0].count << " zones: " << watch.getTimeMilliSeconds()
+	          << " ms\n";
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sfz/util/SmallVector.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+using std::string;
+
+TEST_CASE("SmallVector inline storage", "[sfz::SmallVector]")
+{
+	SmallVector<int, 4> vec;
+	REQUIRE(vec.size() == 0);
+	REQUIRE(vec.capacity() == 4);
+	REQUIRE(vec.isInline());
+
+	for (int i = 0; i < 4; i++) vec.push_back(i);
+	REQUIRE(vec.isInline());
+	REQUIRE(vec.size() == 4);
+	REQUIRE(vec.front() == 0);
+	REQUIRE(vec.back() == 3);
+
+	vec.push_back(4);
+	REQUIRE(!vec.isInline());
+	REQUIRE(vec.capacity() >= 5);
+	for (int i = 0; i < 5; i++) REQUIRE(vec[i] == i);
+
+	// Stays on the heap once there
+	vec.clear();
+	REQUIRE(vec.size() == 0);
+	REQUIRE(!vec.isInline());
+
+	// Pushing an element of the vector itself while growing
+	SmallVector<int, 1> small;
+	small.push_back(7);
+	small.push_back(small[0]);
+	REQUIRE(small.size() == 2);
+	REQUIRE(small[1] == 7);
+}
+
+TEST_CASE("SmallVector copy and move", "[sfz::SmallVector]")
+{
+	SECTION("Inline") {
+		SmallVector<string, 4> vec{"a", "b", "c"};
+		SmallVector<string, 4> copy(vec);
+		REQUIRE(copy == vec);
+		SmallVector<string, 4> moved(std::move(vec));
+		REQUIRE(moved == copy);
+		REQUIRE(moved.isInline());
+		REQUIRE(vec.size() == 0);
+	}
+	SECTION("Heap") {
+		SmallVector<string, 2> vec{"a", "b", "c", "d"};
+		REQUIRE(!vec.isInline());
+		const string* data = vec.data();
+		SmallVector<string, 2> copy;
+		copy = vec;
+		REQUIRE(copy == vec);
+		SmallVector<string, 2> moved;
+		moved = std::move(vec);
+		REQUIRE(moved.data() == data);
+		REQUIRE(moved == copy);
+		REQUIRE(vec.isInline());
+		REQUIRE(vec.size() == 0);
+		vec.push_back("e");
+		REQUIRE(vec[0] == "e");
+	}
+	SECTION("Move only elements") {
+		SmallVector<std::unique_ptr<int>, 2> vec;
+		for (int i = 0; i < 10; i++) vec.emplace_back(new int(i));
+		SmallVector<std::unique_ptr<int>, 2> moved(std::move(vec));
+		for (int i = 0; i < 10; i++) REQUIRE(*moved[i] == i);
+		moved.pop_back();
+		REQUIRE(moved.size() == 9);
+	}
+}
+
+TEST_CASE("SmallVector resize and reserve", "[sfz::SmallVector]")
+{
+	SmallVector<int, 8> vec;
+	vec.resize(3);
+	REQUIRE(vec.size() == 3);
+	for (int value : vec) REQUIRE(value == 0);
+	vec.reserve(100);
+	REQUIRE(vec.capacity() >= 100);
+	REQUIRE(vec.size() == 3);
+	vec.resize(1);
+	REQUIRE(vec.size() == 1);
+}
+
+TEST_CASE("SmallVector performance", "[.][benchmark][sfz::SmallVector]")
+{
+	const int NUM_ITERATIONS = 1000000;
+	volatile int dummy = 0;
+
+	StopWatch watch;
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		std::vector<int> vec;
+		for (int j = 0; j < 8; j++) vec.push_back(j);
+		dummy = dummy + vec[i & 7];
+	}
+	watch.stop();
+	std::cout << "std::vector 8 push_backs: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		SmallVector<int, 8> vec;
+		for (int j = 0; j < 8; j++) vec.push_back(j);
+		dummy = dummy + vec[i & 7];
+	}
+	watch.stop();
+	std::cout << "SmallVector<int, 8> 8 push_backs: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <array>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "sfz/util/StaticVector.hpp"
+#include "sfz/util/StopWatch.hpp"
+
+using namespace sfz;
+using std::string;
+
+TEST_CASE("StaticVector basics", "[sfz::StaticVector]")
+{
+	StaticVector<string, 4> vec;
+	REQUIRE(vec.size() == 0);
+	REQUIRE(vec.capacity() == 4);
+	REQUIRE(vec.empty());
+
+	vec.push_back("a");
+	vec.emplace_back(3, 'b');
+	REQUIRE(vec.size() == 2);
+	REQUIRE(vec[0] == "a");
+	REQUIRE(vec.back() == "bbb");
+	vec.push_back("c");
+	vec.push_back("d");
+	REQUIRE(vec.full());
+
+	vec.pop_back();
+	REQUIRE(vec.size() == 3);
+	REQUIRE(vec.back() == "c");
+
+	vec.resize(4);
+	REQUIRE(vec.back() == "");
+	vec.resize(1);
+	REQUIRE(vec.size() == 1);
+	vec.clear();
+	REQUIRE(vec.empty());
+}
+
+TEST_CASE("StaticVector copy and move", "[sfz::StaticVector]")
+{
+	StaticVector<string, 4> vec{"a", "b", "c"};
+	StaticVector<string, 4> copy(vec);
+	REQUIRE(copy == vec);
+	StaticVector<string, 4> moved(std::move(vec));
+	REQUIRE(moved == copy);
+	REQUIRE(vec.empty());
+	vec = moved;
+	REQUIRE(vec == moved);
+	copy = std::move(moved);
+	REQUIRE(moved.empty());
+	REQUIRE(copy != moved);
+
+	StaticVector<std::unique_ptr<int>, 2> pointers;
+	pointers.emplace_back(new int(1));
+	pointers.emplace_back(new int(2));
+	StaticVector<std::unique_ptr<int>, 2> movedPointers(std::move(pointers));
+	REQUIRE(*movedPointers[0] == 1);
+	REQUIRE(*movedPointers[1] == 2);
+}
+
+TEST_CASE("StaticVector performance", "[.][benchmark][sfz::StaticVector]")
+{
+	const int NUM_ITERATIONS = 1000000;
+	volatile int dummy = 0;
+
+	// std::array default constructs all its elements, StaticVector only constructs the used ones
+	StopWatch watch;
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		std::array<string, 16> arr;
+		arr[0] = "a";
+		dummy = dummy + int(arr[0].size());
+	}
+	watch.stop();
+	std::cout << "std::array<string, 16> with 1 element: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		StaticVector<string, 16> vec;
+		vec.push_back("a");
+		dummy = dummy + int(vec[0].size());
+	}
+	watch.stop();
+	std::cout << "StaticVector<string, 16> with 1 element: "
+	          << (watch.getTimeNanoSeconds() / NUM_ITERATIONS) << " ns\n";
+}
\ No newline at end of file
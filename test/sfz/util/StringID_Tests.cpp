@@ -0,0 +1,115 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "sfz/util/HashMap.hpp"
+#include "sfz/util/StopWatch.hpp"
+#include "sfz/util/StringID.hpp"
+
+using namespace sfz;
+using std::string;
+
+// Evaluated at compile time
+static_assert(fnv1aHash("") == 0xCBF29CE484222325ull, "FNV-1a of empty string");
+static_assert(fnv1aHash("a") == 0xAF63DC4C8601EC8Cull, "FNV-1a of \"a\"");
+static_assert(fnv1aHash("foobar") == 0x85944171F73967E8ull, "FNV-1a of \"foobar\"");
+static_assert(StringID("foobar") == "foobar"_sid, "StringID from literal");
+static_assert(StringID("foobar", 3) == StringID("foo"), "StringID from length");
+
+TEST_CASE("StringID hashing", "[sfz::StringID]")
+{
+	const string str = "uProjMatrix";
+	constexpr StringID PROJ_MATRIX("uProjMatrix");
+	REQUIRE(StringID(str.c_str()) == PROJ_MATRIX);
+	REQUIRE(StringID(str.c_str(), str.size()) == PROJ_MATRIX);
+	REQUIRE(StringID(str.c_str(), str.size()) == "uProjMatrix"_sid);
+	REQUIRE(StringID("uViewMatrix") != PROJ_MATRIX);
+	REQUIRE(StringID() == StringID(uint64_t(0)));
+
+	HashMap<StringID, int> map;
+	map.put("a"_sid, 1);
+	map.put("b"_sid, 2);
+	REQUIRE(*map.get(StringID("a")) == 1);
+	REQUIRE(*map.get(StringID("b")) == 2);
+	REQUIRE(map.get(StringID("c")) == nullptr);
+}
+
+TEST_CASE("StringID intern table", "[sfz::StringID]")
+{
+	REQUIRE(internedString("notInterned"_sid) == nullptr);
+
+	const size_t numBefore = numInternedStrings();
+	StringID id = internString("textures/player.png");
+	REQUIRE(id == "textures/player.png"_sid);
+	REQUIRE(std::strcmp(internedString(id), "textures/player.png") == 0);
+	REQUIRE(numInternedStrings() == numBefore + 1);
+
+	// Interning again returns the same string
+	const char* first = internedString(id);
+	REQUIRE(internString(string("textures/player.png").c_str()) == id);
+	REQUIRE(internedString(id) == first);
+	REQUIRE(numInternedStrings() == numBefore + 1);
+
+	// Only the specified length is interned
+	StringID partial = internString("textures/enemy.png.bak", 18);
+	REQUIRE(partial == "textures/enemy.png"_sid);
+	REQUIRE(std::strcmp(internedString(partial), "textures/enemy.png") == 0);
+
+	// Interning from multiple threads
+	std::atomic<bool> allCorrect{true};
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&allCorrect]() {
+			for (int i = 0; i < 500; i++) {
+				string name = "name" + std::to_string(i);
+				StringID id = internString(name.c_str());
+				const char* interned = internedString(id);
+				if (interned == nullptr || name != interned) allCorrect = false;
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+	REQUIRE(allCorrect);
+	REQUIRE(numInternedStrings() == numBefore + 2 + 500);
+}
+
+TEST_CASE("StringID performance", "[.][benchmark][sfz::StringID]")
+{
+	const int NUM_ITERATIONS = 10000;
+	volatile int dummy = 0;
+
+	std::vector<string> names;
+	std::vector<StringID> ids;
+	std::unordered_map<string, int> stringMap;
+	HashMap<StringID, int> idMap;
+	for (int i = 0; i < 100; i++) {
+		names.push_back("textures/sprite_" + std::to_string(i) + ".png");
+		ids.push_back(internString(names.back().c_str()));
+		stringMap[names.back()] = i;
+		idMap.put(ids.back(), i);
+	}
+
+	StopWatch watch;
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		for (const string& name : names) dummy = dummy + stringMap.find(name)->second;
+	}
+	watch.stop();
+	std::cout << "std::unordered_map<string> lookup: "
+	          << (watch.getTimeNanoSeconds() / (NUM_ITERATIONS * 100)) << " ns\n";
+
+	watch.start();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		for (StringID id : ids) dummy = dummy + *idMap.get(id);
+	}
+	watch.stop();
+	std::cout << "HashMap<StringID> lookup: "
+	          << (watch.getTimeNanoSeconds() / (NUM_ITERATIONS * 100)) << " ns\n";
+}
\ No newline at end of file
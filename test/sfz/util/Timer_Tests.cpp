@@ -0,0 +1,141 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include "sfz/util/StopWatch.hpp"
+#include "sfz/util/Timer.hpp"
+
+using namespace sfz;
+
+static void sleepMs(int ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+TEST_CASE("Timer ticks", "[sfz::Timer]")
+{
+	const TimerInfo& info = timerInfo();
+	REQUIRE(info.ticksPerSecond >= 100000000);
+	REQUIRE(info.secondsPerTick == Approx(1.0 / double(info.ticksPerSecond)));
+	REQUIRE(info.nanosecondsPerTick == Approx(1e9 / double(info.ticksPerSecond)));
+	REQUIRE(secondsToTicks(1.0) == info.ticksPerSecond);
+
+	// Monotonic
+	uint64_t previous = timerTicks();
+	for (int i = 0; i < 100000; i++) {
+		uint64_t current = timerTicks();
+		REQUIRE(current >= previous);
+		previous = current;
+	}
+
+	// Agrees with steady_clock
+	using namespace std::chrono;
+	const auto clockBegin = steady_clock::now();
+	const uint64_t ticksBegin = timerTicks();
+	sleepMs(50);
+	const uint64_t ticksEnd = timerTicks();
+	const auto clockEnd = steady_clock::now();
+	const double clockSeconds = duration<double>(clockEnd - clockBegin).count();
+	const double timerSeconds = ticksToSeconds(ticksEnd - ticksBegin);
+	REQUIRE(timerSeconds <= clockSeconds);
+	REQUIRE(std::abs(timerSeconds - clockSeconds) < 0.001 + 0.01 * clockSeconds);
+	REQUIRE(ticksToMilliseconds(ticksEnd - ticksBegin) == Approx(timerSeconds * 1000.0));
+	REQUIRE(ticksToNanoseconds(ticksEnd - ticksBegin) == Approx(timerSeconds * 1e9));
+}
+
+TEST_CASE("TimeAccumulator and ScopedTimer", "[sfz::Timer]")
+{
+	TimeAccumulator accumulator;
+	REQUIRE(accumulator.count() == 0);
+	REQUIRE(accumulator.averageNanoseconds() == 0.0);
+
+	for (int i = 0; i < 3; i++) {
+		ScopedTimer timer{accumulator};
+		sleepMs(5);
+	}
+	accumulator.begin();
+	sleepMs(5);
+	accumulator.end();
+	sleepMs(20); // Not accumulated
+
+	REQUIRE(accumulator.count() == 4);
+	REQUIRE(accumulator.totalSeconds() >= 0.020);
+	REQUIRE(accumulator.totalSeconds() < 0.040);
+	REQUIRE(accumulator.totalMilliseconds() == Approx(accumulator.totalSeconds() * 1000.0));
+	REQUIRE(accumulator.averageNanoseconds() >= 5e6);
+
+	accumulator.reset();
+	REQUIRE(accumulator.count() == 0);
+	REQUIRE(accumulator.totalTicks() == 0);
+}
+
+TEST_CASE("StopWatch laps", "[sfz::StopWatch]")
+{
+	StopWatch watch;
+	sleepMs(5);
+	const uint64_t lap1 = watch.lapTicks();
+	sleepMs(10);
+	const float lap2 = watch.lapSeconds();
+	watch.stop();
+	const uint64_t total = watch.getTimeTicks();
+
+	REQUIRE(ticksToSeconds(lap1) >= 0.005);
+	REQUIRE(lap2 >= 0.010f);
+	REQUIRE(total >= lap1 + secondsToTicks(lap2) - 1);
+	REQUIRE(watch.getTimeSeconds() == Approx(ticksToSeconds(total)));
+	REQUIRE(watch.getTimeMilliSeconds() == Approx(ticksToMilliseconds(total)));
+
+	// Stopped, time does not change
+	sleepMs(5);
+	REQUIRE(watch.getTimeTicks() == total);
+
+	// Restarting resets laps
+	watch.start();
+	REQUIRE(ticksToSeconds(watch.lapTicks()) < 0.005);
+}
+
+TEST_CASE("Timer overhead", "[.][benchmark][sfz::Timer]")
+{
+	const int NUM_ITERATIONS = 10000000;
+	std::cout << "Timer uses TSC: " << timerInfo().usesTsc << ", "
+	          << (double(timerInfo().ticksPerSecond) / 1e9) << " GHz\n";
+
+	using namespace std::chrono;
+	uint64_t dummy = 0;
+	auto begin = steady_clock::now();
+	for (int i = 0; i < NUM_ITERATIONS; i++) dummy += timerTicks();
+	auto end = steady_clock::now();
+	std::cout << "timerTicks(): "
+	          << (duration<double, std::nano>(end - begin).count() / NUM_ITERATIONS) << " ns\n";
+
+	begin = steady_clock::now();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		dummy += uint64_t(high_resolution_clock::now().time_since_epoch().count());
+	}
+	end = steady_clock::now();
+	std::cout << "high_resolution_clock::now(): "
+	          << (duration<double, std::nano>(end - begin).count() / NUM_ITERATIONS) << " ns\n";
+
+	TimeAccumulator accumulator;
+	begin = steady_clock::now();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		ScopedTimer timer{accumulator};
+		dummy += uint64_t(i);
+	}
+	end = steady_clock::now();
+	std::cout << "ScopedTimer: "
+	          << (duration<double, std::nano>(end - begin).count() / NUM_ITERATIONS) << " ns ("
+	          << accumulator.averageNanoseconds() << " ns measured inside)\n";
+
+	StopWatch watch;
+	begin = steady_clock::now();
+	for (int i = 0; i < NUM_ITERATIONS; i++) dummy += watch.lapTicks();
+	end = steady_clock::now();
+	std::cout << "StopWatch::lapTicks(): "
+	          << (duration<double, std::nano>(end - begin).count() / NUM_ITERATIONS) << " ns\n";
+	std::cout << "(" << (dummy & 1) << ")\n";
+}
\ No newline at end of file
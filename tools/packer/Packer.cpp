@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sfz/util/IO.hpp"
+#include "sfz/util/PackArchive.hpp"
+
+// Build-time tool for creating pack archives (see sfz/util/PackArchive.hpp)
+//
+// Usage: sfzPacker [--compress] <output pack> <base directory> <manifest> [alignment]
+//
+// The manifest is a text file with the path (relative to the base directory) of each file to
+// pack, one per line. Empty lines and lines starting with '#' are ignored. If --compress is
+// specified files are compressed (see sfz/util/Compression.hpp) unless they don't compress.
+
+int main(int argc, char* argv[])
+{
+	bool compress = argc > 1 && std::strcmp(argv[1], "--compress") == 0;
+	char** args = compress ? argv + 1 : argv;
+	int numArgs = compress ? argc - 1 : argc;
+	if (numArgs != 4 && numArgs != 5) {
+		std::fprintf(stderr,
+		    "Usage: %s [--compress] <output pack> <base directory> <manifest> [alignment]\n",
+		    argv[0]);
+		return EXIT_FAILURE;
+	}
+	const char* packPath = args[1];
+	const char* baseDir = args[2];
+	const char* manifestPath = args[3];
+	const unsigned long alignment = numArgs == 5 ? std::strtoul(args[4], nullptr, 10) : 16;
+
+	if (!sfz::fileExists(manifestPath)) {
+		std::fprintf(stderr, "Could not open manifest \"%s\"\n", manifestPath);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::string> paths;
+	std::istringstream manifest{sfz::readTextFile(manifestPath)};
+	std::string line;
+	while (std::getline(manifest, line)) {
+		while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+			line.pop_back();
+		}
+		if (line.empty() || line[0] == '#') continue;
+		paths.push_back(line);
+	}
+
+	if (!sfz::writePackArchive(packPath, baseDir, paths, uint32_t(alignment), compress)) {
+		return EXIT_FAILURE;
+	}
+	std::printf("Packed %u files into \"%s\"\n", unsigned(paths.size()), packPath);
+	return EXIT_SUCCESS;
+}
\ No newline at end of file